@@ -0,0 +1,527 @@
+/**
+ * @file sssp_bench.c
+ * @brief Benchmark driver for the SSSP solvers and heap backends
+ *
+ * Builds a graph from one of the standard synthetic families (or a file),
+ * runs every selected solver over the same set of sources with warmup and
+ * repetitions, and reports min/median/p90/p99 timings as text, JSON or CSV.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "sssp_algorithm.h"
+#include "graph.h"
+#include "partitioning_heap.h"
+#include "relax_kernels.h"
+#include "sssp_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * @brief Benchmark options
+ */
+typedef struct bench_options {
+    const char* family;                 ///< grid, gnm, rmat, geo or file
+    const char* file;                   ///< Input file for the file family
+    vertex_count_t vertices;            ///< Requested vertex count
+    double avg_degree;                  ///< Requested average out-degree
+    uint64_t seed;                      ///< Generator and source seed
+    int warmup;                         ///< Untimed runs per solver
+    int repetitions;                    ///< Timed runs per solver
+    const char* solvers;                ///< Comma-separated solver list or "all"
+    const char* format;                 ///< text, json or csv
+    const char* output;                 ///< Output file (NULL for stdout)
+} bench_options_t;
+
+/**
+ * @brief Timing summary of one benchmark case
+ */
+typedef struct bench_summary {
+    const char* name;                   ///< Solver or heap backend name
+    const char* kind;                   ///< "solver" or "heap"
+    int samples;                        ///< Number of timed runs
+    double min_ms;
+    double median_ms;
+    double p90_ms;
+    double p99_ms;
+    double mean_ms;
+    uint64_t relaxations;               ///< Relaxations of the last run, or BENCH_UNCOUNTED
+    sssp_error_t status;                ///< First error seen, if any
+} bench_summary_t;
+
+/** Relaxations of a case that does not count them; reported as missing */
+#define BENCH_UNCOUNTED UINT64_MAX
+
+/**
+ * Graph families
+ */
+
+static sssp_graph_t* bench_generate_rmat(vertex_count_t n, double avg_degree, uint64_t seed) {
+    unsigned int scale = 1;
+    while ((1u << scale) < n && scale < 30) scale++;
+    double m = avg_degree * (double)(1u << scale);
+    return sssp_graph_generate_rmat(scale, (edge_count_t)SSSP_MIN(m, (double)UINT32_MAX),
+                                    0.57, 0.19, 0.19, 1.0, 100.0, seed, NULL);
+}
+
+static sssp_graph_t* bench_generate_geometric(vertex_count_t n, double avg_degree, uint64_t seed) {
+    // Radius giving the requested expected degree in the unit square
+    double radius = sqrt(avg_degree / (3.14159265358979323846 * (double)n));
+    return sssp_graph_generate_geometric(n, radius, seed, NULL);
+}
+
+static sssp_graph_t* bench_build_graph(const bench_options_t* options) {
+    const char* family = options->family;
+    if (strcmp(family, "grid") == 0) {
+        vertex_count_t side = (vertex_count_t)SSSP_MAX(2.0, ceil(sqrt((double)options->vertices)));
+        return sssp_graph_generate_grid_3d(side, side, 1, false, 1.0, 100.0, options->seed, NULL);
+    } else if (strcmp(family, "gnm") == 0) {
+        double m = options->avg_degree * (double)options->vertices;
+        return sssp_graph_generate_gnm(options->vertices, (edge_count_t)SSSP_MIN(m, (double)UINT32_MAX),
+                                       1.0, 100.0, options->seed, NULL);
+    } else if (strcmp(family, "rmat") == 0) {
+        return bench_generate_rmat(options->vertices, options->avg_degree, options->seed);
+    } else if (strcmp(family, "geo") == 0) {
+        return bench_generate_geometric(options->vertices, options->avg_degree, options->seed);
+    } else if (strcmp(family, "file") == 0) {
+        if (!options->file) {
+            fprintf(stderr, "--family file requires --file <path>\n");
+            return NULL;
+        }
+        return sssp_graph_load_from_file(options->file, NULL);
+    }
+
+    fprintf(stderr, "Unknown graph family: %s\n", family);
+    return NULL;
+}
+
+/**
+ * Solvers under test
+ */
+
+typedef sssp_error_t (*bench_solver_fn)(const sssp_graph_t* graph, vertex_id_t source,
+                                        sssp_algorithm_result_t* result, uint64_t* relaxations);
+
+static sssp_error_t bench_run_dijkstra(const sssp_graph_t* graph, vertex_id_t source,
+                                       sssp_algorithm_result_t* result, uint64_t* relaxations) {
+    sssp_vertex_set_clear(result->processed_vertices);
+    sssp_error_t error = sssp_solve_single_source(graph, source, NULL, result);
+    *relaxations = result->relaxations_performed;
+    return error;
+}
+
+static sssp_error_t bench_run_base_case(const sssp_graph_t* graph, vertex_id_t source,
+                                        sssp_algorithm_result_t* result, uint64_t* relaxations) {
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    sssp_vertex_set_t* sources = sssp_vertex_set_create(1, NULL);
+    if (!sources) return SSSP_ERROR_OUT_OF_MEMORY;
+    sssp_vertex_set_add(sources, source);
+
+    sssp_vertex_set_clear(result->processed_vertices);
+    weight_t b_prime = 0.0;
+    sssp_error_t error = sssp_base_case(graph, SSSP_INFINITY, sources, config.k, &config,
+                                        result->processed_vertices, &b_prime);
+    *relaxations = BENCH_UNCOUNTED;     // sssp_base_case() does not report its count
+    sssp_vertex_set_destroy(sources);
+    return error;
+}
+
+static sssp_error_t bench_run_bmssp(const sssp_graph_t* graph, vertex_id_t source,
+                                    sssp_algorithm_result_t* result, uint64_t* relaxations) {
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+
+    // Seed the source set with the source and its out-neighbors so the
+    // recursion actually exercises FINDPIVOTS on non-trivial graphs.
+    sssp_vertex_set_t* sources = sssp_vertex_set_create(16, NULL);
+    if (!sources) return SSSP_ERROR_OUT_OF_MEMORY;
+    sssp_vertex_set_add(sources, source);
+    const vertex_id_t* targets;
+    edge_count_t degree;
+    if (sssp_graph_neighbors(graph, source, &targets, NULL, &degree) == SSSP_SUCCESS) {
+        for (edge_count_t e = 0; e < degree; e++) {
+            if (!sssp_vertex_set_contains(sources, targets[e])) {
+                sssp_vertex_set_add(sources, targets[e]);
+            }
+        }
+    }
+
+    sssp_vertex_set_clear(result->processed_vertices);
+    weight_t b_prime = 0.0;
+    sssp_error_t error = sssp_bounded_multi_source(graph, 0, SSSP_INFINITY, sources,
+                                                   config.k, config.t, &config,
+                                                   result->processed_vertices, &b_prime);
+    *relaxations = BENCH_UNCOUNTED;     // Nor does sssp_bounded_multi_source()
+    sssp_vertex_set_destroy(sources);
+    return error;
+}
+
+static const struct {
+    const char* name;
+    bench_solver_fn run;
+} bench_solvers[] = {
+    { "dijkstra",  bench_run_dijkstra },
+    { "base_case", bench_run_base_case },
+    { "bmssp",     bench_run_bmssp },
+};
+
+/**
+ * Heap backends under test: a Dijkstra-shaped insert/decrease/extract trace
+ */
+
+typedef sssp_error_t (*bench_heap_fn)(vertex_count_t n, uint64_t seed);
+
+static sssp_error_t bench_heap_binary(vertex_count_t n, uint64_t seed) {
+    sssp_partitioning_heap_t* heap = sssp_partitioning_heap_create(n, NULL);
+    if (!heap) return SSSP_ERROR_OUT_OF_MEMORY;
+
+    sssp_rng_t rng;
+    sssp_rng_seed(&rng, seed, 0);
+    for (vertex_id_t v = 0; v < n; v++) {
+        sssp_partitioning_heap_insert(heap, v, 1000.0 * sssp_rng_uniform(&rng));
+    }
+    for (vertex_id_t v = 0; v < n; v += 2) {
+        distance_t current = sssp_partitioning_heap_get_distance(heap, v);
+        sssp_partitioning_heap_decrease_key(heap, v, current * sssp_rng_uniform(&rng));
+    }
+    vertex_id_t u;
+    distance_t d;
+    while (!sssp_partitioning_heap_is_empty(heap)) {
+        sssp_partitioning_heap_extract_min(heap, &u, &d);
+    }
+
+    sssp_partitioning_heap_destroy(heap);
+    return SSSP_SUCCESS;
+}
+
+static const struct {
+    const char* name;
+    bench_heap_fn run;
+} bench_heaps[] = {
+    { "binary", bench_heap_binary },
+};
+
+/**
+ * Statistics
+ */
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, int count, double p) {
+    if (count <= 0) return 0.0;
+    int rank = (int)ceil(p / 100.0 * count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static void summarize(bench_summary_t* summary, double* samples, int count) {
+    qsort(samples, (size_t)count, sizeof(double), compare_double);
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += samples[i];
+
+    summary->samples = count;
+    summary->min_ms = count ? samples[0] : 0.0;
+    summary->median_ms = percentile(samples, count, 50.0);
+    summary->p90_ms = percentile(samples, count, 90.0);
+    summary->p99_ms = percentile(samples, count, 99.0);
+    summary->mean_ms = count ? sum / count : 0.0;
+}
+
+static bool solver_selected(const char* list, const char* name) {
+    if (strcmp(list, "all") == 0) return true;
+    size_t len = strlen(name);
+    for (const char* p = list; (p = strstr(p, name)) != NULL; p += len) {
+        bool starts = (p == list) || p[-1] == ',';
+        bool ends = p[len] == '\0' || p[len] == ',';
+        if (starts && ends) return true;
+    }
+    return false;
+}
+
+static double elapsed_ms(uint64_t start_ns) {
+    return (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+}
+
+/**
+ * Output
+ */
+
+#ifdef SSSP_PACKED_VISITED
+#define BENCH_PACKED_VISITED 1
+#else
+#define BENCH_PACKED_VISITED 0
+#endif
+
+/**
+ * Relaxation count of s as text, or missing if it has none
+ */
+static const char* format_relaxations(const bench_summary_t* s, char* buffer, size_t size,
+                                      const char* missing) {
+    if (s->relaxations == BENCH_UNCOUNTED) {
+        return missing;
+    }
+    snprintf(buffer, size, "%llu", (unsigned long long)s->relaxations);
+    return buffer;
+}
+
+static void write_text(FILE* out, const bench_options_t* options, const sssp_graph_t* graph,
+                       const bench_summary_t* summaries, int count) {
+    fprintf(out, "graph: family=%s vertices=%u edges=%u seed=%llu\n", options->family,
+            sssp_graph_get_vertex_count(graph), sssp_graph_get_edge_count(graph),
+            (unsigned long long)options->seed);
+    fprintf(out, "build: prefetch_distance=%d packed_visited=%d relax_kernel=%s\n",
+            SSSP_PREFETCH_DISTANCE, BENCH_PACKED_VISITED, sssp_relax_kernel_name(sssp_relax_get_kernel()));
+    fprintf(out, "%-8s %-12s %6s %10s %10s %10s %10s %10s %12s\n", "kind", "name", "reps",
+            "min_ms", "median_ms", "p90_ms", "p99_ms", "mean_ms", "relaxations");
+    for (int i = 0; i < count; i++) {
+        const bench_summary_t* s = &summaries[i];
+        if (s->status != SSSP_SUCCESS) {
+            fprintf(out, "%-8s %-12s failed: %s\n", s->kind, s->name, sssp_error_string(s->status));
+            continue;
+        }
+        char relaxations[24];
+        fprintf(out, "%-8s %-12s %6d %10.3f %10.3f %10.3f %10.3f %10.3f %12s\n", s->kind, s->name,
+                s->samples, s->min_ms, s->median_ms, s->p90_ms, s->p99_ms, s->mean_ms,
+                format_relaxations(s, relaxations, sizeof(relaxations), "-"));
+    }
+}
+
+static void write_csv(FILE* out, const bench_options_t* options, const sssp_graph_t* graph,
+                      const bench_summary_t* summaries, int count) {
+    fprintf(out, "family,vertices,edges,seed,kind,name,status,reps,min_ms,median_ms,p90_ms,p99_ms,mean_ms,relaxations\n");
+    for (int i = 0; i < count; i++) {
+        const bench_summary_t* s = &summaries[i];
+        char relaxations[24];
+        fprintf(out, "%s,%u,%u,%llu,%s,%s,%s,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%s\n", options->family,
+                sssp_graph_get_vertex_count(graph), sssp_graph_get_edge_count(graph),
+                (unsigned long long)options->seed, s->kind, s->name,
+                s->status == SSSP_SUCCESS ? "ok" : "error", s->samples, s->min_ms, s->median_ms,
+                s->p90_ms, s->p99_ms, s->mean_ms,
+                format_relaxations(s, relaxations, sizeof(relaxations), ""));
+    }
+}
+
+static void write_json(FILE* out, const bench_options_t* options, const sssp_graph_t* graph,
+                       const bench_summary_t* summaries, int count) {
+    fprintf(out, "{\n  \"graph\": {\"family\": \"%s\", \"vertices\": %u, \"edges\": %u, \"seed\": %llu},\n",
+            options->family, sssp_graph_get_vertex_count(graph), sssp_graph_get_edge_count(graph),
+            (unsigned long long)options->seed);
+    fprintf(out, "  \"build\": {\"prefetch_distance\": %d, \"packed_visited\": %s, \"relax_kernel\": \"%s\"},\n",
+            SSSP_PREFETCH_DISTANCE, BENCH_PACKED_VISITED ? "true" : "false",
+            sssp_relax_kernel_name(sssp_relax_get_kernel()));
+    fprintf(out, "  \"warmup\": %d,\n  \"repetitions\": %d,\n  \"results\": [\n",
+            options->warmup, options->repetitions);
+    for (int i = 0; i < count; i++) {
+        const bench_summary_t* s = &summaries[i];
+        char relaxations[24];
+        fprintf(out, "    {\"kind\": \"%s\", \"name\": \"%s\", \"status\": \"%s\", \"reps\": %d, "
+                "\"min_ms\": %.6f, \"median_ms\": %.6f, \"p90_ms\": %.6f, \"p99_ms\": %.6f, "
+                "\"mean_ms\": %.6f, \"relaxations\": %s}%s\n",
+                s->kind, s->name, s->status == SSSP_SUCCESS ? "ok" : sssp_error_string(s->status),
+                s->samples, s->min_ms, s->median_ms, s->p90_ms, s->p99_ms, s->mean_ms,
+                format_relaxations(s, relaxations, sizeof(relaxations), "null"), i + 1 < count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void print_usage(const char* program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("Options:\n");
+    printf("  --family <name>    grid, gnm, rmat, geo or file (default: gnm)\n");
+    printf("  --file <path>      Graph file for --family file\n");
+    printf("  -n <vertices>      Vertex count (default: 10000)\n");
+    printf("  --degree <d>       Average out-degree (default: 8)\n");
+    printf("  --seed <s>         Generator and source seed (default: 1)\n");
+    printf("  --warmup <k>       Untimed runs per case (default: 2)\n");
+    printf("  --reps <k>         Timed runs per case (default: 10)\n");
+    printf("  --solvers <list>   Comma-separated solvers or \"all\" (default: all)\n");
+    printf("                     Available: dijkstra, base_case, bmssp\n");
+    printf("  --format <fmt>     text, json or csv (default: text)\n");
+    printf("  -o <file>          Write results to file instead of stdout\n");
+    printf("  -h                 Show this help\n");
+}
+
+int main(int argc, char* argv[]) {
+    bench_options_t options = {
+        .family = "gnm",
+        .file = NULL,
+        .vertices = 10000,
+        .avg_degree = 8.0,
+        .seed = 1,
+        .warmup = 2,
+        .repetitions = 10,
+        .solvers = "all",
+        .format = "text",
+        .output = NULL,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--family") == 0 && i + 1 < argc) {
+            options.family = argv[++i];
+        } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            options.file = argv[++i];
+            options.family = "file";
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            options.vertices = (vertex_count_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--degree") == 0 && i + 1 < argc) {
+            options.avg_degree = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            options.warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            options.repetitions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--solvers") == 0 && i + 1 < argc) {
+            options.solvers = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            options.format = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.vertices < 2 || options.repetitions < 1 || options.warmup < 0) {
+        fprintf(stderr, "Need at least 2 vertices and 1 repetition\n");
+        return 1;
+    }
+
+    uint64_t build_start = sssp_get_timestamp_ns();
+    sssp_graph_t* graph = bench_build_graph(&options);
+    if (!graph) {
+        fprintf(stderr, "Failed to build graph\n");
+        return 1;
+    }
+    fprintf(stderr, "Built %s graph (%u vertices, %u edges) in %.1f ms\n", options.family,
+            sssp_graph_get_vertex_count(graph), sssp_graph_get_edge_count(graph),
+            elapsed_ms(build_start));
+
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+
+    // Every solver sees the same sources in the same order
+    vertex_id_t* sources = malloc((size_t)(options.warmup + options.repetitions) * sizeof(vertex_id_t));
+    double* samples = malloc((size_t)options.repetitions * sizeof(double));
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    int max_cases = (int)(sizeof(bench_solvers) / sizeof(bench_solvers[0]) +
+                          sizeof(bench_heaps) / sizeof(bench_heaps[0]));
+    bench_summary_t* summaries = calloc((size_t)max_cases, sizeof(bench_summary_t));
+    if (!sources || !samples || !result || !summaries) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    sssp_rng_t rng;
+    sssp_rng_seed(&rng, options.seed, 1);
+    for (int i = 0; i < options.warmup + options.repetitions; i++) {
+        // Prefer sources with outgoing edges; R-MAT leaves many vertices isolated
+        vertex_id_t source = (vertex_id_t)sssp_rng_bounded(&rng, n);
+        for (int attempt = 0; attempt < 64; attempt++) {
+            if (sssp_graph_out_degree(graph, source) > 0) break;
+            source = (vertex_id_t)sssp_rng_bounded(&rng, n);
+        }
+        sources[i] = source;
+    }
+
+    int num_cases = 0;
+    for (size_t s = 0; s < sizeof(bench_solvers) / sizeof(bench_solvers[0]); s++) {
+        if (!solver_selected(options.solvers, bench_solvers[s].name)) continue;
+
+        bench_summary_t* summary = &summaries[num_cases++];
+        summary->name = bench_solvers[s].name;
+        summary->kind = "solver";
+        summary->status = SSSP_SUCCESS;
+
+        for (int i = 0; i < options.warmup; i++) {
+            uint64_t relaxations;
+            bench_solvers[s].run(graph, sources[i], result, &relaxations);
+        }
+
+        int count = 0;
+        for (int i = 0; i < options.repetitions; i++) {
+            uint64_t relaxations = 0;
+            uint64_t start = sssp_get_timestamp_ns();
+            sssp_error_t error = bench_solvers[s].run(graph, sources[options.warmup + i], result,
+                                                      &relaxations);
+            double ms = elapsed_ms(start);
+            if (error != SSSP_SUCCESS) {
+                summary->status = error;
+                break;
+            }
+            samples[count++] = ms;
+            summary->relaxations = relaxations;
+        }
+        summarize(summary, samples, count);
+    }
+
+    for (size_t h = 0; h < sizeof(bench_heaps) / sizeof(bench_heaps[0]); h++) {
+        bench_summary_t* summary = &summaries[num_cases++];
+        summary->name = bench_heaps[h].name;
+        summary->kind = "heap";
+        summary->status = SSSP_SUCCESS;
+        summary->relaxations = BENCH_UNCOUNTED;
+
+        for (int i = 0; i < options.warmup; i++) {
+            bench_heaps[h].run(n, options.seed + (uint64_t)i);
+        }
+
+        int count = 0;
+        for (int i = 0; i < options.repetitions; i++) {
+            uint64_t start = sssp_get_timestamp_ns();
+            sssp_error_t error = bench_heaps[h].run(n, options.seed + (uint64_t)(options.warmup + i));
+            double ms = elapsed_ms(start);
+            if (error != SSSP_SUCCESS) {
+                summary->status = error;
+                break;
+            }
+            samples[count++] = ms;
+        }
+        summarize(summary, samples, count);
+    }
+
+    FILE* out = stdout;
+    if (options.output) {
+        out = fopen(options.output, "w");
+        if (!out) {
+            fprintf(stderr, "Failed to open %s\n", options.output);
+            return 1;
+        }
+    }
+
+    if (strcmp(options.format, "json") == 0) {
+        write_json(out, &options, graph, summaries, num_cases);
+    } else if (strcmp(options.format, "csv") == 0) {
+        write_csv(out, &options, graph, summaries, num_cases);
+    } else {
+        write_text(out, &options, graph, summaries, num_cases);
+    }
+
+    if (out != stdout) fclose(out);
+
+    int exit_code = 0;
+    for (int i = 0; i < num_cases; i++) {
+        if (summaries[i].status != SSSP_SUCCESS) exit_code = 2;
+    }
+
+    free(summaries);
+    sssp_algorithm_result_destroy(result);
+    free(samples);
+    free(sources);
+    sssp_graph_destroy(graph);
+    return exit_code;
+}
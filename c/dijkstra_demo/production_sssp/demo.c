@@ -10,11 +10,13 @@
 #include "sssp_algorithm.h"
 #include "graph.h"
 #include "sssp_common.h"
+#include "sssp_server.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <signal.h>
 
 // Add missing string functions
 #ifndef _GNU_SOURCE
@@ -32,12 +34,15 @@ static void print_usage(const char* program_name) {
     printf("  -s <source>     Single source vertex (default: 0)\n");
     printf("  -m <sources>    Multi-source (comma-separated list)\n");
     printf("  -d <distance>   Maximum distance bound (default: infinity)\n");
+    printf("  --serve <addr>  Answer queries until interrupted (unix:PATH or tcp:PORT)\n");
+    printf("  -w <workers>    Query server worker threads (default: all cores)\n");
     printf("  -v              Verbose output\n");
     printf("  -h              Show this help\n");
     printf("\nExamples:\n");
     printf("  %s -g 1000                    # Random graph with 1000 vertices\n", program_name);
     printf("  %s -f graph.txt -s 5          # Load graph from file, source vertex 5\n", program_name);
     printf("  %s -g 500 -m 0,10,20 -d 100   # Multi-source with distance bound\n", program_name);
+    printf("  %s -g 100000 --serve unix:/tmp/sssp.sock  # Query server\n", program_name);
 }
 
 /**
@@ -48,26 +53,14 @@ static sssp_graph_t* generate_random_graph(vertex_count_t num_vertices, double e
     printf("Generating random graph: %u vertices, edge probability %.3f, max weight %.2f\n",
            num_vertices, edge_probability, max_weight);
     
-    sssp_graph_t* graph = sssp_graph_create(num_vertices, NULL);
+    sssp_graph_t* graph = sssp_graph_generate_random(num_vertices, edge_probability, 0.0, max_weight,
+                                                     (unsigned int)time(NULL), NULL);
     if (!graph) {
-        fprintf(stderr, "Failed to create graph\n");
+        fprintf(stderr, "Failed to generate graph\n");
         return NULL;
     }
     
-    srand((unsigned int)time(NULL));
-    
-    edge_count_t edges_added = 0;
-    for (vertex_id_t u = 0; u < num_vertices; u++) {
-        for (vertex_id_t v = 0; v < num_vertices; v++) {
-            if (u != v && ((double)rand() / RAND_MAX) < edge_probability) {
-                double weight = ((double)rand() / RAND_MAX) * max_weight;
-                if (sssp_graph_add_edge(graph, u, v, weight) == SSSP_SUCCESS) {
-                    edges_added++;
-                }
-            }
-        }
-    }
-    
+    edge_count_t edges_added = sssp_graph_get_edge_count(graph);
     printf("Generated graph with %u edges\n", edges_added);
     return graph;
 }
@@ -144,19 +137,7 @@ static void print_path(const sssp_algorithm_result_t* result, vertex_id_t source
 static void print_results_summary(const sssp_algorithm_result_t* result, const sssp_graph_t* graph,
                                   const vertex_id_t* sources, vertex_count_t num_sources) {
     vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
-    edge_count_t num_edges = 0; // We'll count edges manually since function might not exist
-    
-    // Count edges manually
-    for (vertex_count_t v = 0; v < num_vertices; v++) {
-        const sssp_adj_list_t* adj_list = sssp_graph_get_adj_list(graph, v);
-        if (adj_list) {
-            sssp_edge_node_t* edge = adj_list->head;
-            while (edge) {
-                num_edges++;
-                edge = edge->next;
-            }
-        }
-    }
+    edge_count_t num_edges = sssp_graph_get_edge_count(graph);
     
     printf("\n=== RESULTS SUMMARY ===\n");
     printf("Graph: %u vertices, %u edges\n", num_vertices, num_edges);
@@ -288,6 +269,57 @@ static void run_benchmark(const sssp_graph_t* graph, const vertex_id_t* sources,
 /**
  * Main demo program
  */
+// Server stopped by SIGINT and SIGTERM
+static sssp_server_t* active_server = NULL;
+
+static void stop_server(int signal_number) {
+    (void)signal_number;
+    sssp_server_stop(active_server);
+}
+
+/**
+ * Answer queries on the graph until interrupted
+ */
+static int serve_queries(const sssp_graph_t* graph, const char* address, unsigned int workers) {
+    sssp_server_config_t config = sssp_server_config_default(NULL);
+    config.num_workers = workers;
+    if (strncmp(address, "unix:", 5) == 0) {
+        config.unix_path = address + 5;
+    } else if (strncmp(address, "tcp:", 4) == 0) {
+        config.listen_tcp = true;
+        config.tcp_port = (uint16_t)atoi(address + 4);
+    } else {
+        fprintf(stderr, "Server address must be unix:PATH or tcp:PORT, got %s\n", address);
+        return 1;
+    }
+
+    sssp_error_t err = sssp_server_create(graph, &config, &active_server);
+    if (err != SSSP_SUCCESS) {
+        fprintf(stderr, "Failed to start server: %s\n", sssp_error_string(err));
+        return 1;
+    }
+    if (config.listen_tcp) {
+        printf("Serving queries on 127.0.0.1:%u\n", sssp_server_get_port(active_server));
+    } else {
+        printf("Serving queries on %s\n", config.unix_path);
+    }
+    fflush(stdout);
+    signal(SIGINT, stop_server);
+    signal(SIGTERM, stop_server);
+    err = sssp_server_run(active_server);
+
+    sssp_server_stats_t stats = sssp_server_get_stats(active_server);
+    sssp_server_destroy(active_server);
+    active_server = NULL;
+    printf("\nServed %llu of %llu requests on %llu connections (%llu rejected, %llu expired, "
+           "%llu shared searches, %llu batches)\n",
+           (unsigned long long)stats.answered, (unsigned long long)stats.requests,
+           (unsigned long long)stats.connections, (unsigned long long)stats.rejected,
+           (unsigned long long)stats.expired, (unsigned long long)stats.shared_searches,
+           (unsigned long long)stats.batches);
+    return err == SSSP_SUCCESS ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
     // Default parameters
     const char* graph_file = NULL;
@@ -296,6 +328,8 @@ int main(int argc, char* argv[]) {
     char* multi_sources_str = NULL;
     distance_t max_distance = SSSP_INFINITY;
     bool verbose = false;
+    const char* serve_address = NULL;
+    unsigned int server_workers = 0;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -309,6 +343,10 @@ int main(int argc, char* argv[]) {
             multi_sources_str = argv[++i];
         } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
             max_distance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve_address = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            server_workers = (unsigned int)atoi(argv[++i]);
         } else if (strcmp(argv[i], "-v") == 0) {
             verbose = true;
         } else if (strcmp(argv[i], "-h") == 0) {
@@ -353,6 +391,12 @@ int main(int argc, char* argv[]) {
     vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
     printf("Graph created with %u vertices\n", num_vertices);
     
+    if (serve_address) {
+        int status = serve_queries(graph, serve_address, server_workers);
+        sssp_graph_destroy(graph);
+        return status;
+    }
+    
     // Setup sources
     vertex_id_t* sources = NULL;
     vertex_count_t num_sources = 0;
@@ -0,0 +1,124 @@
+/**
+ * @file all_pairs.h
+ * @brief All-pairs shortest paths on small dense graphs (blocked Floyd-Warshall)
+ *
+ * For graphs of up to a few thousand vertices a full distance matrix is
+ * cheaper to compute in one pass than with one single-source solve per
+ * vertex. The matrix is split into square tiles, and each round of the
+ * blocked Floyd-Warshall algorithm updates the diagonal tile, then its row
+ * and column, then all remaining tiles, each tile staying in cache while it
+ * is updated. Tiles of the same phase are independent and run in parallel.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_ALL_PAIRS_H
+#define SSSP_ALL_PAIRS_H
+
+#include "sssp_common.h"
+#include "graph.h"
+#include "vertex_set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest graph accepted; the matrix takes n^2 entries */
+#define SSSP_APSP_MAX_VERTICES 65536
+
+/** Default tile edge, in matrix entries (64 x 64 doubles = 32 KiB) */
+#define SSSP_APSP_DEFAULT_TILE 64
+
+/**
+ * @brief Element type of the distance matrix
+ */
+typedef enum {
+    SSSP_APSP_DOUBLE = 0,               ///< double distances
+    SSSP_APSP_FLOAT                     ///< float distances: half the memory, twice the SIMD lanes
+} sssp_apsp_precision_t;
+
+/**
+ * @brief All-pairs configuration
+ */
+typedef struct sssp_apsp_config {
+    sssp_apsp_precision_t precision;    ///< Distance element type
+    bool compute_next_hops;             ///< Also build the next-hop matrix for path queries
+    bool use_parallel_processing;       ///< Update independent tiles on several threads
+    vertex_count_t tile_size;           ///< Tile edge, a multiple of 16 (0 for the default)
+    const sssp_allocator_t* allocator;  ///< Allocator for the matrices
+} sssp_apsp_config_t;
+
+/**
+ * @brief Distance matrix and optional next-hop matrix
+ *
+ * Rows and columns are padded to whole tiles, and rows are stride entries
+ * apart. Use sssp_apsp_distance() and sssp_apsp_next_hop() rather than
+ * indexing directly.
+ */
+typedef struct sssp_apsp_matrix {
+    vertex_count_t num_vertices;        ///< Number of vertices
+    size_t stride;                      ///< Entries per row (num_vertices padded to whole tiles, plus skew)
+    vertex_count_t tile_size;           ///< Tile edge used to compute the matrix
+    sssp_apsp_precision_t precision;    ///< Element type of distances
+    void* distances;                    ///< Padded rows of stride doubles or floats
+    vertex_id_t* next_hops;             ///< Padded rows of stride first hops, or NULL
+    double total_time_ms;               ///< Time to build and solve the matrix
+    const sssp_allocator_t* allocator;  ///< Allocator of the matrices
+} sssp_apsp_matrix_t;
+
+/**
+ * @brief Default configuration: double distances, no next hops, parallel
+ * @param allocator Memory allocator (NULL for default)
+ */
+sssp_apsp_config_t sssp_apsp_config_default(const sssp_allocator_t* allocator);
+
+/**
+ * @brief Compute shortest distances between all pairs of vertices
+ *
+ * Parallel edges keep their lightest weight. The min-plus kernels follow
+ * the relaxation kernel selection (see relax_kernels.h), so
+ * sssp_relax_set_kernel() also picks the scalar, AVX2 or AVX-512 tiles.
+ *
+ * @param graph Input graph (at most SSSP_APSP_MAX_VERTICES vertices)
+ * @param config Configuration (NULL for default)
+ * @param matrix_out Receives the new matrix
+ * @return SSSP_ERROR_INVALID_ARGUMENT for a bad tile size or too large a graph
+ */
+sssp_error_t sssp_all_pairs(const sssp_graph_t* graph,
+                            const sssp_apsp_config_t* config,
+                            sssp_apsp_matrix_t** matrix_out);
+
+/**
+ * @brief Destroy a matrix
+ * @param matrix Matrix to destroy (may be NULL)
+ */
+void sssp_apsp_matrix_destroy(sssp_apsp_matrix_t* matrix);
+
+/**
+ * @brief Shortest distance from u to v (SSSP_INFINITY if unreachable)
+ */
+distance_t sssp_apsp_distance(const sssp_apsp_matrix_t* matrix, vertex_id_t u, vertex_id_t v);
+
+/**
+ * @brief First vertex after u on a shortest path to v
+ * @return v's first hop, u when u == v, SSSP_INVALID_VERTEX when v is
+ *         unreachable or next hops were not computed
+ */
+vertex_id_t sssp_apsp_next_hop(const sssp_apsp_matrix_t* matrix, vertex_id_t u, vertex_id_t v);
+
+/**
+ * @brief Write the shortest path from u to v, both included, to path
+ * @return SSSP_ERROR_INVALID_ARGUMENT without next hops, or when v is unreachable
+ */
+sssp_error_t sssp_apsp_path(const sssp_apsp_matrix_t* matrix,
+                            vertex_id_t u,
+                            vertex_id_t v,
+                            sssp_vertex_set_t* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_ALL_PAIRS_H
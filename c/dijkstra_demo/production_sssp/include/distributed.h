@@ -0,0 +1,223 @@
+/**
+ * @file distributed.h
+ * @brief Single-source shortest paths across several shard processes
+ *
+ * A cluster splits the vertex id space into contiguous ranges, one per
+ * shard, balanced on out-degree + 1. Each shard is a separate process that
+ * owns the distances of its range and a CSR copy of its out-edges; edges
+ * into other ranges are cut, and relaxing one sends a message to the
+ * owner instead of updating a distance.
+ *
+ * Solves run delta-stepping in bulk-synchronous supersteps. In each
+ * superstep every shard relaxes its part of the current bucket (light
+ * edges, or the heavy edges of the vertices the bucket settled), then
+ * sends one frame to every other shard with its relaxation messages and
+ * its bucket state, and applies the frames it receives. All shards see the
+ * same bucket states, so they make the same decision about the next
+ * superstep without a coordinator.
+ *
+ * Frames go through a transport: Unix domain sockets or shared-memory
+ * rings are built in, and sssp_transport_ops_t plugs in others. The
+ * process that created the cluster only starts solves and gathers results
+ * on request.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_DISTRIBUTED_H
+#define SSSP_DISTRIBUTED_H
+
+#include "sssp_common.h"
+#include "graph.h"
+#include "sssp_algorithm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest number of shards in a cluster */
+#define SSSP_CLUSTER_MAX_SHARDS 16
+
+/** Default capacity of one shared-memory ring, in bytes */
+#define SSSP_CLUSTER_DEFAULT_CHANNEL_CAPACITY ((size_t)256 << 10)
+
+/**
+ * @brief Frame transport between shard processes
+ *
+ * create() runs in the creating process before the shards are started and
+ * must set up every shard-to-shard channel; each shard inherits the state
+ * and calls attach() with its own index first. send() and receive() must
+ * not block: they move what they can and report it through sent and
+ * received (0 is fine). wait() blocks until some channel flagged in
+ * sending or receiving (indexed by peer) can make progress, or briefly.
+ * A channel whose peer is gone reports SSSP_ERROR_IO.
+ */
+typedef struct sssp_transport_ops {
+    const char* name;                   ///< Name for logs
+    sssp_error_t (*create)(uint32_t num_shards, size_t channel_capacity,
+                           const sssp_allocator_t* allocator, void** state_out);
+    sssp_error_t (*attach)(void* state, uint32_t shard);
+    sssp_error_t (*send)(void* state, uint32_t peer, const void* data, size_t size, size_t* sent);
+    sssp_error_t (*receive)(void* state, uint32_t peer, void* data, size_t size, size_t* received);
+    void (*wait)(void* state, const bool* sending, const bool* receiving);
+    void (*destroy)(void* state);       ///< Called by the creating process and by every shard
+} sssp_transport_ops_t;
+
+/**
+ * @brief Stream sockets between every pair of shards
+ */
+const sssp_transport_ops_t* sssp_transport_unix_socket(void);
+
+/**
+ * @brief Single-producer rings in shared memory between every pair of shards
+ *
+ * Waiting yields the processor rather than sleeping, and a ring cannot
+ * tell that its peer has died; the creating process notices that instead
+ * and stops the cluster.
+ */
+const sssp_transport_ops_t* sssp_transport_shared_memory(void);
+
+/**
+ * @brief Cluster configuration
+ */
+typedef struct sssp_cluster_config {
+    uint32_t num_shards;                ///< Shard processes to start
+    const sssp_transport_ops_t* transport; ///< Frame transport (NULL for Unix sockets)
+    size_t channel_capacity;            ///< Buffer per channel (0 for the default)
+    distance_t delta;                   ///< Bucket width (0: max weight / average degree)
+    const sssp_allocator_t* allocator;  ///< Allocator, in the creating process and the shards
+} sssp_cluster_config_t;
+
+/**
+ * @brief Statistics of the last solve
+ */
+typedef struct sssp_cluster_stats {
+    uint32_t supersteps;                ///< Bulk-synchronous supersteps
+    uint32_t buckets;                   ///< Buckets settled
+    uint64_t messages;                  ///< Relaxation messages between shards
+    uint64_t bytes;                     ///< Frame bytes between shards, headers included
+    edge_count_t cut_edges;             ///< Edges between different shards
+    double solve_time_ms;               ///< Time of the solve, without gathering
+} sssp_cluster_stats_t;
+
+/**
+ * @brief Running shard processes and their partition
+ */
+typedef struct sssp_cluster sssp_cluster_t;
+
+/**
+ * @brief Default configuration: Unix sockets and automatic delta
+ * @param num_shards Shard processes to start
+ * @param allocator Memory allocator (NULL for default)
+ */
+sssp_cluster_config_t sssp_cluster_config_default(uint32_t num_shards,
+                                                  const sssp_allocator_t* allocator);
+
+/**
+ * @brief Partition graph and start one process per shard
+ *
+ * Each shard copies its own out-edges after it starts. The graph is not
+ * used afterwards; until the caller frees it, the shards share its pages
+ * with the caller rather than copying them. Its CSR arrays are built
+ * first, so the shards only read it.
+ *
+ * The whole graph, CSR included, must therefore fit in the calling
+ * process, and while it is held the machine's peak is above that of a
+ * single-process solve: the caller's graph plus every shard's partition.
+ * Clusters spread the work of one graph over processes, not a graph too
+ * large for one of them.
+ *
+ * The shards are forked from the calling process and only have the
+ * calling thread. config->allocator must therefore not depend on locks or
+ * threads of the caller that another thread may hold at the time; the
+ * default allocator and the library's own locks are safe.
+ *
+ * @param graph Graph with non-negative weights
+ * @param config Configuration (NULL for two shards over Unix sockets)
+ * @param cluster_out Receives the new cluster
+ * @return SSSP_ERROR_GRAPH_INVALID for negative weights,
+ *         SSSP_ERROR_INVALID_ARGUMENT for a bad shard count or delta,
+ *         SSSP_ERROR_IO if a transport or process cannot be set up,
+ *         SSSP_ERROR_NOT_IMPLEMENTED where processes cannot be forked
+ */
+sssp_error_t sssp_cluster_create(const sssp_graph_t* graph,
+                                 const sssp_cluster_config_t* config,
+                                 sssp_cluster_t** cluster_out);
+
+/**
+ * @brief Stop the shard processes and free the cluster
+ * @param cluster Cluster to destroy (may be NULL)
+ */
+void sssp_cluster_destroy(sssp_cluster_t* cluster);
+
+/**
+ * @brief Solve from source on the shards
+ *
+ * The counterpart of sssp_solve_single_source(). Distances stay on the
+ * shards until gathered: pass a result to gather them right away, or NULL
+ * and use sssp_cluster_gather() or sssp_cluster_distance() later. Each
+ * shard solves on one thread. The cluster does not keep the graph, so
+ * config->enable_validation is not applied; run sssp_validate_result() on
+ * the gathered result instead.
+ *
+ * config->deadline_ns and config->cancel_token are checked by every shard
+ * once per superstep; a solve stopped by them returns SSSP_ERROR_TIMEOUT
+ * or SSSP_ERROR_CANCELLED with nothing to gather, and the cluster stays
+ * usable. No failed or rejected solve leaves an earlier one's distances
+ * to gather. The shards' memory is allocated when they start, so a solve
+ * cannot be held to config->memory_limit_bytes.
+ *
+ * @param cluster Cluster
+ * @param source Source vertex
+ * @param config Algorithm configuration (NULL for default)
+ * @param result Result to fill, or NULL
+ * @return SSSP_ERROR_INVALID_ARGUMENT if config sets a memory limit,
+ *         SSSP_ERROR_TIMEOUT or SSSP_ERROR_CANCELLED if stopped early,
+ *         SSSP_ERROR_IO if a shard fails; the cluster is stopped and
+ *         every later call returns the same
+ */
+sssp_error_t sssp_cluster_solve(sssp_cluster_t* cluster,
+                                vertex_id_t source,
+                                const sssp_algorithm_config_t* config,
+                                sssp_algorithm_result_t* result);
+
+/**
+ * @brief Collect the distances and predecessors of the last solve
+ * @return SSSP_ERROR_INVALID_ARGUMENT if nothing was solved yet
+ */
+sssp_error_t sssp_cluster_gather(sssp_cluster_t* cluster, sssp_algorithm_result_t* result);
+
+/**
+ * @brief Ask the owner of vertex for its distance in the last solve
+ * @param predecessor If not NULL, receives the predecessor
+ */
+sssp_error_t sssp_cluster_distance(sssp_cluster_t* cluster,
+                                   vertex_id_t vertex,
+                                   distance_t* distance,
+                                   vertex_id_t* predecessor);
+
+/**
+ * @brief Number of shards
+ */
+uint32_t sssp_cluster_num_shards(const sssp_cluster_t* cluster);
+
+/**
+ * @brief Vertex range [begin, end) owned by shard
+ */
+sssp_error_t sssp_cluster_shard_range(const sssp_cluster_t* cluster,
+                                      uint32_t shard,
+                                      vertex_id_t* begin,
+                                      vertex_id_t* end);
+
+/**
+ * @brief Statistics of the last solve
+ */
+sssp_cluster_stats_t sssp_cluster_get_stats(const sssp_cluster_t* cluster);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_DISTRIBUTED_H
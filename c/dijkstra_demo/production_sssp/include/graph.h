@@ -43,13 +43,43 @@ struct sssp_adj_list {
 
 /**
  * @brief Graph data structure
+ *
+ * A graph is stored either as per-vertex linked adjacency lists (graphs built
+ * with sssp_graph_add_edge) or in contiguous CSR arrays (graphs produced by
+ * the generators). CSR graphs build linked lists only if something asks for
+ * them through sssp_graph_get_adj_list. List-backed graphs get CSR arrays
+ * alongside their lists on first use of sssp_graph_neighbors, which is how
+ * the solvers read edges. Adding an edge drops the CSR arrays and leaves the
+ * graph in list storage.
+ *
+ * In-edges are kept in a separate transposed CSR, built on first use and
+ * dropped when an edge is added. Weights that are whole numbers after
+ * scaling by a power of ten can also be kept as integers beside the CSR
+ * weights (sssp_graph_build_integer_weights), dropped with the CSR arrays.
  */
 struct sssp_graph {
     vertex_count_t num_vertices;        ///< Number of vertices
     edge_count_t num_edges;             ///< Number of edges
     edge_count_t total_edges;           ///< Alias for num_edges for compatibility
     bool has_negative_weights;          ///< Whether graph has negative edge weights
-    sssp_adj_list_t* adj_list;          ///< Adjacency lists
+    bool allow_negative_weights;        ///< Whether sssp_graph_add_edge accepts negative weights
+    sssp_adj_list_t* adj_list;          ///< Adjacency lists (NULL until built for CSR graphs)
+    
+    // Contiguous storage
+    edge_count_t* csr_offsets;          ///< Out-edges of v are [csr_offsets[v], csr_offsets[v + 1]), NULL if list-backed
+    vertex_id_t* csr_targets;           ///< Edge destinations
+    weight_t* csr_weights;              ///< Edge weights
+    sssp_edge_node_t* edge_pool;        ///< Nodes of the lists built from CSR storage
+    edge_count_t edge_pool_size;        ///< Number of nodes in edge_pool
+    
+    // Transposed storage (NULL until built)
+    edge_count_t* reverse_offsets;      ///< In-edges of v are [reverse_offsets[v], reverse_offsets[v + 1])
+    vertex_id_t* reverse_sources;       ///< In-edge sources, ascending for each vertex
+    weight_t* reverse_weights;          ///< In-edge weights
+    
+    // Integer weights (NULL until built)
+    uint32_t* int_weights;              ///< csr_weights[e] * weight_scale, exactly
+    uint32_t weight_scale;              ///< Power of ten the weights were scaled by (0 if not built)
     
     // Memory management
     const sssp_allocator_t* allocator;  ///< Memory allocator
@@ -61,6 +91,11 @@ struct sssp_graph {
 
 /**
  * @brief Create a new graph with specified number of vertices
+ *
+ * Every array of the graph, CSR and lazily built ones included, comes from
+ * allocator. To back the large ones with huge pages, pass the allocator of
+ * an sssp_huge_page_allocator_t that outlives the graph.
+ *
  * @param num_vertices Number of vertices in the graph
  * @param allocator Memory allocator to use (NULL for default)
  * @return Pointer to new graph or NULL on failure
@@ -85,8 +120,26 @@ sssp_error_t sssp_graph_clear(sssp_graph_t* graph);
  * @brief Edge operations
  */
 
+/**
+ * @brief Let sssp_graph_add_edge accept negative weights
+ *
+ * Off by default. A graph with negative weights can only be solved with
+ * the solvers of negative_weights.h; the Dijkstra-based solvers reject it
+ * with SSSP_ERROR_GRAPH_INVALID.
+ *
+ * @param graph Target graph
+ * @param allow Whether to accept negative weights
+ * @return SSSP_ERROR_INVALID_ARGUMENT when disallowing on a graph that
+ *         already has negative weights
+ */
+sssp_error_t sssp_graph_allow_negative_weights(sssp_graph_t* graph, bool allow);
+
 /**
  * @brief Add a directed edge to the graph
+ *
+ * Negative weights are rejected unless allowed with
+ * sssp_graph_allow_negative_weights().
+ *
  * @param graph Target graph
  * @param src Source vertex
  * @param dest Destination vertex
@@ -154,6 +207,9 @@ SSSP_INLINE size_t sssp_graph_num_edges(const sssp_graph_t* graph) {
 
 /**
  * @brief Check if the graph has negative weights
+ *
+ * Set when a negative edge is added; removing it does not clear the flag.
+ *
  * @param graph Target graph
  * @return true if graph has negative weights
  */
@@ -187,6 +243,27 @@ SSSP_INLINE vertex_count_t sssp_graph_get_vertex_count(const sssp_graph_t* graph
  */
 edge_count_t sssp_graph_get_edge_count(const sssp_graph_t* graph);
 
+/**
+ * @brief Check whether the graph is stored in contiguous CSR arrays
+ * @param graph Graph instance
+ * @return true if csr_offsets, csr_targets and csr_weights are valid
+ */
+SSSP_INLINE bool sssp_graph_is_csr(const sssp_graph_t* graph) {
+    return graph && __atomic_load_n(&graph->csr_offsets, __ATOMIC_ACQUIRE) != NULL;
+}
+
+/**
+ * @brief Build linked adjacency lists for a CSR graph
+ *
+ * All nodes come from a single allocation and keep the CSR edge order. This
+ * is done on first use by sssp_graph_get_adj_list. Concurrent first uses on
+ * an unmodified graph are safe: one thread builds, the others wait for it.
+ *
+ * @param graph Graph instance
+ * @return Error code
+ */
+sssp_error_t sssp_graph_build_adj_lists(sssp_graph_t* graph);
+
 /**
  * @brief Get adjacency list for a vertex
  * @param graph Graph instance
@@ -197,7 +274,163 @@ SSSP_INLINE const sssp_adj_list_t* sssp_graph_get_adj_list(const sssp_graph_t* g
     if (!graph || vertex >= graph->num_vertices) {
         return NULL;
     }
-    return &graph->adj_list[vertex];
+    const sssp_adj_list_t* adj_list = __atomic_load_n(&graph->adj_list, __ATOMIC_ACQUIRE);
+    if (SSSP_UNLIKELY(!adj_list)) {
+        if (sssp_graph_build_adj_lists((sssp_graph_t*)graph) != SSSP_SUCCESS) {
+            return NULL;
+        }
+        adj_list = graph->adj_list;
+    }
+    return &adj_list[vertex];
+}
+
+/**
+ * @brief Copy the edges of a list-backed graph into CSR arrays
+ *
+ * The lists are kept, and the arrays hold each vertex's edges in list
+ * order, so the graph is CSR until the next sssp_graph_add_edge. This runs
+ * on first use by sssp_graph_neighbors, so the first solve on a list-backed
+ * graph pays for it; concurrent first uses are safe and build it once.
+ * Does nothing for CSR graphs.
+ *
+ * @param graph Graph instance
+ * @return Error code
+ */
+sssp_error_t sssp_graph_build_csr(sssp_graph_t* graph);
+
+/**
+ * @brief Get the out-edges of a vertex as contiguous arrays
+ *
+ * The arrays stay valid until the graph is changed or destroyed. Edges come
+ * in storage order: CSR order, or list order for list-backed graphs.
+ *
+ * @param graph Graph instance
+ * @param vertex Vertex ID
+ * @param targets_out Receives the edge destinations
+ * @param weights_out Receives the matching weights (may be NULL)
+ * @param count_out Receives the out-degree
+ * @return Error code
+ */
+SSSP_INLINE sssp_error_t sssp_graph_neighbors(const sssp_graph_t* graph, vertex_id_t vertex,
+                                              const vertex_id_t** targets_out,
+                                              const weight_t** weights_out,
+                                              edge_count_t* count_out) {
+    if (!graph || !targets_out || !count_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (vertex >= graph->num_vertices) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    const edge_count_t* offsets = __atomic_load_n(&graph->csr_offsets, __ATOMIC_ACQUIRE);
+    if (SSSP_UNLIKELY(!offsets)) {
+        sssp_error_t result = sssp_graph_build_csr((sssp_graph_t*)graph);
+        if (result != SSSP_SUCCESS) {
+            return result;
+        }
+        offsets = graph->csr_offsets;
+    }
+    edge_count_t begin = offsets[vertex];
+    *targets_out = graph->csr_targets + begin;
+    if (weights_out) {
+        *weights_out = graph->csr_weights + begin;
+    }
+    *count_out = offsets[vertex + 1] - begin;
+    return SSSP_SUCCESS;
+}
+
+/** Most decimal places sssp_graph_build_integer_weights() scales away */
+#define SSSP_MAX_WEIGHT_DECIMALS 6
+
+/**
+ * @brief Keep the weights as 32-bit integers if they are whole numbers at
+ *        some decimal scale
+ *
+ * Finds the fewest decimal places d <= SSSP_MAX_WEIGHT_DECIMALS for which
+ * every weight times 10^d is a whole number no larger than UINT32_MAX and
+ * stores those integers in CSR order. sssp_solve_single_source() then runs
+ * on integer distances and divides them by 10^d at the end.
+ * sssp_graph_load_from_file() calls this; the integers are dropped by the
+ * next sssp_graph_add_edge. Not thread-safe: call it before sharing the
+ * graph.
+ *
+ * @param graph Graph instance
+ * @return SSSP_SUCCESS if the integers are built (or were already),
+ *         SSSP_ERROR_INVALID_ARGUMENT if some weight is negative, not finite,
+ *         or needs more decimals or bits
+ */
+sssp_error_t sssp_graph_build_integer_weights(sssp_graph_t* graph);
+
+/**
+ * @brief Scale of the integer weights
+ * @param graph Graph instance
+ * @return 10^d as chosen by sssp_graph_build_integer_weights(), or 0 if the
+ *         graph has no integer weights
+ */
+SSSP_INLINE uint32_t sssp_graph_get_weight_scale(const sssp_graph_t* graph) {
+    return graph && graph->int_weights ? graph->weight_scale : 0;
+}
+
+/**
+ * @brief Build the in-edges of every vertex
+ *
+ * A counting sort over the out-edges in O(n + m) time, kept on the graph
+ * until the next sssp_graph_add_edge. Like sssp_graph_build_adj_lists this
+ * runs on first use by the in-edge functions below, and concurrent first
+ * uses build it once.
+ *
+ * @param graph Graph instance
+ * @return Error code
+ */
+sssp_error_t sssp_graph_build_reverse(sssp_graph_t* graph);
+
+/**
+ * @brief Get the in-degree of a vertex
+ * @param graph Graph instance
+ * @param vertex Vertex ID
+ * @return In-degree of the vertex, or 0 if vertex is invalid
+ */
+SSSP_INLINE vertex_count_t sssp_graph_in_degree(const sssp_graph_t* graph, vertex_id_t vertex) {
+    if (!graph || vertex >= graph->num_vertices) {
+        return 0;
+    }
+    const edge_count_t* offsets = __atomic_load_n(&graph->reverse_offsets, __ATOMIC_ACQUIRE);
+    if (SSSP_UNLIKELY(!offsets)) {
+        if (sssp_graph_build_reverse((sssp_graph_t*)graph) != SSSP_SUCCESS) {
+            return 0;
+        }
+        offsets = graph->reverse_offsets;
+    }
+    return offsets[vertex + 1] - offsets[vertex];
+}
+
+/**
+ * @brief Get the in-edges of a vertex
+ *
+ * The arrays stay valid until the graph is changed or destroyed.
+ *
+ * @param graph Graph instance
+ * @param vertex Vertex ID
+ * @param sources_out Receives the in-edge sources, in ascending order
+ * @param weights_out Receives the matching weights (may be NULL)
+ * @return Number of in-edges, or 0 if vertex is invalid
+ */
+SSSP_INLINE vertex_count_t sssp_graph_in_edges(const sssp_graph_t* graph, vertex_id_t vertex,
+                                               const vertex_id_t** sources_out,
+                                               const weight_t** weights_out) {
+    vertex_count_t degree = sssp_graph_in_degree(graph, vertex);
+    if (degree == 0) {
+        *sources_out = NULL;
+        if (weights_out) {
+            *weights_out = NULL;
+        }
+        return 0;
+    }
+    edge_count_t begin = graph->reverse_offsets[vertex];
+    *sources_out = graph->reverse_sources + begin;
+    if (weights_out) {
+        *weights_out = graph->reverse_weights + begin;
+    }
+    return degree;
 }
 
 /**
@@ -226,8 +459,20 @@ sssp_error_t sssp_graph_save_to_file(const sssp_graph_t* graph,
  * @brief Graph generation for testing
  */
 
+/*
+ * All generators run in O(n + m) time, write CSR storage directly and split
+ * the work across sssp_get_num_threads() threads. Work is divided into chunks
+ * that depend only on the parameters, each with its own random stream, so a
+ * given seed produces the same graph for any thread count. Edge weights are
+ * drawn uniformly from [min_weight, max_weight).
+ */
+
 /**
- * @brief Generate a random graph for testing
+ * @brief Generate a G(n,p) random directed graph (no self-loops)
+ *
+ * Uses geometric skip sampling, so the cost is proportional to the number of
+ * edges produced rather than n^2.
+ *
  * @param num_vertices Number of vertices
  * @param edge_probability Probability of each edge existing (0.0 to 1.0)
  * @param min_weight Minimum edge weight
@@ -243,8 +488,59 @@ sssp_graph_t* sssp_graph_generate_random(vertex_count_t num_vertices,
                                           unsigned int seed,
                                           const sssp_allocator_t* allocator);
 
+/**
+ * @brief Generate a G(n,m) random directed graph (no self-loops or duplicates)
+ *
+ * The edge set is uniform over all graphs with exactly num_edges edges.
+ *
+ * @param num_vertices Number of vertices
+ * @param num_edges Number of edges (at most n * (n - 1))
+ * @param min_weight Minimum edge weight
+ * @param max_weight Maximum edge weight
+ * @param seed Random seed
+ * @param allocator Memory allocator
+ * @return Generated graph or NULL on failure
+ */
+sssp_graph_t* sssp_graph_generate_gnm(vertex_count_t num_vertices,
+                                       edge_count_t num_edges,
+                                       weight_t min_weight,
+                                       weight_t max_weight,
+                                       uint64_t seed,
+                                       const sssp_allocator_t* allocator);
+
+/**
+ * @brief Generate an R-MAT (stochastic Kronecker) power-law graph
+ *
+ * Each edge picks a quadrant of the adjacency matrix with probabilities
+ * a, b, c and 1 - a - b - c at each of the scale levels. Vertex ids are
+ * scrambled with a fixed bijection so that hubs are not clustered at low ids.
+ * Self-loops are redrawn; parallel edges are kept, as in Graph500.
+ *
+ * @param scale Log2 of the number of vertices (1 to 30)
+ * @param num_edges Number of edges
+ * @param a Probability of the top-left quadrant
+ * @param b Probability of the top-right quadrant
+ * @param c Probability of the bottom-left quadrant
+ * @param min_weight Minimum edge weight
+ * @param max_weight Maximum edge weight
+ * @param seed Random seed
+ * @param allocator Memory allocator
+ * @return Generated graph or NULL on failure
+ */
+sssp_graph_t* sssp_graph_generate_rmat(unsigned int scale,
+                                        edge_count_t num_edges,
+                                        double a, double b, double c,
+                                        weight_t min_weight,
+                                        weight_t max_weight,
+                                        uint64_t seed,
+                                        const sssp_allocator_t* allocator);
+
 /**
  * @brief Generate a grid graph for testing
+ *
+ * Vertex (r, c) has id r * cols + c. Edges go both ways; axis edges have
+ * weight 1 and diagonal edges weight sqrt(2).
+ *
  * @param rows Number of rows
  * @param cols Number of columns
  * @param diagonal_edges Whether to include diagonal edges
@@ -256,13 +552,66 @@ sssp_graph_t* sssp_graph_generate_grid(vertex_count_t rows,
                                         bool diagonal_edges,
                                         const sssp_allocator_t* allocator);
 
+/**
+ * @brief Generate a 2D or 3D grid graph with random weights
+ *
+ * Vertex (x, y, z) has id (z * ny + y) * nx + x. Each vertex connects to its
+ * 6 axis neighbors, or all 26 neighbors with diagonal_edges (4 and 8 when
+ * nz == 1). An edge's weight is its Euclidean step length times a factor
+ * drawn from [min_weight, max_weight); both directions share the factor.
+ *
+ * @param nx Extent along x
+ * @param ny Extent along y
+ * @param nz Extent along z (1 for a 2D grid)
+ * @param diagonal_edges Whether to include diagonal edges
+ * @param min_weight Minimum weight factor
+ * @param max_weight Maximum weight factor
+ * @param seed Random seed
+ * @param allocator Memory allocator
+ * @return Generated grid graph or NULL on failure
+ */
+sssp_graph_t* sssp_graph_generate_grid_3d(vertex_count_t nx,
+                                           vertex_count_t ny,
+                                           vertex_count_t nz,
+                                           bool diagonal_edges,
+                                           weight_t min_weight,
+                                           weight_t max_weight,
+                                           uint64_t seed,
+                                           const sssp_allocator_t* allocator);
+
+/**
+ * @brief Generate a random geometric graph in the unit square
+ *
+ * Points are placed uniformly at random and every pair closer than radius is
+ * connected in both directions, weighted by their distance. Vertex ids follow
+ * a row-major cell order, so nearby points get nearby ids as in road networks.
+ * The expected degree is about pi * radius^2 * n.
+ *
+ * @param num_vertices Number of points
+ * @param radius Connection radius
+ * @param seed Random seed
+ * @param allocator Memory allocator
+ * @return Generated graph or NULL on failure
+ */
+sssp_graph_t* sssp_graph_generate_geometric(vertex_count_t num_vertices,
+                                             double radius,
+                                             uint64_t seed,
+                                             const sssp_allocator_t* allocator);
+
 /**
  * @brief Iterator for traversing edges
+ *
+ * A wrapper over sssp_graph_neighbors for code written against the node
+ * interface; new code should loop over the arrays directly.
  */
 typedef struct sssp_edge_iterator {
     const sssp_graph_t* graph;
     vertex_id_t current_vertex;
-    const sssp_edge_node_t* current_edge;
+    const vertex_id_t* targets;         ///< Out-edge destinations of current_vertex
+    const weight_t* weights;            ///< Matching weights
+    edge_count_t count;                 ///< Out-degree of current_vertex
+    edge_count_t position;              ///< Index of the next edge
+    sssp_edge_node_t current_edge;      ///< Last edge handed out (next is always NULL)
 } sssp_edge_iterator_t;
 
 /**
@@ -279,7 +628,7 @@ sssp_error_t sssp_edge_iterator_init(const sssp_graph_t* graph,
 /**
  * @brief Get next edge from iterator
  * @param iter Edge iterator
- * @param edge_out Pointer to store edge information
+ * @param edge_out Receives the edge, valid until the next call
  * @return true if edge was retrieved, false if no more edges
  */
 bool sssp_edge_iterator_next(sssp_edge_iterator_t* iter, 
@@ -0,0 +1,135 @@
+/**
+ * @file implicit_graph.h
+ * @brief Implicit graphs whose edges are computed on demand
+ *
+ * An implicit graph is a vertex count plus a callback that enumerates the
+ * out-edges of one vertex. Nothing about the edges is stored, so grid maps
+ * and state spaces far larger than an adjacency structure would allow can
+ * be searched with memory for the distance arrays and the frontier only.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_IMPLICIT_GRAPH_H
+#define SSSP_IMPLICIT_GRAPH_H
+
+#include "sssp_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct sssp_implicit_graph sssp_implicit_graph_t;
+typedef struct sssp_implicit_graph_ops sssp_implicit_graph_ops_t;
+typedef struct sssp_implicit_stats sssp_implicit_stats_t;
+
+/**
+ * @brief Operations implemented by an implicit graph
+ */
+struct sssp_implicit_graph_ops {
+    /**
+     * Write the out-edges of vertex to targets[] and weights[], which have
+     * room for graph->max_degree entries, and return how many were written.
+     * Weights must be non-negative.
+     */
+    vertex_count_t (*neighbors)(const sssp_implicit_graph_t* graph,
+                                vertex_id_t vertex,
+                                vertex_id_t* targets,
+                                weight_t* weights);
+
+    /** Release the graph; NULL when the caller owns the storage */
+    void (*destroy)(sssp_implicit_graph_t* graph);
+};
+
+/**
+ * @brief Implicit graph
+ *
+ * User-defined graphs can be set up in place, e.g.
+ * `sssp_implicit_graph_t g = { &my_ops, n, 4, &my_state };`
+ */
+struct sssp_implicit_graph {
+    const sssp_implicit_graph_ops_t* ops;   ///< Edge enumeration
+    vertex_count_t num_vertices;            ///< Number of vertices
+    vertex_count_t max_degree;              ///< Upper bound on out-degree
+    void* context;                          ///< Implementation data
+};
+
+/**
+ * @brief Search statistics
+ */
+struct sssp_implicit_stats {
+    uint64_t vertices_settled;              ///< Vertices removed from the frontier
+    uint64_t edges_relaxed;                 ///< Out-edges examined
+    uint64_t peak_frontier;                 ///< Largest frontier size
+    double total_time_ms;                   ///< Search time
+};
+
+// Built-in graphs
+
+/**
+ * @brief Create an implicit grid map
+ *
+ * Vertex (r, c) has id r * cols + c. Each cell connects to its 4 axis
+ * neighbors, or 8 with diagonal moves. Entering cell v costs the step length
+ * (1 or sqrt(2)) times cell_costs[v]; cells whose cost is negative, NaN or
+ * infinite are blocked. With cell_costs NULL every step has weight equal to
+ * its length, matching sssp_graph_generate_grid(). The cost array is
+ * borrowed and must outlive the grid.
+ *
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param diagonal_moves Whether to allow diagonal moves
+ * @param cell_costs Optional rows * cols entry cost multipliers
+ * @param allocator Memory allocator
+ * @return New grid or NULL on failure
+ */
+sssp_implicit_graph_t* sssp_implicit_grid_create(vertex_count_t rows,
+                                                 vertex_count_t cols,
+                                                 bool diagonal_moves,
+                                                 const weight_t* cell_costs,
+                                                 const sssp_allocator_t* allocator);
+
+/**
+ * @brief Destroy an implicit graph through its destroy operation
+ * @param graph Graph to destroy (may be NULL)
+ */
+void sssp_implicit_graph_destroy(sssp_implicit_graph_t* graph);
+
+// Search
+
+/**
+ * @brief Dijkstra's algorithm over an implicit graph
+ *
+ * Fills distances[] (and predecessors[] when not NULL) for all vertices
+ * within max_distance of source. With a target other than
+ * SSSP_INVALID_VERTEX the search stops once the target is settled; entries
+ * of vertices not yet settled then hold upper bounds or SSSP_INFINITY.
+ *
+ * Apart from the caller's arrays, memory use is proportional to the
+ * frontier, not to the number of vertices or edges.
+ *
+ * @param graph Implicit graph
+ * @param source Source vertex
+ * @param target Vertex to stop at, or SSSP_INVALID_VERTEX
+ * @param max_distance Distance bound (SSSP_INFINITY for none)
+ * @param distances Output, graph->num_vertices entries
+ * @param predecessors Optional output, graph->num_vertices entries
+ * @param stats Optional search statistics
+ * @return Error code
+ */
+sssp_error_t sssp_implicit_solve(const sssp_implicit_graph_t* graph,
+                                 vertex_id_t source,
+                                 vertex_id_t target,
+                                 distance_t max_distance,
+                                 distance_t* distances,
+                                 vertex_id_t* predecessors,
+                                 sssp_implicit_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_IMPLICIT_GRAPH_H
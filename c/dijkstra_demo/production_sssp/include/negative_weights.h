@@ -0,0 +1,130 @@
+/**
+ * @file negative_weights.h
+ * @brief Shortest paths on graphs with negative edge weights
+ *
+ * Graphs accept negative weights only after
+ * sssp_graph_allow_negative_weights(); the Dijkstra-based solvers refuse
+ * such graphs. Two ways to solve them are provided:
+ *
+ * - sssp_solve_bellman_ford() runs a queue-based Bellman-Ford (SPFA) from
+ *   one source and reports negative cycles reachable from it.
+ * - sssp_johnson_create() computes vertex potentials h once, with the same
+ *   Bellman-Ford from a virtual source joined to every vertex, and keeps a
+ *   copy of the graph with reduced costs w(u, v) + h(u) - h(v) >= 0.
+ *   sssp_johnson_solve() then answers each query with the regular Dijkstra
+ *   solver and converts the distances back.
+ *
+ * Johnson pays one Bellman-Ford for any number of queries, so it is the
+ * choice when a graph is queried more than once.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_NEGATIVE_WEIGHTS_H
+#define SSSP_NEGATIVE_WEIGHTS_H
+
+#include "sssp_common.h"
+#include "graph.h"
+#include "vertex_set.h"
+#include "sssp_algorithm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Graph with precomputed Johnson potentials
+ */
+typedef struct sssp_johnson {
+    vertex_count_t num_vertices;        ///< Number of vertices
+    distance_t* potentials;             ///< Potential h(v) of every vertex (<= 0)
+    sssp_graph_t* reduced;              ///< CSR copy with non-negative reduced costs
+    uint32_t rounds;                    ///< Bellman-Ford rounds used for the potentials
+    double preprocessing_time_ms;       ///< Time to compute potentials and build reduced
+    const sssp_allocator_t* allocator;  ///< Allocator of this structure
+} sssp_johnson_t;
+
+/**
+ * @brief Single-source shortest paths with negative weights allowed
+ *
+ * Each round relaxes the out-edges of the vertices improved in the previous
+ * round. With config->use_parallel_processing, large rounds scan their
+ * edges on all threads and apply the improvements afterwards. Distances do
+ * not depend on the thread count; among equally short paths, predecessors
+ * may. The predecessor graph is checked for cycles every power-of-two
+ * round, which finds most negative cycles long before the n-round bound.
+ *
+ * @param graph Input graph
+ * @param source Source vertex
+ * @param config Algorithm configuration (NULL for default)
+ * @param result Result structure to fill
+ * @param cycle If not NULL, receives a negative cycle in edge order
+ * @return SSSP_ERROR_NEGATIVE_CYCLE if a negative cycle is reachable from
+ *         source; result is then incomplete
+ */
+sssp_error_t sssp_solve_bellman_ford(const sssp_graph_t* graph,
+                                     vertex_id_t source,
+                                     const sssp_algorithm_config_t* config,
+                                     sssp_algorithm_result_t* result,
+                                     sssp_vertex_set_t* cycle);
+
+/**
+ * @brief Compute Johnson potentials and the reduced-cost graph
+ *
+ * Reduced costs that come out slightly negative through rounding are
+ * clamped to zero. Later changes to graph are not reflected.
+ *
+ * @param graph Input graph
+ * @param config Configuration for the Bellman-Ford pass (NULL for default)
+ * @param johnson_out Receives the new structure
+ * @param cycle If not NULL, receives a negative cycle in edge order
+ * @return SSSP_ERROR_NEGATIVE_CYCLE if the graph has a negative cycle
+ */
+sssp_error_t sssp_johnson_create(const sssp_graph_t* graph,
+                                 const sssp_algorithm_config_t* config,
+                                 sssp_johnson_t** johnson_out,
+                                 sssp_vertex_set_t* cycle);
+
+/**
+ * @brief Destroy a Johnson structure
+ * @param johnson Structure to destroy (may be NULL)
+ */
+void sssp_johnson_destroy(sssp_johnson_t* johnson);
+
+/**
+ * @brief Solve from source with Dijkstra on the reduced costs
+ *
+ * Distances in result are in the original weights; predecessors are the
+ * same in both, since reweighting preserves shortest paths.
+ *
+ * @param johnson Potentials and reduced graph
+ * @param source Source vertex
+ * @param config Algorithm configuration (NULL for default)
+ * @param result Result structure to fill
+ * @return Error code
+ */
+sssp_error_t sssp_johnson_solve(const sssp_johnson_t* johnson,
+                                vertex_id_t source,
+                                const sssp_algorithm_config_t* config,
+                                sssp_algorithm_result_t* result);
+
+/**
+ * @brief Convert a reduced-cost distance from source to target back
+ */
+SSSP_INLINE distance_t sssp_johnson_distance(const sssp_johnson_t* johnson,
+                                             vertex_id_t source,
+                                             vertex_id_t target,
+                                             distance_t reduced_distance) {
+    if (reduced_distance == SSSP_INFINITY) {
+        return SSSP_INFINITY;
+    }
+    return reduced_distance - johnson->potentials[source] + johnson->potentials[target];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_NEGATIVE_WEIGHTS_H
@@ -0,0 +1,220 @@
+/**
+ * @file profiler.h
+ * @brief Phase profiler with optional hardware performance counters
+ *
+ * The profiler attributes wall time and, on Linux, hardware counter deltas
+ * (cycles, instructions, cache, branch and TLB misses) to the phases of a
+ * solve. Counters are read through perf_event_open; when the kernel or the
+ * sandbox does not allow it the profiler still records phase times and
+ * reports the counters as unavailable. Counters are opened as perf event
+ * groups, as few as the PMU can schedule together, so a snapshot costs one
+ * read() per group rather than one per counter.
+ *
+ * Heap operations and relaxations alternate per settled vertex, far too
+ * often to switch phases each time. Solver loops run as a split phase
+ * instead (sssp_profiler_begin_split): the loop is charged as one phase, and
+ * when it ends its time and counters are divided between heap operations and
+ * relaxation in the proportion measured on one settled vertex in every
+ * SSSP_PROFILE_SAMPLE_INTERVAL.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_PROFILER_H
+#define SSSP_PROFILER_H
+
+#include "sssp_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Phases a solve is broken into for profiling
+ */
+typedef enum {
+    SSSP_PHASE_INITIALIZATION = 0,      ///< Solver setup and source initialization
+    SSSP_PHASE_FIND_PIVOTS,             ///< FINDPIVOTS (Algorithm 1)
+    SSSP_PHASE_HEAP_OPERATIONS,         ///< Heap insert, decrease-key and extract-min
+    SSSP_PHASE_RELAXATION,              ///< Edge scanning and relaxation
+    SSSP_PHASE_FINALIZATION,            ///< Copying results out of the solver
+    SSSP_PHASE_COUNT
+} sssp_profile_phase_t;
+
+/**
+ * @brief Hardware events captured per phase
+ */
+typedef enum {
+    SSSP_HW_CYCLES = 0,                 ///< CPU cycles
+    SSSP_HW_INSTRUCTIONS,               ///< Retired instructions
+    SSSP_HW_L1D_MISSES,                 ///< L1 data cache read misses
+    SSSP_HW_LLC_REFERENCES,             ///< Last-level cache references
+    SSSP_HW_LLC_MISSES,                 ///< Last-level cache misses
+    SSSP_HW_BRANCH_MISSES,              ///< Mispredicted branches
+    SSSP_HW_DTLB_MISSES,                ///< Data TLB read misses
+    SSSP_HW_COUNTER_COUNT
+} sssp_hw_counter_t;
+
+/**
+ * @brief Hardware counter values
+ */
+typedef struct sssp_hw_counters {
+    uint64_t values[SSSP_HW_COUNTER_COUNT]; ///< Event counts, indexed by sssp_hw_counter_t
+    uint32_t available_mask;            ///< Bit i set when values[i] was measured
+} sssp_hw_counters_t;
+
+/** Iterations of a split phase between two timed samples */
+#define SSSP_PROFILE_SAMPLE_INTERVAL 64
+
+/**
+ * @brief Phase profiler state
+ */
+typedef struct sssp_profiler {
+    int fds[SSSP_HW_COUNTER_COUNT];     ///< perf event descriptors (-1 if unavailable)
+    uint32_t available_mask;            ///< Counters that could be opened
+    int group_fds[SSSP_HW_COUNTER_COUNT]; ///< Leader of each counter group
+    uint32_t num_groups;                ///< Groups in group_fds
+    uint8_t group_of[SSSP_HW_COUNTER_COUNT]; ///< Group of each open counter
+    uint8_t slot_of[SSSP_HW_COUNTER_COUNT];  ///< Position of each open counter in its group's read
+
+    sssp_profile_phase_t current_phase; ///< Phase currently being charged
+    bool running;                       ///< Whether a phase is active
+    uint64_t phase_start_ns;            ///< Timestamp at which the current phase began
+    uint64_t phase_start_values[SSSP_HW_COUNTER_COUNT]; ///< Counter snapshot at phase start
+
+    double phase_time_ms[SSSP_PHASE_COUNT];             ///< Accumulated time per phase
+    sssp_hw_counters_t phase_counters[SSSP_PHASE_COUNT]; ///< Accumulated counters per phase
+    uint64_t phase_switches;            ///< Number of phase transitions recorded
+
+    // Split phase (see sssp_profiler_begin_split)
+    bool splitting;                     ///< Whether the current phase is split when it closes
+    sssp_profile_phase_t split_phases[2]; ///< Phases the current phase is divided between
+    uint64_t split_sample_ns[2];        ///< Sampled time of each
+    uint32_t until_sample;              ///< Iterations left before the next sample
+} sssp_profiler_t;
+
+/**
+ * @brief Initialize a profiler
+ * @param profiler Profiler to initialize
+ * @param use_hw_counters Try to open hardware counters
+ * @return Error code (hardware counters being unavailable is not an error)
+ */
+sssp_error_t sssp_profiler_init(sssp_profiler_t* profiler, bool use_hw_counters);
+
+/**
+ * @brief Release counter descriptors held by a profiler
+ * @param profiler Profiler to destroy
+ */
+void sssp_profiler_destroy(sssp_profiler_t* profiler);
+
+/**
+ * @brief Start charging a phase
+ * @param profiler Profiler
+ * @param phase Phase to start
+ */
+void sssp_profiler_start(sssp_profiler_t* profiler, sssp_profile_phase_t phase);
+
+/**
+ * @brief Close the current phase and start charging another one
+ * @param profiler Profiler
+ * @param phase Phase to switch to
+ * @return Phase that was active before the switch
+ */
+sssp_profile_phase_t sssp_profiler_switch(sssp_profiler_t* profiler, sssp_profile_phase_t phase);
+
+/**
+ * @brief Close the current phase and start a phase split between two
+ *
+ * Everything until the next switch or stop is divided between first and
+ * second in the proportion of the time recorded with
+ * sssp_profiler_add_sample(), or charged to first without samples.
+ *
+ * @param profiler Profiler
+ * @param first Phase charged while the split phase runs
+ * @param second Phase that receives its sampled share at the end
+ */
+void sssp_profiler_begin_split(sssp_profiler_t* profiler, sssp_profile_phase_t first,
+                               sssp_profile_phase_t second);
+
+/**
+ * @brief Whether to time this iteration of a split phase
+ *
+ * True once every SSSP_PROFILE_SAMPLE_INTERVAL calls while a split phase
+ * runs; the caller then times the iteration and reports it with
+ * sssp_profiler_add_sample().
+ */
+SSSP_INLINE bool sssp_profiler_sample_due(sssp_profiler_t* profiler) {
+    if (!profiler->splitting || --profiler->until_sample != 0) {
+        return false;
+    }
+    profiler->until_sample = SSSP_PROFILE_SAMPLE_INTERVAL;
+    return true;
+}
+
+/**
+ * @brief Record the time one sampled iteration spent in each split phase
+ */
+SSSP_INLINE void sssp_profiler_add_sample(sssp_profiler_t* profiler, uint64_t first_ns, uint64_t second_ns) {
+    profiler->split_sample_ns[0] += first_ns;
+    profiler->split_sample_ns[1] += second_ns;
+}
+
+/**
+ * @brief Close the current phase
+ * @param profiler Profiler
+ */
+void sssp_profiler_stop(sssp_profiler_t* profiler);
+
+/**
+ * @brief Check whether any hardware counter was opened
+ * @param profiler Profiler
+ * @return true if hardware counters are being recorded
+ */
+bool sssp_profiler_has_hw_counters(const sssp_profiler_t* profiler);
+
+/**
+ * @brief Sum counters over all phases
+ * @param profiler Profiler
+ * @param total Output counter totals
+ */
+void sssp_profiler_total_counters(const sssp_profiler_t* profiler, sssp_hw_counters_t* total);
+
+/**
+ * @brief Profiler attached to the calling thread (NULL if none)
+ */
+sssp_profiler_t* sssp_profiler_current(void);
+
+/**
+ * @brief Attach a profiler to the calling thread
+ * @param profiler Profiler to attach (NULL to detach)
+ * @return Previously attached profiler
+ */
+sssp_profiler_t* sssp_profiler_set_current(sssp_profiler_t* profiler);
+
+/**
+ * @brief Get a printable phase name
+ */
+const char* sssp_profile_phase_name(sssp_profile_phase_t phase);
+
+/**
+ * @brief Get a printable hardware counter name
+ */
+const char* sssp_hw_counter_name(sssp_hw_counter_t counter);
+
+/**
+ * @brief Switch phase only when a profiler is attached
+ */
+#define SSSP_PROFILE_SWITCH(profiler, phase) \
+    do { \
+        if (SSSP_UNLIKELY((profiler) != NULL)) { \
+            sssp_profiler_switch((profiler), (phase)); \
+        } \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_PROFILER_H
@@ -0,0 +1,96 @@
+/**
+ * @file relax_kernels.h
+ * @brief Vectorized edge relaxation over contiguous adjacency
+ *
+ * A relaxation kernel scans a run of CSR edges leaving one vertex, gathers
+ * the current distances of their targets and compares them with
+ * dist_u + weight several edges at a time. It only reports which edges
+ * improve a distance; applying the improvement (distance, predecessor and
+ * heap update) stays with the caller, on the scalar path.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_RELAX_KERNELS_H
+#define SSSP_RELAX_KERNELS_H
+
+#include "sssp_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Edges the solver hands to one kernel call */
+#define SSSP_RELAX_CHUNK 256
+
+/** Vertices with fewer out-edges are relaxed one edge at a time */
+#define SSSP_RELAX_MIN_VECTOR_DEGREE 16
+
+/**
+ * @brief Relaxation kernel implementations
+ */
+typedef enum {
+    SSSP_RELAX_KERNEL_AUTO = 0,         ///< Widest kernel the CPU supports
+    SSSP_RELAX_KERNEL_SCALAR,           ///< One edge per iteration
+    SSSP_RELAX_KERNEL_AVX2,             ///< 4 edges per iteration (AVX2 gather)
+    SSSP_RELAX_KERNEL_AVX512            ///< 8 edges per iteration (AVX-512F gather)
+} sssp_relax_kernel_t;
+
+/**
+ * @brief Select the kernel used by sssp_relax_scan()
+ *
+ * The choice is process-wide. It may be made while solves run on other
+ * threads, but then each of their scans may use either kernel. AUTO picks
+ * AVX-512, then AVX2, then scalar, from CPUID; a solve that needs a kernel
+ * before any was set picks the same way.
+ *
+ * @param kernel Kernel to use
+ * @return SSSP_ERROR_INVALID_ARGUMENT if this build or CPU lacks the kernel
+ */
+sssp_error_t sssp_relax_set_kernel(sssp_relax_kernel_t kernel);
+
+/**
+ * @brief Get the kernel sssp_relax_scan() currently uses (never AUTO)
+ */
+sssp_relax_kernel_t sssp_relax_get_kernel(void);
+
+/**
+ * @brief Check whether a kernel can run on this build and CPU
+ */
+bool sssp_relax_kernel_supported(sssp_relax_kernel_t kernel);
+
+/**
+ * @brief Get a printable kernel name
+ */
+const char* sssp_relax_kernel_name(sssp_relax_kernel_t kernel);
+
+/**
+ * @brief Find the edges of a run that improve their target's distance
+ *
+ * Writes to improved[] the offsets i (ascending) with
+ * dist_u + weights[i] < distances[targets[i]]. Distances are read once, so
+ * when a target repeats within the run the caller must recheck before
+ * applying; since distances only decrease, unreported edges never improve.
+ *
+ * @param dist_u Distance of the vertex being scanned
+ * @param targets Edge targets (all below SSSP_MAX_VERTICES)
+ * @param weights Edge weights
+ * @param count Number of edges
+ * @param distances Current distance of every vertex
+ * @param improved Output, room for count offsets
+ * @return Number of offsets written
+ */
+edge_count_t sssp_relax_scan(distance_t dist_u,
+                             const vertex_id_t* targets,
+                             const weight_t* weights,
+                             edge_count_t count,
+                             const distance_t* distances,
+                             edge_count_t* improved);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_RELAX_KERNELS_H
@@ -0,0 +1,166 @@
+/**
+ * @file snapshot.h
+ * @brief Graph snapshots with precomputed indexes, mapped from disk
+ *
+ * A snapshot file holds a graph in CSR form plus any number of derived
+ * indexes (potentials, orderings, landmark tables, ...), each an opaque
+ * byte section identified by a tag. Opening a snapshot maps the file
+ * read-only; the graph's CSR arrays and the index sections point straight
+ * into the mapping, so startup costs a few page faults rather than
+ * parsing or preprocessing, and processes opening the same file share its
+ * pages.
+ *
+ * Files are written in host byte order and carry a format version, the
+ * content hash of the graph they were built from (sssp_graph_content_hash())
+ * and a checksum per section. sssp_snapshot_load_or_build() is the usual
+ * entry point: it reuses the file when it matches the graph and rebuilds
+ * it otherwise.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_SNAPSHOT_H
+#define SSSP_SNAPSHOT_H
+
+#include "sssp_common.h"
+#include "graph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Snapshot format version; files of another version are not opened */
+#define SSSP_SNAPSHOT_VERSION 1
+
+/** Check every section checksum when opening (reads the whole file) */
+#define SSSP_SNAPSHOT_VERIFY 0x1u
+
+/** Read the whole file into the page cache when opening */
+#define SSSP_SNAPSHOT_PREFETCH 0x2u
+
+/**
+ * @brief Index section to store in a snapshot
+ *
+ * Tags are chosen by the application and must be unique within a
+ * snapshot; tags with the high bit set are reserved for the graph.
+ */
+typedef struct sssp_snapshot_section {
+    uint32_t tag;                       ///< Section identifier
+    const void* data;                   ///< Contents
+    uint64_t size;                      ///< Size in bytes
+} sssp_snapshot_section_t;
+
+/**
+ * @brief Derived index that sssp_snapshot_load_or_build() can rebuild
+ *
+ * build() computes the index of graph into a buffer allocated with
+ * allocator, which the caller frees after writing it out.
+ */
+typedef struct sssp_snapshot_index {
+    uint32_t tag;                       ///< Section identifier
+    sssp_error_t (*build)(const sssp_graph_t* graph, void* context,
+                          const sssp_allocator_t* allocator,
+                          void** data_out, uint64_t* size_out);
+    void* context;                      ///< Passed to build()
+} sssp_snapshot_index_t;
+
+/**
+ * @brief Mapped snapshot file
+ */
+typedef struct sssp_snapshot sssp_snapshot_t;
+
+/**
+ * @brief Hash of a graph's vertices, edges and weights
+ *
+ * Edges are hashed in storage order, so the same edges added in a
+ * different order hash differently. A graph read back from a snapshot
+ * hashes like the graph it was written from.
+ */
+uint64_t sssp_graph_content_hash(const sssp_graph_t* graph);
+
+/**
+ * @brief Write graph and index sections to path
+ *
+ * The file is written next to path and renamed over it when complete, so
+ * readers never see a partial snapshot.
+ *
+ * @return SSSP_ERROR_INVALID_ARGUMENT for duplicate or reserved tags,
+ *         SSSP_ERROR_IO if the file cannot be written
+ */
+sssp_error_t sssp_snapshot_save(const char* path,
+                                const sssp_graph_t* graph,
+                                const sssp_snapshot_section_t* sections,
+                                uint32_t num_sections);
+
+/**
+ * @brief Map a snapshot file
+ *
+ * The header and section table are always checked; section contents only
+ * with SSSP_SNAPSHOT_VERIFY. Without it the file is trusted to be one
+ * written by sssp_snapshot_save().
+ *
+ * @param path Snapshot file
+ * @param flags SSSP_SNAPSHOT_VERIFY and/or SSSP_SNAPSHOT_PREFETCH
+ * @param allocator Memory allocator (NULL for default)
+ * @param snapshot_out Receives the snapshot
+ * @return SSSP_ERROR_IO if the file is missing, of another version or
+ *         damaged; SSSP_ERROR_NOT_IMPLEMENTED where files cannot be mapped
+ */
+sssp_error_t sssp_snapshot_open(const char* path,
+                                uint32_t flags,
+                                const sssp_allocator_t* allocator,
+                                sssp_snapshot_t** snapshot_out);
+
+/**
+ * @brief Open path if it was built from graph with all indexes, else
+ *        rebuild it
+ *
+ * On a mismatch (missing file, other version, damage, other graph, or a
+ * missing index) every index is built again, the file is rewritten and
+ * then opened.
+ *
+ * @param rebuilt_out If not NULL, tells whether the file was rebuilt
+ */
+sssp_error_t sssp_snapshot_load_or_build(const char* path,
+                                         const sssp_graph_t* graph,
+                                         const sssp_snapshot_index_t* indexes,
+                                         uint32_t num_indexes,
+                                         uint32_t flags,
+                                         const sssp_allocator_t* allocator,
+                                         sssp_snapshot_t** snapshot_out,
+                                         bool* rebuilt_out);
+
+/**
+ * @brief Unmap a snapshot; its graph and sections become invalid
+ * @param snapshot Snapshot to close (may be NULL)
+ */
+void sssp_snapshot_close(sssp_snapshot_t* snapshot);
+
+/**
+ * @brief The snapshot's graph, in CSR form over the mapped file
+ *
+ * Read-only: do not add edges to it or destroy it.
+ */
+const sssp_graph_t* sssp_snapshot_graph(const sssp_snapshot_t* snapshot);
+
+/**
+ * @brief Content hash of the graph the snapshot was built from
+ */
+uint64_t sssp_snapshot_graph_hash(const sssp_snapshot_t* snapshot);
+
+/**
+ * @brief Find an index section
+ * @return SSSP_ERROR_INVALID_ARGUMENT if the snapshot has no such section
+ */
+sssp_error_t sssp_snapshot_find(const sssp_snapshot_t* snapshot,
+                                uint32_t tag,
+                                const void** data_out,
+                                uint64_t* size_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_SNAPSHOT_H
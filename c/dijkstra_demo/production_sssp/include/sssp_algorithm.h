@@ -18,6 +18,7 @@
 #include "vertex_set.h"
 #include "partitioning_heap.h"
 #include "find_pivots.h"
+#include "profiler.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +28,20 @@ extern "C" {
 typedef struct sssp_solver sssp_solver_t;
 typedef struct sssp_stats sssp_stats_t;
 
+/**
+ * @brief Storage unit of the solver's settled flags
+ *
+ * With SSSP_PACKED_VISITED the flags are a bitmap, 64 vertices per word,
+ * so they take 1/8 of the cache lines a bool array does. That pays off once
+ * the bool array no longer fits in the last-level cache. Use
+ * sssp_solver_is_visited() rather than indexing the array.
+ */
+#ifdef SSSP_PACKED_VISITED
+typedef uint64_t sssp_visited_t;
+#else
+typedef bool sssp_visited_t;
+#endif
+
 /**
  * @brief Algorithm performance statistics
  */
@@ -35,25 +50,42 @@ struct sssp_stats {
     uint64_t total_edges_relaxed;       ///< Total edge relaxations
     uint64_t pivots_used;               ///< Number of pivots used
     uint64_t heap_operations;           ///< Number of heap operations
+    uint64_t heap_inserts;              ///< Heap insertions (including decrease-key)
+    uint64_t heap_pulls;                ///< Heap extract-min operations
+    uint64_t useful_relaxations;        ///< Relaxations that improved a distance
+    uint64_t max_heap_size;             ///< Largest heap size observed
     uint64_t algorithm_calls;           ///< Number of algorithm calls
     double execution_time_ms;           ///< Total execution time in milliseconds
 };
 
+/**
+ * @brief Solver storage modes, from most to least memory
+ */
+typedef enum sssp_solver_mode {
+    SSSP_SOLVER_FULL,                   ///< Indexed heap plus FINDPIVOTS working state
+    SSSP_SOLVER_DIJKSTRA,               ///< Indexed heap only
+    SSSP_SOLVER_LEAN                    ///< Lazy heap sized to the frontier, no per-vertex heap index
+} sssp_solver_mode_t;
+
 /**
  * @brief Main SSSP solver structure
  */
 struct sssp_solver {
     vertex_count_t max_vertices;        ///< Maximum number of vertices
     const sssp_allocator_t* allocator;  ///< Memory allocator
+    sssp_solver_mode_t mode;            ///< Storage mode
     
     // Core algorithm data structures
     distance_t* distances;              ///< Distance array
     vertex_id_t* predecessors;          ///< Predecessor array
-    bool* visited;                      ///< Visited array
+    sssp_visited_t* visited;            ///< Settled flags (see sssp_visited_t)
     
     // Algorithm components
-    sssp_partitioning_heap_t* heap;     ///< Partitioning heap
-    sssp_pivot_finder_t* pivot_finder;  ///< Pivot finder
+    sssp_partitioning_heap_t* heap;     ///< Partitioning heap (NULL in lean mode)
+    sssp_heap_element_t* frontier;      ///< Lazy heap (lean mode only)
+    size_t frontier_size;               ///< Entries in the lazy heap, including outdated ones
+    size_t frontier_capacity;           ///< Capacity of the lazy heap
+    sssp_pivot_finder_t* pivot_finder;  ///< Pivot finder (full mode only)
     
     // Working sets
     sssp_vertex_set_t* sources;         ///< Source vertices set
@@ -62,6 +94,21 @@ struct sssp_solver {
     
     // Statistics
     sssp_stats_t stats;                 ///< Performance statistics
+    sssp_profiler_t* profiler;          ///< Phase profiler (NULL when not profiling)
+    bool sampling;                      ///< Whether heap updates are being timed for the profiler
+    uint64_t sampled_heap_ns;           ///< Heap update time of the sampled vertex
+    
+    // Query limits
+    uint64_t deadline_ns;               ///< Stop with SSSP_ERROR_TIMEOUT after this (0: none)
+    const sssp_cancel_token_t* cancel_token; ///< Stop with SSSP_ERROR_CANCELLED once set (NULL: none)
+    uint32_t check_interval;            ///< Settled vertices between limit checks
+    uint32_t until_check;               ///< Settled vertices left before the next check
+    
+    // Reuse across queries (sssp_workspace_t only; NULL otherwise)
+    vertex_id_t* touched;               ///< Vertices given a distance since the last reset
+    vertex_count_t touched_count;       ///< Entries in touched
+    vertex_id_t* settled_order;         ///< Vertices settled since the last reset, in order
+    vertex_count_t settled_count;       ///< Entries in settled_order
 };
 
 /**
@@ -80,11 +127,21 @@ typedef struct sssp_algorithm_config {
     
     // Memory management
     const sssp_allocator_t* allocator;  ///< Memory allocator
-    size_t memory_limit_bytes;          ///< Memory usage limit (0 for no limit)
+    size_t memory_limit_bytes;          ///< Limit on solver working memory (0 for no limit)
+    sssp_arena_t* scratch_arena;        ///< Arena for recursion temporaries (NULL: one per solve)
+    size_t huge_page_threshold;         ///< Map solver arrays this large onto huge pages (0: off; not the graph's)
+    
+    // Approximation
+    double approximation_epsilon;       ///< Single-source distances within 1 + this of exact (0: exact)
+    
+    // Query limits
+    uint64_t deadline_ns;               ///< Give up at this sssp_get_timestamp_ns() time (0: none)
+    const sssp_cancel_token_t* cancel_token; ///< Give up once cancelled (NULL: none)
+    uint32_t limit_check_interval;      ///< Settled vertices between checks (0 for the default)
     
     // Debugging and profiling
     bool enable_profiling;              ///< Enable detailed profiling
-    bool enable_validation;             ///< Enable algorithm validation
+    bool enable_validation;             ///< Check each single-source result with sssp_validate_result()
     sssp_log_level_t log_level;         ///< Logging level
 } sssp_algorithm_config_t;
 
@@ -104,19 +161,97 @@ typedef struct sssp_algorithm_result {
     double total_time_ms;               ///< Total execution time
     uint64_t relaxations_performed;     ///< Total edge relaxations
     vertex_count_t recursive_calls;     ///< Number of recursive calls made
-    size_t peak_memory_bytes;           ///< Peak memory usage
+    size_t peak_memory_bytes;           ///< Peak solver working memory
+    size_t page_size;                   ///< Page size behind the solver's huge arrays (0: none mapped)
     
     // Validation
     bool is_optimal;                    ///< Whether result is guaranteed optimal
+    double approximation_bound;         ///< Every distance is at most this times the shortest (1.0 if optimal)
     sssp_error_t validation_status;     ///< Result of validation check
 } sssp_algorithm_result_t;
 
+/** Settled vertices between checks of a query's deadline and cancellation token */
+#define SSSP_DEFAULT_LIMIT_CHECK_INTERVAL 256
+
+/**
+ * @brief Words of a vertex tag bitmap over num_vertices vertices
+ *
+ * Vertex v is tagged when bit (v % 64) of word v / 64 is set.
+ */
+#define SSSP_TAG_WORDS(num_vertices) (((size_t)(num_vertices) + 63) / 64)
+
+/**
+ * @brief Compact result of a targeted query
+ *
+ * Holds one entry per answered vertex instead of arrays over the whole
+ * graph, so a result can be kept or sent per query.
+ */
+typedef struct sssp_target_result {
+    vertex_count_t count;               ///< Entries filled
+    vertex_count_t capacity;            ///< Entries allocated
+    vertex_id_t* vertices;              ///< Answered vertices
+    distance_t* distances;              ///< Distance of each answered vertex (SSSP_INFINITY if unreachable)
+    vertex_id_t* predecessors;          ///< Last hop of each shortest path (SSSP_INVALID_VERTEX for none)
+    
+    // Performance metrics
+    uint64_t vertices_settled;          ///< Vertices settled before the query was answered
+    uint64_t relaxations_performed;     ///< Edge relaxations
+    double total_time_ms;               ///< Total execution time
+    size_t peak_memory_bytes;           ///< Peak solver working memory
+    
+    const sssp_allocator_t* allocator;  ///< Allocator of the entry arrays
+} sssp_target_result_t;
+
 /**
  * @brief Main algorithm interface
+ *
+ * Solves allocate their working memory through a tracking allocator on top
+ * of config->allocator. With memory_limit_bytes set, a solve whose indexed
+ * heap would not fit switches to a lean lazy heap, and a solve that cannot
+ * fit at all fails with SSSP_ERROR_MEMORY_LIMIT, before allocating or as
+ * soon as the budget is hit. The result arrays are not counted.
+ *
+ * A solve given config->deadline_ns or config->cancel_token checks them
+ * every config->limit_check_interval settled vertices and at each recursion
+ * level. When one trips, the solve stops with SSSP_ERROR_TIMEOUT or
+ * SSSP_ERROR_CANCELLED and still fills its result: vertices marked settled
+ * have exact distances, every other finite distance is an upper bound
+ * reached by following the predecessors, and is_optimal is false.
+ */
+
+/**
+ * @brief Bytes a solver allocates up front for num_vertices vertices
+ *
+ * Lean solvers also grow their lazy heap as the search proceeds.
+ *
+ * @param num_vertices Number of vertices
+ * @param mode Solver storage mode
+ * @return Estimated bytes
+ */
+size_t sssp_solver_memory_estimate(vertex_count_t num_vertices, sssp_solver_mode_t mode);
+
+/**
+ * @brief Check whether the solver has settled a vertex
+ * @param solver Solver
+ * @param vertex Vertex ID (below solver->max_vertices)
+ * @return true if the vertex was removed from the heap
  */
+bool sssp_solver_is_visited(const sssp_solver_t* solver, vertex_id_t vertex);
 
 /**
  * @brief Solve single-source shortest paths
+ *
+ * With config->approximation_epsilon > 0 the solve settles vertices in
+ * geometric distance buckets instead of exact heap order, and every
+ * distance d satisfies dist <= d <= (1 + epsilon) * dist. The bound the
+ * solve certifies, often well below 1 + epsilon, is reported in
+ * result->approximation_bound. Such a result is not optimal and
+ * config->enable_validation does not apply to it.
+ *
+ * Exact solves on a graph with integer weights
+ * (sssp_graph_build_integer_weights()) run on 64-bit integer distances
+ * with a radix heap and convert them to distance_t at the end.
+ *
  * @param graph Input graph
  * @param source Source vertex
  * @param config Algorithm configuration (NULL for default)
@@ -128,8 +263,146 @@ sssp_error_t sssp_solve_single_source(const sssp_graph_t* graph,
                                        const sssp_algorithm_config_t* config,
                                        sssp_algorithm_result_t* result);
 
+/**
+ * @brief Solve shortest paths from source to a set of targets
+ *
+ * Runs Dijkstra's algorithm until every target is settled, so only the
+ * region closer to source than the farthest target is explored. Entry i of
+ * the result answers targets[i]; targets that cannot be reached have
+ * distance SSSP_INFINITY, and are only known to be unreachable once the
+ * whole component of source has been searched. An interrupted solve still
+ * fills every entry, with upper bounds for the targets not yet settled.
+ *
+ * @param graph Input graph
+ * @param source Source vertex
+ * @param targets Target vertices (duplicates allowed)
+ * @param num_targets Number of targets
+ * @param config Algorithm configuration (NULL for default)
+ * @param result Result with capacity of at least num_targets
+ * @return Error code
+ */
+sssp_error_t sssp_solve_to_targets(const sssp_graph_t* graph,
+                                   vertex_id_t source,
+                                   const vertex_id_t* targets,
+                                   vertex_count_t num_targets,
+                                   const sssp_algorithm_config_t* config,
+                                   sssp_target_result_t* result);
+
+/**
+ * @brief Find the k tagged vertices nearest to source
+ *
+ * Runs Dijkstra's algorithm until k tagged vertices are settled. Entries
+ * come out in order of non-decreasing distance; source itself counts when
+ * tagged. Fewer than k entries means fewer than k tagged vertices are
+ * reachable, or that the solve was interrupted; the entries found before an
+ * interruption are exact.
+ *
+ * @param graph Input graph
+ * @param source Source vertex
+ * @param tags Tag bitmap of SSSP_TAG_WORDS(num_vertices) words
+ * @param k Number of vertices wanted
+ * @param config Algorithm configuration (NULL for default)
+ * @param result Result with capacity of at least k
+ * @return Error code
+ */
+sssp_error_t sssp_solve_k_nearest(const sssp_graph_t* graph,
+                                  vertex_id_t source,
+                                  const uint64_t* tags,
+                                  vertex_count_t k,
+                                  const sssp_algorithm_config_t* config,
+                                  sssp_target_result_t* result);
+
+/**
+ * @brief Reusable search state for repeated queries on one graph
+ *
+ * A workspace keeps a Dijkstra solver over the whole graph between queries
+ * and resets only the vertices the previous query reached, so a query
+ * costs the region it explores rather than the size of the graph. Queries
+ * run the same search as sssp_solve_to_targets(), with its relaxation
+ * kernels and query limits. A workspace serves one thread at a time; keep
+ * one per thread.
+ */
+typedef struct sssp_workspace sssp_workspace_t;
+
+/**
+ * @brief One query on a workspace
+ */
+typedef struct sssp_workspace_query {
+    const vertex_id_t* sources;         ///< Source vertices (duplicates allowed)
+    vertex_count_t num_sources;         ///< Number of sources
+    distance_t bound;                   ///< Settle vertices up to this distance (SSSP_INFINITY: all)
+    const vertex_id_t* targets;         ///< Stop once all of these are settled (NULL: none)
+    vertex_count_t num_targets;         ///< Number of targets (duplicates allowed)
+    uint64_t deadline_ns;               ///< Stop with SSSP_ERROR_TIMEOUT after this (0: none)
+    const sssp_cancel_token_t* cancel_token; ///< Stop with SSSP_ERROR_CANCELLED once set (NULL: none)
+} sssp_workspace_query_t;
+
+/**
+ * @brief Create a workspace for queries on graph
+ *
+ * The solver is allocated once, within config->memory_limit_bytes, and
+ * config->limit_check_interval applies to every query. The graph must stay
+ * alive and unchanged while the workspace is in use.
+ *
+ * @param graph Graph to query
+ * @param config Algorithm configuration (NULL for default)
+ * @param workspace_out Created workspace
+ * @return SSSP_ERROR_GRAPH_INVALID for negative weights, or another error code
+ */
+sssp_error_t sssp_workspace_create(const sssp_graph_t* graph,
+                                   const sssp_algorithm_config_t* config,
+                                   sssp_workspace_t** workspace_out);
+
+/**
+ * @brief Destroy a workspace (may be NULL)
+ */
+void sssp_workspace_destroy(sssp_workspace_t* workspace);
+
+/**
+ * @brief Run a query, replacing the previous query's answer
+ *
+ * Settles vertices in order of distance from the nearest source until none
+ * is left within query->bound, or every target is settled. A query stopped
+ * by its deadline or token keeps what it settled in time, with exact
+ * distances.
+ *
+ * @param workspace Workspace
+ * @param query Query
+ * @return Error code
+ */
+sssp_error_t sssp_workspace_solve(sssp_workspace_t* workspace, const sssp_workspace_query_t* query);
+
+/**
+ * @brief Vertices the last query settled, in order of non-decreasing distance
+ * @param workspace Workspace
+ * @param count_out Number of vertices
+ * @return Vertex array, valid until the next query
+ */
+const vertex_id_t* sssp_workspace_settled(const sssp_workspace_t* workspace, vertex_count_t* count_out);
+
+/**
+ * @brief Distance of vertex in the last query (SSSP_INFINITY if not reached)
+ *
+ * Exact for settled vertices; an upper bound for the others.
+ */
+distance_t sssp_workspace_distance(const sssp_workspace_t* workspace, vertex_id_t vertex);
+
+/**
+ * @brief Last hop to vertex in the last query (SSSP_INVALID_VERTEX for none)
+ */
+vertex_id_t sssp_workspace_predecessor(const sssp_workspace_t* workspace, vertex_id_t vertex);
+
+/**
+ * @brief Whether the last query settled vertex, read from the solver's visited flags
+ */
+bool sssp_workspace_is_settled(const sssp_workspace_t* workspace, vertex_id_t vertex);
+
 /**
  * @brief Solve bounded multi-source shortest paths (Algorithm 3)
+ *
+ * When interrupted by the query limits in config, output_set holds the
+ * vertices completed so far, all with exact distances.
+ *
  * @param graph Input graph
  * @param recursion_level Current recursion level (l parameter)
  * @param threshold Distance threshold (B parameter)
@@ -220,6 +493,21 @@ sssp_algorithm_result_t* sssp_algorithm_result_create(vertex_count_t num_vertice
  */
 void sssp_algorithm_result_destroy(sssp_algorithm_result_t* result);
 
+/**
+ * @brief Create a compact result for targeted queries
+ * @param capacity Number of entries (targets, or k)
+ * @param allocator Memory allocator (NULL for default)
+ * @return Empty result or NULL on failure
+ */
+sssp_target_result_t* sssp_target_result_create(vertex_count_t capacity,
+                                                 const sssp_allocator_t* allocator);
+
+/**
+ * @brief Destroy a compact result
+ * @param result Result to destroy (may be NULL)
+ */
+void sssp_target_result_destroy(sssp_target_result_t* result);
+
 /**
  * @brief Clear result structure for reuse
  * @param result Result structure to clear
@@ -272,13 +560,23 @@ sssp_error_t sssp_get_distance(const sssp_algorithm_result_t* result,
  * @brief Validation and verification
  */
 
+/** Relative slack of the validation checks, for distances computed along other paths */
+#define SSSP_VALIDATION_TOLERANCE 1e-9
+
 /**
- * @brief Validate algorithm result against expected distances
+ * @brief Check that a result is a valid shortest-path certificate
+ *
+ * Without a second solve: the source has distance 0 and no predecessor,
+ * no edge (u, v, w) has d[v] > d[u] + w, every other reachable vertex has a
+ * tight predecessor edge, and the predecessor links are acyclic. Runs in
+ * O(n + m) time, split across sssp_parallel_for threads on large graphs.
+ *
  * @param graph Input graph
  * @param source Source vertex
  * @param result Algorithm result to validate
  * @param expected_distances Expected distance array (can be NULL)
- * @return Error code
+ * @return SSSP_ERROR_ALGORITHM if any check fails (the first failure found
+ *         is logged)
  */
 sssp_error_t sssp_validate_result(const sssp_graph_t* graph,
                                    vertex_id_t source,
@@ -286,7 +584,11 @@ sssp_error_t sssp_validate_result(const sssp_graph_t* graph,
                                    const weight_t* expected_distances);
 
 /**
- * @brief Compare two algorithm results for equality
+ * @brief Compare the distances of two algorithm results
+ *
+ * Predecessors are not compared, since equally short paths are equally
+ * valid.
+ *
  * @param result1 First result
  * @param result2 Second result
  * @param num_vertices Number of vertices
@@ -347,6 +649,7 @@ typedef struct sssp_performance_profile {
     double initialization_time_ms;
     double find_pivots_time_ms;
     double heap_operations_time_ms;
+    double relaxation_time_ms;
     double recursive_calls_time_ms;
     double finalization_time_ms;
     
@@ -367,11 +670,26 @@ typedef struct sssp_performance_profile {
     vertex_count_t max_recursion_depth;
     vertex_count_t avg_pivot_set_size;
     vertex_count_t max_heap_size;
-    double cache_hit_ratio;
+    double cache_hit_ratio;             ///< LLC hit ratio (0 when counters are unavailable)
+    
+    // Hardware counters (Linux perf_event_open)
+    bool hw_counters_available;         ///< Whether any hardware counter was measured
+    sssp_hw_counters_t phase_counters[SSSP_PHASE_COUNT]; ///< Counters per phase
+    sssp_hw_counters_t total_counters;  ///< Counters summed over all phases
 } sssp_performance_profile_t;
 
 /**
  * @brief Execute algorithm with detailed profiling
+ *
+ * Phase times are always recorded. Hardware counters are read as perf
+ * groups, one read() per group at each phase transition. The search loop
+ * is a single phase, divided between heap operations and relaxation by
+ * timing one settled vertex in SSSP_PROFILE_SAMPLE_INTERVAL, so profiled
+ * times run only somewhat above unprofiled ones.
+ *
+ * This runs the single-source solve, which never calls FINDPIVOTS; use
+ * sssp_bounded_multi_source_with_profiling() for a FINDPIVOTS breakdown.
+ *
  * @param graph Input graph
  * @param source Source vertex
  * @param config Algorithm configuration
@@ -385,6 +703,34 @@ sssp_error_t sssp_solve_with_profiling(const sssp_graph_t* graph,
                                         sssp_algorithm_result_t* result,
                                         sssp_performance_profile_t* profile);
 
+/**
+ * @brief Run top-level Algorithm 3 with detailed profiling
+ *
+ * Same as sssp_bounded_multi_source() at recursion level 0, with FINDPIVOTS
+ * and every base case's heap operations and relaxation charged to their
+ * phases. Only the phase times and hardware counters of profile are filled.
+ *
+ * @param graph Input graph
+ * @param threshold Distance bound B
+ * @param source_set Source vertex set S
+ * @param k Pivot parameter
+ * @param t Base case threshold
+ * @param config Algorithm configuration
+ * @param output_set Vertices found within the bound
+ * @param B_prime_out Largest distance found
+ * @param profile Profiling information to fill
+ * @return Error code
+ */
+sssp_error_t sssp_bounded_multi_source_with_profiling(const sssp_graph_t* graph,
+                                                       weight_t threshold,
+                                                       const sssp_vertex_set_t* source_set,
+                                                       vertex_count_t k,
+                                                       vertex_count_t t,
+                                                       const sssp_algorithm_config_t* config,
+                                                       sssp_vertex_set_t* output_set,
+                                                       weight_t* B_prime_out,
+                                                       sssp_performance_profile_t* profile);
+
 /**
  * @brief Debugging and visualization
  */
@@ -78,6 +78,10 @@ typedef enum {
     SSSP_ERROR_IO = -6,
     SSSP_ERROR_NOT_IMPLEMENTED = -7,
     SSSP_ERROR_ALGORITHM = -8,
+    SSSP_ERROR_MEMORY_LIMIT = -9,
+    SSSP_ERROR_NEGATIVE_CYCLE = -10,
+    SSSP_ERROR_TIMEOUT = -11,           // Deadline passed; the result so far is valid but partial
+    SSSP_ERROR_CANCELLED = -12,         // Cancelled through a token; likewise partial
     SSSP_ERROR_INTERNAL = -99
 } sssp_error_t;
 
@@ -107,6 +111,17 @@ typedef uint32_t edge_count_t;      // Count of edges
 #define SSSP_MIN(a, b) ((a) < (b) ? (a) : (b))
 #define SSSP_ABS(x) ((x) < 0 ? -(x) : (x))
 
+// Software prefetching: relaxation loops prefetch the per-vertex state of
+// the target this many edges ahead (0 disables; set by CMake)
+#ifndef SSSP_PREFETCH_DISTANCE
+#  define SSSP_PREFETCH_DISTANCE 8
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#  define SSSP_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#  define SSSP_PREFETCH(addr) ((void)(addr))
+#endif
+
 // Memory management
 typedef struct sssp_allocator {
     void* (*alloc)(size_t size, void* context);
@@ -158,6 +173,26 @@ void sssp_set_log_level(sssp_log_level_t level);
 void sssp_log(sssp_log_level_t level, const char* file, int line, 
               const char* func, const char* format, ...);
 
+// Asynchronous logging. While started, sssp_log() copies the format pointer
+// and arguments of each message into a ring buffer owned by the calling
+// thread, and a background thread formats and writes them in batches. A
+// full ring drops the message and counts it. Formats must be string
+// literals; %s arguments are copied, truncated to fit a record.
+typedef struct sssp_log_async_config {
+    uint32_t ring_records;          // Records per thread, a power of two (0 = 1024)
+    uint32_t flush_interval_ms;     // Longest wait between drains (0 = 5)
+} sssp_log_async_config_t;
+
+typedef struct sssp_log_async_stats {
+    uint64_t written;               // Messages formatted and written
+    uint64_t dropped;               // Messages lost to full rings
+} sssp_log_async_stats_t;
+
+sssp_error_t sssp_log_async_start(const sssp_log_async_config_t* config);  // NULL for defaults
+void sssp_log_async_stop(void);     // Writes everything queued, then logs synchronously again
+void sssp_log_flush(void);          // Waits until messages logged so far are written
+sssp_log_async_stats_t sssp_log_async_get_stats(void);
+
 // Internal error reporting
 void sssp_report_error(sssp_error_t error, const char* message);
 
@@ -183,18 +218,143 @@ void sssp_timer_stop(sssp_timer_t* timer);
 double sssp_timer_elapsed_ms(const sssp_timer_t* timer);
 uint64_t sssp_get_timestamp_ns(void);
 
+// Query limits. A query given a deadline (on the sssp_get_timestamp_ns()
+// clock) or a cancellation token checks them every few hundred settled
+// vertices and at each recursion level, and stops with SSSP_ERROR_TIMEOUT
+// or SSSP_ERROR_CANCELLED. Any thread may cancel a token at any time; a
+// token cancels every query it is given to until it is reset.
+typedef struct sssp_cancel_token {
+    uint32_t cancelled;             // Accessed atomically
+} sssp_cancel_token_t;
+
+void sssp_cancel_token_init(sssp_cancel_token_t* token);
+void sssp_cancel_token_cancel(sssp_cancel_token_t* token);
+void sssp_cancel_token_reset(sssp_cancel_token_t* token);
+bool sssp_cancel_token_is_cancelled(const sssp_cancel_token_t* token);
+uint64_t sssp_deadline_after_ms(double ms);  // Deadline ms from now
+
+// SSSP_ERROR_TIMEOUT once deadline_ns (0: none) has passed,
+// SSSP_ERROR_CANCELLED once token (may be NULL) is cancelled
+sssp_error_t sssp_check_query_limits(uint64_t deadline_ns, const sssp_cancel_token_t* token);
+
+// Whether error stopped a query early with a partial result
+static inline bool sssp_error_is_interruption(sssp_error_t error) {
+    return error == SSSP_ERROR_TIMEOUT || error == SSSP_ERROR_CANCELLED;
+}
+
+// Deterministic random numbers (xoshiro256**). Each (seed, stream) pair is an
+// independent sequence, so parallel code can give every work chunk its own
+// stream and produce the same output for any thread count.
+typedef struct sssp_rng {
+    uint64_t state[4];
+} sssp_rng_t;
+
+void sssp_rng_seed(sssp_rng_t* rng, uint64_t seed, uint64_t stream);
+uint64_t sssp_rng_next(sssp_rng_t* rng);
+double sssp_rng_uniform(sssp_rng_t* rng);                   // [0, 1)
+uint64_t sssp_rng_bounded(sssp_rng_t* rng, uint64_t bound);  // [0, bound)
+uint64_t sssp_hash64(uint64_t x);                           // splitmix64 finalizer
+
+// Parallel loops. The calling thread takes part in the work; chunks of
+// `grain` consecutive indices are handed out dynamically.
+typedef void (*sssp_parallel_fn_t)(size_t begin, size_t end, void* context);
+
+void sssp_set_num_threads(unsigned int num_threads);        // 0 = one per online CPU
+unsigned int sssp_get_num_threads(void);
+sssp_error_t sssp_parallel_for(size_t count, size_t grain, sssp_parallel_fn_t fn, void* context);
+
 // Memory usage tracking
 typedef struct sssp_memory_stats {
     size_t current_bytes;
     size_t peak_bytes;
     size_t total_allocations;
     size_t total_deallocations;
+    size_t page_size;                   // Page size behind large blocks (0 if not known)
 } sssp_memory_stats_t;
 
 void sssp_memory_stats_reset(sssp_memory_stats_t* stats);
 void sssp_memory_stats_add_allocation(sssp_memory_stats_t* stats, size_t bytes);
 void sssp_memory_stats_add_deallocation(sssp_memory_stats_t* stats, size_t bytes);
 
+// Tracking allocator: wraps a parent allocator, counts the bytes requested
+// through it and refuses requests that would take current_bytes above
+// limit_bytes. Trackers can be chained (a per-query tracker on top of a
+// per-process one). Counters are updated atomically.
+typedef struct sssp_tracking_allocator {
+    sssp_allocator_t allocator;         // Hand this out; its context is the tracker
+    const sssp_allocator_t* parent;     // Allocator doing the actual work
+    size_t limit_bytes;                 // Budget for current_bytes (0 = no limit)
+    sssp_memory_stats_t stats;          // Usage so far
+    size_t limit_failures;              // Requests refused because of the budget
+} sssp_tracking_allocator_t;
+
+void sssp_tracking_allocator_init(sssp_tracking_allocator_t* tracker,
+                                  const sssp_allocator_t* parent,
+                                  size_t limit_bytes);
+sssp_memory_stats_t sssp_tracking_allocator_stats(const sssp_tracking_allocator_t* tracker);
+
+// Huge page allocator: requests of at least threshold bytes get their own
+// anonymous mapping backed by huge pages, which cuts TLB misses on large,
+// randomly accessed arrays; smaller requests go to the parent allocator.
+// TRANSPARENT mode aligns the mapping to the huge page size and applies
+// madvise(MADV_HUGEPAGE). EXPLICIT mode asks for MAP_HUGETLB pages from the
+// reserved pool and falls back to TRANSPARENT when none are available.
+// Without mmap (non-POSIX builds) everything goes to the parent.
+#define SSSP_HUGE_PAGE_THRESHOLD ((size_t)2 << 20)
+
+typedef enum sssp_huge_page_mode {
+    SSSP_HUGE_PAGES_TRANSPARENT,        // mmap + madvise(MADV_HUGEPAGE)
+    SSSP_HUGE_PAGES_EXPLICIT            // MAP_HUGETLB, falling back to transparent
+} sssp_huge_page_mode_t;
+
+typedef struct sssp_huge_page_allocator {
+    sssp_allocator_t allocator;         // Hand this out; its context is this struct
+    const sssp_allocator_t* parent;     // Allocator for requests below threshold
+    size_t threshold;                   // Smallest request that is mapped
+    sssp_huge_page_mode_t mode;         // How mappings get huge pages
+    sssp_memory_stats_t stats;          // Mapped bytes; page_size of the latest mapping
+    size_t hugetlb_mappings;            // Mappings from the explicit huge page pool
+    size_t fallback_mappings;           // EXPLICIT requests served with transparent pages
+} sssp_huge_page_allocator_t;
+
+void sssp_huge_page_allocator_init(sssp_huge_page_allocator_t* pages,
+                                   const sssp_allocator_t* parent,
+                                   size_t threshold,
+                                   sssp_huge_page_mode_t mode);
+sssp_memory_stats_t sssp_huge_page_allocator_stats(const sssp_huge_page_allocator_t* pages);
+
+// Arena allocator: bump allocation from blocks obtained from a parent
+// allocator. free() is a no-op and realloc() grows the newest allocation in
+// place. Rewinding to a mark releases everything allocated after it in O(1)
+// and keeps the blocks for reuse, so a workload that repeats the same
+// allocation pattern stops calling the parent after its first round.
+typedef struct sssp_arena_block sssp_arena_block_t;
+
+typedef struct sssp_arena {
+    sssp_allocator_t allocator;         // Hand this out; its context is the arena
+    const sssp_allocator_t* parent;     // Source of blocks
+    size_t block_size;                  // Minimum size of a new block
+    sssp_arena_block_t* first;          // Blocks in allocation order
+    sssp_arena_block_t* current;        // Block being bumped (NULL before first use)
+    size_t offset;                      // Bytes used in the current block
+    size_t reserved_bytes;              // Bytes held in blocks
+    size_t block_allocations;           // Blocks requested from the parent
+} sssp_arena_t;
+
+typedef struct sssp_arena_mark {
+    sssp_arena_block_t* block;
+    size_t offset;
+} sssp_arena_mark_t;
+
+void sssp_arena_init(sssp_arena_t* arena, const sssp_allocator_t* parent, size_t block_size);
+void sssp_arena_destroy(sssp_arena_t* arena);
+sssp_arena_mark_t sssp_arena_mark(const sssp_arena_t* arena);
+void sssp_arena_rewind(sssp_arena_t* arena, sssp_arena_mark_t mark);
+void sssp_arena_reset(sssp_arena_t* arena);
+// Bytes held in blocks but free after the last rewind (the unused tail of
+// the current block and every block after it)
+size_t sssp_arena_spare_bytes(const sssp_arena_t* arena);
+
 // Thread safety (if needed in future)
 #ifdef SSSP_THREAD_SAFE
 #include <pthread.h>
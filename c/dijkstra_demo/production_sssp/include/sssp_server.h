@@ -0,0 +1,227 @@
+/**
+ * @file sssp_server.h
+ * @brief Long-running query server over Unix domain or TCP loopback sockets
+ *
+ * A server keeps one graph in memory and answers queries from any number
+ * of connections. The calling thread runs sssp_server_run(), which accepts
+ * connections, reads requests and admits or rejects them; a pool of worker
+ * threads takes queued requests in batches and answers them. Each worker
+ * owns a library search workspace (sssp_workspace_t) over the whole graph
+ * that is reset only where the previous query touched it, so a query costs
+ * the region it explores rather than the size of the graph. Point-to-point
+ * queries from the same source in one batch share a single search.
+ *
+ * Wire format, in host byte order (the server only listens on the local
+ * machine):
+ *
+ *   request:  uint32 magic (SSSP_SERVER_REQUEST_MAGIC), uint32 id,
+ *             uint16 type (sssp_query_type_t), uint16 reserved,
+ *             uint32 deadline_ms (0: none), uint32 source, uint32 target,
+ *             uint32 num_sources, uint32 reserved, double bound,
+ *             then num_sources uint32 sources (multi-source only)
+ *   response: uint32 magic (SSSP_SERVER_RESPONSE_MAGIC), uint32 id,
+ *             int32 status (sssp_server_status_t), int32 error,
+ *             uint32 count, uint32 reserved, double service_time_ms,
+ *             then count uint32 vertices, then count double distances
+ *
+ * Responses carry the id of their request and may come back in a
+ * different order than the requests were sent.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_SERVER_H
+#define SSSP_SERVER_H
+
+#include "sssp_common.h"
+#include "graph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SSSP_SERVER_REQUEST_MAGIC 0x51505353u   ///< "SSPQ"
+#define SSSP_SERVER_RESPONSE_MAGIC 0x52505353u  ///< "SSPR"
+
+/** Default number of requests a worker takes from the queue at once */
+#define SSSP_SERVER_DEFAULT_BATCH 32
+
+/** Default number of requests waiting before new ones are rejected */
+#define SSSP_SERVER_DEFAULT_QUEUE 1024
+
+/**
+ * @brief Query types
+ */
+typedef enum {
+    SSSP_QUERY_POINT_TO_POINT = 1,      ///< Shortest path from source to target
+    SSSP_QUERY_SINGLE_SOURCE,           ///< Every vertex reachable from source
+    SSSP_QUERY_BOUNDED,                 ///< Vertices within bound of source
+    SSSP_QUERY_MULTI_SOURCE             ///< Distance from the nearest of several sources, within bound
+} sssp_query_type_t;
+
+/**
+ * @brief Outcome of a request
+ */
+typedef enum {
+    SSSP_SERVER_OK = 0,                 ///< Answered
+    SSSP_SERVER_BAD_REQUEST,            ///< Unknown type or vertex out of range
+    SSSP_SERVER_REJECTED,               ///< Not admitted: queue full or deadline out of reach
+    SSSP_SERVER_EXPIRED,                ///< Deadline passed while queued or searching (see reply)
+    SSSP_SERVER_FAILED                  ///< The search failed; see error
+} sssp_server_status_t;
+
+/**
+ * @brief A query, as sent by a client
+ */
+typedef struct sssp_query {
+    sssp_query_type_t type;             ///< Query type
+    vertex_id_t source;                 ///< Source (all types but multi-source)
+    vertex_id_t target;                 ///< Target (point-to-point)
+    const vertex_id_t* sources;         ///< Sources (multi-source)
+    vertex_count_t num_sources;         ///< Number of sources (multi-source)
+    distance_t bound;                   ///< Distance bound (bounded, multi-source; SSSP_INFINITY: none)
+    uint32_t deadline_ms;               ///< Time to answer, from arrival at the server (0: none)
+} sssp_query_t;
+
+/**
+ * @brief Answer to a query
+ *
+ * Entries come in order of non-decreasing distance. For a point-to-point
+ * query they are the vertices of the path, source first, each with its
+ * distance from source; no entries means the target is unreachable.
+ *
+ * A search still running at the request's deadline is stopped and answered
+ * with SSSP_SERVER_EXPIRED and SSSP_ERROR_TIMEOUT. For the query types that
+ * list settled vertices, the entries are then those settled in time, with
+ * exact distances; a point-to-point reply has none.
+ */
+typedef struct sssp_query_reply {
+    uint32_t id;                        ///< Id of the request
+    sssp_server_status_t status;        ///< Outcome
+    sssp_error_t error;                 ///< Search error for SSSP_SERVER_FAILED
+    vertex_count_t count;               ///< Entries
+    vertex_id_t* vertices;              ///< Vertices of the entries
+    distance_t* distances;              ///< Distances of the entries
+    double service_time_ms;             ///< Time from arrival to answer at the server
+} sssp_query_reply_t;
+
+/**
+ * @brief Server configuration
+ */
+typedef struct sssp_server_config {
+    const char* unix_path;              ///< Unix socket path (NULL: none); an existing file is replaced
+    bool listen_tcp;                    ///< Also listen on 127.0.0.1
+    uint16_t tcp_port;                  ///< TCP port (0: any free port, see sssp_server_get_port())
+    unsigned int num_workers;           ///< Worker threads (0: sssp_get_num_threads())
+    vertex_count_t max_batch;           ///< Requests a worker takes at once (0 for the default)
+    vertex_count_t max_queue;           ///< Waiting requests before rejecting (0 for the default)
+    const sssp_allocator_t* allocator;  ///< Memory allocator
+} sssp_server_config_t;
+
+/**
+ * @brief Server counters
+ */
+typedef struct sssp_server_stats {
+    uint64_t connections;               ///< Connections accepted
+    uint64_t requests;                  ///< Requests read
+    uint64_t answered;                  ///< Requests answered with SSSP_SERVER_OK
+    uint64_t rejected;                  ///< Requests not admitted
+    uint64_t expired;                   ///< Requests whose deadline passed before they were answered
+    uint64_t batches;                   ///< Batches taken by workers
+    uint64_t shared_searches;           ///< Point-to-point requests answered by another's search
+} sssp_server_stats_t;
+
+typedef struct sssp_server sssp_server_t;
+
+/**
+ * @brief Default configuration: no listener set, default pool and queue
+ */
+sssp_server_config_t sssp_server_config_default(const sssp_allocator_t* allocator);
+
+/**
+ * @brief Bind the listeners and start the workers
+ *
+ * Clients can connect as soon as this returns; their requests are read
+ * once sssp_server_run() is called. The graph must stay alive and
+ * unchanged until the server is destroyed; a list-backed graph gets its
+ * CSR arrays here (see sssp_graph_build_csr()).
+ *
+ * @return SSSP_ERROR_INVALID_ARGUMENT without any listener, SSSP_ERROR_IO
+ *         if a listener cannot be bound, SSSP_ERROR_GRAPH_INVALID for
+ *         negative weights
+ */
+sssp_error_t sssp_server_create(const sssp_graph_t* graph,
+                                const sssp_server_config_t* config,
+                                sssp_server_t** server_out);
+
+/**
+ * @brief Serve until sssp_server_stop() is called
+ */
+sssp_error_t sssp_server_run(sssp_server_t* server);
+
+/**
+ * @brief Make sssp_server_run() return
+ *
+ * Safe to call from another thread or from a signal handler.
+ */
+void sssp_server_stop(sssp_server_t* server);
+
+/**
+ * @brief Cancel queued and running searches, stop the workers and close everything
+ *
+ * Requests not answered yet get SSSP_SERVER_FAILED with SSSP_ERROR_CANCELLED.
+ * @param server Server to destroy (may be NULL); must not be running
+ */
+void sssp_server_destroy(sssp_server_t* server);
+
+/**
+ * @brief Bound TCP port, or 0 without a TCP listener
+ */
+uint16_t sssp_server_get_port(const sssp_server_t* server);
+
+/**
+ * @brief Snapshot of the counters
+ */
+sssp_server_stats_t sssp_server_get_stats(sssp_server_t* server);
+
+/**
+ * @brief Client side: connect to a server's Unix socket
+ */
+sssp_error_t sssp_client_connect_unix(const char* path, int* fd_out);
+
+/**
+ * @brief Client side: connect to a server on 127.0.0.1
+ */
+sssp_error_t sssp_client_connect_tcp(uint16_t port, int* fd_out);
+
+/**
+ * @brief Client side: send a request without waiting for the answer
+ */
+sssp_error_t sssp_client_send(int fd, uint32_t id, const sssp_query_t* query);
+
+/**
+ * @brief Client side: read the next answer
+ *
+ * The entry arrays are allocated with allocator and freed by
+ * sssp_query_reply_free().
+ */
+sssp_error_t sssp_client_receive(int fd, const sssp_allocator_t* allocator, sssp_query_reply_t* reply);
+
+/**
+ * @brief Client side: send one request and wait for its answer
+ */
+sssp_error_t sssp_client_query(int fd, const sssp_query_t* query,
+                               const sssp_allocator_t* allocator, sssp_query_reply_t* reply);
+
+/**
+ * @brief Free the entry arrays of a reply
+ */
+void sssp_query_reply_free(sssp_query_reply_t* reply, const sssp_allocator_t* allocator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_SERVER_H
@@ -4,6 +4,15 @@
  * 
  * This file defines a dynamic vertex set used throughout the SSSP algorithm
  * for managing collections of vertices efficiently.
+ *
+ * A set created with sssp_vertex_set_create_indexed() also keeps a position
+ * map over a fixed vertex universe (a sparse set), which makes add, remove
+ * and contains O(1). Plain sets scan the array for membership.
+ *
+ * Every set also tracks whether its vertices are strictly ascending (for
+ * example after sssp_vertex_set_unique()). Set algebra between two sorted
+ * sets runs as a vectorized merge, or as a galloping search when one set is
+ * much smaller than the other, and keeps the result sorted.
  * 
  * @author Sambit Chakraborty
  * @date 21-08-2025
@@ -27,6 +36,9 @@ typedef struct sssp_vertex_set {
     vertex_count_t size;            ///< Current number of vertices
     vertex_count_t capacity;        ///< Current capacity of the array
     const sssp_allocator_t* allocator; ///< Memory allocator
+    vertex_count_t* index;          ///< Position of each member (NULL unless indexed)
+    vertex_count_t universe;        ///< Vertex ids allowed in an indexed set
+    bool sorted;                    ///< Vertices strictly ascending (no duplicates)
 } sssp_vertex_set_t;
 
 /**
@@ -42,6 +54,21 @@ typedef struct sssp_vertex_set {
 sssp_vertex_set_t* sssp_vertex_set_create(vertex_count_t initial_capacity,
                                            const sssp_allocator_t* allocator);
 
+/**
+ * @brief Create a vertex set with O(1) membership over vertices [0, universe)
+ *
+ * Uses a position map of universe entries next to the vertex array. Adding
+ * a vertex outside the universe fails, add_array() skips duplicates, and
+ * removal moves the last vertex into the freed slot, so order is not
+ * preserved.
+ *
+ * @param universe Number of vertex ids the set can hold
+ * @param allocator Memory allocator (NULL for default)
+ * @return Pointer to new vertex set or NULL on failure
+ */
+sssp_vertex_set_t* sssp_vertex_set_create_indexed(vertex_count_t universe,
+                                                   const sssp_allocator_t* allocator);
+
 /**
  * @brief Destroy a vertex set and free all memory
  * @param set Vertex set to destroy
@@ -79,7 +106,7 @@ sssp_error_t sssp_vertex_set_add_array(sssp_vertex_set_t* set,
                                         vertex_count_t count);
 
 /**
- * @brief Remove a vertex from the set (maintains order)
+ * @brief Remove a vertex from the set (maintains order unless indexed)
  * @param set Target vertex set
  * @param vertex Vertex ID to remove
  * @return Error code (SSSP_SUCCESS if removed, other if not found)
@@ -135,6 +162,12 @@ vertex_id_t sssp_vertex_set_get_vertex(const sssp_vertex_set_t* set,
 
 /**
  * @brief Set operations
+ *
+ * When both sets are sorted these merge with SIMD kernels (AVX2 when the
+ * CPU has it, SSE2 otherwise, scalar off x86-64), or gallop through the
+ * larger set when the sizes differ by more than 32x. Otherwise they run in
+ * O(|dest| + |src|) for indexed or small sets, and the probed set is
+ * radix-sorted into a temporary copy first.
  */
 
 /**
@@ -204,6 +237,24 @@ SSSP_INLINE bool sssp_vertex_set_is_empty(const sssp_vertex_set_t* set) {
     return !set || set->size == 0;
 }
 
+/**
+ * @brief Check whether the set has O(1) membership
+ * @param set Target vertex set
+ * @return true if the set was created with sssp_vertex_set_create_indexed()
+ */
+SSSP_INLINE bool sssp_vertex_set_is_indexed(const sssp_vertex_set_t* set) {
+    return set && set->index != NULL;
+}
+
+/**
+ * @brief Check whether the vertices are strictly ascending
+ * @param set Target vertex set
+ * @return true if the set is sorted and free of duplicates
+ */
+SSSP_INLINE bool sssp_vertex_set_is_sorted(const sssp_vertex_set_t* set) {
+    return !set || set->sorted;
+}
+
 /**
  * @brief Get direct access to the vertex array (read-only)
  * @param set Target vertex set
@@ -233,7 +284,7 @@ sssp_error_t sssp_vertex_set_shrink_to_fit(sssp_vertex_set_t* set);
  */
 
 /**
- * @brief Sort vertices in the set in ascending order
+ * @brief Sort vertices in the set in ascending order (radix sort)
  * @param set Target vertex set
  * @return Error code
  */
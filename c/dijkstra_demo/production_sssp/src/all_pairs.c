@@ -0,0 +1,839 @@
+/**
+ * @file all_pairs.c
+ * @brief Blocked Floyd-Warshall with SIMD min-plus tile kernels
+ *
+ * Round r of the blocked algorithm uses tile (r, r) as pivot block:
+ *   1. the pivot tile runs plain Floyd-Warshall on itself,
+ *   2. the tiles of row r and column r are updated through the pivot tile,
+ *   3. every other tile (i, j) takes min(D[i][j], D[i][r] + D[r][j]).
+ * Phases 1 and 2 update a tile through itself, so they must take the pivot
+ * k outermost. Phase 3, which does almost all of the work, reads two other
+ * tiles and can keep one output row in L1 while it sweeps k.
+ *
+ * Padding rows and columns are SSSP_INFINITY, so every tile is full and the
+ * row kernels need no tails.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "all_pairs.h"
+#include "relax_kernels.h"
+#include <string.h>
+#include <math.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#    define APSP_X86_SIMD 1
+#    include <immintrin.h>
+#endif
+
+/**
+ * One tile update: C = min(C, A (min,+) B), with next hops of improved
+ * entries taken from NA. Pointers are to the top-left entry of each tile.
+ */
+typedef struct apsp_tile {
+    void* c;
+    const void* a;
+    const void* b;
+    vertex_id_t* nc;                    // NULL without next hops
+    const vertex_id_t* na;
+    size_t stride;
+    vertex_count_t size;
+    bool self_dependent;                // C is A or B: take k outermost
+} apsp_tile_t;
+
+typedef void (*apsp_tile_fn_t)(const apsp_tile_t* tile);
+
+/*
+ * Row kernels: c[j] = min(c[j], a + b[j]) for j < size, recording na as the
+ * next hop of every improved entry. b may be c itself.
+ */
+
+static inline void row_f64_scalar(double* c, vertex_id_t* nc, double a, vertex_id_t na,
+                                  const double* b, vertex_count_t size) {
+    if (!nc) {
+        for (vertex_count_t j = 0; j < size; j++) {
+            double s = a + b[j];
+            c[j] = s < c[j] ? s : c[j];
+        }
+        return;
+    }
+    for (vertex_count_t j = 0; j < size; j++) {
+        double s = a + b[j];
+        if (s < c[j]) {
+            c[j] = s;
+            nc[j] = na;
+        }
+    }
+}
+
+static inline void row_f32_scalar(float* c, vertex_id_t* nc, float a, vertex_id_t na,
+                                  const float* b, vertex_count_t size) {
+    if (!nc) {
+        for (vertex_count_t j = 0; j < size; j++) {
+            float s = a + b[j];
+            c[j] = s < c[j] ? s : c[j];
+        }
+        return;
+    }
+    for (vertex_count_t j = 0; j < size; j++) {
+        float s = a + b[j];
+        if (s < c[j]) {
+            c[j] = s;
+            nc[j] = na;
+        }
+    }
+}
+
+/*
+ * Tile drivers: (i, k) visits every row i of C with pivot column k, in
+ * k-major order for self-dependent tiles and i-major order otherwise.
+ * Rows whose a is infinite cannot improve anything and are skipped.
+ */
+
+static void tile_f64_scalar(const apsp_tile_t* t) {
+    double* c = t->c;
+    const double* a = t->a;
+    const double* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t outer = 0; outer < t->size; outer++) {
+        for (vertex_count_t inner = 0; inner < t->size; inner++) {
+            vertex_count_t i = t->self_dependent ? inner : outer;
+            vertex_count_t k = t->self_dependent ? outer : inner;
+            double aik = a[i * s + k];
+            if (aik == SSSP_INFINITY) continue;
+            row_f64_scalar(c + i * s, t->nc ? t->nc + i * s : NULL, aik,
+                           t->nc ? t->na[i * s + k] : 0, b + k * s, t->size);
+        }
+    }
+}
+
+static void tile_f32_scalar(const apsp_tile_t* t) {
+    float* c = t->c;
+    const float* a = t->a;
+    const float* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t outer = 0; outer < t->size; outer++) {
+        for (vertex_count_t inner = 0; inner < t->size; inner++) {
+            vertex_count_t i = t->self_dependent ? inner : outer;
+            vertex_count_t k = t->self_dependent ? outer : inner;
+            float aik = a[i * s + k];
+            if (aik == (float)SSSP_INFINITY) continue;
+            row_f32_scalar(c + i * s, t->nc ? t->nc + i * s : NULL, aik,
+                           t->nc ? t->na[i * s + k] : 0, b + k * s, t->size);
+        }
+    }
+}
+
+#ifdef APSP_X86_SIMD
+__attribute__((target("avx2")))
+static inline void row_f64_avx2(double* c, vertex_id_t* nc, double a, vertex_id_t na,
+                                const double* b, vertex_count_t size) {
+    const __m256d va = _mm256_set1_pd(a);
+    if (!nc) {
+        for (vertex_count_t j = 0; j < size; j += 4) {
+            __m256d s = _mm256_add_pd(va, _mm256_loadu_pd(b + j));
+            _mm256_storeu_pd(c + j, _mm256_min_pd(s, _mm256_loadu_pd(c + j)));
+        }
+        return;
+    }
+
+    // The 64-bit compare mask is narrowed to the 32-bit next-hop lanes
+    const __m128i vn = _mm_set1_epi32((int)na);
+    const __m256i narrow = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    for (vertex_count_t j = 0; j < size; j += 4) {
+        __m256d current = _mm256_loadu_pd(c + j);
+        __m256d s = _mm256_add_pd(va, _mm256_loadu_pd(b + j));
+        __m256d better = _mm256_cmp_pd(s, current, _CMP_LT_OQ);
+        _mm256_storeu_pd(c + j, _mm256_blendv_pd(current, s, better));
+        __m128i mask = _mm256_castsi256_si128(
+            _mm256_permutevar8x32_epi32(_mm256_castpd_si256(better), narrow));
+        __m128i hops = _mm_loadu_si128((const __m128i*)(nc + j));
+        _mm_storeu_si128((__m128i*)(nc + j), _mm_blendv_epi8(hops, vn, mask));
+    }
+}
+
+__attribute__((target("avx2")))
+static inline void row_f32_avx2(float* c, vertex_id_t* nc, float a, vertex_id_t na,
+                                const float* b, vertex_count_t size) {
+    const __m256 va = _mm256_set1_ps(a);
+    if (!nc) {
+        for (vertex_count_t j = 0; j < size; j += 8) {
+            __m256 s = _mm256_add_ps(va, _mm256_loadu_ps(b + j));
+            _mm256_storeu_ps(c + j, _mm256_min_ps(s, _mm256_loadu_ps(c + j)));
+        }
+        return;
+    }
+
+    const __m256i vn = _mm256_set1_epi32((int)na);
+    for (vertex_count_t j = 0; j < size; j += 8) {
+        __m256 current = _mm256_loadu_ps(c + j);
+        __m256 s = _mm256_add_ps(va, _mm256_loadu_ps(b + j));
+        __m256 better = _mm256_cmp_ps(s, current, _CMP_LT_OQ);
+        _mm256_storeu_ps(c + j, _mm256_blendv_ps(current, s, better));
+        __m256i hops = _mm256_loadu_si256((const __m256i*)(nc + j));
+        _mm256_storeu_si256((__m256i*)(nc + j),
+                            _mm256_blendv_epi8(hops, vn, _mm256_castps_si256(better)));
+    }
+}
+
+__attribute__((target("avx2")))
+static void tile_f64_avx2(const apsp_tile_t* t) {
+    double* c = t->c;
+    const double* a = t->a;
+    const double* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t outer = 0; outer < t->size; outer++) {
+        for (vertex_count_t inner = 0; inner < t->size; inner++) {
+            vertex_count_t i = t->self_dependent ? inner : outer;
+            vertex_count_t k = t->self_dependent ? outer : inner;
+            double aik = a[i * s + k];
+            if (aik == SSSP_INFINITY) continue;
+            row_f64_avx2(c + i * s, t->nc ? t->nc + i * s : NULL, aik,
+                         t->nc ? t->na[i * s + k] : 0, b + k * s, t->size);
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void tile_f32_avx2(const apsp_tile_t* t) {
+    float* c = t->c;
+    const float* a = t->a;
+    const float* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t outer = 0; outer < t->size; outer++) {
+        for (vertex_count_t inner = 0; inner < t->size; inner++) {
+            vertex_count_t i = t->self_dependent ? inner : outer;
+            vertex_count_t k = t->self_dependent ? outer : inner;
+            float aik = a[i * s + k];
+            if (aik == (float)SSSP_INFINITY) continue;
+            row_f32_avx2(c + i * s, t->nc ? t->nc + i * s : NULL, aik,
+                         t->nc ? t->na[i * s + k] : 0, b + k * s, t->size);
+        }
+    }
+}
+
+/*
+ * Register-blocked phase 3 kernels, for tiles without next hops: a block of
+ * C rows stays in registers while k sweeps the tile, so every row of B that
+ * is loaded feeds several rows of C and C is read and written only once.
+ * Tile sizes are multiples of 16, which all block shapes divide. The
+ * scalar build has none: the compiler already vectorizes the row kernels,
+ * and spills a register block written in plain C.
+ */
+
+// 2 rows x 16 doubles: 8 accumulators, 4 loads of B per k
+__attribute__((target("avx2")))
+static void block_f64_avx2(const apsp_tile_t* t) {
+    double* c = t->c;
+    const double* a = t->a;
+    const double* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t i = 0; i < t->size; i += 2) {
+        double* c0 = c + i * s;
+        double* c1 = c0 + s;
+        const double* a0 = a + i * s;
+        const double* a1 = a0 + s;
+        for (vertex_count_t j = 0; j < t->size; j += 16) {
+            __m256d r00 = _mm256_loadu_pd(c0 + j), r01 = _mm256_loadu_pd(c0 + j + 4);
+            __m256d r02 = _mm256_loadu_pd(c0 + j + 8), r03 = _mm256_loadu_pd(c0 + j + 12);
+            __m256d r10 = _mm256_loadu_pd(c1 + j), r11 = _mm256_loadu_pd(c1 + j + 4);
+            __m256d r12 = _mm256_loadu_pd(c1 + j + 8), r13 = _mm256_loadu_pd(c1 + j + 12);
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const double* bk = b + k * s + j;
+                const __m256d b0 = _mm256_loadu_pd(bk), b1 = _mm256_loadu_pd(bk + 4);
+                const __m256d b2 = _mm256_loadu_pd(bk + 8), b3 = _mm256_loadu_pd(bk + 12);
+                const __m256d x = _mm256_broadcast_sd(a0 + k);
+                const __m256d y = _mm256_broadcast_sd(a1 + k);
+                r00 = _mm256_min_pd(_mm256_add_pd(x, b0), r00);
+                r01 = _mm256_min_pd(_mm256_add_pd(x, b1), r01);
+                r02 = _mm256_min_pd(_mm256_add_pd(x, b2), r02);
+                r03 = _mm256_min_pd(_mm256_add_pd(x, b3), r03);
+                r10 = _mm256_min_pd(_mm256_add_pd(y, b0), r10);
+                r11 = _mm256_min_pd(_mm256_add_pd(y, b1), r11);
+                r12 = _mm256_min_pd(_mm256_add_pd(y, b2), r12);
+                r13 = _mm256_min_pd(_mm256_add_pd(y, b3), r13);
+            }
+            _mm256_storeu_pd(c0 + j, r00);
+            _mm256_storeu_pd(c0 + j + 4, r01);
+            _mm256_storeu_pd(c0 + j + 8, r02);
+            _mm256_storeu_pd(c0 + j + 12, r03);
+            _mm256_storeu_pd(c1 + j, r10);
+            _mm256_storeu_pd(c1 + j + 4, r11);
+            _mm256_storeu_pd(c1 + j + 8, r12);
+            _mm256_storeu_pd(c1 + j + 12, r13);
+        }
+    }
+}
+
+// 4 rows x 16 floats: 8 accumulators, 2 loads of B per k
+__attribute__((target("avx2")))
+static void block_f32_avx2(const apsp_tile_t* t) {
+    float* c = t->c;
+    const float* a = t->a;
+    const float* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t i = 0; i < t->size; i += 4) {
+        for (vertex_count_t j = 0; j < t->size; j += 16) {
+            __m256 lo[4], hi[4];
+            for (int r = 0; r < 4; r++) {
+                lo[r] = _mm256_loadu_ps(c + (i + r) * s + j);
+                hi[r] = _mm256_loadu_ps(c + (i + r) * s + j + 8);
+            }
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const __m256 b0 = _mm256_loadu_ps(b + k * s + j);
+                const __m256 b1 = _mm256_loadu_ps(b + k * s + j + 8);
+                for (int r = 0; r < 4; r++) {
+                    const __m256 x = _mm256_broadcast_ss(a + (i + r) * s + k);
+                    lo[r] = _mm256_min_ps(_mm256_add_ps(x, b0), lo[r]);
+                    hi[r] = _mm256_min_ps(_mm256_add_ps(x, b1), hi[r]);
+                }
+            }
+            for (int r = 0; r < 4; r++) {
+                _mm256_storeu_ps(c + (i + r) * s + j, lo[r]);
+                _mm256_storeu_ps(c + (i + r) * s + j + 8, hi[r]);
+            }
+        }
+    }
+}
+
+/*
+ * Next-hop variants keep the hops of the block in registers too, and blend
+ * na into them wherever a distance improves
+ */
+
+// 2 rows x 8 doubles
+__attribute__((target("avx2")))
+static void block_next_f64_avx2(const apsp_tile_t* t) {
+    double* c = t->c;
+    const double* a = t->a;
+    const double* b = t->b;
+    const size_t s = t->stride;
+    // Gathers the low halves of four 64-bit lanes into four 32-bit lanes
+    const __m256i narrow = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    for (vertex_count_t i = 0; i < t->size; i += 2) {
+        for (vertex_count_t j = 0; j < t->size; j += 8) {
+            __m256d lo[2], hi[2];
+            __m256i hop[2];
+            for (int r = 0; r < 2; r++) {
+                lo[r] = _mm256_loadu_pd(c + (i + r) * s + j);
+                hi[r] = _mm256_loadu_pd(c + (i + r) * s + j + 4);
+                hop[r] = _mm256_loadu_si256((const __m256i*)(t->nc + (i + r) * s + j));
+            }
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const __m256d b0 = _mm256_loadu_pd(b + k * s + j);
+                const __m256d b1 = _mm256_loadu_pd(b + k * s + j + 4);
+                for (int r = 0; r < 2; r++) {
+                    const __m256d x = _mm256_broadcast_sd(a + (i + r) * s + k);
+                    const __m256d s0 = _mm256_add_pd(x, b0);
+                    const __m256d s1 = _mm256_add_pd(x, b1);
+                    const __m256d m0 = _mm256_cmp_pd(s0, lo[r], _CMP_LT_OQ);
+                    const __m256d m1 = _mm256_cmp_pd(s1, hi[r], _CMP_LT_OQ);
+                    lo[r] = _mm256_blendv_pd(lo[r], s0, m0);
+                    hi[r] = _mm256_blendv_pd(hi[r], s1, m1);
+                    const __m256i mask = _mm256_inserti128_si256(
+                        _mm256_castsi128_si256(_mm256_castsi256_si128(
+                            _mm256_permutevar8x32_epi32(_mm256_castpd_si256(m0), narrow))),
+                        _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(m1), narrow)),
+                        1);
+                    hop[r] = _mm256_blendv_epi8(hop[r], _mm256_set1_epi32((int)t->na[(i + r) * s + k]), mask);
+                }
+            }
+            for (int r = 0; r < 2; r++) {
+                _mm256_storeu_pd(c + (i + r) * s + j, lo[r]);
+                _mm256_storeu_pd(c + (i + r) * s + j + 4, hi[r]);
+                _mm256_storeu_si256((__m256i*)(t->nc + (i + r) * s + j), hop[r]);
+            }
+        }
+    }
+}
+
+// 4 rows x 8 floats
+__attribute__((target("avx2")))
+static void block_next_f32_avx2(const apsp_tile_t* t) {
+    float* c = t->c;
+    const float* a = t->a;
+    const float* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t i = 0; i < t->size; i += 4) {
+        for (vertex_count_t j = 0; j < t->size; j += 8) {
+            __m256 acc[4];
+            __m256i hop[4];
+            for (int r = 0; r < 4; r++) {
+                acc[r] = _mm256_loadu_ps(c + (i + r) * s + j);
+                hop[r] = _mm256_loadu_si256((const __m256i*)(t->nc + (i + r) * s + j));
+            }
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const __m256 bk = _mm256_loadu_ps(b + k * s + j);
+                for (int r = 0; r < 4; r++) {
+                    const __m256 sum = _mm256_add_ps(_mm256_broadcast_ss(a + (i + r) * s + k), bk);
+                    const __m256 better = _mm256_cmp_ps(sum, acc[r], _CMP_LT_OQ);
+                    acc[r] = _mm256_blendv_ps(acc[r], sum, better);
+                    hop[r] = _mm256_blendv_epi8(hop[r], _mm256_set1_epi32((int)t->na[(i + r) * s + k]),
+                                                _mm256_castps_si256(better));
+                }
+            }
+            for (int r = 0; r < 4; r++) {
+                _mm256_storeu_ps(c + (i + r) * s + j, acc[r]);
+                _mm256_storeu_si256((__m256i*)(t->nc + (i + r) * s + j), hop[r]);
+            }
+        }
+    }
+}
+
+// 4 rows x 16 doubles
+__attribute__((target("avx512f")))
+static void block_next_f64_avx512(const apsp_tile_t* t) {
+    double* c = t->c;
+    const double* a = t->a;
+    const double* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t i = 0; i < t->size; i += 4) {
+        for (vertex_count_t j = 0; j < t->size; j += 16) {
+            __m512d lo[4], hi[4];
+            __m512i hop[4];
+            for (int r = 0; r < 4; r++) {
+                lo[r] = _mm512_loadu_pd(c + (i + r) * s + j);
+                hi[r] = _mm512_loadu_pd(c + (i + r) * s + j + 8);
+                hop[r] = _mm512_loadu_si512(t->nc + (i + r) * s + j);
+            }
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const __m512d b0 = _mm512_loadu_pd(b + k * s + j);
+                const __m512d b1 = _mm512_loadu_pd(b + k * s + j + 8);
+                for (int r = 0; r < 4; r++) {
+                    const __m512d x = _mm512_set1_pd(a[(i + r) * s + k]);
+                    const __m512d s0 = _mm512_add_pd(x, b0);
+                    const __m512d s1 = _mm512_add_pd(x, b1);
+                    const __mmask8 m0 = _mm512_cmp_pd_mask(s0, lo[r], _CMP_LT_OQ);
+                    const __mmask8 m1 = _mm512_cmp_pd_mask(s1, hi[r], _CMP_LT_OQ);
+                    lo[r] = _mm512_mask_mov_pd(lo[r], m0, s0);
+                    hi[r] = _mm512_mask_mov_pd(hi[r], m1, s1);
+                    hop[r] = _mm512_mask_mov_epi32(hop[r], _mm512_kunpackb(m1, m0),
+                                                   _mm512_set1_epi32((int)t->na[(i + r) * s + k]));
+                }
+            }
+            for (int r = 0; r < 4; r++) {
+                _mm512_storeu_pd(c + (i + r) * s + j, lo[r]);
+                _mm512_storeu_pd(c + (i + r) * s + j + 8, hi[r]);
+                _mm512_storeu_si512(t->nc + (i + r) * s + j, hop[r]);
+            }
+        }
+    }
+}
+
+// 8 rows x 16 floats
+__attribute__((target("avx512f")))
+static void block_next_f32_avx512(const apsp_tile_t* t) {
+    float* c = t->c;
+    const float* a = t->a;
+    const float* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t i = 0; i < t->size; i += 8) {
+        for (vertex_count_t j = 0; j < t->size; j += 16) {
+            __m512 acc[8];
+            __m512i hop[8];
+            for (int r = 0; r < 8; r++) {
+                acc[r] = _mm512_loadu_ps(c + (i + r) * s + j);
+                hop[r] = _mm512_loadu_si512(t->nc + (i + r) * s + j);
+            }
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const __m512 bk = _mm512_loadu_ps(b + k * s + j);
+                for (int r = 0; r < 8; r++) {
+                    const __m512 sum = _mm512_add_ps(_mm512_set1_ps(a[(i + r) * s + k]), bk);
+                    const __mmask16 better = _mm512_cmp_ps_mask(sum, acc[r], _CMP_LT_OQ);
+                    acc[r] = _mm512_mask_mov_ps(acc[r], better, sum);
+                    hop[r] = _mm512_mask_mov_epi32(hop[r], better,
+                                                   _mm512_set1_epi32((int)t->na[(i + r) * s + k]));
+                }
+            }
+            for (int r = 0; r < 8; r++) {
+                _mm512_storeu_ps(c + (i + r) * s + j, acc[r]);
+                _mm512_storeu_si512(t->nc + (i + r) * s + j, hop[r]);
+            }
+        }
+    }
+}
+
+// 8 rows x 16 doubles: 16 accumulators, 2 loads of B per k
+__attribute__((target("avx512f")))
+static void block_f64_avx512(const apsp_tile_t* t) {
+    double* c = t->c;
+    const double* a = t->a;
+    const double* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t i = 0; i < t->size; i += 8) {
+        for (vertex_count_t j = 0; j < t->size; j += 16) {
+            __m512d lo[8], hi[8];
+            for (int r = 0; r < 8; r++) {
+                lo[r] = _mm512_loadu_pd(c + (i + r) * s + j);
+                hi[r] = _mm512_loadu_pd(c + (i + r) * s + j + 8);
+            }
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const __m512d b0 = _mm512_loadu_pd(b + k * s + j);
+                const __m512d b1 = _mm512_loadu_pd(b + k * s + j + 8);
+                for (int r = 0; r < 8; r++) {
+                    const __m512d x = _mm512_set1_pd(a[(i + r) * s + k]);
+                    lo[r] = _mm512_min_pd(_mm512_add_pd(x, b0), lo[r]);
+                    hi[r] = _mm512_min_pd(_mm512_add_pd(x, b1), hi[r]);
+                }
+            }
+            for (int r = 0; r < 8; r++) {
+                _mm512_storeu_pd(c + (i + r) * s + j, lo[r]);
+                _mm512_storeu_pd(c + (i + r) * s + j + 8, hi[r]);
+            }
+        }
+    }
+}
+
+// 16 rows x 16 floats: 16 accumulators, 1 load of B per k
+__attribute__((target("avx512f")))
+static void block_f32_avx512(const apsp_tile_t* t) {
+    float* c = t->c;
+    const float* a = t->a;
+    const float* b = t->b;
+    const size_t s = t->stride;
+    for (vertex_count_t i = 0; i < t->size; i += 16) {
+        for (vertex_count_t j = 0; j < t->size; j += 16) {
+            __m512 acc[16];
+            for (int r = 0; r < 16; r++) {
+                acc[r] = _mm512_loadu_ps(c + (i + r) * s + j);
+            }
+            for (vertex_count_t k = 0; k < t->size; k++) {
+                const __m512 bk = _mm512_loadu_ps(b + k * s + j);
+                for (int r = 0; r < 16; r++) {
+                    const __m512 x = _mm512_set1_ps(a[(i + r) * s + k]);
+                    acc[r] = _mm512_min_ps(_mm512_add_ps(x, bk), acc[r]);
+                }
+            }
+            for (int r = 0; r < 16; r++) {
+                _mm512_storeu_ps(c + (i + r) * s + j, acc[r]);
+            }
+        }
+    }
+}
+#endif
+
+/**
+ * Tile kernels of one precision and instruction set: general handles
+ * self-dependent tiles, blocked and blocked_next the phase 3 tiles without
+ * and with next hops
+ */
+typedef struct apsp_kernels {
+    apsp_tile_fn_t general;
+    apsp_tile_fn_t blocked;
+    apsp_tile_fn_t blocked_next;
+} apsp_kernels_t;
+
+/**
+ * Pick kernels matching the relaxation kernel selection; AVX-512 uses the
+ * AVX2 kernels for the general tiles, which are a small share of the work
+ */
+static apsp_kernels_t select_kernels(sssp_apsp_precision_t precision) {
+    const bool single = precision == SSSP_APSP_FLOAT;
+    switch (sssp_relax_get_kernel()) {
+#ifdef APSP_X86_SIMD
+        case SSSP_RELAX_KERNEL_AVX512:
+            return (apsp_kernels_t){ single ? tile_f32_avx2 : tile_f64_avx2,
+                                     single ? block_f32_avx512 : block_f64_avx512,
+                                     single ? block_next_f32_avx512 : block_next_f64_avx512 };
+        case SSSP_RELAX_KERNEL_AVX2:
+            return (apsp_kernels_t){ single ? tile_f32_avx2 : tile_f64_avx2,
+                                     single ? block_f32_avx2 : block_f64_avx2,
+                                     single ? block_next_f32_avx2 : block_next_f64_avx2 };
+#endif
+        default:
+            return (apsp_kernels_t){ single ? tile_f32_scalar : tile_f64_scalar,
+                                     single ? tile_f32_scalar : tile_f64_scalar,
+                                     single ? tile_f32_scalar : tile_f64_scalar };
+    }
+}
+
+/*
+ * Rounds
+ */
+
+typedef struct apsp_round {
+    sssp_apsp_matrix_t* matrix;
+    apsp_kernels_t kernels;
+    size_t element_size;
+    vertex_count_t tile_size;
+    vertex_count_t num_blocks;
+    vertex_count_t pivot;               // Pivot block of this round
+} apsp_round_t;
+
+static void* tile_at(const apsp_round_t* round, void* base, size_t size, vertex_count_t bi,
+                     vertex_count_t bj) {
+    size_t offset = (size_t)bi * round->tile_size * round->matrix->stride +
+                    (size_t)bj * round->tile_size;
+    return (char*)base + offset * size;
+}
+
+static void update_tile(const apsp_round_t* round, vertex_count_t bi, vertex_count_t bj,
+                        bool self_dependent) {
+    sssp_apsp_matrix_t* m = round->matrix;
+    const vertex_count_t r = round->pivot;
+    apsp_tile_t tile = {
+        .c = tile_at(round, m->distances, round->element_size, bi, bj),
+        .a = tile_at(round, m->distances, round->element_size, bi, r),
+        .b = tile_at(round, m->distances, round->element_size, r, bj),
+        .nc = m->next_hops ? tile_at(round, m->next_hops, sizeof(vertex_id_t), bi, bj) : NULL,
+        .na = m->next_hops ? tile_at(round, m->next_hops, sizeof(vertex_id_t), bi, r) : NULL,
+        .stride = m->stride,
+        .size = round->tile_size,
+        .self_dependent = self_dependent,
+    };
+    if (self_dependent) {
+        round->kernels.general(&tile);
+    } else if (tile.nc) {
+        round->kernels.blocked_next(&tile);
+    } else {
+        round->kernels.blocked(&tile);
+    }
+}
+
+// Map 0 .. num_blocks - 2 onto the block indices other than the pivot
+static inline vertex_count_t skip_pivot(vertex_count_t index, vertex_count_t pivot) {
+    return index < pivot ? index : index + 1;
+}
+
+// Phase 2: jobs [0, n - 1) are the row tiles, [n - 1, 2n - 2) the column tiles
+static void update_pivot_cross(size_t begin, size_t end, void* context) {
+    const apsp_round_t* round = context;
+    const vertex_count_t others = round->num_blocks - 1;
+    for (size_t job = begin; job < end; job++) {
+        if (job < others) {
+            update_tile(round, round->pivot, skip_pivot((vertex_count_t)job, round->pivot), true);
+        } else {
+            update_tile(round, skip_pivot((vertex_count_t)(job - others), round->pivot), round->pivot, true);
+        }
+    }
+}
+
+// Phase 3: all tiles outside the pivot row and column
+static void update_remaining(size_t begin, size_t end, void* context) {
+    const apsp_round_t* round = context;
+    const vertex_count_t others = round->num_blocks - 1;
+    for (size_t job = begin; job < end; job++) {
+        vertex_count_t bi = skip_pivot((vertex_count_t)(job / others), round->pivot);
+        vertex_count_t bj = skip_pivot((vertex_count_t)(job % others), round->pivot);
+        update_tile(round, bi, bj, false);
+    }
+}
+
+static sssp_error_t run_phase(bool parallel, size_t jobs, sssp_parallel_fn_t fn, apsp_round_t* round) {
+    if (parallel && jobs > 1) {
+        return sssp_parallel_for(jobs, 1, fn, round);
+    }
+    fn(0, jobs, round);
+    return SSSP_SUCCESS;
+}
+
+/*
+ * Matrix setup
+ */
+
+// Rows of the matrix: num_vertices rounded up to whole tiles
+static size_t apsp_rows(const sssp_apsp_matrix_t* m) {
+    return ((size_t)m->num_vertices + m->tile_size - 1) / m->tile_size * m->tile_size;
+}
+
+static void set_edge(sssp_apsp_matrix_t* m, vertex_id_t u, vertex_id_t v, weight_t w) {
+    size_t index = (size_t)u * m->stride + v;
+    bool better;
+    if (m->precision == SSSP_APSP_FLOAT) {
+        float* d = m->distances;
+        better = (float)w < d[index];
+        if (better) d[index] = (float)w;
+    } else {
+        double* d = m->distances;
+        better = w < d[index];
+        if (better) d[index] = w;
+    }
+    if (better && m->next_hops) {
+        m->next_hops[index] = v;
+    }
+}
+
+static void load_graph(sssp_apsp_matrix_t* m, const sssp_graph_t* graph) {
+    const size_t entries = apsp_rows(m) * m->stride;
+    if (m->precision == SSSP_APSP_FLOAT) {
+        float* d = m->distances;
+        for (size_t i = 0; i < entries; i++) d[i] = (float)SSSP_INFINITY;
+        for (vertex_count_t v = 0; v < m->num_vertices; v++) d[(size_t)v * m->stride + v] = 0.0f;
+    } else {
+        double* d = m->distances;
+        for (size_t i = 0; i < entries; i++) d[i] = SSSP_INFINITY;
+        for (vertex_count_t v = 0; v < m->num_vertices; v++) d[(size_t)v * m->stride + v] = 0.0;
+    }
+    if (m->next_hops) {
+        for (size_t i = 0; i < entries; i++) m->next_hops[i] = SSSP_INVALID_VERTEX;
+        for (vertex_count_t v = 0; v < m->num_vertices; v++) m->next_hops[(size_t)v * m->stride + v] = v;
+    }
+
+    for (vertex_id_t u = 0; u < m->num_vertices; u++) {
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t degree;
+        if (sssp_graph_neighbors(graph, u, &targets, &weights, &degree) != SSSP_SUCCESS) {
+            continue;
+        }
+        for (edge_count_t e = 0; e < degree; e++) {
+            set_edge(m, u, targets[e], weights[e]);
+        }
+    }
+}
+
+/*
+ * Public interface
+ */
+
+sssp_apsp_config_t sssp_apsp_config_default(const sssp_allocator_t* allocator) {
+    sssp_apsp_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.precision = SSSP_APSP_DOUBLE;
+    config.compute_next_hops = false;
+    config.use_parallel_processing = true;
+    config.tile_size = SSSP_APSP_DEFAULT_TILE;
+    config.allocator = allocator ? allocator : &SSSP_DEFAULT_ALLOCATOR;
+    return config;
+}
+
+sssp_error_t sssp_all_pairs(const sssp_graph_t* graph,
+                            const sssp_apsp_config_t* config,
+                            sssp_apsp_matrix_t** matrix_out) {
+    if (!graph || !matrix_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    *matrix_out = NULL;
+
+    sssp_apsp_config_t default_config;
+    if (!config) {
+        default_config = sssp_apsp_config_default(NULL);
+        config = &default_config;
+    }
+
+    const vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    const vertex_count_t tile_size = config->tile_size ? config->tile_size : SSSP_APSP_DEFAULT_TILE;
+    if (tile_size % 16 != 0 || tile_size > SSSP_APSP_MAX_VERTICES) {
+        SSSP_LOG_ERROR("All-pairs tile size must be a multiple of 16, got %u", tile_size);
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    if (n == 0 || n > SSSP_APSP_MAX_VERTICES) {
+        SSSP_LOG_ERROR("All-pairs needs 1 to %u vertices, got %u", SSSP_APSP_MAX_VERTICES, n);
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint64_t start_ns = sssp_get_timestamp_ns();
+    const sssp_allocator_t* allocator = config->allocator ? config->allocator : &SSSP_DEFAULT_ALLOCATOR;
+    const size_t element_size = config->precision == SSSP_APSP_FLOAT ? sizeof(float) : sizeof(double);
+    const vertex_count_t num_blocks = (n + tile_size - 1) / tile_size;
+    const size_t rows = (size_t)num_blocks * tile_size;
+    // One cache line of skew keeps power-of-two row lengths from mapping a
+    // tile's column onto the same few L1 sets
+    const size_t stride = rows + 64 / element_size;
+
+    sssp_apsp_matrix_t* m = sssp_alloc(allocator, sizeof(sssp_apsp_matrix_t));
+    if (!m) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(m, 0, sizeof(*m));
+    m->num_vertices = n;
+    m->stride = stride;
+    m->tile_size = tile_size;
+    m->precision = config->precision;
+    m->allocator = allocator;
+    m->distances = sssp_alloc(allocator, rows * stride * element_size);
+    if (config->compute_next_hops) {
+        m->next_hops = sssp_alloc(allocator, rows * stride * sizeof(vertex_id_t));
+    }
+    if (!m->distances || (config->compute_next_hops && !m->next_hops)) {
+        SSSP_LOG_ERROR("Failed to allocate %zu x %zu all-pairs matrix", rows, stride);
+        sssp_apsp_matrix_destroy(m);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+
+    load_graph(m, graph);
+
+    apsp_round_t round = {
+        .matrix = m,
+        .kernels = select_kernels(config->precision),
+        .element_size = element_size,
+        .tile_size = tile_size,
+        .num_blocks = num_blocks,
+    };
+    const bool parallel = config->use_parallel_processing;
+    const size_t others = num_blocks - 1;
+    sssp_error_t error = SSSP_SUCCESS;
+
+    for (vertex_count_t r = 0; r < num_blocks && error == SSSP_SUCCESS; r++) {
+        round.pivot = r;
+        update_tile(&round, r, r, true);
+        error = run_phase(parallel, 2 * others, update_pivot_cross, &round);
+        if (error == SSSP_SUCCESS) {
+            error = run_phase(parallel, others * others, update_remaining, &round);
+        }
+    }
+    if (error != SSSP_SUCCESS) {
+        sssp_apsp_matrix_destroy(m);
+        return error;
+    }
+
+    m->total_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    SSSP_LOG_INFO("All-pairs on %u vertices (%u tiles of %u) took %.2f ms", n,
+                  num_blocks * num_blocks, tile_size, m->total_time_ms);
+    *matrix_out = m;
+    return SSSP_SUCCESS;
+}
+
+void sssp_apsp_matrix_destroy(sssp_apsp_matrix_t* matrix) {
+    if (!matrix) return;
+
+    const sssp_allocator_t* allocator = matrix->allocator;
+    if (matrix->distances) sssp_free(allocator, matrix->distances);
+    if (matrix->next_hops) sssp_free(allocator, matrix->next_hops);
+    sssp_free(allocator, matrix);
+}
+
+distance_t sssp_apsp_distance(const sssp_apsp_matrix_t* matrix, vertex_id_t u, vertex_id_t v) {
+    if (!matrix || u >= matrix->num_vertices || v >= matrix->num_vertices) {
+        return SSSP_INFINITY;
+    }
+    size_t index = (size_t)u * matrix->stride + v;
+    if (matrix->precision == SSSP_APSP_FLOAT) {
+        return ((const float*)matrix->distances)[index];
+    }
+    return ((const double*)matrix->distances)[index];
+}
+
+vertex_id_t sssp_apsp_next_hop(const sssp_apsp_matrix_t* matrix, vertex_id_t u, vertex_id_t v) {
+    if (!matrix || !matrix->next_hops || u >= matrix->num_vertices || v >= matrix->num_vertices) {
+        return SSSP_INVALID_VERTEX;
+    }
+    return matrix->next_hops[(size_t)u * matrix->stride + v];
+}
+
+sssp_error_t sssp_apsp_path(const sssp_apsp_matrix_t* matrix,
+                            vertex_id_t u,
+                            vertex_id_t v,
+                            sssp_vertex_set_t* path) {
+    if (!matrix || !path) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (!matrix->next_hops || u >= matrix->num_vertices || v >= matrix->num_vertices ||
+        sssp_apsp_next_hop(matrix, u, v) == SSSP_INVALID_VERTEX) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+
+    sssp_vertex_set_clear(path);
+    sssp_error_t error = sssp_vertex_set_add(path, u);
+    // A simple path has fewer than num_vertices hops
+    for (vertex_count_t hops = 0; u != v && error == SSSP_SUCCESS; hops++) {
+        if (hops == matrix->num_vertices) {
+            return SSSP_ERROR_ALGORITHM;
+        }
+        u = sssp_apsp_next_hop(matrix, u, v);
+        error = sssp_vertex_set_add(path, u);
+    }
+    return error;
+}
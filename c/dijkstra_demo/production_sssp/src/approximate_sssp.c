@@ -0,0 +1,317 @@
+/**
+ * @file approximate_sssp.c
+ * @brief (1+ε)-approximate single-source shortest paths over geometric buckets
+ *
+ * Tentative distances are grouped by their leading bits: the exponent and
+ * top k mantissa bits of a double, read as an integer, number buckets whose
+ * upper end is at most 1 + 2^-k times their lower end, with
+ * k = ceil(log2(1/ε)) kept within [8, 16]. Buckets are emptied in
+ * increasing order, and vertices in the same bucket are settled in
+ * whatever order they come out, without a heap. Every tentative distance
+ * is the length of a path, so it never falls below the true distance.
+ *
+ * Settling out of order within a bucket can leave an edge (u, v) with v
+ * already settled at more than d(u) + w. Such an edge is accepted while
+ * d(v) <= d(u) + (1+ε)w and corrected otherwise, which moves v back into
+ * the queue. Once the queue is empty every edge meets that inequality, and
+ * summing it along a shortest path gives d(v) <= (1+ε) * dist(v). The
+ * largest (d(v) - d(u)) / w accepted is reported as the achieved bound.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "sssp_internal.h"
+#include <math.h>
+#include <string.h>
+
+// Bucket resolution bounds, in mantissa bits. Buckets much wider than
+// 2^-APPROX_MIN_MANTISSA_BITS settle so far out of order on long paths that
+// the corrections cost more than the heap they replace.
+#define APPROX_MIN_MANTISSA_BITS 8
+#define APPROX_MAX_MANTISSA_BITS 16
+
+// Bucket of a vertex without a live queue entry
+#define APPROX_NOT_QUEUED UINT32_MAX
+
+/**
+ * One bucket: a stack of vertices, some of them outdated
+ */
+typedef struct approx_bucket {
+    vertex_id_t* items;
+    uint32_t size;
+    uint32_t capacity;
+} approx_bucket_t;
+
+/**
+ * Working state of one approximate solve
+ *
+ * A bucket key is 0 for distance 0 and one more than the leading bits of
+ * the distance otherwise. Keys are absolute, so vertices keep theirs when
+ * the bucket array is rebased; buckets[0] holds key 0 and buckets[i] key
+ * base_key + i - 1.
+ */
+typedef struct approx_state {
+    const sssp_allocator_t* allocator;
+    distance_t* distances;
+    vertex_id_t* predecessors;
+    uint32_t* queued_key;               // Key of each vertex's live entry (APPROX_NOT_QUEUED: none)
+    approx_bucket_t* buckets;
+    uint32_t num_buckets;
+    uint32_t base_key;                  // Key of buckets[1] (0: no positive distance yet)
+    unsigned int shift;                 // Bits dropped from a distance to get its key
+    double slack;                       // 1 + ε
+    double worst_ratio;                 // Largest (d(v) - d(u)) / w accepted
+    uint64_t settled;
+    uint64_t relaxations;
+    uint64_t corrections;
+} approx_state_t;
+
+static inline uint32_t bucket_key(const approx_state_t* state, distance_t distance) {
+    if (distance <= 0.0) {
+        return 0;
+    }
+    uint64_t bits;
+    memcpy(&bits, &distance, sizeof(bits));
+    return (uint32_t)(bits >> state->shift) + 1;
+}
+
+/**
+ * Make room for a bucket with key, growing the array or rebasing it
+ * below the current base
+ */
+static sssp_error_t reserve_bucket(approx_state_t* state, uint32_t key, uint32_t* index_out) {
+    if (state->base_key == 0) {
+        state->base_key = key;
+    }
+    if (key < state->base_key) {
+        // Only while the zero bucket is open: later distances never drop
+        // below the key being settled
+        uint32_t delta = state->base_key - key;
+        uint32_t count = state->num_buckets + delta;
+        approx_bucket_t* buckets = sssp_realloc(state->allocator, state->buckets,
+                                                (size_t)count * sizeof(approx_bucket_t));
+        if (!buckets) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        memmove(buckets + 1 + delta, buckets + 1, (state->num_buckets - 1) * sizeof(approx_bucket_t));
+        memset(buckets + 1, 0, delta * sizeof(approx_bucket_t));
+        state->buckets = buckets;
+        state->num_buckets = count;
+        state->base_key = key;
+    }
+    uint32_t index = key - state->base_key + 1;
+    if (index >= state->num_buckets) {
+        uint32_t count = SSSP_MAX(state->num_buckets * 2, index + 1);
+        approx_bucket_t* buckets = sssp_realloc(state->allocator, state->buckets,
+                                                (size_t)count * sizeof(approx_bucket_t));
+        if (!buckets) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        memset(buckets + state->num_buckets, 0, (count - state->num_buckets) * sizeof(approx_bucket_t));
+        state->buckets = buckets;
+        state->num_buckets = count;
+    }
+    *index_out = index;
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t enqueue(approx_state_t* state, vertex_id_t v, distance_t distance) {
+    uint32_t key = bucket_key(state, distance);
+    if (state->queued_key[v] == key) {
+        return SSSP_SUCCESS;            // Its entry is already in this bucket
+    }
+    uint32_t index = 0;
+    if (key != 0) {
+        sssp_error_t error = reserve_bucket(state, key, &index);
+        if (error != SSSP_SUCCESS) {
+            return error;
+        }
+    }
+    approx_bucket_t* bucket = &state->buckets[index];
+    if (bucket->size == bucket->capacity) {
+        uint32_t capacity = bucket->capacity ? bucket->capacity * 2 : SSSP_INITIAL_CAPACITY;
+        vertex_id_t* items = sssp_realloc(state->allocator, bucket->items, capacity * sizeof(vertex_id_t));
+        if (!items) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        bucket->items = items;
+        bucket->capacity = capacity;
+    }
+    bucket->items[bucket->size++] = v;
+    state->queued_key[v] = key;
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Relax the out-edges of a settled vertex
+ */
+static sssp_error_t relax_approximate(approx_state_t* state, vertex_id_t u, distance_t dist_u,
+                                      const vertex_id_t* targets, const weight_t* weights,
+                                      edge_count_t degree) {
+    distance_t* distances = state->distances;
+    state->relaxations += degree;
+    for (edge_count_t e = 0; e < degree; e++) {
+        vertex_id_t v = targets[e];
+        distance_t candidate = dist_u + weights[e];
+        if (candidate >= distances[v]) {
+            continue;
+        }
+        if (distances[v] < SSSP_INFINITY && state->queued_key[v] == APPROX_NOT_QUEUED) {
+            // Already settled: keep it if it is close enough
+            distance_t excess = distances[v] - dist_u;
+            if (excess <= state->slack * weights[e]) {
+                state->worst_ratio = fmax(state->worst_ratio, excess / weights[e]);
+                continue;
+            }
+            state->corrections++;
+        }
+        distances[v] = candidate;
+        state->predecessors[v] = u;
+        sssp_error_t error = enqueue(state, v, candidate);
+        if (error != SSSP_SUCCESS) {
+            return error;
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t run_buckets(approx_state_t* state, const sssp_graph_t* graph,
+                                const sssp_algorithm_config_t* config) {
+    uint32_t check_interval = sssp_limit_check_interval(config->deadline_ns, config->cancel_token,
+                                                        config->limit_check_interval);
+    uint32_t until_check = check_interval;
+    sssp_error_t expired = sssp_check_query_limits(config->deadline_ns, config->cancel_token);
+    if (expired != SSSP_SUCCESS) {
+        return expired;
+    }
+
+    // Profiled as a split phase: bucket pops against scans, sampled
+    sssp_profiler_t* profiler = sssp_profiler_current();
+    if (SSSP_UNLIKELY(profiler != NULL)) {
+        sssp_profiler_begin_split(profiler, SSSP_PHASE_HEAP_OPERATIONS, SSSP_PHASE_RELAXATION);
+    }
+
+    // Buckets may be added, and rebased while index is 0, as vertices are settled
+    for (uint32_t index = 0; index < state->num_buckets; index++) {
+        while (state->buckets[index].size > 0) {
+            bool sampled = SSSP_UNLIKELY(profiler != NULL) && sssp_profiler_sample_due(profiler);
+            uint64_t sample_start_ns = sampled ? sssp_get_timestamp_ns() : 0;
+            approx_bucket_t* bucket = &state->buckets[index];
+            vertex_id_t u = bucket->items[--bucket->size];
+            uint32_t key = index == 0 ? 0 : state->base_key + index - 1;
+            uint64_t scan_start_ns = sampled ? sssp_get_timestamp_ns() : 0;
+            if (state->queued_key[u] != key) {
+                if (sampled) {
+                    sssp_profiler_add_sample(profiler, scan_start_ns - sample_start_ns, 0);
+                }
+                continue;               // Outdated entry
+            }
+            state->queued_key[u] = APPROX_NOT_QUEUED;
+            state->settled++;
+
+            const vertex_id_t* targets;
+            const weight_t* weights;
+            edge_count_t degree;
+            sssp_error_t result = sssp_graph_neighbors(graph, u, &targets, &weights, &degree);
+            if (result == SSSP_SUCCESS) {
+                result = relax_approximate(state, u, state->distances[u], targets, weights, degree);
+            }
+            if (sampled) {
+                sssp_profiler_add_sample(profiler, scan_start_ns - sample_start_ns,
+                                         sssp_get_timestamp_ns() - scan_start_ns);
+            }
+            if (result != SSSP_SUCCESS) {
+                return result;
+            }
+
+            result = sssp_poll_query_limits(&until_check, check_interval, config->deadline_ns,
+                                            config->cancel_token);
+            if (result != SSSP_SUCCESS) {
+                return result;
+            }
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_solve_approximate(const sssp_graph_t* graph, vertex_id_t source,
+                                    const sssp_algorithm_config_t* config,
+                                    sssp_algorithm_result_t* result) {
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    double epsilon = config->approximation_epsilon;
+    uint64_t start_ns = sssp_get_timestamp_ns();
+
+    sssp_tracking_allocator_t tracker;
+    sssp_tracking_allocator_init(&tracker, config->allocator, config->memory_limit_bytes);
+
+    approx_state_t state;
+    memset(&state, 0, sizeof(state));
+    state.allocator = &tracker.allocator;
+    unsigned int bits = epsilon >= 1.0 ? 0 : (unsigned int)ceil(-log2(epsilon));
+    bits = SSSP_MIN(SSSP_MAX(bits, (unsigned int)APPROX_MIN_MANTISSA_BITS), (unsigned int)APPROX_MAX_MANTISSA_BITS);
+    state.shift = 52 - bits;
+    state.slack = 1.0 + epsilon;
+    state.worst_ratio = 1.0;
+    state.distances = sssp_alloc(state.allocator, n * sizeof(distance_t));
+    state.predecessors = sssp_alloc(state.allocator, n * sizeof(vertex_id_t));
+    state.queued_key = sssp_alloc(state.allocator, n * sizeof(uint32_t));
+    state.buckets = sssp_alloc(state.allocator, sizeof(approx_bucket_t));
+
+    sssp_error_t error = SSSP_SUCCESS;
+    if (!state.distances || !state.predecessors || !state.queued_key || !state.buckets) {
+        error = SSSP_ERROR_OUT_OF_MEMORY;
+    } else {
+        memset(state.buckets, 0, sizeof(approx_bucket_t));
+        state.num_buckets = 1;
+        for (vertex_count_t v = 0; v < n; v++) {
+            state.distances[v] = SSSP_INFINITY;
+            state.predecessors[v] = SSSP_INVALID_VERTEX;
+            state.queued_key[v] = APPROX_NOT_QUEUED;
+        }
+        state.distances[source] = 0.0;
+        error = enqueue(&state, source, 0.0);
+        if (error == SSSP_SUCCESS) {
+            error = run_buckets(&state, graph, config);
+        }
+        SSSP_PROFILE_SWITCH(sssp_profiler_current(), SSSP_PHASE_FINALIZATION);
+    }
+    if (error == SSSP_ERROR_OUT_OF_MEMORY && tracker.limit_failures > 0) {
+        error = SSSP_ERROR_MEMORY_LIMIT;
+    }
+
+    if (error == SSSP_SUCCESS || sssp_error_is_interruption(error)) {
+        // An interrupted solve has upper bounds only: settled vertices may
+        // still have been corrected
+        for (vertex_count_t v = 0; v < n; v++) {
+            result->distances[v] = state.distances[v];
+            result->predecessors[v] = state.predecessors[v];
+            if (state.distances[v] < SSSP_INFINITY && state.queued_key[v] == APPROX_NOT_QUEUED) {
+                sssp_vertex_set_add(result->processed_vertices, v);
+            }
+        }
+        result->vertices_processed = (vertex_count_t)state.settled;
+        result->relaxations_performed = state.relaxations;
+        result->recursive_calls = 1;
+        result->is_optimal = false;
+        result->validation_status = error;
+        result->approximation_bound = error == SSSP_SUCCESS ? state.worst_ratio : SSSP_INFINITY;
+    }
+
+    for (uint32_t i = 0; i < state.num_buckets && state.buckets; i++) {
+        sssp_free(state.allocator, state.buckets[i].items);
+    }
+    sssp_free(state.allocator, state.buckets);
+    sssp_free(state.allocator, state.queued_key);
+    sssp_free(state.allocator, state.predecessors);
+    sssp_free(state.allocator, state.distances);
+    result->peak_memory_bytes = sssp_tracking_allocator_stats(&tracker).peak_bytes;
+    result->page_size = 0;
+    result->total_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+
+    SSSP_LOG_INFO("Approximate SSSP (epsilon %.3g) settled %llu vertices, %llu corrections, "
+                  "bound %.4f, in %.2f ms", epsilon, (unsigned long long)state.settled,
+                  (unsigned long long)state.corrections, state.worst_ratio, result->total_time_ms);
+    return error;
+}
@@ -0,0 +1,683 @@
+/**
+ * @file async_log.c
+ * @brief Asynchronous log backend: per-thread rings of unformatted records
+ *
+ * Each logging thread owns a single-producer ring of fixed-size records.
+ * A record holds the format pointer and the arguments read from the
+ * va_list according to the format's conversions, with %s strings copied
+ * into the record. The drain thread is the only consumer of every ring; it
+ * formats records back through snprintf, one conversion at a time, and
+ * writes them to stderr in batches (or hands them to the function set with
+ * sssp_set_log_function()).
+ *
+ * Rings are registered in a list on a thread's first message and marked
+ * abandoned when the thread exits; the drain thread frees abandoned rings
+ * once they are empty. Nothing but the drain thread frees a ring, so it
+ * walks the list without holding the registry lock.
+ *
+ * A forked child has no drain thread, so the backend counts as stopped
+ * there and the child logs synchronously. Fork handlers hold both locks
+ * across the fork, so the child never inherits one held by a thread that
+ * no longer exists.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "../include/sssp_common.h"
+#include "sssp_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define LOG_RECORD_SIZE 256
+#define LOG_MAX_ARGS 12
+#define LOG_DEFAULT_RING_RECORDS 1024
+#define LOG_DEFAULT_FLUSH_MS 5
+#define LOG_MESSAGE_SIZE 1024           // As in the synchronous path
+#define LOG_BATCH_SIZE (64 * 1024)
+
+typedef union log_arg {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void* p;
+    struct {
+        uint16_t offset;                // Of the copied string in text
+        uint16_t length;
+    } s;
+} log_arg_t;
+
+#define LOG_HEADER_SIZE (3 * sizeof(const char*) + 2 * sizeof(int32_t) + LOG_MAX_ARGS * sizeof(log_arg_t))
+
+typedef struct log_record {
+    const char* file;
+    const char* func;
+    const char* format;                 // NULL: text holds the formatted message
+    int32_t line;
+    uint8_t level;
+    uint8_t num_args;
+    uint16_t text_used;
+    log_arg_t args[LOG_MAX_ARGS];
+    char text[LOG_RECORD_SIZE - LOG_HEADER_SIZE];
+} log_record_t;
+
+typedef struct log_ring {
+    _Atomic uint64_t head;              // Next record to write (producer)
+    uint64_t cached_tail;               // Producer's last view of tail
+    char head_padding[SSSP_CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];
+    _Atomic uint64_t tail;              // Next record to read (drain thread)
+    char tail_padding[SSSP_CACHE_LINE_SIZE - sizeof(uint64_t)];
+    _Atomic uint64_t dropped;           // Written by the producer only
+    uint64_t reported;                  // Drops already reported (drain thread)
+    atomic_bool abandoned;              // The owning thread has exited
+    uint32_t mask;
+    log_record_t* records;
+    struct log_ring* next;
+} log_ring_t;
+
+// Conversion kinds
+typedef enum {
+    SPEC_INVALID,                       // Not supported: format synchronously
+    SPEC_PERCENT,
+    SPEC_SIGNED,
+    SPEC_UNSIGNED,
+    SPEC_CHAR,
+    SPEC_DOUBLE,
+    SPEC_STRING,
+    SPEC_POINTER
+} spec_kind_t;
+
+typedef enum { LENGTH_NONE, LENGTH_L, LENGTH_LL, LENGTH_Z, LENGTH_J, LENGTH_T, LENGTH_LONG_DOUBLE } length_t;
+
+typedef struct format_spec {
+    spec_kind_t kind;
+    length_t length;
+    bool star_width;
+    bool star_precision;
+    const char* flags_begin;            // After '%'
+    const char* length_begin;           // Length modifier, or the conversion if none
+    char conversion;
+} format_spec_t;
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;  // Registry, start and stop
+static _Atomic(log_ring_t*) g_rings;
+static atomic_bool g_running;
+static atomic_bool g_stop_requested;
+static atomic_uint g_pushing;           // Threads inside sssp_log_async_push()
+static pthread_t g_thread;
+static uint32_t g_ring_records = LOG_DEFAULT_RING_RECORDS;
+static uint32_t g_flush_interval_ms = LOG_DEFAULT_FLUSH_MS;
+static pthread_mutex_t g_wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wake = PTHREAD_COND_INITIALIZER;        // Drain thread: drain now
+static pthread_cond_t g_drained = PTHREAD_COND_INITIALIZER;     // Flushers: a pass finished
+static uint64_t g_passes;                                       // Drain passes, under g_wake_lock
+static bool g_flush_requested;                                  // Under g_wake_lock
+static _Atomic uint64_t g_written;
+static _Atomic uint64_t g_dropped_freed;     // Drops counted by rings already freed
+static pthread_key_t g_ring_key;
+static pthread_once_t g_key_once = PTHREAD_ONCE_INIT;
+static pthread_once_t g_atfork_once = PTHREAD_ONCE_INIT;
+static _Thread_local log_ring_t* t_ring;
+
+/*
+ * Format parsing, shared by capture and rendering
+ */
+
+// Parse the conversion after a '%' at p; returns the character after it
+static const char* parse_spec(const char* p, format_spec_t* spec) {
+    memset(spec, 0, sizeof(*spec));
+    spec->flags_begin = p;
+    while (*p && strchr("-+ #0", *p)) p++;
+    if (*p == '*') {
+        spec->star_width = true;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->star_precision = true;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') p++;
+        }
+    }
+
+    spec->length_begin = p;
+    if (p[0] == 'h') {
+        p += p[1] == 'h' ? 2 : 1;
+    } else if (p[0] == 'l') {
+        spec->length = p[1] == 'l' ? LENGTH_LL : LENGTH_L;
+        p += p[1] == 'l' ? 2 : 1;
+    } else if (*p == 'z' || *p == 'j' || *p == 't' || *p == 'L') {
+        spec->length = *p == 'z' ? LENGTH_Z : *p == 'j' ? LENGTH_J : *p == 't' ? LENGTH_T : LENGTH_LONG_DOUBLE;
+        p++;
+    }
+
+    spec->conversion = *p;
+    switch (*p) {
+        case '%': spec->kind = SPEC_PERCENT; break;
+        case 'd': case 'i': spec->kind = SPEC_SIGNED; break;
+        case 'u': case 'o': case 'x': case 'X': spec->kind = SPEC_UNSIGNED; break;
+        case 'c': spec->kind = spec->length == LENGTH_NONE ? SPEC_CHAR : SPEC_INVALID; break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec->kind = SPEC_DOUBLE;
+            break;
+        case 's': spec->kind = spec->length == LENGTH_NONE ? SPEC_STRING : SPEC_INVALID; break;
+        case 'p': spec->kind = SPEC_POINTER; break;
+        default: spec->kind = SPEC_INVALID; break;
+    }
+    return *p ? p + 1 : p;
+}
+
+static long long read_signed(length_t length, va_list* args) {
+    switch (length) {
+        case LENGTH_L: return va_arg(*args, long);
+        case LENGTH_LL: return va_arg(*args, long long);
+        case LENGTH_Z: case LENGTH_T: return va_arg(*args, ptrdiff_t);
+        case LENGTH_J: return va_arg(*args, intmax_t);
+        default: return va_arg(*args, int);
+    }
+}
+
+static unsigned long long read_unsigned(length_t length, va_list* args) {
+    switch (length) {
+        case LENGTH_L: return va_arg(*args, unsigned long);
+        case LENGTH_LL: return va_arg(*args, unsigned long long);
+        case LENGTH_Z: case LENGTH_T: return va_arg(*args, size_t);
+        case LENGTH_J: return va_arg(*args, uintmax_t);
+        default: return va_arg(*args, unsigned int);
+    }
+}
+
+/**
+ * Read the arguments of format into record; false if the format has a
+ * conversion records cannot hold, or its strings do not fit in the record
+ */
+static bool capture(log_record_t* record, const char* format, va_list* args) {
+    record->num_args = 0;
+    record->text_used = 0;
+    for (const char* p = format; *p; ) {
+        if (*p++ != '%') {
+            continue;
+        }
+        format_spec_t spec;
+        p = parse_spec(p, &spec);
+        if (spec.kind == SPEC_INVALID) {
+            return false;
+        }
+        if (spec.kind == SPEC_PERCENT) {
+            continue;
+        }
+        int needed = 1 + spec.star_width + spec.star_precision;
+        if (record->num_args + needed > LOG_MAX_ARGS) {
+            return false;
+        }
+        if (spec.star_width) {
+            record->args[record->num_args++].i = va_arg(*args, int);
+        }
+        if (spec.star_precision) {
+            record->args[record->num_args++].i = va_arg(*args, int);
+        }
+        log_arg_t* arg = &record->args[record->num_args++];
+        switch (spec.kind) {
+            case SPEC_SIGNED: arg->i = read_signed(spec.length, args); break;
+            case SPEC_UNSIGNED: arg->u = read_unsigned(spec.length, args); break;
+            case SPEC_CHAR: arg->i = va_arg(*args, int); break;
+            case SPEC_DOUBLE:
+                arg->d = spec.length == LENGTH_LONG_DOUBLE ? (double)va_arg(*args, long double)
+                                                           : va_arg(*args, double);
+                break;
+            case SPEC_POINTER: arg->p = va_arg(*args, void*); break;
+            case SPEC_STRING: {
+                // Copied, since the caller's string may not outlive the call
+                const char* string = va_arg(*args, const char*);
+                if (!string) {
+                    string = "(null)";
+                }
+                size_t room = sizeof(record->text) - record->text_used;
+                size_t length = strnlen(string, room);
+                if (length == room && string[length] != '\0') {
+                    return false;
+                }
+                memcpy(record->text + record->text_used, string, length);
+                arg->s.offset = record->text_used;
+                arg->s.length = (uint16_t)length;
+                record->text_used += (uint16_t)length;
+                break;
+            }
+            default: break;
+        }
+    }
+    return true;
+}
+
+// Append the formatted record to message (size LOG_MESSAGE_SIZE); returns its length
+static size_t render(const log_record_t* record, char* message) {
+    if (!record->format) {
+        size_t length = strnlen(record->text, sizeof(record->text));
+        memcpy(message, record->text, length);
+        message[length] = '\0';
+        return length;
+    }
+
+    size_t used = 0;
+    uint8_t next_arg = 0;
+    const char* p = record->format;
+    while (*p && used < LOG_MESSAGE_SIZE - 1) {
+        if (*p != '%') {
+            message[used++] = *p++;
+            continue;
+        }
+        format_spec_t spec;
+        const char* end = parse_spec(p + 1, &spec);
+        p = end;
+        if (spec.kind == SPEC_PERCENT) {
+            message[used++] = '%';
+            continue;
+        }
+
+        // Rebuild the conversion with '*' replaced by the captured values and
+        // integers widened to long long, matching how they were stored
+        char conversion[64];
+        size_t c = 0;
+        conversion[c++] = '%';
+        for (const char* q = spec.flags_begin; q < spec.length_begin && c < sizeof(conversion) - 24; q++) {
+            if (*q == '*') {
+                c += (size_t)snprintf(conversion + c, sizeof(conversion) - c, "%lld",
+                                      record->args[next_arg++].i);
+            } else {
+                conversion[c++] = *q;
+            }
+        }
+        if (spec.kind == SPEC_SIGNED || spec.kind == SPEC_UNSIGNED) {
+            conversion[c++] = 'l';
+            conversion[c++] = 'l';
+        }
+        conversion[c++] = spec.conversion;
+        conversion[c] = '\0';
+
+        const log_arg_t* arg = &record->args[next_arg++];
+        char* out = message + used;
+        size_t room = LOG_MESSAGE_SIZE - used;
+        int written = 0;
+        // conversion is one conversion of a format the compiler checked at the
+        // logging call, rebuilt to match the stored argument's type
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+        switch (spec.kind) {
+            case SPEC_SIGNED: written = snprintf(out, room, conversion, arg->i); break;
+            case SPEC_CHAR: written = snprintf(out, room, conversion, (int)arg->i); break;
+            case SPEC_UNSIGNED: written = snprintf(out, room, conversion, arg->u); break;
+            case SPEC_DOUBLE: written = snprintf(out, room, conversion, arg->d); break;
+            case SPEC_POINTER: written = snprintf(out, room, conversion, arg->p); break;
+            case SPEC_STRING: {
+                // Precision bounds the copy, which is not NUL-terminated
+                char string[sizeof(record->text) + 1];
+                memcpy(string, record->text + arg->s.offset, arg->s.length);
+                string[arg->s.length] = '\0';
+                written = snprintf(out, room, conversion, string);
+                break;
+            }
+            default: break;
+        }
+#pragma GCC diagnostic pop
+        if (written > 0) {
+            used += SSSP_MIN((size_t)written, room - 1);
+        }
+    }
+    message[used] = '\0';
+    return used;
+}
+
+/*
+ * Rings
+ */
+
+static void abandon_ring(void* ring) {
+    atomic_store(&((log_ring_t*)ring)->abandoned, true);
+}
+
+static void create_key(void) {
+    pthread_key_create(&g_ring_key, abandon_ring);
+}
+
+static log_ring_t* register_ring(void) {
+    pthread_once(&g_key_once, create_key);
+    log_ring_t* ring = sssp_alloc(&SSSP_DEFAULT_ALLOCATOR, sizeof(log_ring_t));
+    log_record_t* records = sssp_alloc(&SSSP_DEFAULT_ALLOCATOR, (size_t)g_ring_records * sizeof(log_record_t));
+    if (!ring || !records) {
+        sssp_free(&SSSP_DEFAULT_ALLOCATOR, ring);
+        sssp_free(&SSSP_DEFAULT_ALLOCATOR, records);
+        return NULL;
+    }
+    memset(ring, 0, sizeof(*ring));
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+    atomic_init(&ring->abandoned, false);
+    ring->mask = g_ring_records - 1;
+    ring->records = records;
+
+    pthread_mutex_lock(&g_lock);
+    ring->next = atomic_load(&g_rings);
+    atomic_store(&g_rings, ring);
+    pthread_mutex_unlock(&g_lock);
+    pthread_setspecific(g_ring_key, ring);
+    t_ring = ring;
+    return ring;
+}
+
+/**
+ * Queue a record on the calling thread's ring; false if the message does
+ * not fit in a record or no ring can be registered
+ */
+static bool push_record(sssp_log_level_t level, const char* file, int line,
+                        const char* func, const char* format, va_list args) {
+    log_ring_t* ring = t_ring;
+    if (SSSP_UNLIKELY(!ring) && !(ring = register_ring())) {
+        return false;
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - ring->cached_tail > ring->mask) {
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->cached_tail > ring->mask) {
+            atomic_store_explicit(&ring->dropped,
+                                  atomic_load_explicit(&ring->dropped, memory_order_relaxed) + 1,
+                                  memory_order_relaxed);
+            return true;
+        }
+    }
+
+    log_record_t* record = &ring->records[head & ring->mask];
+    record->file = file;
+    record->func = func;
+    record->line = line;
+    record->level = (uint8_t)level;
+    record->format = format;
+    va_list copy;
+    va_copy(copy, args);
+    bool captured = capture(record, format, &copy);
+    va_end(copy);
+    if (!captured) {
+        // Formatted now instead, unless that would truncate the message
+        record->format = NULL;
+        va_copy(copy, args);
+        int length = vsnprintf(record->text, sizeof(record->text), format, copy);
+        va_end(copy);
+        if (length < 0 || (size_t)length >= sizeof(record->text)) {
+            return false;
+        }
+    }
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool sssp_log_async_push(sssp_log_level_t level, const char* file, int line,
+                         const char* func, const char* format, va_list args) {
+    // sssp_log_async_stop() waits for pushes that saw the backend running,
+    // so none lands in a ring after the final drain
+    atomic_fetch_add(&g_pushing, 1);
+    bool pushed = atomic_load(&g_running) && push_record(level, file, line, func, format, args);
+    atomic_fetch_sub(&g_pushing, 1);
+    return pushed;
+}
+
+/*
+ * Fork handlers
+ */
+
+static void before_fork(void) {
+    pthread_mutex_lock(&g_lock);
+    pthread_mutex_lock(&g_wake_lock);
+}
+
+static void after_fork_parent(void) {
+    pthread_mutex_unlock(&g_wake_lock);
+    pthread_mutex_unlock(&g_lock);
+}
+
+static void after_fork_child(void) {
+    atomic_store(&g_running, false);
+    pthread_mutex_unlock(&g_wake_lock);
+    pthread_mutex_unlock(&g_lock);
+}
+
+static void register_fork_handlers(void) {
+    pthread_atfork(before_fork, after_fork_parent, after_fork_child);
+}
+
+/*
+ * Drain thread
+ */
+
+typedef struct log_batch {
+    char* data;
+    size_t used;
+} log_batch_t;
+
+static void batch_flush(log_batch_t* batch) {
+    if (batch->used > 0) {
+        fwrite(batch->data, 1, batch->used, stderr);
+        fflush(stderr);
+        batch->used = 0;
+    }
+}
+
+static void emit(log_batch_t* batch, sssp_log_level_t level, const char* file, int line,
+                 const char* func, const char* message) {
+    sssp_log_func_t log_func = sssp_log_get_function();
+    if (log_func) {
+        log_func(level, file, line, func, "%s", message);
+        return;
+    }
+    if (LOG_BATCH_SIZE - batch->used < LOG_MESSAGE_SIZE + 512) {
+        batch_flush(batch);
+    }
+    int written = snprintf(batch->data + batch->used, LOG_BATCH_SIZE - batch->used,
+                           "[%s] %s:%d in %s(): %s\n", sssp_log_level_name(level), file, line, func, message);
+    if (written > 0) {
+        batch->used += SSSP_MIN((size_t)written, LOG_BATCH_SIZE - batch->used - 1);
+    }
+}
+
+// Free abandoned rings that have been drained
+static void collect_abandoned(void) {
+    pthread_mutex_lock(&g_lock);
+    log_ring_t* head = atomic_load(&g_rings);
+    log_ring_t** link = &head;
+    while (*link) {
+        log_ring_t* ring = *link;
+        if (atomic_load(&ring->abandoned) &&
+            atomic_load(&ring->tail) == atomic_load(&ring->head)) {
+            *link = ring->next;
+            atomic_fetch_add(&g_dropped_freed, atomic_load(&ring->dropped));
+            sssp_free(&SSSP_DEFAULT_ALLOCATOR, ring->records);
+            sssp_free(&SSSP_DEFAULT_ALLOCATOR, ring);
+        } else {
+            link = &ring->next;
+        }
+    }
+    atomic_store(&g_rings, head);
+    pthread_mutex_unlock(&g_lock);
+}
+
+// Write out everything queued; returns the number of records drained
+static uint64_t drain(log_batch_t* batch, char* message) {
+    uint64_t drained = 0;
+    uint64_t dropped = 0;
+    for (log_ring_t* ring = atomic_load(&g_rings); ring; ring = ring->next) {
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        for (; tail != head; tail++) {
+            const log_record_t* record = &ring->records[tail & ring->mask];
+            render(record, message);
+            emit(batch, (sssp_log_level_t)record->level, record->file, record->line, record->func, message);
+            drained++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+        uint64_t ring_dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+        dropped += ring_dropped - ring->reported;
+        ring->reported = ring_dropped;
+    }
+    if (dropped > 0) {
+        snprintf(message, LOG_MESSAGE_SIZE, "%llu messages dropped by full log rings",
+                 (unsigned long long)dropped);
+        emit(batch, SSSP_LOG_WARN, __FILE__, __LINE__, __func__, message);
+    }
+    batch_flush(batch);
+    atomic_fetch_add(&g_written, drained);
+    return drained;
+}
+
+static void* drain_main(void* arg) {
+    log_batch_t* batch = arg;
+    char message[LOG_MESSAGE_SIZE];
+    for (;;) {
+        bool stopping = atomic_load(&g_stop_requested);
+        uint64_t drained = drain(batch, message);
+        if (drained == 0) {
+            collect_abandoned();
+        }
+
+        pthread_mutex_lock(&g_wake_lock);
+        g_passes++;
+        pthread_cond_broadcast(&g_drained);
+        if (stopping) {
+            pthread_mutex_unlock(&g_wake_lock);
+            break;
+        }
+        if (drained == 0 && !g_flush_requested && !atomic_load(&g_stop_requested)) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += g_flush_interval_ms / 1000;
+            deadline.tv_nsec += (long)(g_flush_interval_ms % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&g_wake, &g_wake_lock, &deadline);
+        }
+        g_flush_requested = false;
+        pthread_mutex_unlock(&g_wake_lock);
+    }
+    return NULL;
+}
+
+static log_batch_t g_batch;
+
+sssp_error_t sssp_log_async_start(const sssp_log_async_config_t* config) {
+    uint32_t ring_records = config && config->ring_records ? config->ring_records : LOG_DEFAULT_RING_RECORDS;
+    uint32_t interval = config && config->flush_interval_ms ? config->flush_interval_ms : LOG_DEFAULT_FLUSH_MS;
+    if (ring_records < 2 || (ring_records & (ring_records - 1)) != 0) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+
+    pthread_once(&g_atfork_once, register_fork_handlers);
+    pthread_mutex_lock(&g_lock);
+    sssp_error_t result = SSSP_SUCCESS;
+    if (!atomic_load(&g_running)) {
+        // Rings already registered keep their size
+        g_ring_records = ring_records;
+        g_flush_interval_ms = interval;
+        g_batch.data = sssp_alloc(&SSSP_DEFAULT_ALLOCATOR, LOG_BATCH_SIZE);
+        g_batch.used = 0;
+        atomic_store(&g_stop_requested, false);
+        if (!g_batch.data) {
+            result = SSSP_ERROR_OUT_OF_MEMORY;
+        } else if (pthread_create(&g_thread, NULL, drain_main, &g_batch) != 0) {
+            sssp_free(&SSSP_DEFAULT_ALLOCATOR, g_batch.data);
+            g_batch.data = NULL;
+            result = SSSP_ERROR_INTERNAL;
+        } else {
+            atomic_store(&g_running, true);
+        }
+    }
+    pthread_mutex_unlock(&g_lock);
+    return result;
+}
+
+void sssp_log_async_stop(void) {
+    pthread_mutex_lock(&g_lock);
+    bool running = atomic_exchange(&g_running, false);
+    pthread_mutex_unlock(&g_lock);
+    if (running) {
+        // Outside g_lock, which a push registering its ring may be waiting for
+        while (atomic_load(&g_pushing) != 0) {
+            sched_yield();
+        }
+        atomic_store(&g_stop_requested, true);
+        pthread_mutex_lock(&g_wake_lock);
+        pthread_cond_signal(&g_wake);
+        pthread_mutex_unlock(&g_wake_lock);
+
+        // The drain thread takes the lock to collect rings
+        pthread_join(g_thread, NULL);
+        sssp_free(&SSSP_DEFAULT_ALLOCATOR, g_batch.data);
+        g_batch.data = NULL;
+    }
+}
+
+void sssp_log_flush(void) {
+    // The second pass to finish from now started after this call, so it
+    // drains everything this thread logged before it
+    pthread_mutex_lock(&g_wake_lock);
+    uint64_t target = g_passes + 2;
+    while (atomic_load(&g_running) && g_passes < target) {
+        g_flush_requested = true;
+        pthread_cond_signal(&g_wake);
+        pthread_cond_wait(&g_drained, &g_wake_lock);
+    }
+    pthread_mutex_unlock(&g_wake_lock);
+}
+
+sssp_log_async_stats_t sssp_log_async_get_stats(void) {
+    sssp_log_async_stats_t stats;
+    stats.written = atomic_load(&g_written);
+    stats.dropped = atomic_load(&g_dropped_freed);
+    pthread_mutex_lock(&g_lock);
+    for (log_ring_t* ring = atomic_load(&g_rings); ring; ring = ring->next) {
+        stats.dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return stats;
+}
+
+#else // _WIN32
+
+sssp_error_t sssp_log_async_start(const sssp_log_async_config_t* config) {
+    (void)config;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+void sssp_log_async_stop(void) {
+}
+
+void sssp_log_flush(void) {
+}
+
+sssp_log_async_stats_t sssp_log_async_get_stats(void) {
+    sssp_log_async_stats_t stats = { 0, 0 };
+    return stats;
+}
+
+bool sssp_log_async_push(sssp_log_level_t level, const char* file, int line,
+                         const char* func, const char* format, va_list args) {
+    (void)level; (void)file; (void)line; (void)func; (void)format; (void)args;
+    return false;
+}
+
+#endif // _WIN32
@@ -0,0 +1,1564 @@
+/**
+ * @file distributed.c
+ * @brief Shard processes running bulk-synchronous delta-stepping
+ *
+ * Each superstep every shard either relaxes the light edges (weight <=
+ * delta) of the current bucket's vertices, or, once no shard has work left
+ * in the bucket, the heavy edges of the vertices the bucket settled. Then
+ * it sends every other shard one frame:
+ *
+ *   frame_header_t { messages, smallest non-empty bucket, flags }
+ *   relax_message_t[messages]
+ *
+ * The header reports the shard's own buckets and the buckets of the
+ * messages it sends, so merging all headers tells every shard whether the
+ * current bucket has more light work anywhere and, after a heavy step,
+ * which bucket comes next. A solve ends after a heavy step when no bucket
+ * anywhere is non-empty.
+ *
+ * The creating process talks to each shard over a control socket:
+ * commands are control_command_t, replies control_reply_t, and a gather
+ * reply is followed by the shard's distances and predecessors. A solve's
+ * deadline travels with its command, and a cancellation is relayed through
+ * a flag in memory shared with the shards; each shard checks both once per
+ * superstep and reports them in its frame header, so all shards give up in
+ * the same superstep.
+ *
+ * Shards are forked from the creating process, which may have other
+ * threads. A child only has the forking thread, so nothing a shard does
+ * may wait on a lock another thread could have held at the fork: the graph
+ * structures it reads are built before forking, and the asynchronous log
+ * backend falls back to synchronous logging in the child.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE     // MAP_ANONYMOUS
+
+#include "distributed.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#endif
+
+// Bucket a vertex is not queued in
+#define NO_BUCKET UINT64_MAX
+
+// Largest ring of buckets; smaller deltas are rejected
+#define MAX_BUCKET_SLOTS ((uint64_t)1 << 24)
+
+// Smallest shared-memory ring
+#define MIN_RING_CAPACITY ((size_t)4096)
+
+// How often a solve given a cancellation token looks at it, in milliseconds
+#define CANCEL_POLL_MS 1
+
+sssp_cluster_config_t sssp_cluster_config_default(uint32_t num_shards,
+                                                  const sssp_allocator_t* allocator) {
+    sssp_cluster_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.num_shards = num_shards;
+    config.transport = NULL;
+    config.channel_capacity = 0;
+    config.delta = 0.0;
+    config.allocator = allocator;
+    return config;
+}
+
+#ifndef _WIN32
+
+// ============================================================================
+// Unix socket transport
+// ============================================================================
+
+typedef struct socket_transport {
+    uint32_t num_shards;
+    uint32_t shard;                     // Attached shard
+    int* fds;                           // fds[i * num_shards + j]: shard i's end of its socket to j
+    struct pollfd* polls;
+    const sssp_allocator_t* allocator;
+} socket_transport_t;
+
+static void socket_destroy(void* state) {
+    socket_transport_t* transport = state;
+    if (!transport) {
+        return;
+    }
+    if (transport->fds) {
+        size_t count = (size_t)transport->num_shards * transport->num_shards;
+        for (size_t i = 0; i < count; i++) {
+            if (transport->fds[i] >= 0) {
+                close(transport->fds[i]);
+            }
+        }
+    }
+    sssp_free(transport->allocator, transport->fds);
+    sssp_free(transport->allocator, transport->polls);
+    sssp_free(transport->allocator, transport);
+}
+
+static sssp_error_t socket_create(uint32_t num_shards, size_t channel_capacity,
+                                  const sssp_allocator_t* allocator, void** state_out) {
+    socket_transport_t* transport = sssp_alloc(allocator, sizeof(socket_transport_t));
+    if (!transport) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    size_t count = (size_t)num_shards * num_shards;
+    transport->num_shards = num_shards;
+    transport->shard = num_shards;
+    transport->allocator = allocator;
+    transport->fds = sssp_alloc(allocator, count * sizeof(int));
+    transport->polls = sssp_alloc(allocator, num_shards * sizeof(struct pollfd));
+    if (!transport->fds || !transport->polls) {
+        sssp_free(allocator, transport->fds);
+        transport->fds = NULL;
+        socket_destroy(transport);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < count; i++) {
+        transport->fds[i] = -1;
+    }
+
+    int buffer_size = (int)SSSP_MIN(channel_capacity, (size_t)1 << 30);
+    for (uint32_t i = 0; i < num_shards; i++) {
+        for (uint32_t j = i + 1; j < num_shards; j++) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+                SSSP_LOG_ERROR("socketpair failed: %s", strerror(errno));
+                socket_destroy(transport);
+                return SSSP_ERROR_IO;
+            }
+            transport->fds[(size_t)i * num_shards + j] = pair[0];
+            transport->fds[(size_t)j * num_shards + i] = pair[1];
+            for (int k = 0; buffer_size > 0 && k < 2; k++) {
+                // Only a hint; the kernel may clamp it
+                setsockopt(pair[k], SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+                setsockopt(pair[k], SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+            }
+        }
+    }
+    *state_out = transport;
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t socket_attach(void* state, uint32_t shard) {
+    socket_transport_t* transport = state;
+    uint32_t p = transport->num_shards;
+    transport->shard = shard;
+    for (uint32_t i = 0; i < p; i++) {
+        for (uint32_t j = 0; j < p; j++) {
+            int* fd = &transport->fds[(size_t)i * p + j];
+            if (*fd < 0) {
+                continue;
+            }
+            if (i != shard) {
+                close(*fd);
+                *fd = -1;
+            } else if (fcntl(*fd, F_SETFL, fcntl(*fd, F_GETFL) | O_NONBLOCK) != 0) {
+                return SSSP_ERROR_IO;
+            }
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t socket_send(void* state, uint32_t peer, const void* data, size_t size, size_t* sent) {
+    socket_transport_t* transport = state;
+    int fd = transport->fds[(size_t)transport->shard * transport->num_shards + peer];
+    ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0) {
+        *sent = 0;
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? SSSP_SUCCESS : SSSP_ERROR_IO;
+    }
+    *sent = (size_t)n;
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t socket_receive(void* state, uint32_t peer, void* data, size_t size, size_t* received) {
+    socket_transport_t* transport = state;
+    int fd = transport->fds[(size_t)transport->shard * transport->num_shards + peer];
+    ssize_t n = recv(fd, data, size, 0);
+    if (n < 0) {
+        *received = 0;
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? SSSP_SUCCESS : SSSP_ERROR_IO;
+    }
+    *received = (size_t)n;
+    // A closed peer reads as end of stream
+    return n == 0 && size > 0 ? SSSP_ERROR_IO : SSSP_SUCCESS;
+}
+
+static void socket_wait(void* state, const bool* sending, const bool* receiving) {
+    socket_transport_t* transport = state;
+    nfds_t count = 0;
+    for (uint32_t peer = 0; peer < transport->num_shards; peer++) {
+        short events = (short)((sending[peer] ? POLLOUT : 0) | (receiving[peer] ? POLLIN : 0));
+        if (events) {
+            transport->polls[count].fd = transport->fds[(size_t)transport->shard * transport->num_shards + peer];
+            transport->polls[count].events = events;
+            transport->polls[count].revents = 0;
+            count++;
+        }
+    }
+    if (count > 0) {
+        poll(transport->polls, count, -1);
+    }
+}
+
+static const sssp_transport_ops_t g_socket_transport = {
+    "unix-socket",
+    socket_create,
+    socket_attach,
+    socket_send,
+    socket_receive,
+    socket_wait,
+    socket_destroy
+};
+
+const sssp_transport_ops_t* sssp_transport_unix_socket(void) {
+    return &g_socket_transport;
+}
+
+// ============================================================================
+// Shared-memory transport
+// ============================================================================
+
+/**
+ * Counters of one ring, on separate cache lines. The data follows.
+ */
+typedef struct shm_ring {
+    size_t head;                        // Bytes written, advanced by the sender
+    char head_padding[SSSP_CACHE_LINE_SIZE - sizeof(size_t)];
+    size_t tail;                        // Bytes read, advanced by the receiver
+    char tail_padding[SSSP_CACHE_LINE_SIZE - sizeof(size_t)];
+} shm_ring_t;
+
+typedef struct shm_transport {
+    uint32_t num_shards;
+    uint32_t shard;                     // Attached shard
+    size_t capacity;                    // Ring data bytes, a power of two
+    size_t ring_size;                   // Counters plus data
+    unsigned char* region;              // num_shards^2 rings, mapped shared
+    size_t region_size;
+    const sssp_allocator_t* allocator;
+} shm_transport_t;
+
+static shm_ring_t* shm_ring(const shm_transport_t* transport, uint32_t from, uint32_t to) {
+    size_t index = (size_t)from * transport->num_shards + to;
+    return (shm_ring_t*)(transport->region + index * transport->ring_size);
+}
+
+static void shm_destroy(void* state) {
+    shm_transport_t* transport = state;
+    if (!transport) {
+        return;
+    }
+    if (transport->region) {
+        munmap(transport->region, transport->region_size);
+    }
+    sssp_free(transport->allocator, transport);
+}
+
+static sssp_error_t shm_create(uint32_t num_shards, size_t channel_capacity,
+                               const sssp_allocator_t* allocator, void** state_out) {
+    shm_transport_t* transport = sssp_alloc(allocator, sizeof(shm_transport_t));
+    if (!transport) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    size_t capacity = MIN_RING_CAPACITY;
+    while (capacity < channel_capacity) {
+        capacity <<= 1;
+    }
+    transport->num_shards = num_shards;
+    transport->shard = num_shards;
+    transport->capacity = capacity;
+    transport->ring_size = sizeof(shm_ring_t) + capacity;
+    transport->region_size = (size_t)num_shards * num_shards * transport->ring_size;
+    transport->allocator = allocator;
+    transport->region = mmap(NULL, transport->region_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (transport->region == MAP_FAILED) {
+        SSSP_LOG_ERROR("Cannot map %zu bytes of rings: %s", transport->region_size, strerror(errno));
+        transport->region = NULL;
+        shm_destroy(transport);
+        return SSSP_ERROR_IO;
+    }
+    *state_out = transport;
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t shm_attach(void* state, uint32_t shard) {
+    ((shm_transport_t*)state)->shard = shard;
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t shm_send(void* state, uint32_t peer, const void* data, size_t size, size_t* sent) {
+    shm_transport_t* transport = state;
+    shm_ring_t* ring = shm_ring(transport, transport->shard, peer);
+    unsigned char* buffer = (unsigned char*)(ring + 1);
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    size_t n = SSSP_MIN(size, transport->capacity - (head - tail));
+    size_t offset = head & (transport->capacity - 1);
+    size_t first = SSSP_MIN(n, transport->capacity - offset);
+    memcpy(buffer + offset, data, first);
+    memcpy(buffer, (const unsigned char*)data + first, n - first);
+    __atomic_store_n(&ring->head, head + n, __ATOMIC_RELEASE);
+    *sent = n;
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t shm_receive(void* state, uint32_t peer, void* data, size_t size, size_t* received) {
+    shm_transport_t* transport = state;
+    shm_ring_t* ring = shm_ring(transport, peer, transport->shard);
+    const unsigned char* buffer = (const unsigned char*)(ring + 1);
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    size_t n = SSSP_MIN(size, head - tail);
+    size_t offset = tail & (transport->capacity - 1);
+    size_t first = SSSP_MIN(n, transport->capacity - offset);
+    memcpy(data, buffer + offset, first);
+    memcpy((unsigned char*)data + first, buffer, n - first);
+    __atomic_store_n(&ring->tail, tail + n, __ATOMIC_RELEASE);
+    *received = n;
+    return SSSP_SUCCESS;
+}
+
+static void shm_wait(void* state, const bool* sending, const bool* receiving) {
+    (void)state;
+    (void)sending;
+    (void)receiving;
+    sched_yield();
+}
+
+static const sssp_transport_ops_t g_shm_transport = {
+    "shared-memory",
+    shm_create,
+    shm_attach,
+    shm_send,
+    shm_receive,
+    shm_wait,
+    shm_destroy
+};
+
+const sssp_transport_ops_t* sssp_transport_shared_memory(void) {
+    return &g_shm_transport;
+}
+
+// ============================================================================
+// Cluster and control protocol
+// ============================================================================
+
+struct sssp_cluster {
+    uint32_t num_shards;
+    vertex_count_t num_vertices;
+    vertex_id_t* bounds;                // Shard i owns [bounds[i], bounds[i + 1])
+    pid_t* pids;
+    int* control;                       // Creating process's end of each control socket
+    const sssp_transport_ops_t* transport;
+    void* transport_state;              // Valid until the shards are started
+    uint32_t* cancel;                   // Shared with the shards; set to stop the solve
+    distance_t delta;
+    uint64_t num_slots;                 // Buckets that can hold vertices at once
+    bool solved;
+    bool failed;                        // A shard was lost; the rest were killed
+    sssp_cluster_stats_t stats;
+    const sssp_allocator_t* allocator;
+};
+
+typedef enum {
+    CONTROL_SOLVE = 1,
+    CONTROL_GATHER,
+    CONTROL_QUERY,
+    CONTROL_STOP
+} control_op_t;
+
+typedef struct control_command {
+    uint32_t op;
+    vertex_id_t vertex;                 // Source of a solve, vertex of a query
+    uint64_t deadline_ns;               // Of a solve (0: none)
+} control_command_t;
+
+typedef struct control_reply {
+    int32_t error;
+    uint32_t supersteps;
+    uint32_t buckets;
+    vertex_id_t predecessor;            // Query answer
+    distance_t distance;                // Query answer
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t scans;
+    uint64_t relaxations;
+} control_reply_t;
+
+static sssp_error_t write_all(int fd, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    while (size > 0) {
+        ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return SSSP_ERROR_IO;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t read_all(int fd, void* data, size_t size) {
+    unsigned char* bytes = data;
+    while (size > 0) {
+        ssize_t n = recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return SSSP_ERROR_IO;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Shard owning vertex: the last range starting at or before it
+ */
+static uint32_t owner_of(const vertex_id_t* bounds, uint32_t num_shards, vertex_id_t vertex) {
+    uint32_t low = 0;
+    uint32_t high = num_shards;
+    while (high - low > 1) {
+        uint32_t mid = (low + high) / 2;
+        if (vertex >= bounds[mid]) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// ============================================================================
+// Shard
+// ============================================================================
+
+typedef struct vertex_array {
+    vertex_id_t* items;
+    size_t size;
+    size_t capacity;
+} vertex_array_t;
+
+/**
+ * Frame buffer; done counts the bytes sent or received so far
+ */
+typedef struct channel {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    size_t done;
+} channel_t;
+
+typedef struct frame_header {
+    uint64_t count;                     // Relaxation messages that follow
+    uint64_t min_bucket;                // Smallest bucket the sender queued or sent to
+    uint32_t flags;
+    uint32_t reserved;
+} frame_header_t;
+
+// The sender has light work left in the current bucket, or sent some
+#define FRAME_LIGHT_PENDING 1u
+// The sender ran out of memory; every shard abandons the solve
+#define FRAME_FAILED 2u
+// The sender saw the solve's deadline pass
+#define FRAME_EXPIRED 4u
+// The sender saw the solve cancelled
+#define FRAME_CANCELLED 8u
+
+typedef struct relax_message {
+    vertex_id_t target;
+    vertex_id_t predecessor;
+    distance_t distance;
+} relax_message_t;
+
+typedef struct shard {
+    uint32_t index;
+    uint32_t num_shards;
+    const vertex_id_t* bounds;
+    vertex_id_t begin;                  // First owned vertex
+    vertex_count_t count;               // Owned vertices
+    distance_t delta;
+
+    // Out-edges of owned vertices, light edges first
+    edge_count_t* offsets;
+    edge_count_t* heavy;                // First heavy edge of each vertex
+    vertex_id_t* targets;
+    weight_t* weights;
+
+    distance_t* distances;
+    vertex_id_t* predecessors;
+    uint64_t* queued;                   // Bucket each vertex is queued in
+    uint64_t* settled;                  // Bucket whose light steps last scanned each vertex
+    vertex_array_t* slots;              // Bucket b lives in slots[b % num_slots]
+    uint64_t num_slots;
+    uint64_t bucket;                    // Current bucket
+    vertex_array_t frontier;
+    vertex_array_t settled_list;        // Vertices scanned in the current bucket
+
+    channel_t* out;
+    channel_t* in;
+    bool* sending;
+    bool* receiving;
+    const sssp_transport_ops_t* transport;
+    void* transport_state;
+    const uint32_t* cancel;             // Set by the creating process
+    uint64_t deadline_ns;               // Of the current solve (0: none)
+
+    uint64_t sent_min_bucket;           // Smallest bucket messages went to this superstep
+    bool sent_current;                  // Whether any went to the current bucket
+    sssp_error_t error;
+    bool solved;
+
+    uint32_t supersteps;
+    uint32_t buckets;
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t scans;
+    uint64_t relaxations;
+    const sssp_allocator_t* allocator;
+} shard_t;
+
+static bool vertex_array_push(vertex_array_t* array, vertex_id_t vertex, const sssp_allocator_t* allocator) {
+    if (array->size == array->capacity) {
+        size_t capacity = array->capacity ? array->capacity * 2 : SSSP_INITIAL_CAPACITY;
+        vertex_id_t* items = sssp_realloc(allocator, array->items, capacity * sizeof(vertex_id_t));
+        if (!items) {
+            return false;
+        }
+        array->items = items;
+        array->capacity = capacity;
+    }
+    array->items[array->size++] = vertex;
+    return true;
+}
+
+static bool channel_reserve(channel_t* channel, size_t size, const sssp_allocator_t* allocator) {
+    if (size <= channel->capacity) {
+        return true;
+    }
+    size_t capacity = SSSP_MAX(channel->capacity * 2, size);
+    unsigned char* data = sssp_realloc(allocator, channel->data, capacity);
+    if (!data) {
+        return false;
+    }
+    channel->data = data;
+    channel->capacity = capacity;
+    return true;
+}
+
+static void shard_destroy(shard_t* shard) {
+    const sssp_allocator_t* allocator = shard->allocator;
+    sssp_free(allocator, shard->offsets);
+    sssp_free(allocator, shard->heavy);
+    sssp_free(allocator, shard->targets);
+    sssp_free(allocator, shard->weights);
+    sssp_free(allocator, shard->distances);
+    sssp_free(allocator, shard->predecessors);
+    sssp_free(allocator, shard->queued);
+    sssp_free(allocator, shard->settled);
+    if (shard->slots) {
+        for (uint64_t i = 0; i < shard->num_slots; i++) {
+            sssp_free(allocator, shard->slots[i].items);
+        }
+    }
+    sssp_free(allocator, shard->slots);
+    sssp_free(allocator, shard->frontier.items);
+    sssp_free(allocator, shard->settled_list.items);
+    for (uint32_t p = 0; p < shard->num_shards; p++) {
+        if (shard->out) sssp_free(allocator, shard->out[p].data);
+        if (shard->in) sssp_free(allocator, shard->in[p].data);
+    }
+    sssp_free(allocator, shard->out);
+    sssp_free(allocator, shard->in);
+    sssp_free(allocator, shard->sending);
+    sssp_free(allocator, shard->receiving);
+}
+
+/**
+ * Append the light or heavy out-edges of u
+ */
+static void copy_edges(shard_t* shard, const sssp_graph_t* graph, vertex_id_t u, bool light, edge_count_t* e) {
+    const vertex_id_t* targets;
+    const weight_t* weights;
+    edge_count_t degree;
+    if (sssp_graph_neighbors(graph, u, &targets, &weights, &degree) != SSSP_SUCCESS) {
+        return;
+    }
+    for (edge_count_t i = 0; i < degree; i++) {
+        if ((weights[i] <= shard->delta) == light) {
+            shard->targets[*e] = targets[i];
+            shard->weights[*e] = weights[i];
+            (*e)++;
+        }
+    }
+}
+
+/**
+ * Copy the shard's part of graph and allocate its state
+ */
+static sssp_error_t shard_init(shard_t* shard, const sssp_cluster_t* cluster, uint32_t index,
+                               const sssp_graph_t* graph) {
+    const sssp_allocator_t* allocator = cluster->allocator;
+    memset(shard, 0, sizeof(*shard));
+    shard->index = index;
+    shard->num_shards = cluster->num_shards;
+    shard->bounds = cluster->bounds;
+    shard->begin = cluster->bounds[index];
+    shard->count = cluster->bounds[index + 1] - shard->begin;
+    shard->delta = cluster->delta;
+    shard->num_slots = cluster->num_slots;
+    shard->transport = cluster->transport;
+    shard->transport_state = cluster->transport_state;
+    shard->cancel = cluster->cancel;
+    shard->allocator = allocator;
+
+    edge_count_t num_edges = 0;
+    for (vertex_count_t v = 0; v < shard->count; v++) {
+        num_edges += sssp_graph_out_degree(graph, shard->begin + v);
+    }
+
+    size_t n = SSSP_MAX(shard->count, 1);
+    uint32_t p = shard->num_shards;
+    shard->offsets = sssp_alloc(allocator, (n + 1) * sizeof(edge_count_t));
+    shard->heavy = sssp_alloc(allocator, n * sizeof(edge_count_t));
+    shard->targets = sssp_alloc(allocator, SSSP_MAX(num_edges, 1) * sizeof(vertex_id_t));
+    shard->weights = sssp_alloc(allocator, SSSP_MAX(num_edges, 1) * sizeof(weight_t));
+    shard->distances = sssp_alloc(allocator, n * sizeof(distance_t));
+    shard->predecessors = sssp_alloc(allocator, n * sizeof(vertex_id_t));
+    shard->queued = sssp_alloc(allocator, n * sizeof(uint64_t));
+    shard->settled = sssp_alloc(allocator, n * sizeof(uint64_t));
+    shard->slots = sssp_alloc(allocator, shard->num_slots * sizeof(vertex_array_t));
+    shard->out = sssp_alloc(allocator, p * sizeof(channel_t));
+    shard->in = sssp_alloc(allocator, p * sizeof(channel_t));
+    shard->sending = sssp_alloc(allocator, p * sizeof(bool));
+    shard->receiving = sssp_alloc(allocator, p * sizeof(bool));
+    if (shard->slots) memset(shard->slots, 0, shard->num_slots * sizeof(vertex_array_t));
+    if (shard->out) memset(shard->out, 0, p * sizeof(channel_t));
+    if (shard->in) memset(shard->in, 0, p * sizeof(channel_t));
+    if (!shard->offsets || !shard->heavy || !shard->targets || !shard->weights ||
+        !shard->distances || !shard->predecessors || !shard->queued || !shard->settled ||
+        !shard->slots || !shard->out || !shard->in || !shard->sending || !shard->receiving) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t peer = 0; peer < p; peer++) {
+        if (!channel_reserve(&shard->out[peer], sizeof(frame_header_t), allocator) ||
+            !channel_reserve(&shard->in[peer], sizeof(frame_header_t), allocator)) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    edge_count_t e = 0;
+    for (vertex_count_t v = 0; v < shard->count; v++) {
+        shard->offsets[v] = e;
+        copy_edges(shard, graph, shard->begin + v, true, &e);
+        shard->heavy[v] = e;
+        copy_edges(shard, graph, shard->begin + v, false, &e);
+    }
+    shard->offsets[shard->count] = e;
+    return SSSP_SUCCESS;
+}
+
+static void enqueue(shard_t* shard, vertex_id_t local, distance_t distance) {
+    uint64_t bucket = (uint64_t)(distance / shard->delta);
+    if (shard->queued[local] == bucket) {
+        return;
+    }
+    shard->queued[local] = bucket;
+    if (!vertex_array_push(&shard->slots[bucket % shard->num_slots], local, shard->allocator)) {
+        shard->error = SSSP_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+/**
+ * Relax an edge of owned vertex u: locally, or by a message to the owner
+ */
+static void relax(shard_t* shard, vertex_id_t u, distance_t distance, vertex_id_t target) {
+    vertex_id_t local = target - shard->begin;
+    if (local < shard->count) {
+        if (distance < shard->distances[local]) {
+            shard->distances[local] = distance;
+            shard->predecessors[local] = u;
+            enqueue(shard, local, distance);
+        }
+        return;
+    }
+
+    channel_t* out = &shard->out[owner_of(shard->bounds, shard->num_shards, target)];
+    if (!channel_reserve(out, out->size + sizeof(relax_message_t), shard->allocator)) {
+        shard->error = SSSP_ERROR_OUT_OF_MEMORY;
+        return;
+    }
+    relax_message_t message = { target, u, distance };
+    memcpy(out->data + out->size, &message, sizeof(message));
+    out->size += sizeof(message);
+
+    uint64_t bucket = (uint64_t)(distance / shard->delta);
+    shard->sent_min_bucket = SSSP_MIN(shard->sent_min_bucket, bucket);
+    shard->sent_current |= bucket == shard->bucket;
+    shard->messages++;
+}
+
+static void relax_edges(shard_t* shard, vertex_id_t local, edge_count_t begin, edge_count_t end) {
+    vertex_id_t u = shard->begin + local;
+    distance_t distance = shard->distances[local];
+    for (edge_count_t e = begin; e < end; e++) {
+        relax(shard, u, distance + shard->weights[e], shard->targets[e]);
+    }
+    shard->relaxations += end - begin;
+}
+
+/**
+ * Scan the current bucket's vertices over their light edges
+ */
+static void light_step(shard_t* shard) {
+    vertex_array_t* slot = &shard->slots[shard->bucket % shard->num_slots];
+    vertex_array_t frontier = *slot;
+    *slot = shard->frontier;
+    slot->size = 0;
+
+    for (size_t i = 0; i < frontier.size; i++) {
+        vertex_id_t v = frontier.items[i];
+        if (shard->queued[v] != shard->bucket) {
+            continue;                   // Moved to a smaller bucket since
+        }
+        shard->queued[v] = NO_BUCKET;
+        if (shard->settled[v] != shard->bucket) {
+            shard->settled[v] = shard->bucket;
+            if (!vertex_array_push(&shard->settled_list, v, shard->allocator)) {
+                shard->error = SSSP_ERROR_OUT_OF_MEMORY;
+            }
+        }
+        shard->scans++;
+        relax_edges(shard, v, shard->offsets[v], shard->heavy[v]);
+    }
+    shard->frontier = frontier;
+    shard->frontier.size = 0;
+}
+
+/**
+ * Relax the heavy edges of the vertices the current bucket settled
+ */
+static void heavy_step(shard_t* shard) {
+    for (size_t i = 0; i < shard->settled_list.size; i++) {
+        vertex_id_t v = shard->settled_list.items[i];
+        relax_edges(shard, v, shard->heavy[v], shard->offsets[v + 1]);
+    }
+    shard->settled_list.size = 0;
+}
+
+/**
+ * Smallest non-empty bucket from the current one on
+ *
+ * Queued vertices are never more than num_slots - 1 buckets ahead, so one
+ * pass over the ring finds it.
+ */
+static uint64_t next_local_bucket(const shard_t* shard) {
+    for (uint64_t i = 0; i < shard->num_slots; i++) {
+        if (shard->slots[(shard->bucket + i) % shard->num_slots].size > 0) {
+            return shard->bucket + i;
+        }
+    }
+    return NO_BUCKET;
+}
+
+/**
+ * Send every out frame and receive one frame from every peer
+ */
+static sssp_error_t exchange(shard_t* shard) {
+    const size_t header_size = sizeof(frame_header_t);
+    size_t pending = 0;
+    for (uint32_t peer = 0; peer < shard->num_shards; peer++) {
+        bool active = peer != shard->index;
+        shard->sending[peer] = active;
+        shard->receiving[peer] = active;
+        shard->out[peer].done = 0;
+        shard->in[peer].done = 0;
+        shard->in[peer].size = header_size;
+        pending += active ? 2 : 0;
+        shard->bytes += active ? shard->out[peer].size : 0;
+    }
+
+    while (pending > 0) {
+        bool progress = false;
+        for (uint32_t peer = 0; peer < shard->num_shards; peer++) {
+            size_t moved = 0;
+            if (shard->sending[peer]) {
+                channel_t* out = &shard->out[peer];
+                sssp_error_t error = shard->transport->send(shard->transport_state, peer,
+                                                            out->data + out->done,
+                                                            out->size - out->done, &moved);
+                if (error != SSSP_SUCCESS) {
+                    return error;
+                }
+                out->done += moved;
+                progress |= moved > 0;
+                if (out->done == out->size) {
+                    shard->sending[peer] = false;
+                    pending--;
+                }
+            }
+            if (shard->receiving[peer]) {
+                channel_t* in = &shard->in[peer];
+                sssp_error_t error = shard->transport->receive(shard->transport_state, peer,
+                                                               in->data + in->done,
+                                                               in->size - in->done, &moved);
+                if (error != SSSP_SUCCESS) {
+                    return error;
+                }
+                in->done += moved;
+                progress |= moved > 0;
+                if (moved > 0 && in->done == header_size && in->size == header_size) {
+                    frame_header_t header;
+                    memcpy(&header, in->data, header_size);
+                    in->size = header_size + header.count * sizeof(relax_message_t);
+                    if (!channel_reserve(in, in->size, shard->allocator)) {
+                        return SSSP_ERROR_OUT_OF_MEMORY;
+                    }
+                }
+                if (in->done == in->size) {
+                    shard->receiving[peer] = false;
+                    pending--;
+                }
+            }
+        }
+        if (!progress && pending > 0) {
+            shard->transport->wait(shard->transport_state, shard->sending, shard->receiving);
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+/**
+ * One superstep: local work, exchange, apply the messages received
+ *
+ * merged receives the headers of all shards combined, this one included.
+ */
+static sssp_error_t superstep(shard_t* shard, bool heavy, frame_header_t* merged) {
+    for (uint32_t peer = 0; peer < shard->num_shards; peer++) {
+        shard->out[peer].size = sizeof(frame_header_t);
+    }
+    shard->sent_min_bucket = NO_BUCKET;
+    shard->sent_current = false;
+
+    if (heavy) {
+        heavy_step(shard);
+    } else {
+        light_step(shard);
+    }
+
+    frame_header_t own;
+    memset(&own, 0, sizeof(own));
+    own.min_bucket = SSSP_MIN(next_local_bucket(shard), shard->sent_min_bucket);
+    if (!heavy && (shard->slots[shard->bucket % shard->num_slots].size > 0 || shard->sent_current)) {
+        own.flags |= FRAME_LIGHT_PENDING;
+    }
+    if (shard->error != SSSP_SUCCESS) {
+        own.flags |= FRAME_FAILED;
+    }
+    if (__atomic_load_n(shard->cancel, __ATOMIC_ACQUIRE) != 0) {
+        own.flags |= FRAME_CANCELLED;
+    } else if (sssp_check_query_limits(shard->deadline_ns, NULL) == SSSP_ERROR_TIMEOUT) {
+        own.flags |= FRAME_EXPIRED;
+    }
+    for (uint32_t peer = 0; peer < shard->num_shards; peer++) {
+        frame_header_t header = own;
+        header.count = (shard->out[peer].size - sizeof(frame_header_t)) / sizeof(relax_message_t);
+        memcpy(shard->out[peer].data, &header, sizeof(header));
+    }
+
+    sssp_error_t error = exchange(shard);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+    shard->supersteps++;
+
+    *merged = own;
+    for (uint32_t peer = 0; peer < shard->num_shards; peer++) {
+        if (peer == shard->index) {
+            continue;
+        }
+        const channel_t* in = &shard->in[peer];
+        frame_header_t header;
+        memcpy(&header, in->data, sizeof(header));
+        merged->min_bucket = SSSP_MIN(merged->min_bucket, header.min_bucket);
+        merged->flags |= header.flags;
+
+        for (uint64_t i = 0; i < header.count; i++) {
+            relax_message_t message;
+            memcpy(&message, in->data + sizeof(header) + i * sizeof(message), sizeof(message));
+            vertex_id_t local = message.target - shard->begin;
+            if (message.distance < shard->distances[local]) {
+                shard->distances[local] = message.distance;
+                shard->predecessors[local] = message.predecessor;
+                enqueue(shard, local, message.distance);
+            }
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t shard_solve(shard_t* shard, vertex_id_t source) {
+    for (vertex_count_t v = 0; v < shard->count; v++) {
+        shard->distances[v] = SSSP_INFINITY;
+        shard->predecessors[v] = SSSP_INVALID_VERTEX;
+        shard->queued[v] = NO_BUCKET;
+        shard->settled[v] = NO_BUCKET;
+    }
+    for (uint64_t i = 0; i < shard->num_slots; i++) {
+        shard->slots[i].size = 0;
+    }
+    shard->settled_list.size = 0;
+    shard->bucket = 0;
+    shard->error = SSSP_SUCCESS;
+    shard->solved = false;
+    shard->supersteps = 0;
+    shard->buckets = 0;
+    shard->messages = 0;
+    shard->bytes = 0;
+    shard->scans = 0;
+    shard->relaxations = 0;
+
+    if (source - shard->begin < shard->count) {
+        shard->distances[source - shard->begin] = 0.0;
+        enqueue(shard, source - shard->begin, 0.0);
+    }
+
+    bool heavy = false;
+    for (;;) {
+        frame_header_t merged;
+        sssp_error_t error = superstep(shard, heavy, &merged);
+        if (error != SSSP_SUCCESS) {
+            return error;
+        }
+        if (merged.flags & FRAME_FAILED) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        if (merged.flags & FRAME_CANCELLED) {
+            return SSSP_ERROR_CANCELLED;
+        }
+        if (merged.flags & FRAME_EXPIRED) {
+            return SSSP_ERROR_TIMEOUT;
+        }
+        if (!heavy) {
+            heavy = !(merged.flags & FRAME_LIGHT_PENDING);
+            continue;
+        }
+        shard->buckets++;
+        if (merged.min_bucket == NO_BUCKET) {
+            break;
+        }
+        shard->bucket = merged.min_bucket;
+        heavy = false;
+    }
+    shard->solved = true;
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Body of a shard process; never returns
+ */
+static void shard_main(const sssp_cluster_t* cluster, uint32_t index, const sssp_graph_t* graph, int control) {
+    shard_t shard;
+    sssp_error_t error = cluster->transport->attach(cluster->transport_state, index);
+    if (error == SSSP_SUCCESS) {
+        error = shard_init(&shard, cluster, index, graph);
+    } else {
+        memset(&shard, 0, sizeof(shard));
+        shard.allocator = cluster->allocator;
+    }
+
+    control_reply_t reply;
+    memset(&reply, 0, sizeof(reply));
+    reply.error = error;
+    bool running = write_all(control, &reply, sizeof(reply)) == SSSP_SUCCESS && error == SSSP_SUCCESS;
+
+    while (running) {
+        control_command_t command;
+        if (read_all(control, &command, sizeof(command)) != SSSP_SUCCESS) {
+            break;
+        }
+        memset(&reply, 0, sizeof(reply));
+        switch (command.op) {
+            case CONTROL_SOLVE:
+                shard.deadline_ns = command.deadline_ns;
+                reply.error = shard_solve(&shard, command.vertex);
+                reply.supersteps = shard.supersteps;
+                reply.buckets = shard.buckets;
+                reply.messages = shard.messages;
+                reply.bytes = shard.bytes;
+                reply.scans = shard.scans;
+                reply.relaxations = shard.relaxations;
+                running = write_all(control, &reply, sizeof(reply)) == SSSP_SUCCESS;
+                break;
+            case CONTROL_GATHER:
+                reply.error = shard.solved ? SSSP_SUCCESS : SSSP_ERROR_INVALID_ARGUMENT;
+                running = write_all(control, &reply, sizeof(reply)) == SSSP_SUCCESS;
+                if (running && shard.solved) {
+                    running = write_all(control, shard.distances, shard.count * sizeof(distance_t)) == SSSP_SUCCESS &&
+                              write_all(control, shard.predecessors, shard.count * sizeof(vertex_id_t)) == SSSP_SUCCESS;
+                }
+                break;
+            case CONTROL_QUERY:
+                if (!shard.solved || command.vertex - shard.begin >= shard.count) {
+                    reply.error = SSSP_ERROR_INVALID_ARGUMENT;
+                } else {
+                    reply.distance = shard.distances[command.vertex - shard.begin];
+                    reply.predecessor = shard.predecessors[command.vertex - shard.begin];
+                }
+                running = write_all(control, &reply, sizeof(reply)) == SSSP_SUCCESS;
+                break;
+            default:
+                running = false;
+                break;
+        }
+    }
+
+    shard_destroy(&shard);
+    cluster->transport->destroy(cluster->transport_state);
+    close(control);
+    _exit(0);
+}
+
+// ============================================================================
+// Creating process
+// ============================================================================
+
+/**
+ * Kill every shard after one was lost; the cluster only accepts destroy
+ */
+static void cluster_fail(sssp_cluster_t* cluster) {
+    SSSP_LOG_ERROR("Lost a shard process, stopping the cluster");
+    cluster->failed = true;
+    for (uint32_t i = 0; i < cluster->num_shards; i++) {
+        if (cluster->pids[i] > 0) {
+            kill(cluster->pids[i], SIGKILL);
+        }
+    }
+}
+
+/**
+ * Read one reply from every shard, noticing shards that exit meanwhile;
+ * passes a cancellation of token (may be NULL) on to the shards
+ */
+static sssp_error_t collect_replies(sssp_cluster_t* cluster, control_reply_t* replies,
+                                    const sssp_cancel_token_t* token) {
+    struct pollfd polls[SSSP_CLUSTER_MAX_SHARDS];
+    uint32_t remaining = cluster->num_shards;
+    for (uint32_t i = 0; i < cluster->num_shards; i++) {
+        polls[i].fd = cluster->control[i];
+        polls[i].events = POLLIN;
+    }
+    while (remaining > 0) {
+        if (sssp_cancel_token_is_cancelled(token)) {
+            __atomic_store_n(cluster->cancel, 1, __ATOMIC_RELEASE);
+            token = NULL;
+        }
+        if (poll(polls, cluster->num_shards, token ? CANCEL_POLL_MS : -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return SSSP_ERROR_IO;
+        }
+        for (uint32_t i = 0; i < cluster->num_shards; i++) {
+            if (polls[i].fd < 0 || polls[i].revents == 0) {
+                continue;
+            }
+            if (!(polls[i].revents & POLLIN) ||
+                read_all(polls[i].fd, &replies[i], sizeof(control_reply_t)) != SSSP_SUCCESS) {
+                return SSSP_ERROR_IO;
+            }
+            polls[i].fd = -1;
+            remaining--;
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t send_all(sssp_cluster_t* cluster, control_op_t op, vertex_id_t vertex,
+                             uint64_t deadline_ns) {
+    control_command_t command;
+    memset(&command, 0, sizeof(command));
+    command.op = (uint32_t)op;
+    command.vertex = vertex;
+    command.deadline_ns = deadline_ns;
+    for (uint32_t i = 0; i < cluster->num_shards; i++) {
+        if (write_all(cluster->control[i], &command, sizeof(command)) != SSSP_SUCCESS) {
+            return SSSP_ERROR_IO;
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Split the vertex ids into ranges of about equal out-degree + 1
+ */
+static void partition(sssp_cluster_t* cluster, const sssp_graph_t* graph) {
+    vertex_count_t n = cluster->num_vertices;
+    uint32_t p = cluster->num_shards;
+    uint64_t total = (uint64_t)n + graph->num_edges;
+    uint64_t load = 0;
+    uint32_t next = 1;
+
+    cluster->bounds[0] = 0;
+    for (vertex_id_t v = 0; v < n; v++) {
+        while (next < p && load >= total * next / p) {
+            cluster->bounds[next++] = v;
+        }
+        load += (uint64_t)sssp_graph_out_degree(graph, v) + 1;
+    }
+    while (next <= p) {
+        cluster->bounds[next++] = n;
+    }
+}
+
+/**
+ * Largest weight and the number of edges between shards
+ */
+static weight_t scan_edges(sssp_cluster_t* cluster, const sssp_graph_t* graph) {
+    weight_t max_weight = 0.0;
+    edge_count_t cut = 0;
+    for (vertex_id_t u = 0; u < cluster->num_vertices; u++) {
+        uint32_t owner = owner_of(cluster->bounds, cluster->num_shards, u);
+        vertex_id_t begin = cluster->bounds[owner];
+        vertex_id_t end = cluster->bounds[owner + 1];
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t degree;
+        if (sssp_graph_neighbors(graph, u, &targets, &weights, &degree) != SSSP_SUCCESS) {
+            continue;
+        }
+        for (edge_count_t e = 0; e < degree; e++) {
+            max_weight = SSSP_MAX(max_weight, weights[e]);
+            cut += targets[e] < begin || targets[e] >= end;
+        }
+    }
+    cluster->stats.cut_edges = cut;
+    return max_weight;
+}
+
+static void cluster_free(sssp_cluster_t* cluster) {
+    const sssp_allocator_t* allocator = cluster->allocator;
+    sssp_free(allocator, cluster->bounds);
+    sssp_free(allocator, cluster->pids);
+    sssp_free(allocator, cluster->control);
+    if (cluster->cancel) {
+        munmap(cluster->cancel, sizeof(uint32_t));
+    }
+    sssp_free(allocator, cluster);
+}
+
+sssp_error_t sssp_cluster_create(const sssp_graph_t* graph,
+                                 const sssp_cluster_config_t* config,
+                                 sssp_cluster_t** cluster_out) {
+    if (!graph || !cluster_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    *cluster_out = NULL;
+
+    sssp_cluster_config_t default_config;
+    if (!config) {
+        default_config = sssp_cluster_config_default(2, NULL);
+        config = &default_config;
+    }
+    if (config->num_shards == 0 || config->num_shards > SSSP_CLUSTER_MAX_SHARDS ||
+        !(config->delta >= 0.0) || isinf(config->delta)) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    if (sssp_graph_has_negative_weights(graph)) {
+        SSSP_LOG_ERROR("Delta-stepping needs non-negative weights");
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    // Up front, so that no shard builds them, and takes the graph's lock,
+    // after the fork
+    sssp_error_t error = sssp_graph_build_csr((sssp_graph_t*)graph);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    const sssp_allocator_t* allocator = config->allocator ? config->allocator : sssp_default_allocator();
+    uint32_t p = config->num_shards;
+    sssp_cluster_t* cluster = sssp_alloc(allocator, sizeof(sssp_cluster_t));
+    if (!cluster) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(cluster, 0, sizeof(*cluster));
+    cluster->num_shards = p;
+    cluster->num_vertices = sssp_graph_get_vertex_count(graph);
+    cluster->allocator = allocator;
+    cluster->transport = config->transport ? config->transport : sssp_transport_unix_socket();
+    cluster->bounds = sssp_alloc(allocator, ((size_t)p + 1) * sizeof(vertex_id_t));
+    cluster->pids = sssp_alloc(allocator, p * sizeof(pid_t));
+    cluster->control = sssp_alloc(allocator, p * sizeof(int));
+    void* cancel = mmap(NULL, sizeof(uint32_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    cluster->cancel = cancel == MAP_FAILED ? NULL : cancel;
+    if (!cluster->bounds || !cluster->pids || !cluster->control || !cluster->cancel) {
+        cluster_free(cluster);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < p; i++) {
+        cluster->pids[i] = -1;
+        cluster->control[i] = -1;
+    }
+
+    partition(cluster, graph);
+    weight_t max_weight = scan_edges(cluster, graph);
+    cluster->delta = config->delta;
+    if (cluster->delta == 0.0) {
+        // Max weight over average degree: about one heavy edge per vertex
+        cluster->delta = max_weight > 0.0 && graph->num_edges > 0
+            ? max_weight * cluster->num_vertices / graph->num_edges : 1.0;
+    }
+    if (max_weight / cluster->delta >= (double)(MAX_BUCKET_SLOTS - 2)) {
+        SSSP_LOG_ERROR("Delta %g is too small for weights up to %g", cluster->delta, max_weight);
+        cluster_free(cluster);
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    cluster->num_slots = (uint64_t)(max_weight / cluster->delta) + 2;
+
+    size_t capacity = config->channel_capacity ? config->channel_capacity : SSSP_CLUSTER_DEFAULT_CHANNEL_CAPACITY;
+    error = cluster->transport->create(p, capacity, allocator, &cluster->transport_state);
+    if (error != SSSP_SUCCESS) {
+        cluster_free(cluster);
+        return error;
+    }
+
+    for (uint32_t i = 0; i < p && error == SSSP_SUCCESS; i++) {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            error = SSSP_ERROR_IO;
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(pair[0]);
+            for (uint32_t j = 0; j < i; j++) {
+                close(cluster->control[j]);
+            }
+            shard_main(cluster, i, graph, pair[1]);
+        }
+        close(pair[1]);
+        if (pid < 0) {
+            close(pair[0]);
+            error = SSSP_ERROR_IO;
+            break;
+        }
+        cluster->pids[i] = pid;
+        cluster->control[i] = pair[0];
+    }
+
+    // Only the shards use the transport from here on
+    cluster->transport->destroy(cluster->transport_state);
+    cluster->transport_state = NULL;
+
+    if (error == SSSP_SUCCESS) {
+        control_reply_t replies[SSSP_CLUSTER_MAX_SHARDS];
+        error = collect_replies(cluster, replies, NULL);
+        for (uint32_t i = 0; i < p && error == SSSP_SUCCESS; i++) {
+            error = (sssp_error_t)replies[i].error;
+        }
+    }
+    if (error != SSSP_SUCCESS) {
+        SSSP_LOG_ERROR("Cannot start %u shards: %s", p, sssp_error_string(error));
+        cluster_fail(cluster);
+        sssp_cluster_destroy(cluster);
+        return error;
+    }
+
+    SSSP_LOG_INFO("Started %u shards over %s, delta %g, %u cut edges",
+                  p, cluster->transport->name, cluster->delta, cluster->stats.cut_edges);
+    *cluster_out = cluster;
+    return SSSP_SUCCESS;
+}
+
+void sssp_cluster_destroy(sssp_cluster_t* cluster) {
+    if (!cluster) {
+        return;
+    }
+    if (!cluster->failed) {
+        send_all(cluster, CONTROL_STOP, 0, 0);
+    }
+    for (uint32_t i = 0; i < cluster->num_shards; i++) {
+        if (cluster->control[i] >= 0) {
+            close(cluster->control[i]);
+        }
+        if (cluster->pids[i] > 0) {
+            while (waitpid(cluster->pids[i], NULL, 0) < 0 && errno == EINTR) {
+            }
+        }
+    }
+    cluster_free(cluster);
+}
+
+sssp_error_t sssp_cluster_solve(sssp_cluster_t* cluster,
+                                vertex_id_t source,
+                                const sssp_algorithm_config_t* config,
+                                sssp_algorithm_result_t* result) {
+    if (!cluster) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (cluster->failed) {
+        return SSSP_ERROR_IO;
+    }
+    // Whatever happens below, the last solve's distances are no longer the answer
+    cluster->solved = false;
+    cluster->stats.supersteps = 0;
+    cluster->stats.buckets = 0;
+    cluster->stats.messages = 0;
+    cluster->stats.bytes = 0;
+    cluster->stats.solve_time_ms = 0.0;
+    if (source >= cluster->num_vertices) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    uint64_t deadline_ns = config ? config->deadline_ns : 0;
+    const sssp_cancel_token_t* token = config ? config->cancel_token : NULL;
+    if (config && config->memory_limit_bytes != 0) {
+        // The shards' memory is allocated when they start, in other processes
+        SSSP_LOG_ERROR("Cluster solves cannot be held to a memory limit");
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    sssp_error_t error = sssp_check_query_limits(deadline_ns, token);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    SSSP_LOG_INFO("Solving from vertex %u on %u shards", source, cluster->num_shards);
+    uint64_t start_ns = sssp_get_timestamp_ns();
+    control_reply_t replies[SSSP_CLUSTER_MAX_SHARDS];
+    __atomic_store_n(cluster->cancel, 0, __ATOMIC_RELEASE);
+    error = send_all(cluster, CONTROL_SOLVE, source, deadline_ns);
+    if (error == SSSP_SUCCESS) {
+        error = collect_replies(cluster, replies, token);
+    }
+    if (error != SSSP_SUCCESS) {
+        cluster_fail(cluster);
+        return error;
+    }
+
+    uint64_t scans = 0;
+    uint64_t relaxations = 0;
+    cluster->stats.supersteps = replies[0].supersteps;
+    cluster->stats.buckets = replies[0].buckets;
+    cluster->stats.messages = 0;
+    cluster->stats.bytes = 0;
+    for (uint32_t i = 0; i < cluster->num_shards; i++) {
+        if (replies[i].error != SSSP_SUCCESS && error == SSSP_SUCCESS) {
+            error = (sssp_error_t)replies[i].error;
+        }
+        cluster->stats.messages += replies[i].messages;
+        cluster->stats.bytes += replies[i].bytes;
+        scans += replies[i].scans;
+        relaxations += replies[i].relaxations;
+    }
+    cluster->stats.solve_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    if (error == SSSP_ERROR_IO) {
+        cluster_fail(cluster);
+    }
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+    cluster->solved = true;
+    SSSP_LOG_INFO("Cluster solve took %u supersteps, %llu messages, %.2f ms",
+                  cluster->stats.supersteps, (unsigned long long)cluster->stats.messages,
+                  cluster->stats.solve_time_ms);
+
+    if (!result) {
+        return SSSP_SUCCESS;
+    }
+    error = sssp_cluster_gather(cluster, result);
+    if (error == SSSP_SUCCESS) {
+        result->vertices_processed = (vertex_count_t)SSSP_MIN(scans, (uint64_t)UINT32_MAX);
+        result->relaxations_performed = relaxations;
+        result->recursive_calls = 1;
+        result->total_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    }
+    return error;
+}
+
+sssp_error_t sssp_cluster_gather(sssp_cluster_t* cluster, sssp_algorithm_result_t* result) {
+    if (!cluster || !result) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (cluster->failed) {
+        return SSSP_ERROR_IO;
+    }
+    if (!cluster->solved) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+
+    sssp_error_t error = send_all(cluster, CONTROL_GATHER, 0, 0);
+    for (uint32_t i = 0; i < cluster->num_shards && error == SSSP_SUCCESS; i++) {
+        vertex_id_t begin = cluster->bounds[i];
+        size_t count = cluster->bounds[i + 1] - begin;
+        control_reply_t reply;
+        error = read_all(cluster->control[i], &reply, sizeof(reply));
+        if (error == SSSP_SUCCESS && reply.error != SSSP_SUCCESS) {
+            // Cannot happen after a successful solve
+            error = SSSP_ERROR_INTERNAL;
+        }
+        if (error == SSSP_SUCCESS) {
+            error = read_all(cluster->control[i], result->distances + begin, count * sizeof(distance_t));
+        }
+        if (error == SSSP_SUCCESS) {
+            error = read_all(cluster->control[i], result->predecessors + begin, count * sizeof(vertex_id_t));
+        }
+    }
+    if (error != SSSP_SUCCESS) {
+        cluster_fail(cluster);
+        return error;
+    }
+
+    for (vertex_count_t v = 0; v < cluster->num_vertices; v++) {
+        if (result->distances[v] != SSSP_INFINITY) {
+            sssp_vertex_set_add(result->processed_vertices, v);
+        }
+    }
+    result->total_time_ms = cluster->stats.solve_time_ms;
+    result->peak_memory_bytes = 0;
+    result->page_size = 0;
+    result->is_optimal = true;
+    result->validation_status = SSSP_SUCCESS;
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_cluster_distance(sssp_cluster_t* cluster,
+                                   vertex_id_t vertex,
+                                   distance_t* distance,
+                                   vertex_id_t* predecessor) {
+    if (!cluster || !distance) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (cluster->failed) {
+        return SSSP_ERROR_IO;
+    }
+    if (!cluster->solved || vertex >= cluster->num_vertices) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+
+    int control = cluster->control[owner_of(cluster->bounds, cluster->num_shards, vertex)];
+    control_command_t command = { CONTROL_QUERY, vertex, 0 };
+    control_reply_t reply;
+    if (write_all(control, &command, sizeof(command)) != SSSP_SUCCESS ||
+        read_all(control, &reply, sizeof(reply)) != SSSP_SUCCESS) {
+        cluster_fail(cluster);
+        return SSSP_ERROR_IO;
+    }
+    if (reply.error != SSSP_SUCCESS) {
+        return (sssp_error_t)reply.error;
+    }
+    *distance = reply.distance;
+    if (predecessor) {
+        *predecessor = reply.predecessor;
+    }
+    return SSSP_SUCCESS;
+}
+
+uint32_t sssp_cluster_num_shards(const sssp_cluster_t* cluster) {
+    return cluster ? cluster->num_shards : 0;
+}
+
+sssp_error_t sssp_cluster_shard_range(const sssp_cluster_t* cluster,
+                                      uint32_t shard,
+                                      vertex_id_t* begin,
+                                      vertex_id_t* end) {
+    if (!cluster || !begin || !end) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (shard >= cluster->num_shards) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    *begin = cluster->bounds[shard];
+    *end = cluster->bounds[shard + 1];
+    return SSSP_SUCCESS;
+}
+
+sssp_cluster_stats_t sssp_cluster_get_stats(const sssp_cluster_t* cluster) {
+    sssp_cluster_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    return cluster ? cluster->stats : stats;
+}
+
+#else // _WIN32
+
+const sssp_transport_ops_t* sssp_transport_unix_socket(void) {
+    return NULL;
+}
+
+const sssp_transport_ops_t* sssp_transport_shared_memory(void) {
+    return NULL;
+}
+
+sssp_error_t sssp_cluster_create(const sssp_graph_t* graph,
+                                 const sssp_cluster_config_t* config,
+                                 sssp_cluster_t** cluster_out) {
+    (void)graph;
+    (void)config;
+    if (cluster_out) {
+        *cluster_out = NULL;
+    }
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+void sssp_cluster_destroy(sssp_cluster_t* cluster) {
+    (void)cluster;
+}
+
+sssp_error_t sssp_cluster_solve(sssp_cluster_t* cluster, vertex_id_t source,
+                                const sssp_algorithm_config_t* config,
+                                sssp_algorithm_result_t* result) {
+    (void)cluster; (void)source; (void)config; (void)result;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_cluster_gather(sssp_cluster_t* cluster, sssp_algorithm_result_t* result) {
+    (void)cluster; (void)result;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_cluster_distance(sssp_cluster_t* cluster, vertex_id_t vertex,
+                                   distance_t* distance, vertex_id_t* predecessor) {
+    (void)cluster; (void)vertex; (void)distance; (void)predecessor;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+uint32_t sssp_cluster_num_shards(const sssp_cluster_t* cluster) {
+    (void)cluster;
+    return 0;
+}
+
+sssp_error_t sssp_cluster_shard_range(const sssp_cluster_t* cluster, uint32_t shard,
+                                      vertex_id_t* begin, vertex_id_t* end) {
+    (void)cluster; (void)shard; (void)begin; (void)end;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_cluster_stats_t sssp_cluster_get_stats(const sssp_cluster_t* cluster) {
+    sssp_cluster_stats_t stats;
+    (void)cluster;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+#endif // _WIN32
@@ -10,6 +10,7 @@
 #include "find_pivots.h"
 #include "partitioning_heap.h"
 #include "sssp_common.h"
+#include "profiler.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -120,9 +121,31 @@ void sssp_pivot_finder_destroy(sssp_pivot_finder_t* finder) {
 }
 
 /**
- * Helper function to run Dijkstra from a single source
+ * Relax one edge of the helper Dijkstra below
+ */
+static inline void relax_bounded(sssp_partitioning_heap_t* heap, distance_t* distances,
+                                 distance_t dist_u, vertex_id_t v, weight_t weight) {
+    distance_t new_dist = dist_u + weight;
+
+    if (new_dist < distances[v]) {
+        if (distances[v] == SSSP_INFINITY) {
+            // First time seeing this vertex
+            distances[v] = new_dist;
+            sssp_partitioning_heap_insert(heap, v, new_dist);
+        } else {
+            // Update existing distance
+            distances[v] = new_dist;
+            sssp_partitioning_heap_decrease_key(heap, v, new_dist);
+        }
+    }
+}
+
+/**
+ * Helper function to run Dijkstra from a single source, reusing the
+ * caller's heap
  */
 static distance_t run_single_source_dijkstra(const sssp_graph_t* graph, vertex_id_t source,
+                                              sssp_partitioning_heap_t* heap,
                                               distance_t* distances, bool* visited,
                                               distance_t max_distance) {
     // Reset arrays
@@ -132,12 +155,8 @@ static distance_t run_single_source_dijkstra(const sssp_graph_t* graph, vertex_i
         visited[i] = false;
     }
     
-    // Create temporary heap for Dijkstra
-    sssp_partitioning_heap_t* heap = sssp_partitioning_heap_create(num_vertices, NULL);
-    if (!heap) {
-        SSSP_LOG_ERROR("Failed to create heap for Dijkstra");
-        return SSSP_INFINITY;
-    }
+    // Entries left over from a run that stopped at max_distance
+    sssp_partitioning_heap_clear(heap);
     
     // Initialize source
     distances[source] = 0.0;
@@ -162,31 +181,17 @@ static distance_t run_single_source_dijkstra(const sssp_graph_t* graph, vertex_i
         max_reached = dist_u;
         
         // Process all neighbors
-        const sssp_adj_list_t* adj_list = sssp_graph_get_adj_list(graph, u);
-        if (adj_list) {
-            sssp_edge_node_t* edge = adj_list->head;
-            while (edge) {
-                vertex_id_t v = edge->to;
-                distance_t new_dist = dist_u + edge->weight;
-                
-                if (new_dist < distances[v]) {
-                    if (distances[v] == SSSP_INFINITY) {
-                        // First time seeing this vertex
-                        distances[v] = new_dist;
-                        sssp_partitioning_heap_insert(heap, v, new_dist);
-                    } else {
-                        // Update existing distance
-                        distances[v] = new_dist;
-                        sssp_partitioning_heap_decrease_key(heap, v, new_dist);
-                    }
-                }
-                
-                edge = edge->next;
-            }
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t degree;
+        if (sssp_graph_neighbors(graph, u, &targets, &weights, &degree) != SSSP_SUCCESS) {
+            continue;
+        }
+        for (edge_count_t e = 0; e < degree; e++) {
+            relax_bounded(heap, distances, dist_u, targets[e], weights[e]);
         }
     }
     
-    sssp_partitioning_heap_destroy(heap);
     return max_reached;
 }
 
@@ -196,6 +201,7 @@ static distance_t run_single_source_dijkstra(const sssp_graph_t* graph, vertex_i
  */
 static distance_t compute_bottleneck_distance(const sssp_graph_t* graph,
                                                const sssp_vertex_set_t* vertex_set,
+                                               sssp_partitioning_heap_t* heap,
                                                distance_t* work_distances, bool* work_visited) {
     distance_t max_bottleneck = 0.0;
     
@@ -203,8 +209,7 @@ static distance_t compute_bottleneck_distance(const sssp_graph_t* graph,
     for (vertex_count_t i = 0; i < sssp_vertex_set_size(vertex_set); i++) {
         vertex_id_t source = sssp_vertex_set_get_vertex(vertex_set, i);
         
-        distance_t max_dist = run_single_source_dijkstra(graph, source, work_distances, 
-                                                          work_visited, SSSP_INFINITY);
+        run_single_source_dijkstra(graph, source, heap, work_distances, work_visited, SSSP_INFINITY);
         
         // Find maximum distance to other vertices in the set
         for (vertex_count_t j = 0; j < sssp_vertex_set_size(vertex_set); j++) {
@@ -223,6 +228,7 @@ static distance_t compute_bottleneck_distance(const sssp_graph_t* graph,
  */
 static vertex_id_t find_best_pivot_candidate(const sssp_graph_t* graph,
                                               const sssp_vertex_set_t* vertex_set,
+                                              sssp_partitioning_heap_t* heap,
                                               distance_t* work_distances, bool* work_visited,
                                               distance_t* best_max_distance) {
     vertex_id_t best_pivot = SSSP_INVALID_VERTEX;
@@ -231,7 +237,7 @@ static vertex_id_t find_best_pivot_candidate(const sssp_graph_t* graph,
     for (vertex_count_t i = 0; i < sssp_vertex_set_size(vertex_set); i++) {
         vertex_id_t candidate = sssp_vertex_set_get_vertex(vertex_set, i);
         
-        run_single_source_dijkstra(graph, candidate, work_distances, work_visited, SSSP_INFINITY);
+        run_single_source_dijkstra(graph, candidate, heap, work_distances, work_visited, SSSP_INFINITY);
         
         // Find maximum distance to any vertex in the set
         distance_t max_dist = 0.0;
@@ -253,14 +259,13 @@ static vertex_id_t find_best_pivot_candidate(const sssp_graph_t* graph,
 
 /**
  * Implementation of Algorithm 1 (FINDPIVOTS) from the research paper
- * This is the correct signature matching the header file
  */
-sssp_error_t sssp_find_pivots(const sssp_graph_t* graph,
-                               weight_t threshold,
-                               const sssp_vertex_set_t* source_set,
-                               vertex_count_t k,
-                               const sssp_find_pivots_config_t* config,
-                               sssp_find_pivots_result_t* result) {
+static sssp_error_t find_pivots_impl(const sssp_graph_t* graph,
+                                     weight_t threshold,
+                                     const sssp_vertex_set_t* source_set,
+                                     vertex_count_t k,
+                                     const sssp_find_pivots_config_t* config,
+                                     sssp_find_pivots_result_t* result) {
     if (!graph || !source_set || !result) {
         SSSP_LOG_ERROR("Invalid parameters");
         return SSSP_ERROR_INVALID_PARAMETER;
@@ -292,30 +297,33 @@ sssp_error_t sssp_find_pivots(const sssp_graph_t* graph,
     result->layers_processed = 0;
     result->relaxations_performed = 0;
     
-    // Create temporary working structures
+    // Create temporary working structures, once per call. With an arena
+    // allocator (see sssp_algorithm_config_t::scratch_arena) they are
+    // released by the caller's rewind.
     vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
     distance_t* work_distances = sssp_alloc(config->allocator, num_vertices * sizeof(distance_t));
     bool* work_visited = sssp_alloc(config->allocator, num_vertices * sizeof(bool));
-    sssp_vertex_set_t* candidates = sssp_vertex_set_create(num_vertices, config->allocator);
+    sssp_vertex_set_t* candidates = sssp_vertex_set_create_indexed(num_vertices, config->allocator);
+    sssp_vertex_set_t* to_remove = sssp_vertex_set_create_indexed(num_vertices, config->allocator);
+    sssp_partitioning_heap_t* heap = sssp_partitioning_heap_create(num_vertices, config->allocator);
+    sssp_error_t error = SSSP_SUCCESS;
     
-    if (!work_distances || !work_visited || !candidates) {
+    if (!work_distances || !work_visited || !candidates || !to_remove || !heap) {
         SSSP_LOG_ERROR("Failed to allocate working memory");
-        if (work_distances) sssp_free(config->allocator, work_distances);
-        if (work_visited) sssp_free(config->allocator, work_visited);
-        if (candidates) sssp_vertex_set_destroy(candidates);
-        return SSSP_ERROR_OUT_OF_MEMORY;
+        error = SSSP_ERROR_OUT_OF_MEMORY;
+        goto cleanup;
     }
     
     // Initialize candidate set with all vertices from source set
-    for (vertex_count_t i = 0; i < set_size; i++) {
-        vertex_id_t v = sssp_vertex_set_get_vertex(source_set, i);
-        sssp_vertex_set_add(candidates, v);
+    error = sssp_vertex_set_add_array(candidates, sssp_vertex_set_data(source_set), set_size);
+    if (error != SSSP_SUCCESS) {
+        goto cleanup;
     }
     
     // Main algorithm loop
     while (sssp_vertex_set_size(candidates) > 0) {
         // Check if current diameter is acceptable
-        distance_t current_diameter = compute_bottleneck_distance(graph, candidates,
+        distance_t current_diameter = compute_bottleneck_distance(graph, candidates, heap,
                                                                   work_distances, work_visited);
         
         SSSP_LOG_TRACE("Current diameter: %.2f, threshold: %.2f", current_diameter, threshold);
@@ -327,16 +335,14 @@ sssp_error_t sssp_find_pivots(const sssp_graph_t* graph,
         
         // Find the best pivot (vertex that minimizes maximum distance to others)
         distance_t best_max_distance;
-        vertex_id_t pivot = find_best_pivot_candidate(graph, candidates,
+        vertex_id_t pivot = find_best_pivot_candidate(graph, candidates, heap,
                                                       work_distances, work_visited,
                                                       &best_max_distance);
         
         if (pivot == SSSP_INVALID_VERTEX) {
             SSSP_LOG_ERROR("Failed to find valid pivot");
-            sssp_free(config->allocator, work_distances);
-            sssp_free(config->allocator, work_visited);
-            sssp_vertex_set_destroy(candidates);
-            return SSSP_ERROR_ALGORITHM;
+            error = SSSP_ERROR_ALGORITHM;
+            goto cleanup;
         }
         
         // Add pivot to result
@@ -345,18 +351,10 @@ sssp_error_t sssp_find_pivots(const sssp_graph_t* graph,
         SSSP_LOG_TRACE("Added pivot %u with max distance %.2f", pivot, best_max_distance);
         
         // Run Dijkstra from the pivot to determine which vertices to remove
-        run_single_source_dijkstra(graph, pivot, work_distances, work_visited, threshold);
+        run_single_source_dijkstra(graph, pivot, heap, work_distances, work_visited, threshold);
         
         // Remove vertices that are within threshold distance of the pivot
-        sssp_vertex_set_t* to_remove = sssp_vertex_set_create(num_vertices, config->allocator);
-        if (!to_remove) {
-            SSSP_LOG_ERROR("Failed to create temporary vertex set");
-            sssp_free(config->allocator, work_distances);
-            sssp_free(config->allocator, work_visited);
-            sssp_vertex_set_destroy(candidates);
-            return SSSP_ERROR_OUT_OF_MEMORY;
-        }
-        
+        sssp_vertex_set_clear(to_remove);
         for (vertex_count_t i = 0; i < sssp_vertex_set_size(candidates); i++) {
             vertex_id_t v = sssp_vertex_set_get_vertex(candidates, i);
             if (work_distances[v] <= threshold) {
@@ -364,24 +362,20 @@ sssp_error_t sssp_find_pivots(const sssp_graph_t* graph,
             }
         }
         
-        // Remove the vertices from candidates
-        for (vertex_count_t i = 0; i < sssp_vertex_set_size(to_remove); i++) {
-            vertex_id_t v = sssp_vertex_set_get_vertex(to_remove, i);
-            sssp_vertex_set_remove(candidates, v);
+        // Remove the vertices from candidates, keeping the remaining order
+        error = sssp_vertex_set_difference(candidates, to_remove);
+        if (error != SSSP_SUCCESS) {
+            goto cleanup;
         }
         
-        sssp_vertex_set_destroy(to_remove);
-        
         SSSP_LOG_TRACE("Removed vertices within distance %.2f of pivot %u. Remaining: %u", 
                        threshold, pivot, sssp_vertex_set_size(candidates));
         
         // Safety check to prevent infinite loops
         if (sssp_vertex_set_size(result->pivots) > set_size) {
             SSSP_LOG_ERROR("Too many pivots generated (possible infinite loop)");
-            sssp_free(config->allocator, work_distances);
-            sssp_free(config->allocator, work_visited);
-            sssp_vertex_set_destroy(candidates);
-            return SSSP_ERROR_ALGORITHM;
+            error = SSSP_ERROR_ALGORITHM;
+            goto cleanup;
         }
         
         // Early termination based on k parameter
@@ -393,22 +387,45 @@ sssp_error_t sssp_find_pivots(const sssp_graph_t* graph,
         result->layers_processed++;
     }
     
-    // Store remaining candidates as witnesses
-    for (vertex_count_t i = 0; i < sssp_vertex_set_size(candidates); i++) {
-        vertex_id_t v = sssp_vertex_set_get_vertex(candidates, i);
-        sssp_vertex_set_add(result->witnesses, v);
-    }
+    // Store remaining candidates as witnesses (distinct, so appended as is)
+    error = sssp_vertex_set_add_array(result->witnesses, sssp_vertex_set_data(candidates),
+                                      sssp_vertex_set_size(candidates));
     
-    // Clean up
-    sssp_free(config->allocator, work_distances);
-    sssp_free(config->allocator, work_visited);
+cleanup:
+    sssp_partitioning_heap_destroy(heap);
+    sssp_vertex_set_destroy(to_remove);
     sssp_vertex_set_destroy(candidates);
+    sssp_free(config->allocator, work_visited);
+    sssp_free(config->allocator, work_distances);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
     
     SSSP_LOG_INFO("FINDPIVOTS completed: %u pivots found, %u witnesses", 
                   sssp_vertex_set_size(result->pivots), sssp_vertex_set_size(result->witnesses));
     return SSSP_SUCCESS;
 }
 
+/**
+ * FINDPIVOTS entry point; charges its time to the FINDPIVOTS phase when profiling
+ */
+sssp_error_t sssp_find_pivots(const sssp_graph_t* graph,
+                               weight_t threshold,
+                               const sssp_vertex_set_t* source_set,
+                               vertex_count_t k,
+                               const sssp_find_pivots_config_t* config,
+                               sssp_find_pivots_result_t* result) {
+    sssp_profiler_t* profiler = sssp_profiler_current();
+    if (SSSP_LIKELY(profiler == NULL)) {
+        return find_pivots_impl(graph, threshold, source_set, k, config, result);
+    }
+    
+    sssp_profile_phase_t previous = sssp_profiler_switch(profiler, SSSP_PHASE_FIND_PIVOTS);
+    sssp_error_t error = find_pivots_impl(graph, threshold, source_set, k, config, result);
+    sssp_profiler_switch(profiler, previous);
+    return error;
+}
+
 // Remove the old function with incorrect signature and add utility function for backward compatibility
 /**
  * Utility function for backward compatibility with pivot_finder_t
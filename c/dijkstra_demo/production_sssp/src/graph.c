@@ -9,11 +9,16 @@
 
 #include "graph.h"
 #include "sssp_common.h"
+#include "sssp_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <errno.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <float.h>
+#include <pthread.h>
 
 /**
  * Create a new graph with specified number of vertices
@@ -40,6 +45,17 @@ sssp_graph_t* sssp_graph_create(vertex_count_t num_vertices, const sssp_allocato
     graph->num_edges = 0;
     graph->total_edges = 0;  // Initialize total_edges
     graph->has_negative_weights = false;
+    graph->allow_negative_weights = false;
+    graph->csr_offsets = NULL;
+    graph->csr_targets = NULL;
+    graph->csr_weights = NULL;
+    graph->edge_pool = NULL;
+    graph->edge_pool_size = 0;
+    graph->reverse_offsets = NULL;
+    graph->reverse_sources = NULL;
+    graph->reverse_weights = NULL;
+    graph->int_weights = NULL;
+    graph->weight_scale = 0;
     graph->allocator = allocator;
     
     // Allocate adjacency list array
@@ -60,6 +76,490 @@ sssp_graph_t* sssp_graph_create(vertex_count_t num_vertices, const sssp_allocato
     return graph;
 }
 
+/**
+ * Create an empty CSR graph; the caller fills the offsets and edges
+ */
+sssp_graph_t* sssp_graph_create_csr(vertex_count_t num_vertices, const sssp_allocator_t* allocator) {
+    if (num_vertices == 0 || num_vertices > SSSP_MAX_VERTICES) {
+        SSSP_LOG_ERROR("Invalid vertex count for CSR graph: %u", num_vertices);
+        return NULL;
+    }
+    
+    if (allocator == NULL) {
+        allocator = &SSSP_DEFAULT_ALLOCATOR;
+    }
+    
+    sssp_graph_t* graph = sssp_alloc(allocator, sizeof(sssp_graph_t));
+    if (!graph) {
+        SSSP_LOG_ERROR("Failed to allocate memory for graph");
+        return NULL;
+    }
+    memset(graph, 0, sizeof(*graph));
+    graph->num_vertices = num_vertices;
+    graph->allocator = allocator;
+    
+    size_t offsets_size = ((size_t)num_vertices + 1) * sizeof(edge_count_t);
+    graph->csr_offsets = sssp_alloc(allocator, offsets_size);
+    if (!graph->csr_offsets) {
+        SSSP_LOG_ERROR("Failed to allocate CSR offsets for %u vertices", num_vertices);
+        sssp_free(allocator, graph);
+        return NULL;
+    }
+    memset(graph->csr_offsets, 0, offsets_size);
+    
+    return graph;
+}
+
+/**
+ * Allocate the CSR edge arrays
+ */
+sssp_error_t sssp_graph_csr_reserve_edges(sssp_graph_t* graph, edge_count_t num_edges) {
+    if (!graph || !graph->csr_offsets) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    
+    // Keep the arrays non-NULL for empty graphs so edge loops need no special case
+    size_t count = num_edges > 0 ? num_edges : 1;
+    graph->csr_targets = sssp_alloc(graph->allocator, count * sizeof(vertex_id_t));
+    graph->csr_weights = sssp_alloc(graph->allocator, count * sizeof(weight_t));
+    if (!graph->csr_targets || !graph->csr_weights) {
+        SSSP_LOG_ERROR("Failed to allocate CSR storage for %u edges", num_edges);
+        sssp_free(graph->allocator, graph->csr_targets);
+        sssp_free(graph->allocator, graph->csr_weights);
+        graph->csr_targets = NULL;
+        graph->csr_weights = NULL;
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    
+    graph->num_edges = num_edges;
+    graph->total_edges = num_edges;
+    return SSSP_SUCCESS;
+}
+
+static bool is_pool_node(const sssp_graph_t* graph, const sssp_edge_node_t* node) {
+    uintptr_t address = (uintptr_t)node;
+    uintptr_t begin = (uintptr_t)graph->edge_pool;
+    uintptr_t end = (uintptr_t)(graph->edge_pool + graph->edge_pool_size);
+    return graph->edge_pool && address >= begin && address < end;
+}
+
+static void release_csr(sssp_graph_t* graph) {
+    sssp_free(graph->allocator, graph->csr_offsets);
+    sssp_free(graph->allocator, graph->csr_targets);
+    sssp_free(graph->allocator, graph->csr_weights);
+    sssp_free(graph->allocator, graph->int_weights);
+    graph->csr_offsets = NULL;
+    graph->csr_targets = NULL;
+    graph->csr_weights = NULL;
+    graph->int_weights = NULL;
+    graph->weight_scale = 0;
+}
+
+static void release_reverse(sssp_graph_t* graph) {
+    sssp_free(graph->allocator, graph->reverse_offsets);
+    sssp_free(graph->allocator, graph->reverse_sources);
+    sssp_free(graph->allocator, graph->reverse_weights);
+    graph->reverse_offsets = NULL;
+    graph->reverse_sources = NULL;
+    graph->reverse_weights = NULL;
+}
+
+// Serializes the structures built on first use (lists, CSR arrays, in-edges),
+// which concurrent queries on an unmodified graph may all ask for. Each is
+// published by a release store of its first pointer once filled in, which
+// the inline accessors in graph.h read with acquire ordering.
+static pthread_mutex_t lazy_build_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Build linked adjacency lists on top of CSR storage; lazy_build_lock held
+ */
+static sssp_error_t build_adj_lists_locked(sssp_graph_t* graph) {
+    if (graph->adj_list) {
+        return SSSP_SUCCESS;
+    }
+    if (!graph->csr_offsets) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    
+    SSSP_LOG_DEBUG("Building adjacency lists for CSR graph (%u vertices, %u edges)",
+                   graph->num_vertices, graph->num_edges);
+    
+    sssp_adj_list_t* adj_list = sssp_alloc(graph->allocator,
+                                           graph->num_vertices * sizeof(sssp_adj_list_t));
+    sssp_edge_node_t* pool = NULL;
+    if (graph->num_edges > 0) {
+        pool = sssp_alloc(graph->allocator, graph->num_edges * sizeof(sssp_edge_node_t));
+    }
+    if (!adj_list || (graph->num_edges > 0 && !pool)) {
+        SSSP_LOG_ERROR("Failed to allocate adjacency lists for CSR graph");
+        sssp_free(graph->allocator, adj_list);
+        sssp_free(graph->allocator, pool);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    
+    const edge_count_t* offsets = graph->csr_offsets;
+    for (vertex_count_t v = 0; v < graph->num_vertices; v++) {
+        edge_count_t begin = offsets[v];
+        edge_count_t end = offsets[v + 1];
+        adj_list[v].count = end - begin;
+        adj_list[v].head = begin < end ? &pool[begin] : NULL;
+        for (edge_count_t e = begin; e < end; e++) {
+            pool[e].to = graph->csr_targets[e];
+            pool[e].weight = graph->csr_weights[e];
+            pool[e].next = e + 1 < end ? &pool[e + 1] : NULL;
+        }
+    }
+    
+    graph->edge_pool = pool;
+    graph->edge_pool_size = graph->num_edges;
+    __atomic_store_n(&graph->adj_list, adj_list, __ATOMIC_RELEASE);
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_graph_build_adj_lists(sssp_graph_t* graph) {
+    if (!graph) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (__atomic_load_n(&graph->adj_list, __ATOMIC_ACQUIRE)) {
+        return SSSP_SUCCESS;
+    }
+    pthread_mutex_lock(&lazy_build_lock);
+    sssp_error_t result = build_adj_lists_locked(graph);
+    pthread_mutex_unlock(&lazy_build_lock);
+    return result;
+}
+
+/**
+ * Copy linked adjacency lists into CSR arrays, keeping the lists;
+ * lazy_build_lock held
+ */
+static sssp_error_t build_csr_locked(sssp_graph_t* graph) {
+    if (graph->csr_offsets) {
+        return SSSP_SUCCESS;
+    }
+    
+    SSSP_LOG_DEBUG("Building CSR arrays for list graph (%u vertices, %u edges)",
+                   graph->num_vertices, graph->num_edges);
+    
+    size_t count = graph->num_edges > 0 ? graph->num_edges : 1;
+    edge_count_t* offsets = sssp_alloc(graph->allocator,
+                                       ((size_t)graph->num_vertices + 1) * sizeof(edge_count_t));
+    vertex_id_t* targets = sssp_alloc(graph->allocator, count * sizeof(vertex_id_t));
+    weight_t* weights = sssp_alloc(graph->allocator, count * sizeof(weight_t));
+    if (!offsets || !targets || !weights) {
+        SSSP_LOG_ERROR("Failed to allocate CSR storage for %u edges", graph->num_edges);
+        sssp_free(graph->allocator, offsets);
+        sssp_free(graph->allocator, targets);
+        sssp_free(graph->allocator, weights);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    
+    edge_count_t e = 0;
+    for (vertex_count_t v = 0; v < graph->num_vertices; v++) {
+        offsets[v] = e;
+        for (const sssp_edge_node_t* edge = graph->adj_list[v].head; edge; edge = edge->next) {
+            targets[e] = edge->to;
+            weights[e] = edge->weight;
+            e++;
+        }
+    }
+    offsets[graph->num_vertices] = e;
+    
+    graph->csr_targets = targets;
+    graph->csr_weights = weights;
+    __atomic_store_n(&graph->csr_offsets, offsets, __ATOMIC_RELEASE);
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_graph_build_csr(sssp_graph_t* graph) {
+    if (!graph) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (__atomic_load_n(&graph->csr_offsets, __ATOMIC_ACQUIRE)) {
+        return SSSP_SUCCESS;
+    }
+    pthread_mutex_lock(&lazy_build_lock);
+    sssp_error_t result = build_csr_locked(graph);
+    pthread_mutex_unlock(&lazy_build_lock);
+    return result;
+}
+
+/**
+ * Whether weight * scale is a whole number, allowing for the rounding of
+ * the multiplication (0.3 * 10 is not exactly 3)
+ */
+static bool is_whole_at_scale(weight_t weight, double scale) {
+    double scaled = weight * scale;
+    double whole = nearbyint(scaled);
+    return fabs(scaled - whole) <= whole * 4 * DBL_EPSILON;
+}
+
+/**
+ * Scale the weights to exact 32-bit integers
+ */
+sssp_error_t sssp_graph_build_integer_weights(sssp_graph_t* graph) {
+    if (!graph) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (graph->int_weights) {
+        return SSSP_SUCCESS;
+    }
+    sssp_error_t result = sssp_graph_build_csr(graph);
+    if (result != SSSP_SUCCESS) {
+        return result;
+    }
+    
+    // Fewest decimals that make every weight whole
+    const weight_t* weights = graph->csr_weights;
+    unsigned int decimals = 0;
+    double scale = 1.0;
+    for (edge_count_t e = 0; e < graph->num_edges; e++) {
+        if (!(weights[e] >= 0.0) || weights[e] > (double)UINT32_MAX) {
+            return SSSP_ERROR_INVALID_ARGUMENT;
+        }
+        while (!is_whole_at_scale(weights[e], scale)) {
+            if (++decimals > SSSP_MAX_WEIGHT_DECIMALS) {
+                return SSSP_ERROR_INVALID_ARGUMENT;
+            }
+            scale *= 10.0;
+        }
+    }
+    
+    uint32_t* int_weights = sssp_alloc(graph->allocator,
+                                       (graph->num_edges > 0 ? graph->num_edges : 1) * sizeof(uint32_t));
+    if (!int_weights) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    for (edge_count_t e = 0; e < graph->num_edges; e++) {
+        double whole = nearbyint(weights[e] * scale);
+        if (whole > (double)UINT32_MAX) {
+            SSSP_LOG_DEBUG("Weight %f does not fit 32 bits at scale %.0f", weights[e], scale);
+            sssp_free(graph->allocator, int_weights);
+            return SSSP_ERROR_INVALID_ARGUMENT;
+        }
+        int_weights[e] = (uint32_t)whole;
+    }
+    
+    SSSP_LOG_DEBUG("Weights of %u edges are integers at scale %.0f", graph->num_edges, scale);
+    graph->int_weights = int_weights;
+    graph->weight_scale = (uint32_t)scale;
+    return SSSP_SUCCESS;
+}
+
+// Largest number of target blocks the first placement pass spreads edges over
+#define REVERSE_MAX_BLOCKS 1024
+
+/**
+ * Place every out-edge (u, t, w) at cursor[t >> shift]++, in ascending
+ * order of u; targets, if not NULL, keeps t
+ */
+static void scatter_out_edges(const sssp_graph_t* graph, edge_count_t* cursor, unsigned int shift,
+                              vertex_id_t* sources, weight_t* weights, vertex_id_t* targets) {
+    for (vertex_count_t u = 0; u < graph->num_vertices; u++) {
+        if (graph->csr_offsets) {
+            for (edge_count_t e = graph->csr_offsets[u]; e < graph->csr_offsets[u + 1]; e++) {
+                vertex_id_t t = graph->csr_targets[e];
+                edge_count_t slot = cursor[t >> shift]++;
+                sources[slot] = u;
+                weights[slot] = graph->csr_weights[e];
+                if (targets) {
+                    targets[slot] = t;
+                }
+            }
+            continue;
+        }
+        for (const sssp_edge_node_t* edge = graph->adj_list[u].head; edge; edge = edge->next) {
+            edge_count_t slot = cursor[edge->to >> shift]++;
+            sources[slot] = u;
+            weights[slot] = edge->weight;
+            if (targets) {
+                targets[slot] = edge->to;
+            }
+        }
+    }
+}
+
+/**
+ * Place edges grouped by target block at their final slots, one block at
+ * a time; offsets[v] serves as the cursor of v
+ */
+static sssp_error_t place_blocks(sssp_graph_t* graph, edge_count_t* offsets, unsigned int shift,
+                                 size_t num_blocks, vertex_id_t* sources, weight_t* weights) {
+    vertex_count_t n = graph->num_vertices;
+    const sssp_allocator_t* allocator = graph->allocator;
+    edge_count_t* block_cursor = sssp_alloc(allocator, num_blocks * sizeof(edge_count_t));
+    vertex_id_t* targets = sssp_alloc(allocator, (size_t)graph->num_edges * sizeof(vertex_id_t));
+    edge_count_t largest = 0;
+    for (size_t b = 0; b < num_blocks; b++) {
+        vertex_count_t end = (vertex_count_t)SSSP_MIN(((size_t)b + 1) << shift, (size_t)n);
+        largest = SSSP_MAX(largest, offsets[end] - offsets[b << shift]);
+    }
+    vertex_id_t* block_sources = sssp_alloc(allocator, (size_t)largest * sizeof(vertex_id_t));
+    vertex_id_t* block_targets = sssp_alloc(allocator, (size_t)largest * sizeof(vertex_id_t));
+    weight_t* block_weights = sssp_alloc(allocator, (size_t)largest * sizeof(weight_t));
+    sssp_error_t error = SSSP_SUCCESS;
+    if (!block_cursor || !targets || !block_sources || !block_targets || !block_weights) {
+        error = SSSP_ERROR_OUT_OF_MEMORY;
+    } else {
+        for (size_t b = 0; b < num_blocks; b++) {
+            block_cursor[b] = offsets[b << shift];
+        }
+        scatter_out_edges(graph, block_cursor, shift, sources, weights, targets);
+        
+        for (size_t b = 0; b < num_blocks; b++) {
+            vertex_count_t end = (vertex_count_t)SSSP_MIN(((size_t)b + 1) << shift, (size_t)n);
+            edge_count_t first = offsets[b << shift];
+            size_t count = offsets[end] - first;
+            memcpy(block_sources, sources + first, count * sizeof(vertex_id_t));
+            memcpy(block_targets, targets + first, count * sizeof(vertex_id_t));
+            memcpy(block_weights, weights + first, count * sizeof(weight_t));
+            for (size_t i = 0; i < count; i++) {
+                edge_count_t slot = offsets[block_targets[i]]++;
+                sources[slot] = block_sources[i];
+                weights[slot] = block_weights[i];
+            }
+        }
+    }
+    sssp_free(allocator, block_cursor);
+    sssp_free(allocator, targets);
+    sssp_free(allocator, block_sources);
+    sssp_free(allocator, block_targets);
+    sssp_free(allocator, block_weights);
+    return error;
+}
+
+/**
+ * Build the transposed CSR with a counting sort on edge targets
+ *
+ * Scattering edges straight to their slots costs a cache miss per edge on
+ * large graphs. Instead edges are first grouped by blocks of target
+ * vertices, with one sequential write stream per block, and then placed
+ * block by block, where the cursors and slots of a block stay in cache.
+ * Small graphs, or a failed allocation of the block buffers, take the
+ * direct route.
+ */
+static sssp_error_t build_reverse_locked(sssp_graph_t* graph) {
+    if (graph->reverse_offsets) {
+        return SSSP_SUCCESS;
+    }
+    
+    SSSP_LOG_DEBUG("Building reverse graph (%u vertices, %u edges)", graph->num_vertices, graph->num_edges);
+    
+    vertex_count_t n = graph->num_vertices;
+    size_t count = graph->num_edges > 0 ? graph->num_edges : 1;
+    edge_count_t* offsets = sssp_alloc(graph->allocator, ((size_t)n + 1) * sizeof(edge_count_t));
+    vertex_id_t* sources = sssp_alloc(graph->allocator, count * sizeof(vertex_id_t));
+    weight_t* weights = sssp_alloc(graph->allocator, count * sizeof(weight_t));
+    if (!offsets || !sources || !weights) {
+        SSSP_LOG_ERROR("Failed to allocate reverse graph for %u edges", graph->num_edges);
+        sssp_free(graph->allocator, offsets);
+        sssp_free(graph->allocator, sources);
+        sssp_free(graph->allocator, weights);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    
+    // offsets[v + 1] counts in-edges of v, then offsets[v] becomes the cursor of v
+    memset(offsets, 0, ((size_t)n + 1) * sizeof(edge_count_t));
+    if (graph->csr_offsets) {
+        for (edge_count_t e = 0; e < graph->num_edges; e++) {
+            offsets[graph->csr_targets[e] + 1]++;
+        }
+    } else {
+        for (vertex_count_t u = 0; u < n; u++) {
+            for (const sssp_edge_node_t* edge = graph->adj_list[u].head; edge; edge = edge->next) {
+                offsets[edge->to + 1]++;
+            }
+        }
+    }
+    for (vertex_count_t v = 0; v < n; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    
+    // Blocks of at least 4096 vertices, so cursors fit in L1 on small graphs
+    unsigned int shift = 12;
+    while (((size_t)(n - 1) >> shift) >= REVERSE_MAX_BLOCKS) {
+        shift++;
+    }
+    size_t num_blocks = ((size_t)(n - 1) >> shift) + 1;
+    
+    // Both routes visit sources in ascending order, so in-edge lists come out sorted
+    if (num_blocks == 1 ||
+        place_blocks(graph, offsets, shift, num_blocks, sources, weights) != SSSP_SUCCESS) {
+        scatter_out_edges(graph, offsets, 0, sources, weights, NULL);
+    }
+    
+    // Each cursor stopped at the start of the next vertex; shift back
+    for (vertex_count_t v = n; v > 0; v--) {
+        offsets[v] = offsets[v - 1];
+    }
+    offsets[0] = 0;
+    
+    graph->reverse_sources = sources;
+    graph->reverse_weights = weights;
+    __atomic_store_n(&graph->reverse_offsets, offsets, __ATOMIC_RELEASE);
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_graph_build_reverse(sssp_graph_t* graph) {
+    if (!graph) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (__atomic_load_n(&graph->reverse_offsets, __ATOMIC_ACQUIRE)) {
+        return SSSP_SUCCESS;
+    }
+    pthread_mutex_lock(&lazy_build_lock);
+    sssp_error_t result = build_reverse_locked(graph);
+    pthread_mutex_unlock(&lazy_build_lock);
+    return result;
+}
+
+/**
+ * Get the out-degree of a vertex
+ */
+vertex_count_t sssp_graph_out_degree(const sssp_graph_t* graph, vertex_id_t vertex) {
+    if (!graph || vertex >= graph->num_vertices) {
+        return 0;
+    }
+    const edge_count_t* offsets = __atomic_load_n(&graph->csr_offsets, __ATOMIC_ACQUIRE);
+    if (offsets) {
+        return offsets[vertex + 1] - offsets[vertex];
+    }
+    return graph->adj_list[vertex].count;
+}
+
+/**
+ * Initialize an edge iterator over the neighbor arrays of a vertex
+ */
+sssp_error_t sssp_edge_iterator_init(const sssp_graph_t* graph, vertex_id_t vertex,
+                                      sssp_edge_iterator_t* iter) {
+    if (!iter) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    memset(iter, 0, sizeof(*iter));
+    sssp_error_t result = sssp_graph_neighbors(graph, vertex, &iter->targets, &iter->weights, &iter->count);
+    if (result != SSSP_SUCCESS) {
+        return result;
+    }
+    iter->graph = graph;
+    iter->current_vertex = vertex;
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Hand out the next edge of an iterator
+ */
+bool sssp_edge_iterator_next(sssp_edge_iterator_t* iter, const sssp_edge_node_t** edge_out) {
+    if (!iter || !edge_out || iter->position >= iter->count) {
+        return false;
+    }
+    iter->current_edge.to = iter->targets[iter->position];
+    iter->current_edge.weight = iter->weights[iter->position];
+    iter->current_edge.next = NULL;
+    iter->position++;
+    *edge_out = &iter->current_edge;
+    return true;
+}
+
 /**
  * Destroy a graph and free all associated memory
  */
@@ -70,18 +570,25 @@ void sssp_graph_destroy(sssp_graph_t* graph) {
     
     const sssp_allocator_t* allocator = graph->allocator;
     
-    // Free all edge nodes
-    for (vertex_count_t i = 0; i < graph->num_vertices; i++) {
-        sssp_edge_node_t* current = graph->adj_list[i].head;
-        while (current) {
-            sssp_edge_node_t* next = current->next;
-            sssp_free(allocator, current);
-            current = next;
+    // Free all edge nodes (nodes built from CSR storage live in edge_pool)
+    if (graph->adj_list) {
+        for (vertex_count_t i = 0; i < graph->num_vertices; i++) {
+            sssp_edge_node_t* current = graph->adj_list[i].head;
+            while (current) {
+                sssp_edge_node_t* next = current->next;
+                if (!is_pool_node(graph, current)) {
+                    sssp_free(allocator, current);
+                }
+                current = next;
+            }
         }
     }
     
-    // Free adjacency list array
+    // Free adjacency list array and contiguous storage
     sssp_free(allocator, graph->adj_list);
+    sssp_free(allocator, graph->edge_pool);
+    release_csr(graph);
+    release_reverse(graph);
     
     // Free graph structure
     sssp_free(allocator, graph);
@@ -89,6 +596,21 @@ void sssp_graph_destroy(sssp_graph_t* graph) {
     SSSP_LOG_DEBUG("Graph destroyed successfully");
 }
 
+/**
+ * Opt in to (or out of) negative edge weights
+ */
+sssp_error_t sssp_graph_allow_negative_weights(sssp_graph_t* graph, bool allow) {
+    if (!graph) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (!allow && graph->has_negative_weights) {
+        SSSP_LOG_ERROR("Graph already has negative edge weights");
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    graph->allow_negative_weights = allow;
+    return SSSP_SUCCESS;
+}
+
 /**
  * Add an edge to the graph
  */
@@ -105,13 +627,25 @@ sssp_error_t sssp_graph_add_edge(sssp_graph_t* graph, vertex_id_t from, vertex_i
         return SSSP_ERROR_INVALID_PARAMETER;
     }
     
-    if (weight < 0) {
-        SSSP_LOG_ERROR("Negative edge weight not supported: %f", weight);
+    if (weight < 0 && !graph->allow_negative_weights) {
+        SSSP_LOG_ERROR("Negative edge weight not allowed on this graph: %f", weight);
         return SSSP_ERROR_INVALID_PARAMETER;
     }
     
     SSSP_LOG_TRACE("Adding edge: %u -> %u (weight=%.2f)", from, to, weight);
     
+    // In-edges are rebuilt on next use
+    release_reverse(graph);
+    
+    // CSR storage is immutable; move the graph to list storage first
+    if (graph->csr_offsets) {
+        sssp_error_t result = sssp_graph_build_adj_lists(graph);
+        if (result != SSSP_SUCCESS) {
+            return result;
+        }
+        release_csr(graph);
+    }
+    
     // Allocate new edge node
     sssp_edge_node_t* edge_node = sssp_alloc(graph->allocator, sizeof(sssp_edge_node_t));
     if (!edge_node) {
@@ -127,6 +661,7 @@ sssp_error_t sssp_graph_add_edge(sssp_graph_t* graph, vertex_id_t from, vertex_i
     // Insert at head of adjacency list
     graph->adj_list[from].head = edge_node;
     graph->adj_list[from].count++;
+    graph->has_negative_weights |= weight < 0;
     graph->num_edges++;
     graph->total_edges++;  // Update total_edges as well
     
@@ -155,6 +690,33 @@ bool sssp_graph_is_valid(const sssp_graph_t* graph) {
         return false;
     }
     
+    if (graph->csr_offsets && !graph->adj_list) {
+        const edge_count_t* offsets = graph->csr_offsets;
+        if (offsets[0] != 0 || offsets[graph->num_vertices] != graph->num_edges) {
+            SSSP_LOG_ERROR("CSR offsets do not cover %u edges", graph->num_edges);
+            return false;
+        }
+        for (vertex_count_t i = 0; i < graph->num_vertices; i++) {
+            if (offsets[i] > offsets[i + 1]) {
+                SSSP_LOG_ERROR("CSR offsets decrease at vertex %u", i);
+                return false;
+            }
+            for (edge_count_t e = offsets[i]; e < offsets[i + 1]; e++) {
+                if (graph->csr_targets[e] >= graph->num_vertices) {
+                    SSSP_LOG_ERROR("Invalid destination vertex %u in adjacency list of %u",
+                                   graph->csr_targets[e], i);
+                    return false;
+                }
+                if (graph->csr_weights[e] < 0 && !graph->allow_negative_weights) {
+                    SSSP_LOG_ERROR("Negative edge weight %.2f in edge %u -> %u",
+                                   graph->csr_weights[e], i, graph->csr_targets[e]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
     if (!graph->adj_list) {
         SSSP_LOG_ERROR("Graph adjacency list is NULL");
         return false;
@@ -174,7 +736,7 @@ bool sssp_graph_is_valid(const sssp_graph_t* graph) {
                                current->to, i);
                 return false;
             }
-            if (current->weight < 0) {
+            if (current->weight < 0 && !graph->allow_negative_weights) {
                 SSSP_LOG_ERROR("Negative edge weight %.2f in edge %u -> %u", 
                                current->weight, i, current->to);
                 return false;
@@ -247,6 +809,11 @@ sssp_graph_t* sssp_graph_load_from_file(const char* filename, const sssp_allocat
     
     fclose(file);
     
+    // Travel times and the like are usually whole or fixed-point numbers
+    if (sssp_graph_build_integer_weights(graph) == SSSP_SUCCESS) {
+        SSSP_LOG_INFO("Using integer weights at scale %u", graph->weight_scale);
+    }
+    
     SSSP_LOG_INFO("Successfully loaded graph: %u vertices, %u edges", 
                   num_vertices, edges_read);
     
@@ -276,6 +843,12 @@ sssp_error_t sssp_graph_save_to_file(const sssp_graph_t* graph, const char* file
     
     // Write all edges
     for (vertex_count_t i = 0; i < graph->num_vertices; i++) {
+        if (graph->csr_offsets) {
+            for (edge_count_t e = graph->csr_offsets[i]; e < graph->csr_offsets[i + 1]; e++) {
+                fprintf(file, "%u %u %.6f\n", i, graph->csr_targets[e], graph->csr_weights[e]);
+            }
+            continue;
+        }
         sssp_edge_node_t* current = graph->adj_list[i].head;
         while (current) {
             fprintf(file, "%u %u %.6f\n", i, current->to, current->weight);
@@ -311,7 +884,7 @@ void sssp_graph_print_stats(const sssp_graph_t* graph) {
         edge_count_t total_degree = 0;
         
         for (vertex_count_t i = 0; i < graph->num_vertices; i++) {
-            edge_count_t degree = graph->adj_list[i].count;
+            edge_count_t degree = sssp_graph_out_degree(graph, i);
             if (degree < min_degree) min_degree = degree;
             if (degree > max_degree) max_degree = degree;
             total_degree += degree;
@@ -323,6 +896,44 @@ void sssp_graph_print_stats(const sssp_graph_t* graph) {
         printf("  Min degree: %u\n", min_degree);
         printf("  Max degree: %u\n", max_degree);
         printf("  Density: %.6f\n", 
-               (double)graph->num_edges / (graph->num_vertices * (graph->num_vertices - 1)));
+               (double)graph->num_edges / ((double)graph->num_vertices * (graph->num_vertices - 1)));
     }
 }
+
+/**
+ * Compute the memory held by a graph
+ */
+sssp_memory_stats_t sssp_graph_memory_stats(const sssp_graph_t* graph) {
+    sssp_memory_stats_t stats;
+    sssp_memory_stats_reset(&stats);
+    if (!graph) return stats;
+    
+    sssp_memory_stats_add_allocation(&stats, sizeof(sssp_graph_t));
+    if (graph->adj_list) {
+        sssp_memory_stats_add_allocation(&stats, (size_t)graph->num_vertices * sizeof(sssp_adj_list_t));
+        
+        // Nodes outside the pool were allocated one at a time by add_edge
+        size_t loose_nodes = graph->num_edges - graph->edge_pool_size;
+        stats.current_bytes += loose_nodes * sizeof(sssp_edge_node_t);
+        stats.peak_bytes = stats.current_bytes;
+        stats.total_allocations += loose_nodes;
+    }
+    if (graph->edge_pool) {
+        sssp_memory_stats_add_allocation(&stats, (size_t)graph->edge_pool_size * sizeof(sssp_edge_node_t));
+    }
+    if (sssp_graph_is_csr(graph)) {
+        sssp_memory_stats_add_allocation(&stats, ((size_t)graph->num_vertices + 1) * sizeof(edge_count_t));
+        sssp_memory_stats_add_allocation(&stats, (size_t)graph->num_edges * sizeof(vertex_id_t));
+        sssp_memory_stats_add_allocation(&stats, (size_t)graph->num_edges * sizeof(weight_t));
+    }
+    if (graph->int_weights) {
+        sssp_memory_stats_add_allocation(&stats, (size_t)graph->num_edges * sizeof(uint32_t));
+    }
+    if (graph->reverse_offsets) {
+        sssp_memory_stats_add_allocation(&stats, ((size_t)graph->num_vertices + 1) * sizeof(edge_count_t));
+        sssp_memory_stats_add_allocation(&stats, (size_t)graph->num_edges * sizeof(vertex_id_t));
+        sssp_memory_stats_add_allocation(&stats, (size_t)graph->num_edges * sizeof(weight_t));
+    }
+    
+    return stats;
+}
@@ -0,0 +1,876 @@
+/**
+ * @file graph_generators.c
+ * @brief Seeded, parallel synthetic graph generators writing CSR storage
+ *
+ * Every generator works in two passes over a fixed set of work chunks. The
+ * first pass counts out-edges per vertex, the counts become CSR offsets, and
+ * the second pass replays the same random streams to write targets and
+ * weights in place. Chunks depend only on the generator parameters and each
+ * chunk has its own random stream, so the output is independent of the
+ * number of threads.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "graph.h"
+#include "sssp_common.h"
+#include "sssp_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Expected number of edges produced by one work chunk
+#define GENERATOR_CHUNK_EDGES 65536
+// Vertices per work chunk for generators that work vertex by vertex
+#define GENERATOR_CHUNK_VERTICES 16384
+// Rows shorter than this are sorted by insertion
+#define GENERATOR_INSERTION_SORT_LIMIT 16
+
+// Structure and weights of a chunk come from separate streams, so the first
+// pass does not have to draw weights it will not use
+#define STREAM_STRUCTURE(chunk) (2 * (uint64_t)(chunk))
+#define STREAM_WEIGHTS(chunk) (2 * (uint64_t)(chunk) + 1)
+#define STREAM_SETUP UINT64_MAX
+
+static bool valid_weight_range(weight_t min_weight, weight_t max_weight) {
+    return min_weight >= 0 && max_weight >= min_weight && isfinite(max_weight);
+}
+
+static inline weight_t random_weight(sssp_rng_t* rng, weight_t min_weight, weight_t max_weight) {
+    return min_weight + (max_weight - min_weight) * sssp_rng_uniform(rng);
+}
+
+/**
+ * Turn per-vertex counts stored at offsets[v + 1] into offsets and allocate
+ * the edge arrays
+ */
+static sssp_error_t counts_to_offsets(sssp_graph_t* graph) {
+    edge_count_t* offsets = graph->csr_offsets;
+    uint64_t total = 0;
+
+    offsets[0] = 0;
+    for (vertex_count_t v = 0; v < graph->num_vertices; v++) {
+        total += offsets[v + 1];
+        if (total > UINT32_MAX) {
+            SSSP_LOG_ERROR("Generated graph exceeds %u edges", UINT32_MAX);
+            return SSSP_ERROR_OVERFLOW;
+        }
+        offsets[v + 1] = (edge_count_t)total;
+    }
+
+    return sssp_graph_csr_reserve_edges(graph, (edge_count_t)total);
+}
+
+/*
+ * G(n,p) and G(n,m)
+ *
+ * The candidate edges of a chunk of rows form a sequence of rows * (n - 1)
+ * positions (self-loops excluded). Hits of a Bernoulli(p) process over that
+ * sequence are found with geometric skips, so each chunk costs O(hits).
+ *
+ * G(n,m) samples with a p slightly above m / N, retries in the rare case
+ * that fewer than m edges come out, and then drops a uniform subset of the
+ * surplus. A Bernoulli sample of size K is uniform over K-subsets, so the
+ * result is uniform over m-subsets.
+ */
+
+typedef struct bernoulli_job {
+    sssp_graph_t* graph;
+    vertex_count_t rows_per_chunk;
+    double log_q;                       ///< log(1 - p)
+    uint64_t seed;
+    weight_t min_weight;
+    weight_t max_weight;
+    uint64_t* chunk_hits;               ///< Pass 1: hits per chunk; pass 2: index of first hit
+    const uint64_t* drops;              ///< Sorted global hit indices to leave out
+    size_t num_drops;
+    bool fill;                          ///< false for the counting pass
+} bernoulli_job_t;
+
+static inline double geometric_skip(sssp_rng_t* rng, double log_q) {
+    double u = 1.0 - sssp_rng_uniform(rng);   // (0, 1]
+    return floor(log(u) / log_q);
+}
+
+static size_t lower_bound_u64(const uint64_t* values, size_t count, uint64_t key) {
+    size_t low = 0, high = count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (values[mid] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void bernoulli_chunk(bernoulli_job_t* job, size_t chunk) {
+    sssp_graph_t* graph = job->graph;
+    uint64_t n = graph->num_vertices;
+    uint64_t row_begin = (uint64_t)chunk * job->rows_per_chunk;
+    uint64_t row_end = SSSP_MIN(n, row_begin + job->rows_per_chunk);
+    uint64_t width = n - 1;
+    uint64_t span = (row_end - row_begin) * width;
+
+    sssp_rng_t rng, weight_rng;
+    sssp_rng_seed(&rng, job->seed, STREAM_STRUCTURE(chunk));
+    sssp_rng_seed(&weight_rng, job->seed, STREAM_WEIGHTS(chunk));
+
+    uint64_t hits = 0;
+    uint64_t global = job->fill ? job->chunk_hits[chunk] : 0;
+    size_t drop = job->fill ? lower_bound_u64(job->drops, job->num_drops, global) : 0;
+    edge_count_t out = job->fill ? graph->csr_offsets[row_begin] : 0;
+
+    // Row and column of the next candidate; division only when a skip
+    // crosses a row boundary
+    uint64_t position = 0, row = row_begin, column = 0;
+    while (position < span) {
+        double skip = geometric_skip(&rng, job->log_q);
+        if (skip >= (double)(span - position)) {
+            break;
+        }
+        position += (uint64_t)skip;
+        column += (uint64_t)skip;
+        if (column >= width) {
+            row += column / width;
+            column %= width;
+        }
+
+        if (!job->fill) {
+            graph->csr_offsets[row + 1]++;
+        } else if (drop < job->num_drops && job->drops[drop] == global) {
+            drop++;
+        } else {
+            graph->csr_targets[out] = (vertex_id_t)(column + (column >= row));
+            graph->csr_weights[out] = random_weight(&weight_rng, job->min_weight, job->max_weight);
+            out++;
+        }
+
+        global++;
+        hits++;
+        position++;
+        if (++column == width) {
+            row++;
+            column = 0;
+        }
+    }
+
+    if (!job->fill) {
+        job->chunk_hits[chunk] = hits;
+    }
+}
+
+static void bernoulli_body(size_t begin, size_t end, void* context) {
+    for (size_t chunk = begin; chunk < end; chunk++) {
+        bernoulli_chunk(context, chunk);
+    }
+}
+
+static bool hash_insert(uint64_t* table, uint64_t mask, uint64_t value) {
+    uint64_t slot = sssp_hash64(value) & mask;
+    while (table[slot] != 0) {
+        if (table[slot] == value + 1) {
+            return false;
+        }
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = value + 1;
+    return true;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Choose count distinct values from [0, total), sorted (Floyd's algorithm)
+ */
+static uint64_t* choose_sorted_subset(uint64_t total, uint64_t count, uint64_t seed,
+                                      const sssp_allocator_t* allocator) {
+    uint64_t capacity = 16;
+    while (capacity < 2 * count) {
+        capacity <<= 1;
+    }
+
+    uint64_t* table = sssp_alloc(allocator, capacity * sizeof(uint64_t));
+    uint64_t* values = sssp_alloc(allocator, count * sizeof(uint64_t));
+    if (!table || !values) {
+        sssp_free(allocator, table);
+        sssp_free(allocator, values);
+        return NULL;
+    }
+    memset(table, 0, capacity * sizeof(uint64_t));
+
+    sssp_rng_t rng;
+    sssp_rng_seed(&rng, seed, STREAM_SETUP);
+    size_t found = 0;
+    for (uint64_t j = total - count; j < total; j++) {
+        uint64_t t = sssp_rng_bounded(&rng, j + 1);
+        if (!hash_insert(table, capacity - 1, t)) {
+            t = j;
+            hash_insert(table, capacity - 1, t);
+        }
+        values[found++] = t;
+    }
+
+    sssp_free(allocator, table);
+    qsort(values, found, sizeof(uint64_t), compare_u64);
+    return values;
+}
+
+/**
+ * Shared driver for G(n,p) (exact_edges == UINT64_MAX) and G(n,m)
+ */
+static sssp_graph_t* generate_bernoulli(vertex_count_t num_vertices, double p,
+                                        uint64_t exact_edges,
+                                        weight_t min_weight, weight_t max_weight,
+                                        uint64_t seed, const sssp_allocator_t* allocator) {
+    sssp_graph_t* graph = sssp_graph_create_csr(num_vertices, allocator);
+    if (!graph) {
+        return NULL;
+    }
+    allocator = graph->allocator;
+
+    uint64_t width = num_vertices - 1;
+    double expected_row = p * (double)width;
+    double rows = expected_row > 0 ? GENERATOR_CHUNK_EDGES / expected_row : (double)num_vertices;
+    bernoulli_job_t job = {
+        .graph = graph,
+        .rows_per_chunk = (vertex_count_t)SSSP_MAX(1.0, SSSP_MIN(rows, (double)num_vertices)),
+        .log_q = log1p(-p),
+        .min_weight = min_weight,
+        .max_weight = max_weight,
+    };
+    size_t num_chunks = ((size_t)num_vertices + job.rows_per_chunk - 1) / job.rows_per_chunk;
+
+    job.chunk_hits = sssp_alloc(allocator, num_chunks * sizeof(uint64_t));
+    if (!job.chunk_hits) {
+        sssp_graph_destroy(graph);
+        return NULL;
+    }
+
+    // Pass 1: count hits per row. G(n,m) retries on the rare undershoot.
+    uint64_t total_hits = 0;
+    bool counted = p <= 0;
+    for (uint64_t attempt = 0; !counted && attempt < 64; attempt++) {
+        job.seed = attempt == 0 ? seed : sssp_hash64(seed ^ attempt);
+        memset(graph->csr_offsets, 0, ((size_t)num_vertices + 1) * sizeof(edge_count_t));
+        sssp_parallel_for(num_chunks, 1, bernoulli_body, &job);
+
+        total_hits = 0;
+        for (size_t c = 0; c < num_chunks; c++) {
+            total_hits += job.chunk_hits[c];
+        }
+        counted = exact_edges == UINT64_MAX || total_hits >= exact_edges;
+    }
+    if (p <= 0) {
+        memset(job.chunk_hits, 0, num_chunks * sizeof(uint64_t));
+    }
+
+    sssp_error_t result = counted ? SSSP_SUCCESS : SSSP_ERROR_ALGORITHM;
+    uint64_t num_drops = exact_edges == UINT64_MAX ? 0 : total_hits - exact_edges;
+    uint64_t* drops = NULL;
+    if (result == SSSP_SUCCESS && total_hits - num_drops > UINT32_MAX) {
+        SSSP_LOG_ERROR("Generated graph exceeds %u edges", UINT32_MAX);
+        result = SSSP_ERROR_OVERFLOW;
+    }
+    if (result == SSSP_SUCCESS && num_drops > 0) {
+        drops = choose_sorted_subset(total_hits, num_drops, job.seed, allocator);
+        if (!drops) {
+            result = SSSP_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    if (result == SSSP_SUCCESS) {
+        // Offsets, less the dropped hits of each row
+        edge_count_t* offsets = graph->csr_offsets;
+        uint64_t raw_total = 0;
+        size_t dropped = 0;
+        offsets[0] = 0;
+        for (vertex_count_t v = 0; v < num_vertices; v++) {
+            raw_total += offsets[v + 1];
+            while (dropped < num_drops && drops[dropped] < raw_total) {
+                dropped++;
+            }
+            offsets[v + 1] = (edge_count_t)(raw_total - dropped);
+        }
+
+        // Global index of the first hit of each chunk
+        uint64_t first = 0;
+        for (size_t c = 0; c < num_chunks; c++) {
+            uint64_t hits = job.chunk_hits[c];
+            job.chunk_hits[c] = first;
+            first += hits;
+        }
+
+        result = sssp_graph_csr_reserve_edges(graph, (edge_count_t)(total_hits - num_drops));
+    }
+
+    // Pass 2: replay the streams and write the edges
+    if (result == SSSP_SUCCESS && p > 0) {
+        job.fill = true;
+        job.drops = drops;
+        job.num_drops = num_drops;
+        sssp_parallel_for(num_chunks, 1, bernoulli_body, &job);
+    }
+
+    sssp_free(allocator, drops);
+    sssp_free(allocator, job.chunk_hits);
+    if (result != SSSP_SUCCESS) {
+        SSSP_LOG_ERROR("Random graph generation failed: %s", sssp_error_string(result));
+        sssp_graph_destroy(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+sssp_graph_t* sssp_graph_generate_random(vertex_count_t num_vertices,
+                                          double edge_probability,
+                                          weight_t min_weight,
+                                          weight_t max_weight,
+                                          unsigned int seed,
+                                          const sssp_allocator_t* allocator) {
+    if (!(edge_probability >= 0.0 && edge_probability <= 1.0) ||
+        !valid_weight_range(min_weight, max_weight)) {
+        SSSP_LOG_ERROR("Invalid G(n,p) parameters: p=%f, weights [%f, %f)",
+                       edge_probability, min_weight, max_weight);
+        return NULL;
+    }
+
+    SSSP_LOG_DEBUG("Generating G(n,p) graph: n=%u, p=%f", num_vertices, edge_probability);
+    return generate_bernoulli(num_vertices, edge_probability, UINT64_MAX,
+                              min_weight, max_weight, seed, allocator);
+}
+
+sssp_graph_t* sssp_graph_generate_gnm(vertex_count_t num_vertices,
+                                       edge_count_t num_edges,
+                                       weight_t min_weight,
+                                       weight_t max_weight,
+                                       uint64_t seed,
+                                       const sssp_allocator_t* allocator) {
+    uint64_t candidates = num_vertices > 0 ? (uint64_t)num_vertices * (num_vertices - 1) : 0;
+    if (num_edges > candidates || !valid_weight_range(min_weight, max_weight)) {
+        SSSP_LOG_ERROR("Invalid G(n,m) parameters: n=%u, m=%u, weights [%f, %f)",
+                       num_vertices, num_edges, min_weight, max_weight);
+        return NULL;
+    }
+
+    SSSP_LOG_DEBUG("Generating G(n,m) graph: n=%u, m=%u", num_vertices, num_edges);
+
+    // Oversample by a few standard deviations so that a retry is rare
+    double p = 0.0;
+    if (num_edges > 0) {
+        double m = (double)num_edges;
+        p = SSSP_MIN(1.0, (m + 4.0 * sqrt(m) + 16.0) / (double)candidates);
+    }
+    return generate_bernoulli(num_vertices, p, num_edges, min_weight, max_weight, seed, allocator);
+}
+
+/*
+ * R-MAT
+ */
+
+typedef struct rmat_job {
+    sssp_graph_t* graph;
+    unsigned int scale;
+    uint64_t num_edges;
+    uint32_t a, ab, abc;                ///< Cumulative quadrant probabilities, scaled by 2^32
+    uint64_t seed;
+    uint64_t scramble_key;
+    weight_t min_weight;
+    weight_t max_weight;
+    edge_count_t* cursor;               ///< Pass 2: next free slot per vertex
+} rmat_job_t;
+
+/**
+ * Threshold t such that a uniform 32-bit r satisfies r < t with probability p
+ */
+static uint32_t probability_threshold(double p) {
+    double scaled = p * 4294967296.0;
+    return scaled >= 4294967295.0 ? UINT32_MAX : (uint32_t)scaled;
+}
+
+/**
+ * Bijection on [0, 2^scale): odd multipliers and an xorshift are invertible
+ * modulo a power of two
+ */
+static inline vertex_id_t rmat_scramble(uint64_t v, unsigned int scale, uint64_t key) {
+    uint64_t mask = (1ULL << scale) - 1;
+    v = (v * 0x9E3779B97F4A7C15ULL + key) & mask;
+    v ^= v >> (scale / 2 + 1);
+    v = (v * 0xBF58476D1CE4E5B9ULL) & mask;
+    return (vertex_id_t)v;
+}
+
+static inline void rmat_edge(const rmat_job_t* job, sssp_rng_t* rng,
+                             vertex_id_t* from, vertex_id_t* to) {
+    uint64_t u, v;
+    do {
+        u = 0;
+        v = 0;
+        // Quadrant choice is branch-free: the draws are unpredictable by
+        // design, and each 64-bit draw serves two levels
+        uint64_t bits = 0;
+        for (unsigned int level = 0; level < job->scale; level++) {
+            if ((level & 1) == 0) {
+                bits = sssp_rng_next(rng);
+            }
+            uint32_t r = (uint32_t)bits;
+            bits >>= 32;
+            uint64_t bottom = r >= job->ab;
+            uint64_t right = (r >= job->a) & ((r < job->ab) | (r >= job->abc));
+            u = (u << 1) | bottom;
+            v = (v << 1) | right;
+        }
+    } while (u == v);
+
+    *from = rmat_scramble(u, job->scale, job->scramble_key);
+    *to = rmat_scramble(v, job->scale, job->scramble_key);
+}
+
+static void rmat_body(size_t begin, size_t end, void* context) {
+    rmat_job_t* job = context;
+    sssp_graph_t* graph = job->graph;
+
+    for (size_t chunk = begin; chunk < end; chunk++) {
+        uint64_t first = (uint64_t)chunk * GENERATOR_CHUNK_EDGES;
+        uint64_t last = SSSP_MIN(job->num_edges, first + GENERATOR_CHUNK_EDGES);
+
+        sssp_rng_t rng, weight_rng;
+        sssp_rng_seed(&rng, job->seed, STREAM_STRUCTURE(chunk));
+        sssp_rng_seed(&weight_rng, job->seed, STREAM_WEIGHTS(chunk));
+
+        for (uint64_t e = first; e < last; e++) {
+            vertex_id_t u, v;
+            rmat_edge(job, &rng, &u, &v);
+            if (!job->cursor) {
+                __atomic_fetch_add(&graph->csr_offsets[u + 1], 1, __ATOMIC_RELAXED);
+            } else {
+                edge_count_t slot = __atomic_fetch_add(&job->cursor[u], 1, __ATOMIC_RELAXED);
+                graph->csr_targets[slot] = v;
+                graph->csr_weights[slot] = random_weight(&weight_rng, job->min_weight,
+                                                         job->max_weight);
+            }
+        }
+    }
+}
+
+static inline bool edge_less(vertex_id_t t1, weight_t w1, vertex_id_t t2, weight_t w2) {
+    return t1 < t2 || (t1 == t2 && w1 < w2);
+}
+
+static inline void edge_swap(vertex_id_t* targets, weight_t* weights, size_t i, size_t j) {
+    vertex_id_t t = targets[i];
+    targets[i] = targets[j];
+    targets[j] = t;
+    weight_t w = weights[i];
+    weights[i] = weights[j];
+    weights[j] = w;
+}
+
+static void edge_sift_down(vertex_id_t* targets, weight_t* weights, size_t root, size_t count) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= count) {
+            return;
+        }
+        if (child + 1 < count &&
+            edge_less(targets[child], weights[child], targets[child + 1], weights[child + 1])) {
+            child++;
+        }
+        if (!edge_less(targets[root], weights[root], targets[child], weights[child])) {
+            return;
+        }
+        edge_swap(targets, weights, root, child);
+        root = child;
+    }
+}
+
+/**
+ * Sort one row by (target, weight) in place
+ */
+static void sort_edges(vertex_id_t* targets, weight_t* weights, size_t count) {
+    if (count <= GENERATOR_INSERTION_SORT_LIMIT) {
+        for (size_t i = 1; i < count; i++) {
+            for (size_t j = i; j > 0 &&
+                 edge_less(targets[j], weights[j], targets[j - 1], weights[j - 1]); j--) {
+                edge_swap(targets, weights, j, j - 1);
+            }
+        }
+        return;
+    }
+
+    for (size_t i = count / 2; i > 0; i--) {
+        edge_sift_down(targets, weights, i - 1, count);
+    }
+    for (size_t end = count - 1; end > 0; end--) {
+        edge_swap(targets, weights, 0, end);
+        edge_sift_down(targets, weights, 0, end);
+    }
+}
+
+static void sort_rows_body(size_t begin, size_t end, void* context) {
+    sssp_graph_t* graph = context;
+    for (size_t v = begin; v < end; v++) {
+        edge_count_t first = graph->csr_offsets[v];
+        edge_count_t last = graph->csr_offsets[v + 1];
+        sort_edges(graph->csr_targets + first, graph->csr_weights + first, last - first);
+    }
+}
+
+sssp_graph_t* sssp_graph_generate_rmat(unsigned int scale,
+                                        edge_count_t num_edges,
+                                        double a, double b, double c,
+                                        weight_t min_weight,
+                                        weight_t max_weight,
+                                        uint64_t seed,
+                                        const sssp_allocator_t* allocator) {
+    // b + c > 0 keeps self-loops (which are redrawn) from being certain
+    if (scale < 1 || scale > 30 || a < 0 || b < 0 || c < 0 || a + b + c > 1.0 ||
+        b + c <= 0 || !valid_weight_range(min_weight, max_weight)) {
+        SSSP_LOG_ERROR("Invalid R-MAT parameters: scale=%u, a=%f, b=%f, c=%f",
+                       scale, a, b, c);
+        return NULL;
+    }
+
+    SSSP_LOG_DEBUG("Generating R-MAT graph: scale=%u, m=%u", scale, num_edges);
+
+    sssp_graph_t* graph = sssp_graph_create_csr(1u << scale, allocator);
+    if (!graph) {
+        return NULL;
+    }
+    vertex_count_t n = graph->num_vertices;
+
+    rmat_job_t job = {
+        .graph = graph,
+        .scale = scale,
+        .num_edges = num_edges,
+        .a = probability_threshold(a),
+        .ab = probability_threshold(a + b),
+        .abc = probability_threshold(a + b + c),
+        .seed = seed,
+        .scramble_key = sssp_hash64(seed),
+        .min_weight = min_weight,
+        .max_weight = max_weight,
+    };
+    size_t num_chunks = ((size_t)num_edges + GENERATOR_CHUNK_EDGES - 1) / GENERATOR_CHUNK_EDGES;
+
+    // Pass 1: out-degrees
+    sssp_parallel_for(num_chunks, 1, rmat_body, &job);
+    sssp_error_t result = counts_to_offsets(graph);
+
+    // Pass 2: scatter edges into their rows
+    if (result == SSSP_SUCCESS) {
+        job.cursor = sssp_alloc(graph->allocator, (size_t)n * sizeof(edge_count_t));
+        if (!job.cursor) {
+            result = SSSP_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    if (result == SSSP_SUCCESS) {
+        memcpy(job.cursor, graph->csr_offsets, (size_t)n * sizeof(edge_count_t));
+        sssp_parallel_for(num_chunks, 1, rmat_body, &job);
+        sssp_free(graph->allocator, job.cursor);
+
+        // Scatter order depends on thread timing; sorting rows restores determinism
+        sssp_parallel_for(n, GENERATOR_CHUNK_VERTICES, sort_rows_body, graph);
+    }
+
+    if (result != SSSP_SUCCESS) {
+        SSSP_LOG_ERROR("R-MAT generation failed: %s", sssp_error_string(result));
+        sssp_graph_destroy(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+/*
+ * Grids
+ */
+
+typedef struct grid_job {
+    sssp_graph_t* graph;
+    uint64_t nx, ny, nz;
+    bool diagonal_edges;
+    weight_t min_weight;
+    weight_t max_weight;
+    uint64_t key;
+    bool fill;
+} grid_job_t;
+
+/**
+ * Weight factor of an undirected grid edge, the same in both directions
+ */
+static inline weight_t grid_factor(const grid_job_t* job, uint64_t u, uint64_t v) {
+    if (job->min_weight == job->max_weight) {
+        return job->min_weight;
+    }
+    uint64_t low = SSSP_MIN(u, v), high = SSSP_MAX(u, v);
+    uint64_t bits = sssp_hash64(job->key ^ sssp_hash64((low << 32) | high));
+    double unit = (double)(bits >> 11) * (1.0 / 9007199254740992.0);
+    return job->min_weight + (job->max_weight - job->min_weight) * unit;
+}
+
+static void grid_body(size_t begin, size_t end, void* context) {
+    grid_job_t* job = context;
+    sssp_graph_t* graph = job->graph;
+    static const double step_length[4] = {0.0, 1.0, 1.4142135623730951, 1.7320508075688772};
+
+    for (size_t u = begin; u < end; u++) {
+        uint64_t x = u % job->nx;
+        uint64_t y = (u / job->nx) % job->ny;
+        uint64_t z = u / (job->nx * job->ny);
+        edge_count_t out = job->fill ? graph->csr_offsets[u] : 0;
+        edge_count_t degree = 0;
+
+        for (int dz = -1; dz <= 1; dz++) {
+            if ((dz < 0 && z == 0) || (dz > 0 && z + 1 >= job->nz)) continue;
+            for (int dy = -1; dy <= 1; dy++) {
+                if ((dy < 0 && y == 0) || (dy > 0 && y + 1 >= job->ny)) continue;
+                for (int dx = -1; dx <= 1; dx++) {
+                    if ((dx < 0 && x == 0) || (dx > 0 && x + 1 >= job->nx)) continue;
+
+                    int axes = (dx != 0) + (dy != 0) + (dz != 0);
+                    if (axes == 0 || (axes > 1 && !job->diagonal_edges)) continue;
+
+                    if (!job->fill) {
+                        degree++;
+                        continue;
+                    }
+                    uint64_t v = u + (int64_t)dx + (int64_t)dy * (int64_t)job->nx +
+                                 (int64_t)dz * (int64_t)(job->nx * job->ny);
+                    graph->csr_targets[out] = (vertex_id_t)v;
+                    graph->csr_weights[out] = step_length[axes] * grid_factor(job, u, v);
+                    out++;
+                }
+            }
+        }
+
+        if (!job->fill) {
+            graph->csr_offsets[u + 1] = degree;
+        }
+    }
+}
+
+sssp_graph_t* sssp_graph_generate_grid_3d(vertex_count_t nx,
+                                           vertex_count_t ny,
+                                           vertex_count_t nz,
+                                           bool diagonal_edges,
+                                           weight_t min_weight,
+                                           weight_t max_weight,
+                                           uint64_t seed,
+                                           const sssp_allocator_t* allocator) {
+    uint64_t n = (uint64_t)nx * ny * nz;
+    if (n == 0 || n > SSSP_MAX_VERTICES || !valid_weight_range(min_weight, max_weight)) {
+        SSSP_LOG_ERROR("Invalid grid parameters: %u x %u x %u, weights [%f, %f)",
+                       nx, ny, nz, min_weight, max_weight);
+        return NULL;
+    }
+
+    SSSP_LOG_DEBUG("Generating grid graph: %u x %u x %u%s", nx, ny, nz,
+                   diagonal_edges ? " with diagonals" : "");
+
+    sssp_graph_t* graph = sssp_graph_create_csr((vertex_count_t)n, allocator);
+    if (!graph) {
+        return NULL;
+    }
+
+    grid_job_t job = {
+        .graph = graph,
+        .nx = nx,
+        .ny = ny,
+        .nz = nz,
+        .diagonal_edges = diagonal_edges,
+        .min_weight = min_weight,
+        .max_weight = max_weight,
+        .key = sssp_hash64(seed),
+    };
+
+    sssp_parallel_for(n, GENERATOR_CHUNK_VERTICES, grid_body, &job);
+    sssp_error_t result = counts_to_offsets(graph);
+    if (result != SSSP_SUCCESS) {
+        sssp_graph_destroy(graph);
+        return NULL;
+    }
+
+    job.fill = true;
+    sssp_parallel_for(n, GENERATOR_CHUNK_VERTICES, grid_body, &job);
+    return graph;
+}
+
+sssp_graph_t* sssp_graph_generate_grid(vertex_count_t rows,
+                                        vertex_count_t cols,
+                                        bool diagonal_edges,
+                                        const sssp_allocator_t* allocator) {
+    return sssp_graph_generate_grid_3d(cols, rows, 1, diagonal_edges, 1.0, 1.0, 0, allocator);
+}
+
+/*
+ * Random geometric graphs
+ */
+
+typedef struct geometric_job {
+    sssp_graph_t* graph;
+    double* xs;
+    double* ys;
+    const edge_count_t* cell_start;     ///< Points of cell k are [cell_start[k], cell_start[k + 1])
+    uint64_t cells;                     ///< Cells per side
+    double radius;
+    uint64_t seed;
+    bool fill;
+} geometric_job_t;
+
+static inline uint64_t geometric_cell(double coordinate, uint64_t cells) {
+    return SSSP_MIN((uint64_t)(coordinate * (double)cells), cells - 1);
+}
+
+static void geometric_points_body(size_t begin, size_t end, void* context) {
+    geometric_job_t* job = context;
+    for (size_t chunk = begin; chunk < end; chunk++) {
+        size_t first = chunk * GENERATOR_CHUNK_VERTICES;
+        size_t last = SSSP_MIN((size_t)job->graph->num_vertices, first + GENERATOR_CHUNK_VERTICES);
+
+        sssp_rng_t rng;
+        sssp_rng_seed(&rng, job->seed, STREAM_STRUCTURE(chunk));
+        for (size_t i = first; i < last; i++) {
+            job->xs[i] = sssp_rng_uniform(&rng);
+            job->ys[i] = sssp_rng_uniform(&rng);
+        }
+    }
+}
+
+static void geometric_edges_body(size_t begin, size_t end, void* context) {
+    geometric_job_t* job = context;
+    sssp_graph_t* graph = job->graph;
+    double radius_squared = job->radius * job->radius;
+
+    for (size_t u = begin; u < end; u++) {
+        uint64_t cx = geometric_cell(job->xs[u], job->cells);
+        uint64_t cy = geometric_cell(job->ys[u], job->cells);
+        edge_count_t out = job->fill ? graph->csr_offsets[u] : 0;
+        edge_count_t degree = 0;
+
+        for (uint64_t y = cy > 0 ? cy - 1 : 0; y <= cy + 1 && y < job->cells; y++) {
+            for (uint64_t x = cx > 0 ? cx - 1 : 0; x <= cx + 1 && x < job->cells; x++) {
+                uint64_t cell = y * job->cells + x;
+                for (edge_count_t v = job->cell_start[cell]; v < job->cell_start[cell + 1]; v++) {
+                    if (v == u) continue;
+                    double dx = job->xs[u] - job->xs[v];
+                    double dy = job->ys[u] - job->ys[v];
+                    double distance_squared = dx * dx + dy * dy;
+                    if (distance_squared > radius_squared) continue;
+
+                    if (!job->fill) {
+                        degree++;
+                    } else {
+                        graph->csr_targets[out] = v;
+                        graph->csr_weights[out] = sqrt(distance_squared);
+                        out++;
+                    }
+                }
+            }
+        }
+
+        if (!job->fill) {
+            graph->csr_offsets[u + 1] = degree;
+        }
+    }
+}
+
+sssp_graph_t* sssp_graph_generate_geometric(vertex_count_t num_vertices,
+                                             double radius,
+                                             uint64_t seed,
+                                             const sssp_allocator_t* allocator) {
+    if (num_vertices == 0 || !(radius > 0) || !isfinite(radius)) {
+        SSSP_LOG_ERROR("Invalid geometric graph parameters: n=%u, radius=%f",
+                       num_vertices, radius);
+        return NULL;
+    }
+
+    SSSP_LOG_DEBUG("Generating geometric graph: n=%u, radius=%f", num_vertices, radius);
+
+    sssp_graph_t* graph = sssp_graph_create_csr(num_vertices, allocator);
+    if (!graph) {
+        return NULL;
+    }
+    allocator = graph->allocator;
+
+    // Cells at least radius wide, and no more cells than points
+    uint64_t cells = (uint64_t)SSSP_MIN(1.0 / radius, ceil(sqrt((double)num_vertices)));
+    if (cells < 1) cells = 1;
+    uint64_t num_cells = cells * cells;
+
+    size_t coordinates_size = (size_t)num_vertices * sizeof(double);
+    double* xs = sssp_alloc(allocator, coordinates_size);
+    double* ys = sssp_alloc(allocator, coordinates_size);
+    double* sorted_xs = sssp_alloc(allocator, coordinates_size);
+    double* sorted_ys = sssp_alloc(allocator, coordinates_size);
+    edge_count_t* cell_start = sssp_alloc(allocator, (num_cells + 1) * sizeof(edge_count_t));
+
+    sssp_error_t result = SSSP_SUCCESS;
+    if (!xs || !ys || !sorted_xs || !sorted_ys || !cell_start) {
+        result = SSSP_ERROR_OUT_OF_MEMORY;
+    }
+
+    geometric_job_t job = {
+        .graph = graph,
+        .xs = xs,
+        .ys = ys,
+        .cell_start = cell_start,
+        .cells = cells,
+        .radius = radius,
+        .seed = seed,
+    };
+
+    if (result == SSSP_SUCCESS) {
+        size_t num_chunks = ((size_t)num_vertices + GENERATOR_CHUNK_VERTICES - 1) /
+                            GENERATOR_CHUNK_VERTICES;
+        sssp_parallel_for(num_chunks, 1, geometric_points_body, &job);
+
+        // Counting sort by cell; a point's vertex id is its sorted position
+        memset(cell_start, 0, (num_cells + 1) * sizeof(edge_count_t));
+        for (vertex_count_t i = 0; i < num_vertices; i++) {
+            cell_start[geometric_cell(ys[i], cells) * cells + geometric_cell(xs[i], cells) + 1]++;
+        }
+        for (uint64_t k = 0; k < num_cells; k++) {
+            cell_start[k + 1] += cell_start[k];
+        }
+        for (vertex_count_t i = 0; i < num_vertices; i++) {
+            uint64_t cell = geometric_cell(ys[i], cells) * cells + geometric_cell(xs[i], cells);
+            edge_count_t slot = cell_start[cell]++;
+            sorted_xs[slot] = xs[i];
+            sorted_ys[slot] = ys[i];
+        }
+        for (uint64_t k = num_cells; k > 0; k--) {
+            cell_start[k] = cell_start[k - 1];
+        }
+        cell_start[0] = 0;
+
+        job.xs = sorted_xs;
+        job.ys = sorted_ys;
+        sssp_parallel_for(num_vertices, GENERATOR_CHUNK_VERTICES, geometric_edges_body, &job);
+        result = counts_to_offsets(graph);
+    }
+
+    if (result == SSSP_SUCCESS) {
+        job.fill = true;
+        sssp_parallel_for(num_vertices, GENERATOR_CHUNK_VERTICES, geometric_edges_body, &job);
+    }
+
+    sssp_free(allocator, xs);
+    sssp_free(allocator, ys);
+    sssp_free(allocator, sorted_xs);
+    sssp_free(allocator, sorted_ys);
+    sssp_free(allocator, cell_start);
+
+    if (result != SSSP_SUCCESS) {
+        SSSP_LOG_ERROR("Geometric graph generation failed: %s", sssp_error_string(result));
+        sssp_graph_destroy(graph);
+        return NULL;
+    }
+    return graph;
+}
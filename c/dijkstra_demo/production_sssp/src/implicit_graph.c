@@ -0,0 +1,314 @@
+/**
+ * @file implicit_graph.c
+ * @brief Implicit graphs and Dijkstra's algorithm over them
+ *
+ * The search keeps a binary heap with lazy deletion: improving a vertex
+ * pushes a new entry and outdated entries are skipped when popped. That
+ * avoids a per-vertex heap position array, so the only O(n) state is the
+ * caller's distance and predecessor arrays.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "implicit_graph.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define IMPLICIT_SQRT2 1.41421356237309504880
+#define IMPLICIT_INITIAL_FRONTIER 1024
+// Vertices per chunk when clearing the output arrays in parallel
+#define IMPLICIT_INIT_GRAIN 65536
+
+/*
+ * Grid map
+ */
+
+typedef struct implicit_grid {
+    sssp_implicit_graph_t base;
+    vertex_count_t rows;
+    vertex_count_t cols;
+    bool diagonal_moves;
+    const weight_t* cell_costs;
+    const sssp_allocator_t* allocator;
+} implicit_grid_t;
+
+static const int grid_dr[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+static const int grid_dc[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+static vertex_count_t grid_neighbors(const sssp_implicit_graph_t* graph,
+                                     vertex_id_t vertex,
+                                     vertex_id_t* targets,
+                                     weight_t* weights) {
+    const implicit_grid_t* grid = graph->context;
+    const vertex_count_t rows = grid->rows;
+    const vertex_count_t cols = grid->cols;
+    const vertex_count_t r = vertex / cols;
+    const vertex_count_t c = vertex % cols;
+    const int moves = grid->diagonal_moves ? 8 : 4;
+    vertex_count_t count = 0;
+
+    for (int k = 0; k < moves; k++) {
+        // Unsigned wrap-around turns -1 into a value >= rows / cols
+        const vertex_count_t nr = r + (vertex_count_t)grid_dr[k];
+        const vertex_count_t nc = c + (vertex_count_t)grid_dc[k];
+        if (nr >= rows || nc >= cols) {
+            continue;
+        }
+
+        const vertex_id_t v = nr * cols + nc;
+        weight_t w = k < 4 ? 1.0 : IMPLICIT_SQRT2;
+        if (grid->cell_costs) {
+            const weight_t cost = grid->cell_costs[v];
+            if (!(cost >= 0) || isinf(cost)) {
+                continue;
+            }
+            w *= cost;
+        }
+
+        targets[count] = v;
+        weights[count] = w;
+        count++;
+    }
+
+    return count;
+}
+
+static void grid_destroy(sssp_implicit_graph_t* graph) {
+    implicit_grid_t* grid = graph->context;
+    sssp_free(grid->allocator, grid);
+}
+
+static const sssp_implicit_graph_ops_t grid_ops = {
+    .neighbors = grid_neighbors,
+    .destroy = grid_destroy,
+};
+
+sssp_implicit_graph_t* sssp_implicit_grid_create(vertex_count_t rows,
+                                                 vertex_count_t cols,
+                                                 bool diagonal_moves,
+                                                 const weight_t* cell_costs,
+                                                 const sssp_allocator_t* allocator) {
+    vertex_count_t num_vertices;
+    if (rows == 0 || cols == 0 ||
+        !sssp_safe_mul_vertex_count(rows, cols, &num_vertices) ||
+        num_vertices > SSSP_MAX_VERTICES) {
+        SSSP_LOG_ERROR("Invalid implicit grid size %u x %u", rows, cols);
+        return NULL;
+    }
+
+    if (allocator == NULL) {
+        allocator = &SSSP_DEFAULT_ALLOCATOR;
+    }
+
+    implicit_grid_t* grid = sssp_alloc(allocator, sizeof(implicit_grid_t));
+    if (!grid) {
+        SSSP_LOG_ERROR("Failed to allocate implicit grid");
+        return NULL;
+    }
+
+    grid->base.ops = &grid_ops;
+    grid->base.num_vertices = num_vertices;
+    grid->base.max_degree = diagonal_moves ? 8 : 4;
+    grid->base.context = grid;
+    grid->rows = rows;
+    grid->cols = cols;
+    grid->diagonal_moves = diagonal_moves;
+    grid->cell_costs = cell_costs;
+    grid->allocator = allocator;
+
+    SSSP_LOG_DEBUG("Created implicit %ux%u grid", rows, cols);
+    return &grid->base;
+}
+
+void sssp_implicit_graph_destroy(sssp_implicit_graph_t* graph) {
+    if (graph && graph->ops && graph->ops->destroy) {
+        graph->ops->destroy(graph);
+    }
+}
+
+/*
+ * Search
+ */
+
+typedef struct frontier_entry {
+    distance_t distance;
+    vertex_id_t vertex;
+} frontier_entry_t;
+
+typedef struct frontier {
+    frontier_entry_t* entries;
+    size_t size;
+    size_t capacity;
+} frontier_t;
+
+static sssp_error_t frontier_push(frontier_t* frontier, distance_t distance, vertex_id_t vertex) {
+    if (frontier->size == frontier->capacity) {
+        size_t capacity = frontier->capacity * 2;
+        frontier_entry_t* entries = sssp_realloc(&SSSP_DEFAULT_ALLOCATOR, frontier->entries,
+                                                 capacity * sizeof(frontier_entry_t));
+        if (!entries) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        frontier->entries = entries;
+        frontier->capacity = capacity;
+    }
+
+    frontier_entry_t* entries = frontier->entries;
+    size_t i = frontier->size++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (entries[parent].distance <= distance) {
+            break;
+        }
+        entries[i] = entries[parent];
+        i = parent;
+    }
+    entries[i].distance = distance;
+    entries[i].vertex = vertex;
+    return SSSP_SUCCESS;
+}
+
+static frontier_entry_t frontier_pop(frontier_t* frontier) {
+    frontier_entry_t* entries = frontier->entries;
+    frontier_entry_t top = entries[0];
+    frontier_entry_t last = entries[--frontier->size];
+    size_t size = frontier->size;
+    size_t i = 0;
+
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && entries[child + 1].distance < entries[child].distance) {
+            child++;
+        }
+        if (last.distance <= entries[child].distance) {
+            break;
+        }
+        entries[i] = entries[child];
+        i = child;
+    }
+    if (size > 0) {
+        entries[i] = last;
+    }
+    return top;
+}
+
+typedef struct init_job {
+    distance_t* distances;
+    vertex_id_t* predecessors;
+} init_job_t;
+
+static void init_outputs(size_t begin, size_t end, void* context) {
+    init_job_t* job = context;
+    for (size_t v = begin; v < end; v++) {
+        job->distances[v] = SSSP_INFINITY;
+    }
+    if (job->predecessors) {
+        for (size_t v = begin; v < end; v++) {
+            job->predecessors[v] = SSSP_INVALID_VERTEX;
+        }
+    }
+}
+
+sssp_error_t sssp_implicit_solve(const sssp_implicit_graph_t* graph,
+                                 vertex_id_t source,
+                                 vertex_id_t target,
+                                 distance_t max_distance,
+                                 distance_t* distances,
+                                 vertex_id_t* predecessors,
+                                 sssp_implicit_stats_t* stats) {
+    if (!graph || !graph->ops || !graph->ops->neighbors || !distances) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (source >= graph->num_vertices ||
+        (target != SSSP_INVALID_VERTEX && target >= graph->num_vertices) ||
+        max_distance < 0) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+
+    sssp_timer_t timer;
+    sssp_timer_start(&timer);
+
+    init_job_t init = { distances, predecessors };
+    sssp_error_t error = sssp_parallel_for(graph->num_vertices, IMPLICIT_INIT_GRAIN,
+                                           init_outputs, &init);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    const vertex_count_t max_degree = graph->max_degree > 0 ? graph->max_degree : 1;
+    vertex_id_t* targets = sssp_alloc(&SSSP_DEFAULT_ALLOCATOR, max_degree * sizeof(vertex_id_t));
+    weight_t* weights = sssp_alloc(&SSSP_DEFAULT_ALLOCATOR, max_degree * sizeof(weight_t));
+    frontier_t frontier = {
+        sssp_alloc(&SSSP_DEFAULT_ALLOCATOR, IMPLICIT_INITIAL_FRONTIER * sizeof(frontier_entry_t)),
+        0,
+        IMPLICIT_INITIAL_FRONTIER
+    };
+    if (!targets || !weights || !frontier.entries) {
+        error = SSSP_ERROR_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    uint64_t settled = 0;
+    uint64_t relaxed = 0;
+    size_t peak_frontier = 1;
+
+    distances[source] = 0.0;
+    frontier_push(&frontier, 0.0, source);
+
+    while (frontier.size > 0) {
+        frontier_entry_t top = frontier_pop(&frontier);
+        const vertex_id_t u = top.vertex;
+        const distance_t dist_u = top.distance;
+        if (dist_u > distances[u]) {
+            continue;   // Outdated entry
+        }
+
+        settled++;
+        if (u == target) {
+            break;
+        }
+
+        const vertex_count_t degree = graph->ops->neighbors(graph, u, targets, weights);
+        relaxed += degree;
+        for (vertex_count_t i = 0; i < degree; i++) {
+            const vertex_id_t v = targets[i];
+            const distance_t candidate = dist_u + weights[i];
+            if (candidate < distances[v] && candidate <= max_distance) {
+                distances[v] = candidate;
+                if (predecessors) {
+                    predecessors[v] = u;
+                }
+                error = frontier_push(&frontier, candidate, v);
+                if (error != SSSP_SUCCESS) {
+                    goto cleanup;
+                }
+            }
+        }
+        if (frontier.size > peak_frontier) {
+            peak_frontier = frontier.size;
+        }
+    }
+
+    sssp_timer_stop(&timer);
+    if (stats) {
+        stats->vertices_settled = settled;
+        stats->edges_relaxed = relaxed;
+        stats->peak_frontier = peak_frontier;
+        stats->total_time_ms = sssp_timer_elapsed_ms(&timer);
+    }
+
+    SSSP_LOG_DEBUG("Implicit search settled %llu vertices in %.3f ms",
+                   (unsigned long long)settled, sssp_timer_elapsed_ms(&timer));
+
+cleanup:
+    sssp_free(&SSSP_DEFAULT_ALLOCATOR, frontier.entries);
+    sssp_free(&SSSP_DEFAULT_ALLOCATOR, weights);
+    sssp_free(&SSSP_DEFAULT_ALLOCATOR, targets);
+    return error;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file integer_sssp.c
+ * @brief Single-source Dijkstra over integer weights with a radix heap
+ *
+ * Runs on the 32-bit weights built by sssp_graph_build_integer_weights().
+ * Distances are 64-bit integers, so sums are exact and a path of n - 1
+ * edges cannot overflow. They are divided by the weight scale only when
+ * copied into the result.
+ *
+ * The queue is a radix heap, which relies on Dijkstra's keys never falling
+ * below the last one removed. An entry with key k sits in bucket
+ * b = bit length of (k XOR last), so bucket 0 holds keys equal to last and
+ * every key in bucket b shares the bits of last above b - 1. Removing the
+ * minimum empties bucket 0 first; otherwise it takes the smallest key of
+ * the lowest non-empty bucket as the new last and spreads that bucket into
+ * strictly lower ones. Each entry moves down at most 64 times, and a push
+ * is one append with no sift. There is no decrease-key: an improved vertex
+ * is pushed again and its outdated entry skipped when it comes out.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "sssp_internal.h"
+#include <string.h>
+
+// Keys differ from last in at most 64 bits, plus the bucket for equal keys
+#define RADIX_BUCKETS 65
+
+// Distance of a vertex not reached yet
+#define INTEGER_UNREACHED UINT64_MAX
+
+typedef struct radix_entry {
+    uint64_t key;
+    vertex_id_t vertex;
+} radix_entry_t;
+
+typedef struct radix_bucket {
+    radix_entry_t* items;
+    size_t size;
+    size_t capacity;
+} radix_bucket_t;
+
+typedef struct radix_heap {
+    const sssp_allocator_t* allocator;
+    radix_bucket_t buckets[RADIX_BUCKETS];
+    uint64_t last;                      // Last key removed; no queued key is smaller
+    size_t size;
+} radix_heap_t;
+
+static inline unsigned int radix_bucket_index(uint64_t key, uint64_t last) {
+    return key == last ? 0 : 64 - (unsigned int)__builtin_clzll(key ^ last);
+}
+
+static inline sssp_error_t radix_append(radix_heap_t* heap, unsigned int index,
+                                        uint64_t key, vertex_id_t vertex) {
+    radix_bucket_t* bucket = &heap->buckets[index];
+    if (SSSP_UNLIKELY(bucket->size == bucket->capacity)) {
+        size_t capacity = bucket->capacity ? bucket->capacity * 2 : SSSP_INITIAL_CAPACITY;
+        radix_entry_t* items = sssp_realloc(heap->allocator, bucket->items, capacity * sizeof(radix_entry_t));
+        if (!items) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        bucket->items = items;
+        bucket->capacity = capacity;
+    }
+    bucket->items[bucket->size].key = key;
+    bucket->items[bucket->size].vertex = vertex;
+    bucket->size++;
+    return SSSP_SUCCESS;
+}
+
+static inline sssp_error_t radix_push(radix_heap_t* heap, uint64_t key, vertex_id_t vertex) {
+    heap->size++;
+    return radix_append(heap, radix_bucket_index(key, heap->last), key, vertex);
+}
+
+/**
+ * Remove an entry with the smallest key; the heap must not be empty
+ */
+static inline sssp_error_t radix_pop(radix_heap_t* heap, radix_entry_t* entry_out) {
+    if (heap->buckets[0].size == 0) {
+        unsigned int index = 1;
+        while (heap->buckets[index].size == 0) {
+            index++;
+        }
+        radix_bucket_t* bucket = &heap->buckets[index];
+        uint64_t smallest = bucket->items[0].key;
+        for (size_t i = 1; i < bucket->size; i++) {
+            smallest = SSSP_MIN(smallest, bucket->items[i].key);
+        }
+        heap->last = smallest;
+        // Every entry moves to a lower bucket, so items stays put meanwhile
+        size_t count = bucket->size;
+        bucket->size = 0;
+        for (size_t i = 0; i < count; i++) {
+            radix_entry_t entry = bucket->items[i];
+            sssp_error_t error = radix_append(heap, radix_bucket_index(entry.key, smallest),
+                                              entry.key, entry.vertex);
+            if (error != SSSP_SUCCESS) {
+                return error;
+            }
+        }
+    }
+    heap->size--;
+    *entry_out = heap->buckets[0].items[--heap->buckets[0].size];
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Working state of one integer solve
+ */
+typedef struct integer_state {
+    const sssp_allocator_t* allocator;
+    uint64_t* distances;
+    vertex_id_t* predecessors;
+    uint8_t* settled;
+    radix_heap_t heap;
+    uint64_t settled_count;
+    uint64_t relaxations;
+} integer_state_t;
+
+static sssp_error_t run_radix_dijkstra(integer_state_t* state, const sssp_graph_t* graph,
+                                       const sssp_algorithm_config_t* config) {
+    uint32_t check_interval = sssp_limit_check_interval(config->deadline_ns, config->cancel_token,
+                                                        config->limit_check_interval);
+    uint32_t until_check = check_interval;
+    sssp_error_t expired = sssp_check_query_limits(config->deadline_ns, config->cancel_token);
+    if (expired != SSSP_SUCCESS) {
+        return expired;
+    }
+
+    // Profiled as a split phase: pops against scans, sampled
+    sssp_profiler_t* profiler = sssp_profiler_current();
+    if (SSSP_UNLIKELY(profiler != NULL)) {
+        sssp_profiler_begin_split(profiler, SSSP_PHASE_HEAP_OPERATIONS, SSSP_PHASE_RELAXATION);
+    }
+
+    const edge_count_t* offsets = graph->csr_offsets;
+    const vertex_id_t* targets = graph->csr_targets;
+    const uint32_t* weights = graph->int_weights;
+    uint64_t* distances = state->distances;
+    radix_heap_t* heap = &state->heap;
+    while (heap->size > 0) {
+        bool sampled = SSSP_UNLIKELY(profiler != NULL) && sssp_profiler_sample_due(profiler);
+        uint64_t sample_start_ns = sampled ? sssp_get_timestamp_ns() : 0;
+        radix_entry_t top;
+        sssp_error_t result = radix_pop(heap, &top);
+        if (result != SSSP_SUCCESS) {
+            return result;
+        }
+        uint64_t scan_start_ns = sampled ? sssp_get_timestamp_ns() : 0;
+        vertex_id_t u = top.vertex;
+        if (top.key != distances[u]) {
+            if (sampled) {
+                sssp_profiler_add_sample(profiler, scan_start_ns - sample_start_ns, 0);
+            }
+            continue;                   // Outdated entry
+        }
+        state->settled[u] = 1;
+        state->settled_count++;
+
+        uint64_t dist_u = top.key;
+        edge_count_t end = offsets[u + 1];
+        state->relaxations += end - offsets[u];
+        for (edge_count_t e = offsets[u]; e < end; e++) {
+            vertex_id_t v = targets[e];
+            uint64_t candidate = dist_u + weights[e];
+            if (candidate < distances[v]) {
+                distances[v] = candidate;
+                state->predecessors[v] = u;
+                result = radix_push(heap, candidate, v);
+                if (result != SSSP_SUCCESS) {
+                    return result;
+                }
+            }
+        }
+        if (sampled) {
+            sssp_profiler_add_sample(profiler, scan_start_ns - sample_start_ns,
+                                     sssp_get_timestamp_ns() - scan_start_ns);
+        }
+
+        result = sssp_poll_query_limits(&until_check, check_interval, config->deadline_ns,
+                                        config->cancel_token);
+        if (result != SSSP_SUCCESS) {
+            return result;
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_solve_integer(const sssp_graph_t* graph, vertex_id_t source,
+                                const sssp_algorithm_config_t* config,
+                                sssp_algorithm_result_t* result) {
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    double scale = (double)graph->weight_scale;
+    uint64_t start_ns = sssp_get_timestamp_ns();
+
+    sssp_tracking_allocator_t tracker;
+    sssp_tracking_allocator_init(&tracker, config->allocator, config->memory_limit_bytes);
+
+    integer_state_t state;
+    memset(&state, 0, sizeof(state));
+    state.allocator = &tracker.allocator;
+    state.heap.allocator = state.allocator;
+    state.distances = sssp_alloc(state.allocator, n * sizeof(uint64_t));
+    state.predecessors = sssp_alloc(state.allocator, n * sizeof(vertex_id_t));
+    state.settled = sssp_alloc(state.allocator, n * sizeof(uint8_t));
+
+    sssp_error_t error = SSSP_SUCCESS;
+    if (!state.distances || !state.predecessors || !state.settled) {
+        error = SSSP_ERROR_OUT_OF_MEMORY;
+    } else {
+        for (vertex_count_t v = 0; v < n; v++) {
+            state.distances[v] = INTEGER_UNREACHED;
+            state.predecessors[v] = SSSP_INVALID_VERTEX;
+        }
+        memset(state.settled, 0, n * sizeof(uint8_t));
+        state.distances[source] = 0;
+        error = radix_push(&state.heap, 0, source);
+        if (error == SSSP_SUCCESS) {
+            error = run_radix_dijkstra(&state, graph, config);
+        }
+        SSSP_PROFILE_SWITCH(sssp_profiler_current(), SSSP_PHASE_FINALIZATION);
+    }
+    if (error == SSSP_ERROR_OUT_OF_MEMORY && tracker.limit_failures > 0) {
+        error = SSSP_ERROR_MEMORY_LIMIT;
+    }
+
+    if (error == SSSP_SUCCESS || sssp_error_is_interruption(error)) {
+        for (vertex_count_t v = 0; v < n; v++) {
+            uint64_t distance = state.distances[v];
+            result->distances[v] = distance == INTEGER_UNREACHED ? SSSP_INFINITY
+                                                                 : (distance_t)distance / scale;
+            result->predecessors[v] = state.predecessors[v];
+            if (state.settled[v]) {
+                sssp_vertex_set_add(result->processed_vertices, v);
+            }
+        }
+        result->vertices_processed = (vertex_count_t)state.settled_count;
+        result->relaxations_performed = state.relaxations;
+        result->recursive_calls = 1;
+        result->is_optimal = error == SSSP_SUCCESS;
+        result->validation_status = error;
+        result->approximation_bound = error == SSSP_SUCCESS ? 1.0 : SSSP_INFINITY;
+    }
+
+    for (unsigned int i = 0; i < RADIX_BUCKETS; i++) {
+        sssp_free(state.allocator, state.heap.buckets[i].items);
+    }
+    sssp_free(state.allocator, state.settled);
+    sssp_free(state.allocator, state.predecessors);
+    sssp_free(state.allocator, state.distances);
+    result->peak_memory_bytes = sssp_tracking_allocator_stats(&tracker).peak_bytes;
+    result->page_size = 0;
+    result->total_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+
+    SSSP_LOG_INFO("Integer SSSP (scale %.0f) settled %llu vertices in %.2f ms", scale,
+                  (unsigned long long)state.settled_count, result->total_time_ms);
+    return error;
+}
@@ -0,0 +1,592 @@
+/**
+ * @file negative_weights.c
+ * @brief Round-based SPFA and Johnson reweighting
+ *
+ * Each round relaxes the out-edges of the frontier, the vertices improved
+ * in the previous round. On one thread that is done in place. Large rounds
+ * on several threads take two steps instead:
+ *   1. scan: for every frontier vertex, find the out-edges that improve
+ *      their target, against the distances at the start of the round. This
+ *      only reads shared state, so frontier vertices are split across
+ *      threads, and long edge runs go through the SIMD relaxation kernels.
+ *   2. apply: walk the frontier in order and apply the improvements found,
+ *      rechecking each against the current distances.
+ * Either way, without a negative cycle round r leaves every vertex at most
+ * at its shortest r-edge distance, so the frontier is empty after n rounds.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "negative_weights.h"
+#include "relax_kernels.h"
+#include "sssp_internal.h"
+#include <string.h>
+
+// Rounds scanning fewer frontier edges stay on the calling thread
+#define BF_PARALLEL_MIN_EDGES 16384
+
+// Frontiers above 1/BF_SORTED_FRONTIER_FRACTION of the vertices are sorted
+#define BF_SORTED_FRONTIER_FRACTION 64
+
+// Frontier vertices per parallel chunk
+#define BF_GRAIN 64
+
+/**
+ * Working state of one Bellman-Ford pass over a CSR graph
+ */
+typedef struct bf_state {
+    const sssp_graph_t* graph;          // CSR graph
+    distance_t* distances;
+    vertex_id_t* predecessors;
+    vertex_id_t* frontier;              // Vertices to scan this round
+    vertex_id_t* next;                  // Vertices improved this round
+    vertex_count_t frontier_size;
+    uint8_t* queued;                    // Whether a vertex is in next
+    edge_count_t* first;                // Slot in improved of each frontier vertex's edges
+    edge_count_t* found;                // Improving edges of each frontier vertex
+    edge_count_t* improved;             // Offsets of improving edges within their runs
+    uint64_t scans;                     // Frontier vertices scanned
+    uint64_t relaxations;               // Edges scanned
+    uint32_t rounds;
+} bf_state_t;
+
+/**
+ * Copy any graph to a new CSR graph
+ */
+static sssp_graph_t* copy_to_csr(const sssp_graph_t* graph, const sssp_allocator_t* allocator) {
+    vertex_count_t n = graph->num_vertices;
+    sssp_graph_t* csr = sssp_graph_create_csr(n, allocator);
+    if (!csr || sssp_graph_csr_reserve_edges(csr, graph->num_edges) != SSSP_SUCCESS) {
+        sssp_graph_destroy(csr);
+        return NULL;
+    }
+
+    edge_count_t e = 0;
+    for (vertex_id_t u = 0; u < n; u++) {
+        csr->csr_offsets[u] = e;
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t count;
+        if (sssp_graph_neighbors(graph, u, &targets, &weights, &count) != SSSP_SUCCESS) {
+            sssp_graph_destroy(csr);
+            return NULL;
+        }
+        memcpy(csr->csr_targets + e, targets, count * sizeof(vertex_id_t));
+        memcpy(csr->csr_weights + e, weights, count * sizeof(weight_t));
+        e += count;
+    }
+    csr->csr_offsets[n] = e;
+    csr->has_negative_weights = graph->has_negative_weights;
+    csr->allow_negative_weights = graph->allow_negative_weights;
+    return csr;
+}
+
+static void bf_state_destroy(bf_state_t* state, const sssp_allocator_t* allocator) {
+    sssp_free(allocator, state->distances);
+    sssp_free(allocator, state->predecessors);
+    sssp_free(allocator, state->frontier);
+    sssp_free(allocator, state->next);
+    sssp_free(allocator, state->queued);
+    sssp_free(allocator, state->first);
+    sssp_free(allocator, state->found);
+    sssp_free(allocator, state->improved);
+}
+
+/**
+ * Allocate the state for a CSR graph, with every distance infinite
+ */
+static sssp_error_t bf_state_init(bf_state_t* state, const sssp_graph_t* graph,
+                                  const sssp_allocator_t* allocator) {
+    vertex_count_t n = graph->num_vertices;
+    memset(state, 0, sizeof(*state));
+    state->graph = graph;
+    state->distances = sssp_alloc(allocator, n * sizeof(distance_t));
+    state->predecessors = sssp_alloc(allocator, n * sizeof(vertex_id_t));
+    state->frontier = sssp_alloc(allocator, n * sizeof(vertex_id_t));
+    state->next = sssp_alloc(allocator, n * sizeof(vertex_id_t));
+    state->queued = sssp_alloc(allocator, n);
+    state->first = sssp_alloc(allocator, ((size_t)n + 1) * sizeof(edge_count_t));
+    state->found = sssp_alloc(allocator, n * sizeof(edge_count_t));
+    state->improved = sssp_alloc(allocator, SSSP_MAX(graph->num_edges, 1) * sizeof(edge_count_t));
+    if (!state->distances || !state->predecessors || !state->frontier || !state->next ||
+        !state->queued || !state->first || !state->found || !state->improved) {
+        bf_state_destroy(state, allocator);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (vertex_count_t v = 0; v < n; v++) {
+        state->distances[v] = SSSP_INFINITY;
+        state->predecessors[v] = SSSP_INVALID_VERTEX;
+    }
+    memset(state->queued, 0, n);
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Scan step for frontier entries [begin, end)
+ */
+static void scan_frontier(size_t begin, size_t end, void* context) {
+    bf_state_t* state = context;
+    const sssp_graph_t* graph = state->graph;
+    const distance_t* distances = state->distances;
+
+    for (size_t i = begin; i < end; i++) {
+        vertex_id_t u = state->frontier[i];
+        distance_t dist_u = distances[u];
+        edge_count_t run = graph->csr_offsets[u];
+        edge_count_t count = graph->csr_offsets[u + 1] - run;
+        const vertex_id_t* targets = graph->csr_targets + run;
+        const weight_t* weights = graph->csr_weights + run;
+        edge_count_t* improved = state->improved + state->first[i];
+
+        if (count >= SSSP_RELAX_MIN_VECTOR_DEGREE) {
+            state->found[i] = sssp_relax_scan(dist_u, targets, weights, count, distances, improved);
+            continue;
+        }
+        edge_count_t found = 0;
+        for (edge_count_t e = 0; e < count; e++) {
+            if (dist_u + weights[e] < distances[targets[e]]) {
+                improved[found++] = e;
+            }
+        }
+        state->found[i] = found;
+    }
+}
+
+/**
+ * Look for a cycle in the predecessor graph
+ *
+ * Predecessors only change on strict improvements, so any such cycle has
+ * negative weight. Every vertex is visited once; found is free between
+ * rounds and holds the walk marks. With cycle given, the cycle's vertices
+ * are written to it in edge order.
+ *
+ * @return Whether a cycle was found
+ */
+static bool find_predecessor_cycle(bf_state_t* state, sssp_vertex_set_t* cycle) {
+    vertex_count_t n = state->graph->num_vertices;
+    const vertex_id_t* pred = state->predecessors;
+    edge_count_t* mark = state->found;
+    memset(mark, 0, n * sizeof(edge_count_t));
+
+    for (vertex_id_t v = 0; v < n; v++) {
+        vertex_id_t x = v;
+        while (x != SSSP_INVALID_VERTEX && mark[x] == 0) {
+            mark[x] = v + 1;
+            x = pred[x];
+        }
+        if (x == SSSP_INVALID_VERTEX || mark[x] != v + 1) {
+            continue;
+        }
+
+        // x is on the cycle; predecessor links run against the edges
+        if (cycle) {
+            vertex_id_t* reversed = state->first;
+            vertex_count_t length = 0;
+            vertex_id_t y = x;
+            do {
+                reversed[length++] = y;
+                y = pred[y];
+            } while (y != x);
+            sssp_vertex_set_clear(cycle);
+            while (length > 0) {
+                sssp_vertex_set_add(cycle, reversed[--length]);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Lower v's distance through u, queueing v for the next round
+ */
+static inline void improve(bf_state_t* state, vertex_id_t u, vertex_id_t v,
+                           distance_t candidate, vertex_count_t* next_size) {
+    state->distances[v] = candidate;
+    state->predecessors[v] = u;
+    if (!state->queued[v]) {
+        state->queued[v] = 1;
+        state->next[(*next_size)++] = v;
+    }
+}
+
+/**
+ * Serial round: relax in place, so later frontier vertices already see
+ * the improvements made earlier in the round
+ */
+static vertex_count_t relax_in_place(bf_state_t* state) {
+    const sssp_graph_t* graph = state->graph;
+    vertex_count_t next_size = 0;
+    for (vertex_count_t i = 0; i < state->frontier_size; i++) {
+        vertex_id_t u = state->frontier[i];
+        distance_t dist_u = state->distances[u];
+        for (edge_count_t e = graph->csr_offsets[u]; e < graph->csr_offsets[u + 1]; e++) {
+            vertex_id_t v = graph->csr_targets[e];
+            distance_t candidate = dist_u + graph->csr_weights[e];
+            if (candidate < state->distances[v]) {
+                improve(state, u, v, candidate, &next_size);
+            }
+        }
+    }
+    return next_size;
+}
+
+/**
+ * Parallel round: scan on all threads, then apply in frontier order
+ */
+static sssp_error_t scan_and_apply(bf_state_t* state, vertex_count_t* next_size) {
+    const sssp_graph_t* graph = state->graph;
+    vertex_count_t size = state->frontier_size;
+    edge_count_t edges = 0;
+    for (vertex_count_t i = 0; i < size; i++) {
+        vertex_id_t u = state->frontier[i];
+        state->first[i] = edges;
+        edges += graph->csr_offsets[u + 1] - graph->csr_offsets[u];
+    }
+
+    sssp_error_t error = sssp_parallel_for(size, BF_GRAIN, scan_frontier, state);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    *next_size = 0;
+    for (vertex_count_t i = 0; i < size; i++) {
+        vertex_id_t u = state->frontier[i];
+        edge_count_t run = graph->csr_offsets[u];
+        const edge_count_t* improved = state->improved + state->first[i];
+        for (edge_count_t j = 0; j < state->found[i]; j++) {
+            edge_count_t e = run + improved[j];
+            vertex_id_t v = graph->csr_targets[e];
+            distance_t candidate = state->distances[u] + graph->csr_weights[e];
+            if (candidate < state->distances[v]) {
+                improve(state, u, v, candidate, next_size);
+            }
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Run rounds until the frontier empties or a negative cycle shows up
+ */
+static sssp_error_t bf_run(bf_state_t* state, bool parallel, sssp_vertex_set_t* cycle) {
+    const sssp_graph_t* graph = state->graph;
+    const vertex_count_t n = graph->num_vertices;
+    parallel = parallel && sssp_get_num_threads() > 1;
+
+    while (state->frontier_size > 0) {
+        if (state->rounds == n) {
+            SSSP_LOG_INFO("Frontier not empty after %u rounds: negative cycle", n);
+            find_predecessor_cycle(state, cycle);
+            return SSSP_ERROR_NEGATIVE_CYCLE;
+        }
+        state->rounds++;
+
+        edge_count_t edges = 0;
+        for (vertex_count_t i = 0; i < state->frontier_size; i++) {
+            vertex_id_t u = state->frontier[i];
+            edges += graph->csr_offsets[u + 1] - graph->csr_offsets[u];
+        }
+        state->scans += state->frontier_size;
+        state->relaxations += edges;
+
+        vertex_count_t next_size;
+        if (parallel && edges >= BF_PARALLEL_MIN_EDGES) {
+            sssp_error_t error = scan_and_apply(state, &next_size);
+            if (error != SSSP_SUCCESS) {
+                return error;
+            }
+        } else {
+            next_size = relax_in_place(state);
+        }
+
+        // A large frontier is rebuilt in vertex order, so the next round
+        // walks the CSR arrays front to back
+        if (next_size > n / BF_SORTED_FRONTIER_FRACTION) {
+            next_size = 0;
+            for (vertex_id_t v = 0; v < n; v++) {
+                if (state->queued[v]) {
+                    state->queued[v] = 0;
+                    state->next[next_size++] = v;
+                }
+            }
+        } else {
+            for (vertex_count_t i = 0; i < next_size; i++) {
+                state->queued[state->next[i]] = 0;
+            }
+        }
+        vertex_id_t* scanned = state->frontier;
+        state->frontier = state->next;
+        state->next = scanned;
+        state->frontier_size = next_size;
+
+        if (next_size > 0 && (state->rounds & (state->rounds - 1)) == 0 &&
+            find_predecessor_cycle(state, cycle)) {
+            SSSP_LOG_INFO("Negative cycle found after %u rounds", state->rounds);
+            return SSSP_ERROR_NEGATIVE_CYCLE;
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+/*
+ * Public interface
+ */
+
+sssp_error_t sssp_solve_bellman_ford(const sssp_graph_t* graph,
+                                     vertex_id_t source,
+                                     const sssp_algorithm_config_t* config,
+                                     sssp_algorithm_result_t* result,
+                                     sssp_vertex_set_t* cycle) {
+    if (!graph || !result) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+
+    vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
+    if (source >= num_vertices) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+
+    sssp_algorithm_config_t default_config;
+    if (!config) {
+        default_config = sssp_algorithm_config_default(num_vertices, NULL);
+        config = &default_config;
+    }
+
+    SSSP_LOG_INFO("Solving Bellman-Ford from vertex %u", source);
+    uint64_t start_ns = sssp_get_timestamp_ns();
+
+    sssp_tracking_allocator_t tracker;
+    sssp_tracking_allocator_init(&tracker, config->allocator, config->memory_limit_bytes);
+    const sssp_allocator_t* allocator = &tracker.allocator;
+
+    // The rounds read the CSR arrays directly; list-backed graphs get them
+    // as sssp_graph_neighbors() would build them
+    sssp_error_t error = sssp_graph_build_csr((sssp_graph_t*)graph);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    bf_state_t state;
+    error = bf_state_init(&state, graph, allocator);
+    if (error != SSSP_SUCCESS) {
+        return tracker.limit_failures > 0 ? SSSP_ERROR_MEMORY_LIMIT : error;
+    }
+
+    state.distances[source] = 0.0;
+    state.frontier[0] = source;
+    state.frontier_size = 1;
+    error = bf_run(&state, config->use_parallel_processing, cycle);
+
+    if (error == SSSP_SUCCESS) {
+        vertex_count_t reached = 0;
+        for (vertex_count_t v = 0; v < num_vertices; v++) {
+            result->distances[v] = state.distances[v];
+            result->predecessors[v] = state.predecessors[v];
+            if (state.distances[v] != SSSP_INFINITY) {
+                sssp_vertex_set_add(result->processed_vertices, v);
+                reached++;
+            }
+        }
+        result->vertices_processed = reached;
+        result->relaxations_performed = state.relaxations;
+        result->recursive_calls = 1;
+        result->is_optimal = true;
+        result->validation_status = SSSP_SUCCESS;
+    }
+
+    bf_state_destroy(&state, allocator);
+    result->total_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    result->peak_memory_bytes = sssp_tracking_allocator_stats(&tracker).peak_bytes;
+    result->page_size = 0;
+    if (error == SSSP_SUCCESS && config->enable_validation) {
+        error = sssp_validate_result(graph, source, result, NULL);
+        result->validation_status = error;
+        result->is_optimal = error == SSSP_SUCCESS;
+    }
+
+    SSSP_LOG_INFO("Bellman-Ford took %u rounds, %llu vertex scans, %.2f ms", state.rounds,
+                  (unsigned long long)state.scans, result->total_time_ms);
+    return error;
+}
+
+sssp_error_t sssp_johnson_create(const sssp_graph_t* graph,
+                                 const sssp_algorithm_config_t* config,
+                                 sssp_johnson_t** johnson_out,
+                                 sssp_vertex_set_t* cycle) {
+    if (!graph || !johnson_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    *johnson_out = NULL;
+
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    sssp_algorithm_config_t default_config;
+    if (!config) {
+        default_config = sssp_algorithm_config_default(n, NULL);
+        config = &default_config;
+    }
+    const sssp_allocator_t* allocator = config->allocator ? config->allocator : &SSSP_DEFAULT_ALLOCATOR;
+    uint64_t start_ns = sssp_get_timestamp_ns();
+
+    sssp_johnson_t* johnson = sssp_alloc(allocator, sizeof(sssp_johnson_t));
+    if (!johnson) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(johnson, 0, sizeof(*johnson));
+    johnson->num_vertices = n;
+    johnson->allocator = allocator;
+    johnson->reduced = copy_to_csr(graph, allocator);
+
+    bf_state_t state;
+    sssp_error_t error = johnson->reduced ? bf_state_init(&state, johnson->reduced, allocator)
+                                          : SSSP_ERROR_OUT_OF_MEMORY;
+    if (error != SSSP_SUCCESS) {
+        sssp_johnson_destroy(johnson);
+        return error;
+    }
+
+    // A virtual source with a zero-weight edge to every vertex
+    for (vertex_count_t v = 0; v < n; v++) {
+        state.distances[v] = 0.0;
+        state.frontier[v] = v;
+    }
+    state.frontier_size = n;
+    error = bf_run(&state, config->use_parallel_processing, cycle);
+    johnson->rounds = state.rounds;
+
+    if (error == SSSP_SUCCESS) {
+        sssp_graph_t* reduced = johnson->reduced;
+        const distance_t* h = state.distances;
+        for (vertex_id_t u = 0; u < n; u++) {
+            for (edge_count_t e = reduced->csr_offsets[u]; e < reduced->csr_offsets[u + 1]; e++) {
+                weight_t w = reduced->csr_weights[e] + h[u] - h[reduced->csr_targets[e]];
+                reduced->csr_weights[e] = w > 0.0 ? w : 0.0;
+            }
+        }
+        reduced->has_negative_weights = false;
+        reduced->allow_negative_weights = false;
+
+        // Hand the distance array over as the potentials
+        johnson->potentials = state.distances;
+        state.distances = NULL;
+    }
+    bf_state_destroy(&state, allocator);
+
+    if (error != SSSP_SUCCESS) {
+        sssp_johnson_destroy(johnson);
+        return error;
+    }
+
+    johnson->preprocessing_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    SSSP_LOG_INFO("Johnson potentials for %u vertices: %u rounds, %.2f ms", n,
+                  johnson->rounds, johnson->preprocessing_time_ms);
+    *johnson_out = johnson;
+    return SSSP_SUCCESS;
+}
+
+void sssp_johnson_destroy(sssp_johnson_t* johnson) {
+    if (!johnson) {
+        return;
+    }
+    sssp_graph_destroy(johnson->reduced);
+    sssp_free(johnson->allocator, johnson->potentials);
+    sssp_free(johnson->allocator, johnson);
+}
+
+sssp_error_t sssp_johnson_solve(const sssp_johnson_t* johnson,
+                                vertex_id_t source,
+                                const sssp_algorithm_config_t* config,
+                                sssp_algorithm_result_t* result) {
+    if (!johnson || !result) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+
+    sssp_error_t error = sssp_solve_single_source(johnson->reduced, source, config, result);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+    for (vertex_count_t v = 0; v < johnson->num_vertices; v++) {
+        result->distances[v] = sssp_johnson_distance(johnson, source, v, result->distances[v]);
+    }
+    return SSSP_SUCCESS;
+}
+
+/*
+ * Reference implementation
+ */
+
+/**
+ * Relax every out-edge of u; returns whether a distance improved
+ */
+static bool relax_all_out_edges(const sssp_graph_t* graph, vertex_id_t u,
+                                weight_t* distances, vertex_id_t* predecessors) {
+    bool changed = false;
+    distance_t dist_u = distances[u];
+    const vertex_id_t* targets;
+    const weight_t* weights;
+    edge_count_t degree;
+    if (sssp_graph_neighbors(graph, u, &targets, &weights, &degree) != SSSP_SUCCESS) {
+        return false;
+    }
+    for (edge_count_t e = 0; e < degree; e++) {
+        vertex_id_t v = targets[e];
+        if (dist_u + weights[e] < distances[v]) {
+            distances[v] = dist_u + weights[e];
+            if (predecessors) predecessors[v] = u;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+sssp_error_t sssp_bellman_ford_reference(const sssp_graph_t* graph,
+                                          vertex_id_t source,
+                                          const sssp_allocator_t* allocator,
+                                          weight_t** distances_out,
+                                          vertex_id_t** predecessors_out,
+                                          bool* has_negative_cycle_out) {
+    if (!graph || !distances_out || !has_negative_cycle_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    if (source >= n) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (!allocator) {
+        allocator = &SSSP_DEFAULT_ALLOCATOR;
+    }
+
+    weight_t* distances = sssp_alloc(allocator, n * sizeof(weight_t));
+    vertex_id_t* predecessors = predecessors_out ? sssp_alloc(allocator, n * sizeof(vertex_id_t)) : NULL;
+    if (!distances || (predecessors_out && !predecessors)) {
+        if (distances) sssp_free(allocator, distances);
+        if (predecessors) sssp_free(allocator, predecessors);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    for (vertex_count_t v = 0; v < n; v++) {
+        distances[v] = SSSP_INFINITY;
+        if (predecessors) predecessors[v] = SSSP_INVALID_VERTEX;
+    }
+    distances[source] = 0.0;
+
+    // n - 1 passes over all edges settle everything; a further change means a cycle
+    bool changed = true;
+    for (vertex_count_t pass = 0; pass < n && changed; pass++) {
+        changed = false;
+        for (vertex_id_t u = 0; u < n; u++) {
+            if (distances[u] != SSSP_INFINITY) {
+                changed |= relax_all_out_edges(graph, u, distances, predecessors);
+            }
+        }
+    }
+
+    *has_negative_cycle_out = changed;
+    *distances_out = distances;
+    if (predecessors_out) {
+        *predecessors_out = predecessors;
+    }
+    return SSSP_SUCCESS;
+}
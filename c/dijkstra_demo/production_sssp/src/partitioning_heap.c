@@ -434,3 +434,17 @@ sssp_error_t sssp_partitioning_heap_partition(sssp_partitioning_heap_t* heap,
     SSSP_LOG_DEBUG("Partitioning complete: extracted %u vertices", extracted);
     return SSSP_SUCCESS;
 }
+
+/**
+ * Compute the memory held by a heap
+ */
+sssp_memory_stats_t sssp_heap_memory_stats(const sssp_partitioning_heap_t* heap) {
+    sssp_memory_stats_t stats;
+    sssp_memory_stats_reset(&stats);
+    if (!heap) return stats;
+    
+    sssp_memory_stats_add_allocation(&stats, sizeof(sssp_partitioning_heap_t));
+    sssp_memory_stats_add_allocation(&stats, (size_t)heap->max_vertices * sizeof(sssp_heap_element_t));
+    sssp_memory_stats_add_allocation(&stats, (size_t)heap->max_vertices * sizeof(vertex_count_t));
+    return stats;
+}
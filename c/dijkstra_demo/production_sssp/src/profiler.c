@@ -0,0 +1,352 @@
+/**
+ * @file profiler.c
+ * @brief Implementation of the phase profiler and perf_event_open counters
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#define _GNU_SOURCE
+
+#include "../include/profiler.h"
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define SSSP_HAVE_PERF_EVENTS 1
+#endif
+
+static _Thread_local sssp_profiler_t* g_current_profiler = NULL;
+
+#ifdef SSSP_HAVE_PERF_EVENTS
+
+/**
+ * Event encoding for each sssp_hw_counter_t
+ */
+static void hw_counter_attr(sssp_hw_counter_t counter, struct perf_event_attr* attr) {
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->disabled = 1;
+    attr->exclude_kernel = 1;
+    attr->exclude_hv = 1;
+    attr->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (counter) {
+        case SSSP_HW_CYCLES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case SSSP_HW_INSTRUCTIONS:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case SSSP_HW_L1D_MISSES:
+            attr->type = PERF_TYPE_HW_CACHE;
+            attr->config = PERF_COUNT_HW_CACHE_L1D |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case SSSP_HW_LLC_REFERENCES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_CACHE_REFERENCES;
+            break;
+        case SSSP_HW_LLC_MISSES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case SSSP_HW_BRANCH_MISSES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case SSSP_HW_DTLB_MISSES:
+            attr->type = PERF_TYPE_HW_CACHE;
+            attr->config = PERF_COUNT_HW_CACHE_DTLB |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            break;
+    }
+}
+
+static int open_hw_counter(struct perf_event_attr* attr, int group_fd) {
+    long fd = syscall(SYS_perf_event_open, attr, 0, -1, group_fd, 0);
+    return (int)fd;
+}
+
+/**
+ * Open each counter in the first group it fits, or as the leader of a new
+ * group. The kernel refuses a member that would leave its group
+ * unschedulable on the PMU, so every group counts all the time (or is
+ * multiplexed as a whole).
+ */
+static void open_hw_groups(sssp_profiler_t* profiler) {
+    uint8_t group_size[SSSP_HW_COUNTER_COUNT] = {0};
+    for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+        struct perf_event_attr attr;
+        hw_counter_attr((sssp_hw_counter_t)i, &attr);
+
+        int fd = -1;
+        uint32_t group = 0;
+        attr.disabled = 0;              // Members follow their leader
+        for (; group < profiler->num_groups && fd < 0; group++) {
+            fd = open_hw_counter(&attr, profiler->group_fds[group]);
+        }
+        if (fd >= 0) {
+            group--;
+        } else {
+            attr.disabled = 1;
+            fd = open_hw_counter(&attr, -1);
+            if (fd < 0) {
+                continue;
+            }
+            group = profiler->num_groups++;
+            profiler->group_fds[group] = fd;
+        }
+        profiler->fds[i] = fd;
+        profiler->group_of[i] = (uint8_t)group;
+        profiler->slot_of[i] = group_size[group]++;
+        profiler->available_mask |= 1u << i;
+    }
+}
+
+#endif // SSSP_HAVE_PERF_EVENTS
+
+/**
+ * Read every counter, one read() per group, scaled for multiplexing
+ */
+static void snapshot_counters(const sssp_profiler_t* profiler, uint64_t* values) {
+#ifdef SSSP_HAVE_PERF_EVENTS
+    // nr, time enabled, time running, then one value per member
+    uint64_t data[SSSP_HW_COUNTER_COUNT][3 + SSSP_HW_COUNTER_COUNT];
+    double scale[SSSP_HW_COUNTER_COUNT];
+    for (uint32_t g = 0; g < profiler->num_groups; g++) {
+        ssize_t got = read(profiler->group_fds[g], data[g], sizeof(data[g]));
+        if (got < (ssize_t)(3 * sizeof(uint64_t)) || data[g][2] == 0) {
+            scale[g] = 0.0;
+        } else {
+            scale[g] = data[g][1] == data[g][2] ? 1.0 : (double)data[g][1] / (double)data[g][2];
+        }
+    }
+    for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+        if (!(profiler->available_mask & (1u << i))) {
+            values[i] = 0;
+            continue;
+        }
+        uint64_t raw = data[profiler->group_of[i]][3 + profiler->slot_of[i]];
+        double factor = scale[profiler->group_of[i]];
+        values[i] = factor == 1.0 ? raw : (uint64_t)((double)raw * factor);
+    }
+#else
+    (void)profiler;
+    memset(values, 0, SSSP_HW_COUNTER_COUNT * sizeof(uint64_t));
+#endif
+}
+
+/**
+ * Initialize a profiler, opening whatever counters the system allows
+ */
+sssp_error_t sssp_profiler_init(sssp_profiler_t* profiler, bool use_hw_counters) {
+    if (!profiler) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+
+    memset(profiler, 0, sizeof(*profiler));
+    for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+        profiler->fds[i] = -1;
+    }
+
+#ifdef SSSP_HAVE_PERF_EVENTS
+    if (use_hw_counters) {
+        open_hw_groups(profiler);
+
+        if (profiler->available_mask == 0) {
+            SSSP_LOG_INFO("Hardware counters unavailable, profiling phase times only");
+        }
+
+        for (uint32_t g = 0; g < profiler->num_groups; g++) {
+            ioctl(profiler->group_fds[g], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(profiler->group_fds[g], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+#else
+    (void)use_hw_counters;
+#endif
+
+    for (int p = 0; p < SSSP_PHASE_COUNT; p++) {
+        profiler->phase_counters[p].available_mask = profiler->available_mask;
+    }
+
+    return SSSP_SUCCESS;
+}
+
+void sssp_profiler_destroy(sssp_profiler_t* profiler) {
+    if (!profiler) return;
+
+#ifdef SSSP_HAVE_PERF_EVENTS
+    for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+        if (profiler->fds[i] >= 0) {
+            close(profiler->fds[i]);
+            profiler->fds[i] = -1;
+        }
+    }
+#endif
+
+    if (g_current_profiler == profiler) {
+        g_current_profiler = NULL;
+    }
+}
+
+void sssp_profiler_start(sssp_profiler_t* profiler, sssp_profile_phase_t phase) {
+    if (!profiler || phase >= SSSP_PHASE_COUNT) return;
+
+    profiler->current_phase = phase;
+    profiler->running = true;
+    if (profiler->available_mask) {
+        snapshot_counters(profiler, profiler->phase_start_values);
+    }
+    profiler->phase_start_ns = sssp_get_timestamp_ns();
+}
+
+/**
+ * Charge share of a closed phase's time and counter deltas to phase
+ */
+static void charge_phase(sssp_profiler_t* profiler, sssp_profile_phase_t phase, double share,
+                         double elapsed_ms, const uint64_t* deltas) {
+    profiler->phase_time_ms[phase] += elapsed_ms * share;
+    for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+        profiler->phase_counters[phase].values[i] += (uint64_t)((double)deltas[i] * share);
+    }
+}
+
+/**
+ * Charge everything since the last snapshot to the current phase, or
+ * divide it between the split phases
+ */
+static void close_phase(sssp_profiler_t* profiler) {
+    uint64_t now = sssp_get_timestamp_ns();
+    double elapsed_ms = (double)(now - profiler->phase_start_ns) / 1000000.0;
+
+    uint64_t deltas[SSSP_HW_COUNTER_COUNT] = {0};
+    if (profiler->available_mask) {
+        uint64_t values[SSSP_HW_COUNTER_COUNT];
+        snapshot_counters(profiler, values);
+        for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+            if (values[i] > profiler->phase_start_values[i]) {
+                deltas[i] = values[i] - profiler->phase_start_values[i];
+            }
+            profiler->phase_start_values[i] = values[i];
+        }
+    }
+
+    if (profiler->splitting) {
+        profiler->splitting = false;
+        uint64_t sampled = profiler->split_sample_ns[0] + profiler->split_sample_ns[1];
+        double second = sampled > 0 ? (double)profiler->split_sample_ns[1] / (double)sampled : 0.0;
+        charge_phase(profiler, profiler->split_phases[0], 1.0 - second, elapsed_ms, deltas);
+        charge_phase(profiler, profiler->split_phases[1], second, elapsed_ms, deltas);
+    } else {
+        charge_phase(profiler, profiler->current_phase, 1.0, elapsed_ms, deltas);
+    }
+
+    profiler->phase_start_ns = sssp_get_timestamp_ns();
+}
+
+sssp_profile_phase_t sssp_profiler_switch(sssp_profiler_t* profiler, sssp_profile_phase_t phase) {
+    if (!profiler) return phase;
+
+    sssp_profile_phase_t previous = profiler->current_phase;
+    if (!profiler->running) {
+        sssp_profiler_start(profiler, phase);
+        return previous;
+    }
+    if (previous == phase || phase >= SSSP_PHASE_COUNT) {
+        return previous;
+    }
+
+    close_phase(profiler);
+    profiler->current_phase = phase;
+    profiler->phase_switches++;
+    return previous;
+}
+
+void sssp_profiler_begin_split(sssp_profiler_t* profiler, sssp_profile_phase_t first,
+                               sssp_profile_phase_t second) {
+    if (!profiler || first >= SSSP_PHASE_COUNT || second >= SSSP_PHASE_COUNT) return;
+
+    if (profiler->running) {
+        close_phase(profiler);
+        profiler->current_phase = first;
+        profiler->phase_switches++;
+    } else {
+        sssp_profiler_start(profiler, first);
+    }
+    profiler->splitting = true;
+    profiler->split_phases[0] = first;
+    profiler->split_phases[1] = second;
+    profiler->split_sample_ns[0] = 0;
+    profiler->split_sample_ns[1] = 0;
+    profiler->until_sample = SSSP_PROFILE_SAMPLE_INTERVAL;
+}
+
+void sssp_profiler_stop(sssp_profiler_t* profiler) {
+    if (!profiler || !profiler->running) return;
+
+    close_phase(profiler);
+    profiler->running = false;
+}
+
+bool sssp_profiler_has_hw_counters(const sssp_profiler_t* profiler) {
+    return profiler && profiler->available_mask != 0;
+}
+
+void sssp_profiler_total_counters(const sssp_profiler_t* profiler, sssp_hw_counters_t* total) {
+    if (!total) return;
+    memset(total, 0, sizeof(*total));
+    if (!profiler) return;
+
+    total->available_mask = profiler->available_mask;
+    for (int p = 0; p < SSSP_PHASE_COUNT; p++) {
+        for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+            total->values[i] += profiler->phase_counters[p].values[i];
+        }
+    }
+}
+
+sssp_profiler_t* sssp_profiler_current(void) {
+    return g_current_profiler;
+}
+
+sssp_profiler_t* sssp_profiler_set_current(sssp_profiler_t* profiler) {
+    sssp_profiler_t* previous = g_current_profiler;
+    g_current_profiler = profiler;
+    return previous;
+}
+
+const char* sssp_profile_phase_name(sssp_profile_phase_t phase) {
+    switch (phase) {
+        case SSSP_PHASE_INITIALIZATION:  return "initialization";
+        case SSSP_PHASE_FIND_PIVOTS:     return "find_pivots";
+        case SSSP_PHASE_HEAP_OPERATIONS: return "heap_operations";
+        case SSSP_PHASE_RELAXATION:      return "relaxation";
+        case SSSP_PHASE_FINALIZATION:    return "finalization";
+        default:                         return "unknown";
+    }
+}
+
+const char* sssp_hw_counter_name(sssp_hw_counter_t counter) {
+    switch (counter) {
+        case SSSP_HW_CYCLES:         return "cycles";
+        case SSSP_HW_INSTRUCTIONS:   return "instructions";
+        case SSSP_HW_L1D_MISSES:     return "l1d_misses";
+        case SSSP_HW_LLC_REFERENCES: return "llc_references";
+        case SSSP_HW_LLC_MISSES:     return "llc_misses";
+        case SSSP_HW_BRANCH_MISSES:  return "branch_misses";
+        case SSSP_HW_DTLB_MISSES:    return "dtlb_misses";
+        default:                     return "unknown";
+    }
+}
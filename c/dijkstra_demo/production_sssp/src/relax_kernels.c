@@ -0,0 +1,188 @@
+/**
+ * @file relax_kernels.c
+ * @brief Scalar, AVX2 and AVX-512 edge relaxation kernels
+ *
+ * The SIMD kernels are compiled with target attributes, so the library
+ * itself needs no -mavx2 / -mavx512f; which one runs is decided from CPUID
+ * the first time a kernel is needed. All kernels do the same double
+ * additions and comparisons, so they report exactly the same edges.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "relax_kernels.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#    define RELAX_X86_SIMD 1
+#    include <immintrin.h>
+#endif
+
+// Resolved kernel; AUTO until first needed. Accessed atomically, since
+// solves on several threads may all be the first to need it.
+static sssp_relax_kernel_t active_kernel = SSSP_RELAX_KERNEL_AUTO;
+
+/**
+ * Prefetch the distances of the lanes targets[i + SSSP_PREFETCH_DISTANCE ...]
+ */
+static inline void prefetch_ahead(const vertex_id_t* targets, edge_count_t i, edge_count_t lanes,
+                                  edge_count_t count, const distance_t* distances) {
+#if SSSP_PREFETCH_DISTANCE > 0
+    if (i + SSSP_PREFETCH_DISTANCE + lanes <= count) {
+        for (edge_count_t l = 0; l < lanes; l++) {
+            SSSP_PREFETCH(&distances[targets[i + SSSP_PREFETCH_DISTANCE + l]]);
+        }
+    }
+#else
+    (void)targets; (void)i; (void)lanes; (void)count; (void)distances;
+#endif
+}
+
+/**
+ * Scalar scan of edges [begin, count); also finishes the SIMD kernels' tails
+ */
+static edge_count_t scan_scalar(distance_t dist_u, const vertex_id_t* targets,
+                                const weight_t* weights, edge_count_t begin, edge_count_t count,
+                                const distance_t* distances, edge_count_t* improved) {
+    edge_count_t found = 0;
+    for (edge_count_t i = begin; i < count; i++) {
+        prefetch_ahead(targets, i, 1, count, distances);
+        if (dist_u + weights[i] < distances[targets[i]]) {
+            improved[found++] = i;
+        }
+    }
+    return found;
+}
+
+#ifdef RELAX_X86_SIMD
+__attribute__((target("avx2")))
+static edge_count_t scan_avx2(distance_t dist_u, const vertex_id_t* targets,
+                              const weight_t* weights, edge_count_t count,
+                              const distance_t* distances, edge_count_t* improved) {
+    const __m256d base = _mm256_set1_pd(dist_u);
+    edge_count_t found = 0;
+    edge_count_t i = 0;
+
+    // Vertex ids are below 2^31, so they are valid signed gather indices
+    for (; i + 4 <= count; i += 4) {
+        prefetch_ahead(targets, i, 4, count, distances);
+        __m128i index = _mm_loadu_si128((const __m128i*)(targets + i));
+        __m256d current = _mm256_i32gather_pd(distances, index, 8);
+        __m256d candidate = _mm256_add_pd(base, _mm256_loadu_pd(weights + i));
+        unsigned mask = (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(candidate, current, _CMP_LT_OQ));
+        while (mask) {
+            improved[found++] = i + (edge_count_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    return found + scan_scalar(dist_u, targets, weights, i, count, distances, improved + found);
+}
+
+__attribute__((target("avx512f")))
+static edge_count_t scan_avx512(distance_t dist_u, const vertex_id_t* targets,
+                                const weight_t* weights, edge_count_t count,
+                                const distance_t* distances, edge_count_t* improved) {
+    const __m512d base = _mm512_set1_pd(dist_u);
+    edge_count_t found = 0;
+    edge_count_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        prefetch_ahead(targets, i, 8, count, distances);
+        __m256i index = _mm256_loadu_si256((const __m256i*)(targets + i));
+        __m512d current = _mm512_i32gather_pd(index, distances, 8);
+        __m512d candidate = _mm512_add_pd(base, _mm512_loadu_pd(weights + i));
+        unsigned mask = (unsigned)_mm512_cmp_pd_mask(candidate, current, _CMP_LT_OQ);
+        while (mask) {
+            improved[found++] = i + (edge_count_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    return found + scan_scalar(dist_u, targets, weights, i, count, distances, improved + found);
+}
+#endif
+
+bool sssp_relax_kernel_supported(sssp_relax_kernel_t kernel) {
+    switch (kernel) {
+        case SSSP_RELAX_KERNEL_AUTO:
+        case SSSP_RELAX_KERNEL_SCALAR:
+            return true;
+#ifdef RELAX_X86_SIMD
+        case SSSP_RELAX_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SSSP_RELAX_KERNEL_AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * Widest kernel the CPU supports
+ */
+static sssp_relax_kernel_t widest_kernel(void) {
+    return sssp_relax_kernel_supported(SSSP_RELAX_KERNEL_AVX512) ? SSSP_RELAX_KERNEL_AVX512 :
+           sssp_relax_kernel_supported(SSSP_RELAX_KERNEL_AVX2)   ? SSSP_RELAX_KERNEL_AVX2 :
+                                                                   SSSP_RELAX_KERNEL_SCALAR;
+}
+
+sssp_error_t sssp_relax_set_kernel(sssp_relax_kernel_t kernel) {
+    if (!sssp_relax_kernel_supported(kernel)) {
+        SSSP_LOG_ERROR("Relaxation kernel %s is not supported here", sssp_relax_kernel_name(kernel));
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (kernel == SSSP_RELAX_KERNEL_AUTO) {
+        kernel = widest_kernel();
+    }
+    __atomic_store_n(&active_kernel, kernel, __ATOMIC_RELAXED);
+    SSSP_LOG_DEBUG("Using %s relaxation kernel", sssp_relax_kernel_name(kernel));
+    return SSSP_SUCCESS;
+}
+
+sssp_relax_kernel_t sssp_relax_get_kernel(void) {
+    sssp_relax_kernel_t kernel = __atomic_load_n(&active_kernel, __ATOMIC_RELAXED);
+    if (SSSP_UNLIKELY(kernel == SSSP_RELAX_KERNEL_AUTO)) {
+        // Only replaces AUTO, so a kernel set meanwhile is kept
+        sssp_relax_kernel_t expected = SSSP_RELAX_KERNEL_AUTO;
+        kernel = widest_kernel();
+        if (__atomic_compare_exchange_n(&active_kernel, &expected, kernel, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            SSSP_LOG_DEBUG("Using %s relaxation kernel", sssp_relax_kernel_name(kernel));
+        } else {
+            kernel = expected;
+        }
+    }
+    return kernel;
+}
+
+const char* sssp_relax_kernel_name(sssp_relax_kernel_t kernel) {
+    switch (kernel) {
+        case SSSP_RELAX_KERNEL_AUTO:   return "auto";
+        case SSSP_RELAX_KERNEL_SCALAR: return "scalar";
+        case SSSP_RELAX_KERNEL_AVX2:   return "avx2";
+        case SSSP_RELAX_KERNEL_AVX512: return "avx512";
+        default:                       return "unknown";
+    }
+}
+
+edge_count_t sssp_relax_scan(distance_t dist_u,
+                             const vertex_id_t* targets,
+                             const weight_t* weights,
+                             edge_count_t count,
+                             const distance_t* distances,
+                             edge_count_t* improved) {
+    switch (sssp_relax_get_kernel()) {
+#ifdef RELAX_X86_SIMD
+        case SSSP_RELAX_KERNEL_AVX512:
+            return scan_avx512(dist_u, targets, weights, count, distances, improved);
+        case SSSP_RELAX_KERNEL_AVX2:
+            return scan_avx2(dist_u, targets, weights, count, distances, improved);
+#endif
+        default:
+            return scan_scalar(dist_u, targets, weights, 0, count, distances, improved);
+    }
+}
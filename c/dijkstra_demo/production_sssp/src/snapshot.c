@@ -0,0 +1,746 @@
+/**
+ * @file snapshot.c
+ * @brief Snapshot files: layout, hashing, writing and mapping
+ *
+ * File layout:
+ *
+ *   file_header_t
+ *   section_entry_t[num_sections]   graph sections first, then indexes
+ *   section data, each aligned to SECTION_ALIGNMENT
+ *
+ * The graph is stored as three sections with reserved tags: CSR offsets,
+ * targets and weights. Each section's checksum is the hash of its bytes;
+ * the content hash of the graph combines the vertex and edge counts with
+ * the checksums of its three sections, so writing a snapshot yields the
+ * graph hash for free and a mapped graph hashes like its source.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "snapshot.h"
+#include <string.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define SNAPSHOT_MAGIC 0x50414e5350535353ull    // "SSSPSNAP"
+#define SECTION_ALIGNMENT 64
+
+#define TAG_RESERVED 0x80000000u
+#define TAG_CSR_OFFSETS 0x80000001u
+#define TAG_CSR_TARGETS 0x80000002u
+#define TAG_CSR_WEIGHTS 0x80000003u
+#define GRAPH_SECTIONS 3
+
+#define FLAG_NEGATIVE_WEIGHTS 0x1u
+
+typedef struct file_header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t num_sections;
+    uint64_t graph_hash;
+    uint64_t file_size;
+    uint32_t num_vertices;
+    uint32_t num_edges;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t table_checksum;            // Header (with this field 0) and section table
+} file_header_t;
+
+typedef struct section_entry {
+    uint32_t tag;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t checksum;
+} section_entry_t;
+
+// ============================================================================
+// Hashing
+// ============================================================================
+
+#define HASH_K1 0x9E3779B97F4A7C15ull
+#define HASH_K2 0xBF58476D1CE4E5B9ull
+#define HASH_BLOCK 32
+
+/**
+ * Four independent multiply-rotate lanes over 32-byte blocks, so the
+ * multiplications of a block overlap
+ */
+typedef struct hasher {
+    uint64_t lanes[4];
+    unsigned char pending[HASH_BLOCK];
+    size_t pending_size;
+    uint64_t length;
+} hasher_t;
+
+static uint64_t rotate_left(uint64_t x, unsigned int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t finalize(uint64_t x) {
+    x ^= x >> 30;
+    x *= HASH_K2;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static void hasher_init(hasher_t* hasher) {
+    memset(hasher, 0, sizeof(*hasher));
+    for (int i = 0; i < 4; i++) {
+        hasher->lanes[i] = HASH_K1 * (uint64_t)(i + 1);
+    }
+}
+
+static void hasher_block(hasher_t* hasher, const unsigned char* block) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t word;
+        memcpy(&word, block + 8 * i, sizeof(word));
+        hasher->lanes[i] = rotate_left(hasher->lanes[i] ^ (word * HASH_K1), 31) * HASH_K2;
+    }
+}
+
+static void hasher_update(hasher_t* hasher, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    hasher->length += size;
+    if (hasher->pending_size > 0) {
+        size_t take = SSSP_MIN(size, HASH_BLOCK - hasher->pending_size);
+        memcpy(hasher->pending + hasher->pending_size, bytes, take);
+        hasher->pending_size += take;
+        bytes += take;
+        size -= take;
+        if (hasher->pending_size < HASH_BLOCK) {
+            return;
+        }
+        hasher_block(hasher, hasher->pending);
+        hasher->pending_size = 0;
+    }
+    for (; size >= HASH_BLOCK; bytes += HASH_BLOCK, size -= HASH_BLOCK) {
+        hasher_block(hasher, bytes);
+    }
+    memcpy(hasher->pending, bytes, size);
+    hasher->pending_size = size;
+}
+
+static uint64_t hasher_final(hasher_t* hasher) {
+    if (hasher->pending_size > 0) {
+        memset(hasher->pending + hasher->pending_size, 0, HASH_BLOCK - hasher->pending_size);
+        hasher_block(hasher, hasher->pending);
+    }
+    uint64_t hash = hasher->length * HASH_K1;
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ finalize(hasher->lanes[i])) * HASH_K2;
+    }
+    return finalize(hash);
+}
+
+static uint64_t hash_bytes(const void* data, size_t size) {
+    hasher_t hasher;
+    hasher_init(&hasher);
+    hasher_update(&hasher, data, size);
+    return hasher_final(&hasher);
+}
+
+static uint64_t combine_graph_hash(vertex_count_t num_vertices, edge_count_t num_edges,
+                                   const uint64_t checksums[GRAPH_SECTIONS]) {
+    uint64_t parts[2 + GRAPH_SECTIONS] = { num_vertices, num_edges, checksums[0], checksums[1], checksums[2] };
+    return hash_bytes(parts, sizeof(parts));
+}
+
+// ============================================================================
+// Graph arrays in CSR form, from either storage
+// ============================================================================
+
+typedef sssp_error_t (*sink_t)(void* context, const void* data, size_t size);
+
+// Entries converted from list storage at a time
+#define STREAM_CHUNK 2048
+
+static uint64_t graph_section_size(const sssp_graph_t* graph, int section) {
+    switch (section) {
+        case 0: return ((uint64_t)graph->num_vertices + 1) * sizeof(edge_count_t);
+        case 1: return (uint64_t)graph->num_edges * sizeof(vertex_id_t);
+        default: return (uint64_t)graph->num_edges * sizeof(weight_t);
+    }
+}
+
+/**
+ * Feed one CSR array of graph (0: offsets, 1: targets, 2: weights) to sink
+ */
+static sssp_error_t stream_graph_section(const sssp_graph_t* graph, int section, sink_t sink, void* context) {
+    if (graph->csr_offsets) {
+        const void* arrays[GRAPH_SECTIONS] = { graph->csr_offsets, graph->csr_targets, graph->csr_weights };
+        return sink(context, arrays[section], (size_t)graph_section_size(graph, section));
+    }
+
+    union {
+        edge_count_t offsets[STREAM_CHUNK];
+        vertex_id_t targets[STREAM_CHUNK];
+        weight_t weights[STREAM_CHUNK];
+    } chunk;
+    size_t count = 0;
+    sssp_error_t error = SSSP_SUCCESS;
+    edge_count_t offset = 0;
+    size_t entry_size = section == 0 ? sizeof(edge_count_t)
+                      : section == 1 ? sizeof(vertex_id_t) : sizeof(weight_t);
+
+    if (section == 0) {
+        chunk.offsets[count++] = 0;
+    }
+    for (vertex_count_t v = 0; v < graph->num_vertices && error == SSSP_SUCCESS; v++) {
+        if (section == 0) {
+            offset += graph->adj_list[v].count;
+            chunk.offsets[count++] = offset;
+        } else {
+            for (const sssp_edge_node_t* edge = graph->adj_list[v].head; edge; edge = edge->next) {
+                if (section == 1) {
+                    chunk.targets[count++] = edge->to;
+                } else {
+                    chunk.weights[count++] = edge->weight;
+                }
+                if (count == STREAM_CHUNK) {
+                    error = sink(context, &chunk, count * entry_size);
+                    count = 0;
+                    if (error != SSSP_SUCCESS) {
+                        break;
+                    }
+                }
+            }
+        }
+        if (count == STREAM_CHUNK) {
+            error = sink(context, &chunk, count * entry_size);
+            count = 0;
+        }
+    }
+    if (error == SSSP_SUCCESS && count > 0) {
+        error = sink(context, &chunk, count * entry_size);
+    }
+    return error;
+}
+
+static sssp_error_t hash_sink(void* context, const void* data, size_t size) {
+    hasher_update(context, data, size);
+    return SSSP_SUCCESS;
+}
+
+uint64_t sssp_graph_content_hash(const sssp_graph_t* graph) {
+    if (!graph) {
+        return 0;
+    }
+    uint64_t checksums[GRAPH_SECTIONS];
+    for (int section = 0; section < GRAPH_SECTIONS; section++) {
+        hasher_t hasher;
+        hasher_init(&hasher);
+        stream_graph_section(graph, section, hash_sink, &hasher);
+        checksums[section] = hasher_final(&hasher);
+    }
+    return combine_graph_hash(graph->num_vertices, graph->num_edges, checksums);
+}
+
+#ifndef _WIN32
+
+struct sssp_snapshot {
+    void* base;                         // Mapping of the whole file
+    size_t size;
+    const file_header_t* header;
+    const section_entry_t* sections;
+    sssp_graph_t* graph;                // CSR arrays point into the mapping
+    const sssp_allocator_t* allocator;
+};
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+typedef struct writer {
+    int fd;
+    uint64_t offset;
+    hasher_t hasher;                    // Of the current section
+} writer_t;
+
+static sssp_error_t write_sink(void* context, const void* data, size_t size) {
+    writer_t* writer = context;
+    const unsigned char* bytes = data;
+    hasher_update(&writer->hasher, data, size);
+    writer->offset += size;
+    while (size > 0) {
+        ssize_t n = write(writer->fd, bytes, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return SSSP_ERROR_IO;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t write_padding(writer_t* writer) {
+    static const unsigned char zeros[SECTION_ALIGNMENT];
+    size_t padding = (SECTION_ALIGNMENT - writer->offset % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+    return padding > 0 ? write_sink(writer, zeros, padding) : SSSP_SUCCESS;
+}
+
+static sssp_error_t write_snapshot(int fd, const sssp_graph_t* graph,
+                                   const sssp_snapshot_section_t* sections, uint32_t num_sections,
+                                   section_entry_t* table) {
+    uint32_t total = GRAPH_SECTIONS + num_sections;
+    writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.fd = fd;
+
+    // Header and table are written last, over this placeholder
+    size_t table_size = sizeof(file_header_t) + total * sizeof(section_entry_t);
+    if (lseek(fd, (off_t)table_size, SEEK_SET) < 0) {
+        return SSSP_ERROR_IO;
+    }
+    writer.offset = table_size;
+
+    sssp_error_t error = SSSP_SUCCESS;
+    for (uint32_t i = 0; i < total && error == SSSP_SUCCESS; i++) {
+        error = write_padding(&writer);
+        if (error != SSSP_SUCCESS) {
+            break;
+        }
+        hasher_init(&writer.hasher);
+        table[i].offset = writer.offset;
+        if (i < GRAPH_SECTIONS) {
+            table[i].tag = TAG_CSR_OFFSETS + i;
+            error = stream_graph_section(graph, (int)i, write_sink, &writer);
+        } else {
+            const sssp_snapshot_section_t* section = &sections[i - GRAPH_SECTIONS];
+            table[i].tag = section->tag;
+            if (section->size > 0) {
+                error = write_sink(&writer, section->data, (size_t)section->size);
+            }
+        }
+        table[i].size = writer.offset - table[i].offset;
+        table[i].checksum = hasher_final(&writer.hasher);
+    }
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    file_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SSSP_SNAPSHOT_VERSION;
+    header.num_sections = total;
+    uint64_t checksums[GRAPH_SECTIONS] = { table[0].checksum, table[1].checksum, table[2].checksum };
+    header.graph_hash = combine_graph_hash(graph->num_vertices, graph->num_edges, checksums);
+    header.file_size = writer.offset;
+    header.num_vertices = graph->num_vertices;
+    header.num_edges = graph->num_edges;
+    header.flags = graph->has_negative_weights ? FLAG_NEGATIVE_WEIGHTS : 0;
+
+    hasher_t hasher;
+    hasher_init(&hasher);
+    hasher_update(&hasher, &header, sizeof(header));
+    hasher_update(&hasher, table, total * sizeof(section_entry_t));
+    header.table_checksum = hasher_final(&hasher);
+
+    if (lseek(fd, 0, SEEK_SET) < 0) {
+        return SSSP_ERROR_IO;
+    }
+    writer.offset = 0;
+    error = write_sink(&writer, &header, sizeof(header));
+    if (error == SSSP_SUCCESS) {
+        error = write_sink(&writer, table, total * sizeof(section_entry_t));
+    }
+    if (error == SSSP_SUCCESS && fsync(fd) != 0) {
+        error = SSSP_ERROR_IO;
+    }
+    return error;
+}
+
+sssp_error_t sssp_snapshot_save(const char* path,
+                                const sssp_graph_t* graph,
+                                const sssp_snapshot_section_t* sections,
+                                uint32_t num_sections) {
+    if (!path || !graph || (num_sections > 0 && !sections)) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    for (uint32_t i = 0; i < num_sections; i++) {
+        if ((sections[i].tag & TAG_RESERVED) || (sections[i].size > 0 && !sections[i].data)) {
+            SSSP_LOG_ERROR("Snapshot section %u: reserved tag 0x%x or no data", i, sections[i].tag);
+            return SSSP_ERROR_INVALID_ARGUMENT;
+        }
+        for (uint32_t j = 0; j < i; j++) {
+            if (sections[j].tag == sections[i].tag) {
+                SSSP_LOG_ERROR("Snapshot section tag 0x%x used twice", sections[i].tag);
+                return SSSP_ERROR_INVALID_ARGUMENT;
+            }
+        }
+    }
+
+    const sssp_allocator_t* allocator = graph->allocator ? graph->allocator : sssp_default_allocator();
+    uint32_t total = GRAPH_SECTIONS + num_sections;
+    section_entry_t* table = sssp_alloc(allocator, total * sizeof(section_entry_t));
+    size_t temporary_size = strlen(path) + 32;
+    char* temporary = sssp_alloc(allocator, temporary_size);
+    if (!table || !temporary) {
+        sssp_free(allocator, table);
+        sssp_free(allocator, temporary);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(table, 0, total * sizeof(section_entry_t));
+    snprintf(temporary, temporary_size, "%s.%ld.tmp", path, (long)getpid());
+
+    sssp_error_t error = SSSP_SUCCESS;
+    int fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        SSSP_LOG_ERROR("Cannot create snapshot %s: %s", temporary, strerror(errno));
+        error = SSSP_ERROR_IO;
+    } else {
+        error = write_snapshot(fd, graph, sections, num_sections, table);
+        if (close(fd) != 0 && error == SSSP_SUCCESS) {
+            error = SSSP_ERROR_IO;
+        }
+        if (error == SSSP_SUCCESS && rename(temporary, path) != 0) {
+            error = SSSP_ERROR_IO;
+        }
+        if (error != SSSP_SUCCESS) {
+            SSSP_LOG_ERROR("Failed to write snapshot %s: %s", path, strerror(errno));
+            unlink(temporary);
+        }
+    }
+    if (error == SSSP_SUCCESS) {
+        SSSP_LOG_INFO("Wrote snapshot %s: %u vertices, %u edges, %u indexes",
+                      path, graph->num_vertices, graph->num_edges, num_sections);
+    }
+    sssp_free(allocator, temporary);
+    sssp_free(allocator, table);
+    return error;
+}
+
+// ============================================================================
+// Mapping
+// ============================================================================
+
+static const section_entry_t* find_section(const sssp_snapshot_t* snapshot, uint32_t tag) {
+    for (uint32_t i = 0; i < snapshot->header->num_sections; i++) {
+        if (snapshot->sections[i].tag == tag) {
+            return &snapshot->sections[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Check the header, section table and (with verify) section contents
+ */
+static bool check_snapshot(const sssp_snapshot_t* snapshot, const char* path, bool verify) {
+    const unsigned char* base = snapshot->base;
+    const file_header_t* header = snapshot->header;
+    if (snapshot->size < sizeof(file_header_t) || header->magic != SNAPSHOT_MAGIC) {
+        SSSP_LOG_WARN("%s is not a snapshot", path);
+        return false;
+    }
+    if (header->version != SSSP_SNAPSHOT_VERSION) {
+        SSSP_LOG_WARN("Snapshot %s has version %u, expected %u", path, header->version, SSSP_SNAPSHOT_VERSION);
+        return false;
+    }
+    if (header->file_size != snapshot->size || header->num_sections < GRAPH_SECTIONS ||
+        header->num_sections > (snapshot->size - sizeof(file_header_t)) / sizeof(section_entry_t)) {
+        SSSP_LOG_WARN("Snapshot %s is truncated", path);
+        return false;
+    }
+
+    file_header_t copy = *header;
+    copy.table_checksum = 0;
+    hasher_t hasher;
+    hasher_init(&hasher);
+    hasher_update(&hasher, &copy, sizeof(copy));
+    hasher_update(&hasher, snapshot->sections, header->num_sections * sizeof(section_entry_t));
+    if (hasher_final(&hasher) != header->table_checksum) {
+        SSSP_LOG_WARN("Snapshot %s has a damaged header", path);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header->num_sections; i++) {
+        const section_entry_t* section = &snapshot->sections[i];
+        if (section->offset % SECTION_ALIGNMENT != 0 || section->offset > snapshot->size ||
+            section->size > snapshot->size - section->offset) {
+            SSSP_LOG_WARN("Snapshot %s has a section outside the file", path);
+            return false;
+        }
+        if (verify && hash_bytes(base + section->offset, (size_t)section->size) != section->checksum) {
+            SSSP_LOG_WARN("Snapshot %s: section 0x%x fails its checksum", path, section->tag);
+            return false;
+        }
+    }
+
+    sssp_graph_t shape;
+    memset(&shape, 0, sizeof(shape));
+    shape.num_vertices = header->num_vertices;
+    shape.num_edges = header->num_edges;
+    for (int i = 0; i < GRAPH_SECTIONS; i++) {
+        const section_entry_t* section = find_section(snapshot, TAG_CSR_OFFSETS + (uint32_t)i);
+        if (!section || section->size != graph_section_size(&shape, i)) {
+            SSSP_LOG_WARN("Snapshot %s has no valid graph", path);
+            return false;
+        }
+    }
+    const edge_count_t* offsets = (const void*)(base + find_section(snapshot, TAG_CSR_OFFSETS)->offset);
+    if (offsets[0] != 0 || offsets[header->num_vertices] != header->num_edges) {
+        SSSP_LOG_WARN("Snapshot %s has inconsistent edge offsets", path);
+        return false;
+    }
+    return true;
+}
+
+sssp_error_t sssp_snapshot_open(const char* path,
+                                uint32_t flags,
+                                const sssp_allocator_t* allocator,
+                                sssp_snapshot_t** snapshot_out) {
+    if (!path || !snapshot_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    *snapshot_out = NULL;
+    if (!allocator) {
+        allocator = sssp_default_allocator();
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        SSSP_LOG_INFO("No snapshot at %s: %s", path, strerror(errno));
+        return SSSP_ERROR_IO;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < (off_t)sizeof(file_header_t)) {
+        close(fd);
+        SSSP_LOG_WARN("%s is not a snapshot", path);
+        return SSSP_ERROR_IO;
+    }
+    size_t size = (size_t)status.st_size;
+    void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        SSSP_LOG_ERROR("Cannot map snapshot %s: %s", path, strerror(errno));
+        return SSSP_ERROR_IO;
+    }
+    if (flags & SSSP_SNAPSHOT_PREFETCH) {
+        posix_madvise(base, size, POSIX_MADV_WILLNEED);
+    }
+
+    sssp_snapshot_t* snapshot = sssp_alloc(allocator, sizeof(sssp_snapshot_t));
+    sssp_graph_t* graph = sssp_alloc(allocator, sizeof(sssp_graph_t));
+    if (!snapshot || !graph) {
+        sssp_free(allocator, snapshot);
+        sssp_free(allocator, graph);
+        munmap(base, size);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->base = base;
+    snapshot->size = size;
+    snapshot->header = base;
+    snapshot->sections = (const section_entry_t*)((const unsigned char*)base + sizeof(file_header_t));
+    snapshot->allocator = allocator;
+    if (!check_snapshot(snapshot, path, (flags & SSSP_SNAPSHOT_VERIFY) != 0)) {
+        sssp_free(allocator, graph);
+        munmap(base, size);
+        sssp_free(allocator, snapshot);
+        return SSSP_ERROR_IO;
+    }
+
+    // The graph's arrays are the mapped sections; the mapping is read-only
+    unsigned char* bytes = base;
+    memset(graph, 0, sizeof(*graph));
+    graph->num_vertices = snapshot->header->num_vertices;
+    graph->num_edges = snapshot->header->num_edges;
+    graph->total_edges = graph->num_edges;
+    graph->has_negative_weights = (snapshot->header->flags & FLAG_NEGATIVE_WEIGHTS) != 0;
+    graph->allow_negative_weights = graph->has_negative_weights;
+    graph->csr_offsets = (edge_count_t*)(void*)(bytes + find_section(snapshot, TAG_CSR_OFFSETS)->offset);
+    graph->csr_targets = (vertex_id_t*)(void*)(bytes + find_section(snapshot, TAG_CSR_TARGETS)->offset);
+    graph->csr_weights = (weight_t*)(void*)(bytes + find_section(snapshot, TAG_CSR_WEIGHTS)->offset);
+    graph->allocator = allocator;
+    snapshot->graph = graph;
+
+    SSSP_LOG_INFO("Mapped snapshot %s: %u vertices, %u edges, %u indexes", path, graph->num_vertices,
+                  graph->num_edges, snapshot->header->num_sections - GRAPH_SECTIONS);
+    *snapshot_out = snapshot;
+    return SSSP_SUCCESS;
+}
+
+void sssp_snapshot_close(sssp_snapshot_t* snapshot) {
+    if (!snapshot) {
+        return;
+    }
+    // Lists and in-edges built on demand over the mapped arrays are heap memory
+    sssp_free(snapshot->allocator, snapshot->graph->adj_list);
+    sssp_free(snapshot->allocator, snapshot->graph->edge_pool);
+    sssp_free(snapshot->allocator, snapshot->graph->reverse_offsets);
+    sssp_free(snapshot->allocator, snapshot->graph->reverse_sources);
+    sssp_free(snapshot->allocator, snapshot->graph->reverse_weights);
+    sssp_free(snapshot->allocator, snapshot->graph->int_weights);
+    sssp_free(snapshot->allocator, snapshot->graph);
+    munmap(snapshot->base, snapshot->size);
+    sssp_free(snapshot->allocator, snapshot);
+}
+
+const sssp_graph_t* sssp_snapshot_graph(const sssp_snapshot_t* snapshot) {
+    return snapshot ? snapshot->graph : NULL;
+}
+
+uint64_t sssp_snapshot_graph_hash(const sssp_snapshot_t* snapshot) {
+    return snapshot ? snapshot->header->graph_hash : 0;
+}
+
+sssp_error_t sssp_snapshot_find(const sssp_snapshot_t* snapshot,
+                                uint32_t tag,
+                                const void** data_out,
+                                uint64_t* size_out) {
+    if (!snapshot || !data_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    const section_entry_t* section = (tag & TAG_RESERVED) ? NULL : find_section(snapshot, tag);
+    if (!section) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    *data_out = (const unsigned char*)snapshot->base + section->offset;
+    if (size_out) {
+        *size_out = section->size;
+    }
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_snapshot_load_or_build(const char* path,
+                                         const sssp_graph_t* graph,
+                                         const sssp_snapshot_index_t* indexes,
+                                         uint32_t num_indexes,
+                                         uint32_t flags,
+                                         const sssp_allocator_t* allocator,
+                                         sssp_snapshot_t** snapshot_out,
+                                         bool* rebuilt_out) {
+    if (!path || !graph || !snapshot_out || (num_indexes > 0 && !indexes)) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (!allocator) {
+        allocator = sssp_default_allocator();
+    }
+    if (rebuilt_out) {
+        *rebuilt_out = false;
+    }
+
+    sssp_snapshot_t* snapshot = NULL;
+    if (sssp_snapshot_open(path, flags, allocator, &snapshot) == SSSP_SUCCESS) {
+        bool current = sssp_snapshot_graph_hash(snapshot) == sssp_graph_content_hash(graph);
+        for (uint32_t i = 0; i < num_indexes && current; i++) {
+            const void* data;
+            current = sssp_snapshot_find(snapshot, indexes[i].tag, &data, NULL) == SSSP_SUCCESS;
+        }
+        if (current) {
+            *snapshot_out = snapshot;
+            return SSSP_SUCCESS;
+        }
+        SSSP_LOG_INFO("Snapshot %s does not match the graph; rebuilding", path);
+        sssp_snapshot_close(snapshot);
+    }
+
+    sssp_snapshot_section_t* sections = NULL;
+    if (num_indexes > 0) {
+        sections = sssp_alloc(allocator, num_indexes * sizeof(sssp_snapshot_section_t));
+        if (!sections) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        memset(sections, 0, num_indexes * sizeof(sssp_snapshot_section_t));
+    }
+    sssp_error_t error = SSSP_SUCCESS;
+    uint32_t built = 0;
+    for (; built < num_indexes; built++) {
+        void* data = NULL;
+        uint64_t size = 0;
+        error = indexes[built].build(graph, indexes[built].context, allocator, &data, &size);
+        if (error != SSSP_SUCCESS) {
+            SSSP_LOG_ERROR("Building snapshot index 0x%x failed: %s", indexes[built].tag,
+                           sssp_error_string(error));
+            break;
+        }
+        sections[built].tag = indexes[built].tag;
+        sections[built].data = data;
+        sections[built].size = size;
+    }
+    if (error == SSSP_SUCCESS) {
+        error = sssp_snapshot_save(path, graph, sections, num_indexes);
+    }
+    for (uint32_t i = 0; i < built; i++) {
+        sssp_free(allocator, (void*)sections[i].data);
+    }
+    sssp_free(allocator, sections);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    error = sssp_snapshot_open(path, flags & ~SSSP_SNAPSHOT_VERIFY, allocator, snapshot_out);
+    if (error == SSSP_SUCCESS && rebuilt_out) {
+        *rebuilt_out = true;
+    }
+    return error;
+}
+
+#else // _WIN32
+
+sssp_error_t sssp_snapshot_save(const char* path, const sssp_graph_t* graph,
+                                const sssp_snapshot_section_t* sections, uint32_t num_sections) {
+    (void)path; (void)graph; (void)sections; (void)num_sections;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_snapshot_open(const char* path, uint32_t flags, const sssp_allocator_t* allocator,
+                                sssp_snapshot_t** snapshot_out) {
+    (void)path; (void)flags; (void)allocator;
+    if (snapshot_out) {
+        *snapshot_out = NULL;
+    }
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_snapshot_load_or_build(const char* path, const sssp_graph_t* graph,
+                                         const sssp_snapshot_index_t* indexes, uint32_t num_indexes,
+                                         uint32_t flags, const sssp_allocator_t* allocator,
+                                         sssp_snapshot_t** snapshot_out, bool* rebuilt_out) {
+    (void)path; (void)graph; (void)indexes; (void)num_indexes; (void)flags; (void)allocator;
+    (void)rebuilt_out;
+    if (snapshot_out) {
+        *snapshot_out = NULL;
+    }
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+void sssp_snapshot_close(sssp_snapshot_t* snapshot) {
+    (void)snapshot;
+}
+
+const sssp_graph_t* sssp_snapshot_graph(const sssp_snapshot_t* snapshot) {
+    (void)snapshot;
+    return NULL;
+}
+
+uint64_t sssp_snapshot_graph_hash(const sssp_snapshot_t* snapshot) {
+    (void)snapshot;
+    return 0;
+}
+
+sssp_error_t sssp_snapshot_find(const sssp_snapshot_t* snapshot, uint32_t tag,
+                                const void** data_out, uint64_t* size_out) {
+    (void)snapshot; (void)tag; (void)data_out; (void)size_out;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+#endif // _WIN32
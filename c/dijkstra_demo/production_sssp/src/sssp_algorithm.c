@@ -11,21 +11,120 @@
 #include "sssp_common.h"
 #include "partitioning_heap.h"
 #include "find_pivots.h"
+#include "profiler.h"
+#include "relax_kernels.h"
+#include "sssp_internal.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <time.h>
 
+// Initial lazy-heap capacity of a lean solver
+#define SSSP_LEAN_INITIAL_FRONTIER 1024
+
+/*
+ * Early termination for targeted queries: the search stops as soon as
+ * remaining tagged vertices have been settled. Settled tagged vertices are
+ * appended to found when it is not NULL.
+ */
+typedef struct settle_goal {
+    const uint64_t* tags;               // Tag bitmap (SSSP_TAG_WORDS words)
+    vertex_count_t remaining;           // Tagged vertices still to settle
+    sssp_target_result_t* found;        // Settled tagged vertices, in order
+} settle_goal_t;
+
 // Forward declarations for internal functions
-static sssp_solver_t* sssp_solver_create(vertex_count_t max_vertices, const sssp_allocator_t* allocator);
+static sssp_solver_t* sssp_solver_create(vertex_count_t max_vertices, const sssp_allocator_t* allocator,
+                                         sssp_solver_mode_t mode);
 static void sssp_solver_destroy(sssp_solver_t* solver);
 static sssp_error_t initialize_sources(sssp_solver_t* solver, const vertex_id_t* sources, vertex_count_t num_sources);
-static sssp_error_t run_standard_dijkstra(sssp_solver_t* solver, const sssp_graph_t* graph, distance_t max_distance);
+static sssp_error_t run_dijkstra(sssp_solver_t* solver, const sssp_graph_t* graph, distance_t max_distance,
+                                 settle_goal_t* goal);
+static sssp_error_t base_case_impl(const sssp_graph_t* graph, weight_t threshold,
+                                   const sssp_vertex_set_t* source_set, vertex_count_t k,
+                                   const sssp_algorithm_config_t* config,
+                                   sssp_tracking_allocator_t* budget,
+                                   sssp_vertex_set_t* output_set, weight_t* B_prime_out);
+static sssp_error_t enter_bounded_multi_source(const sssp_graph_t* graph,
+                                               vertex_count_t recursion_level,
+                                               weight_t threshold,
+                                               const sssp_vertex_set_t* source_set,
+                                               vertex_count_t k,
+                                               vertex_count_t t,
+                                               const sssp_algorithm_config_t* config,
+                                               sssp_tracking_allocator_t* budget,
+                                               sssp_vertex_set_t* output_set,
+                                               weight_t* B_prime_out);
+
+/*
+ * Settled flags, one bit or one bool per vertex (see sssp_visited_t)
+ */
+
+static inline size_t visited_bytes(vertex_count_t num_vertices) {
+#ifdef SSSP_PACKED_VISITED
+    return ((size_t)num_vertices + 63) / 64 * sizeof(sssp_visited_t);
+#else
+    return (size_t)num_vertices * sizeof(sssp_visited_t);
+#endif
+}
+
+static inline bool visited_test(const sssp_solver_t* solver, vertex_id_t v) {
+#ifdef SSSP_PACKED_VISITED
+    return (solver->visited[v >> 6] >> (v & 63)) & 1u;
+#else
+    return solver->visited[v];
+#endif
+}
+
+static inline void visited_set(sssp_solver_t* solver, vertex_id_t v) {
+#ifdef SSSP_PACKED_VISITED
+    solver->visited[v >> 6] |= (uint64_t)1 << (v & 63);
+#else
+    solver->visited[v] = true;
+#endif
+}
+
+static inline void visited_clear(sssp_solver_t* solver, vertex_id_t v) {
+#ifdef SSSP_PACKED_VISITED
+    solver->visited[v >> 6] &= ~((uint64_t)1 << (v & 63));
+#else
+    solver->visited[v] = false;
+#endif
+}
+
+bool sssp_solver_is_visited(const sssp_solver_t* solver, vertex_id_t vertex) {
+    return solver && vertex < solver->max_vertices && visited_test(solver, vertex);
+}
+
+/**
+ * Bytes a solver allocates up front
+ */
+size_t sssp_solver_memory_estimate(vertex_count_t num_vertices, sssp_solver_mode_t mode) {
+    size_t n = num_vertices;
+    size_t bytes = sizeof(sssp_solver_t) + n * (sizeof(distance_t) + sizeof(vertex_id_t)) +
+                   visited_bytes(num_vertices);
+    
+    if (mode == SSSP_SOLVER_LEAN) {
+        return bytes + SSSP_LEAN_INITIAL_FRONTIER * sizeof(sssp_heap_element_t);
+    }
+    
+    bytes += sizeof(sssp_partitioning_heap_t) + n * (sizeof(sssp_heap_element_t) + sizeof(vertex_count_t));
+    if (mode == SSSP_SOLVER_FULL) {
+        // Pivot finder (candidate set, pivots, two distance arrays, visited)
+        // and the three working sets
+        bytes += sizeof(sssp_pivot_finder_t) + 4 * sizeof(sssp_vertex_set_t);
+        bytes += n * (2 * sizeof(vertex_id_t) + 2 * sizeof(distance_t) + sizeof(bool));
+        bytes += n * 3 * sizeof(vertex_id_t);
+    }
+    return bytes;
+}
 
 /**
  * Create a new SSSP solver
  */
-sssp_solver_t* sssp_solver_create(vertex_count_t max_vertices, const sssp_allocator_t* allocator) {
+sssp_solver_t* sssp_solver_create(vertex_count_t max_vertices, const sssp_allocator_t* allocator,
+                                  sssp_solver_mode_t mode) {
     SSSP_LOG_DEBUG("Creating SSSP solver for %u vertices", max_vertices);
     
     if (max_vertices == 0) {
@@ -43,91 +142,65 @@ sssp_solver_t* sssp_solver_create(vertex_count_t max_vertices, const sssp_alloca
         return NULL;
     }
     
+    // Zeroed members are skipped by sssp_solver_destroy on failure
+    memset(solver, 0, sizeof(*solver));
     solver->max_vertices = max_vertices;
     solver->allocator = allocator;
+    solver->mode = mode;
+    solver->check_interval = UINT32_MAX;
+    solver->until_check = UINT32_MAX;
     
-    // Create distance array
     solver->distances = sssp_alloc(allocator, max_vertices * sizeof(distance_t));
-    if (!solver->distances) {
-        SSSP_LOG_ERROR("Failed to allocate distances array");
-        sssp_free(allocator, solver);
-        return NULL;
-    }
-    
-    // Create predecessor array
     solver->predecessors = sssp_alloc(allocator, max_vertices * sizeof(vertex_id_t));
-    if (!solver->predecessors) {
-        SSSP_LOG_ERROR("Failed to allocate predecessors array");
-        sssp_free(allocator, solver->distances);
-        sssp_free(allocator, solver);
-        return NULL;
-    }
-    
-    // Create visited array
-    solver->visited = sssp_alloc(allocator, max_vertices * sizeof(bool));
-    if (!solver->visited) {
-        SSSP_LOG_ERROR("Failed to allocate visited array");
-        sssp_free(allocator, solver->predecessors);
-        sssp_free(allocator, solver->distances);
-        sssp_free(allocator, solver);
-        return NULL;
-    }
-    
-    // Create partitioning heap
-    solver->heap = sssp_partitioning_heap_create(max_vertices, allocator);
-    if (!solver->heap) {
-        SSSP_LOG_ERROR("Failed to create partitioning heap");
-        sssp_free(allocator, solver->visited);
-        sssp_free(allocator, solver->predecessors);
-        sssp_free(allocator, solver->distances);
-        sssp_free(allocator, solver);
+    solver->visited = sssp_alloc(allocator, visited_bytes(max_vertices));
+    if (!solver->distances || !solver->predecessors || !solver->visited) {
+        SSSP_LOG_ERROR("Failed to allocate solver arrays");
+        sssp_solver_destroy(solver);
         return NULL;
     }
     
-    // Create pivot finder
-    solver->pivot_finder = sssp_pivot_finder_create(max_vertices, allocator);
-    if (!solver->pivot_finder) {
-        SSSP_LOG_ERROR("Failed to create pivot finder");
-        sssp_partitioning_heap_destroy(solver->heap);
-        sssp_free(allocator, solver->visited);
-        sssp_free(allocator, solver->predecessors);
-        sssp_free(allocator, solver->distances);
-        sssp_free(allocator, solver);
-        return NULL;
+    if (mode == SSSP_SOLVER_LEAN) {
+        // Lazy heap without a per-vertex index, grown with the frontier
+        solver->frontier = sssp_alloc(allocator, SSSP_LEAN_INITIAL_FRONTIER * sizeof(sssp_heap_element_t));
+        if (!solver->frontier) {
+            SSSP_LOG_ERROR("Failed to allocate frontier");
+            sssp_solver_destroy(solver);
+            return NULL;
+        }
+        solver->frontier_capacity = SSSP_LEAN_INITIAL_FRONTIER;
+    } else {
+        solver->heap = sssp_partitioning_heap_create(max_vertices, allocator);
+        if (!solver->heap) {
+            SSSP_LOG_ERROR("Failed to create partitioning heap");
+            sssp_solver_destroy(solver);
+            return NULL;
+        }
     }
     
-    // Create vertex sets for algorithm
-    solver->sources = sssp_vertex_set_create(max_vertices, allocator);
-    solver->close_vertices = sssp_vertex_set_create(max_vertices, allocator);
-    solver->far_vertices = sssp_vertex_set_create(max_vertices, allocator);
-    
-    if (!solver->sources || !solver->close_vertices || !solver->far_vertices) {
-        SSSP_LOG_ERROR("Failed to create vertex sets");
-        if (solver->sources) sssp_vertex_set_destroy(solver->sources);
-        if (solver->close_vertices) sssp_vertex_set_destroy(solver->close_vertices);
-        if (solver->far_vertices) sssp_vertex_set_destroy(solver->far_vertices);
-        sssp_pivot_finder_destroy(solver->pivot_finder);
-        sssp_partitioning_heap_destroy(solver->heap);
-        sssp_free(allocator, solver->visited);
-        sssp_free(allocator, solver->predecessors);
-        sssp_free(allocator, solver->distances);
-        sssp_free(allocator, solver);
-        return NULL;
+    if (mode == SSSP_SOLVER_FULL) {
+        solver->pivot_finder = sssp_pivot_finder_create(max_vertices, allocator);
+        if (!solver->pivot_finder) {
+            SSSP_LOG_ERROR("Failed to create pivot finder");
+            sssp_solver_destroy(solver);
+            return NULL;
+        }
+        
+        solver->sources = sssp_vertex_set_create(max_vertices, allocator);
+        solver->close_vertices = sssp_vertex_set_create(max_vertices, allocator);
+        solver->far_vertices = sssp_vertex_set_create(max_vertices, allocator);
+        if (!solver->sources || !solver->close_vertices || !solver->far_vertices) {
+            SSSP_LOG_ERROR("Failed to create vertex sets");
+            sssp_solver_destroy(solver);
+            return NULL;
+        }
     }
     
     // Initialize arrays
     for (vertex_count_t i = 0; i < max_vertices; i++) {
         solver->distances[i] = SSSP_INFINITY;
         solver->predecessors[i] = SSSP_INVALID_VERTEX;
-        solver->visited[i] = false;
     }
-    
-    // Initialize statistics
-    solver->stats.total_vertices_processed = 0;
-    solver->stats.total_edges_relaxed = 0;
-    solver->stats.pivots_used = 0;
-    solver->stats.heap_operations = 0;
-    solver->stats.algorithm_calls = 0;
+    memset(solver->visited, 0, visited_bytes(max_vertices));
     
     SSSP_LOG_DEBUG("SSSP solver created successfully");
     return solver;
@@ -148,6 +221,9 @@ void sssp_solver_destroy(sssp_solver_t* solver) {
     sssp_vertex_set_destroy(solver->far_vertices);
     sssp_pivot_finder_destroy(solver->pivot_finder);
     sssp_partitioning_heap_destroy(solver->heap);
+    sssp_free(allocator, solver->frontier);
+    sssp_free(allocator, solver->settled_order);
+    sssp_free(allocator, solver->touched);
     sssp_free(allocator, solver->visited);
     sssp_free(allocator, solver->predecessors);
     sssp_free(allocator, solver->distances);
@@ -156,18 +232,117 @@ void sssp_solver_destroy(sssp_solver_t* solver) {
     SSSP_LOG_DEBUG("SSSP solver destroyed successfully");
 }
 
+/**
+ * Push onto the lazy heap of a lean solver; outdated entries stay in place
+ * and are skipped when popped
+ */
+static sssp_error_t frontier_push(sssp_solver_t* solver, vertex_id_t vertex, distance_t distance) {
+    if (solver->frontier_size == solver->frontier_capacity) {
+        size_t capacity = solver->frontier_capacity * 2;
+        sssp_heap_element_t* frontier = sssp_realloc(solver->allocator, solver->frontier,
+                                                     capacity * sizeof(sssp_heap_element_t));
+        if (!frontier) {
+            SSSP_LOG_ERROR("Failed to grow frontier to %zu entries", capacity);
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        solver->frontier = frontier;
+        solver->frontier_capacity = capacity;
+    }
+    
+    sssp_heap_element_t* entries = solver->frontier;
+    size_t i = solver->frontier_size++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (entries[parent].distance <= distance) {
+            break;
+        }
+        entries[i] = entries[parent];
+        i = parent;
+    }
+    entries[i].vertex = vertex;
+    entries[i].distance = distance;
+    return SSSP_SUCCESS;
+}
+
+static sssp_heap_element_t frontier_pop(sssp_solver_t* solver) {
+    sssp_heap_element_t* entries = solver->frontier;
+    sssp_heap_element_t top = entries[0];
+    sssp_heap_element_t last = entries[--solver->frontier_size];
+    size_t size = solver->frontier_size;
+    size_t i = 0;
+    
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && entries[child + 1].distance < entries[child].distance) {
+            child++;
+        }
+        if (last.distance <= entries[child].distance) {
+            break;
+        }
+        entries[i] = entries[child];
+        i = child;
+    }
+    if (size > 0) {
+        entries[i] = last;
+    }
+    return top;
+}
+
+static inline size_t solver_heap_size(const sssp_solver_t* solver) {
+    return solver->mode == SSSP_SOLVER_LEAN ? solver->frontier_size : solver->heap->size;
+}
+
+/**
+ * Remove the closest unsettled vertex; returns false when there is none
+ */
+static bool solver_extract_min(sssp_solver_t* solver, vertex_id_t* vertex, distance_t* distance) {
+    if (solver->mode != SSSP_SOLVER_LEAN) {
+        return !sssp_partitioning_heap_is_empty(solver->heap) &&
+               sssp_partitioning_heap_extract_min(solver->heap, vertex, distance) == SSSP_SUCCESS;
+    }
+    
+    while (solver->frontier_size > 0) {
+        sssp_heap_element_t top = frontier_pop(solver);
+        if (!visited_test(solver, top.vertex) && top.distance <= solver->distances[top.vertex]) {
+            *vertex = top.vertex;
+            *distance = top.distance;
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Initialize distances and heap for given sources
  */
 static sssp_error_t initialize_sources(sssp_solver_t* solver, const vertex_id_t* sources, 
                                        vertex_count_t num_sources) {
     // Clear heap and reset distances
-    sssp_partitioning_heap_clear(solver->heap);
+    if (solver->mode == SSSP_SOLVER_LEAN) {
+        solver->frontier_size = 0;
+    } else {
+        sssp_partitioning_heap_clear(solver->heap);
+    }
     
-    for (vertex_count_t i = 0; i < solver->max_vertices; i++) {
-        solver->distances[i] = SSSP_INFINITY;
-        solver->predecessors[i] = SSSP_INVALID_VERTEX;
-        solver->visited[i] = false;
+    if (solver->touched) {
+        // A reused solver resets only what its last search reached
+        for (vertex_count_t i = 0; i < solver->touched_count; i++) {
+            vertex_id_t v = solver->touched[i];
+            solver->distances[v] = SSSP_INFINITY;
+            solver->predecessors[v] = SSSP_INVALID_VERTEX;
+            visited_clear(solver, v);
+        }
+        solver->touched_count = 0;
+        solver->settled_count = 0;
+    } else {
+        for (vertex_count_t i = 0; i < solver->max_vertices; i++) {
+            solver->distances[i] = SSSP_INFINITY;
+            solver->predecessors[i] = SSSP_INVALID_VERTEX;
+        }
+        memset(solver->visited, 0, visited_bytes(solver->max_vertices));
     }
     
     // Initialize source vertices
@@ -177,9 +352,17 @@ static sssp_error_t initialize_sources(sssp_solver_t* solver, const vertex_id_t*
             SSSP_LOG_ERROR("Invalid source vertex: %u", source);
             return SSSP_ERROR_INVALID_PARAMETER;
         }
+        if (solver->distances[source] == 0.0) {
+            continue;                   // Repeated source
+        }
         
+        if (solver->touched) {
+            solver->touched[solver->touched_count++] = source;
+        }
         solver->distances[source] = 0.0;
-        sssp_error_t result = sssp_partitioning_heap_insert(solver->heap, source, 0.0);
+        sssp_error_t result = solver->mode == SSSP_SOLVER_LEAN
+                                  ? frontier_push(solver, source, 0.0)
+                                  : sssp_partitioning_heap_insert(solver->heap, source, 0.0);
         if (result != SSSP_SUCCESS) {
             SSSP_LOG_ERROR("Failed to insert source vertex %u into heap", source);
             return result;
@@ -193,23 +376,163 @@ static sssp_error_t initialize_sources(sssp_solver_t* solver, const vertex_id_t*
 }
 
 /**
- * Standard Dijkstra's algorithm for small sets
+ * Lower the distance of v to new_dist via u if that improves it; the
+ * caller has already counted the edge
  */
-static sssp_error_t run_standard_dijkstra(sssp_solver_t* solver, const sssp_graph_t* graph,
-                                           distance_t max_distance) {
+static inline sssp_error_t apply_relaxation(sssp_solver_t* solver, vertex_id_t u,
+                                            vertex_id_t v, distance_t new_dist) {
+    if (new_dist >= solver->distances[v]) {
+        return SSSP_SUCCESS;
+    }
+    
+    SSSP_LOG_TRACE("Relaxing edge %u -> %u: %.2f -> %.2f", 
+                   u, v, solver->distances[v], new_dist);
+    
+    sssp_error_t result;
+    uint64_t heap_start_ns = SSSP_UNLIKELY(solver->sampling) ? sssp_get_timestamp_ns() : 0;
+    if (solver->mode == SSSP_SOLVER_LEAN) {
+        if (solver->touched && solver->distances[v] == SSSP_INFINITY) {
+            solver->touched[solver->touched_count++] = v;
+        }
+        solver->distances[v] = new_dist;
+        solver->predecessors[v] = u;
+        result = frontier_push(solver, v, new_dist);
+    } else if (solver->distances[v] == SSSP_INFINITY) {
+        // First time seeing this vertex
+        if (solver->touched) {
+            solver->touched[solver->touched_count++] = v;
+        }
+        solver->distances[v] = new_dist;
+        solver->predecessors[v] = u;
+        result = sssp_partitioning_heap_insert(solver->heap, v, new_dist);
+    } else {
+        // Update existing distance
+        solver->distances[v] = new_dist;
+        solver->predecessors[v] = u;
+        result = sssp_partitioning_heap_decrease_key(solver->heap, v, new_dist);
+    }
+    if (SSSP_UNLIKELY(solver->sampling)) {
+        solver->sampled_heap_ns += sssp_get_timestamp_ns() - heap_start_ns;
+    }
+    
+    if (result != SSSP_SUCCESS) {
+        SSSP_LOG_ERROR("Failed heap operation for vertex %u", v);
+        return result;
+    }
+    
+    solver->stats.heap_operations++;
+    solver->stats.heap_inserts++;
+    solver->stats.useful_relaxations++;
+    if (solver_heap_size(solver) > solver->stats.max_heap_size) {
+        solver->stats.max_heap_size = solver_heap_size(solver);
+    }
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Relax a single edge u -> v found while scanning u
+ */
+static inline sssp_error_t relax_edge(sssp_solver_t* solver, vertex_id_t u, distance_t dist_u,
+                                      vertex_id_t v, weight_t weight) {
+    solver->stats.total_edges_relaxed++;
+    return apply_relaxation(solver, u, v, dist_u + weight);
+}
+
+/**
+ * Prefetch what relaxing an edge into v touches: its distance and, with an
+ * indexed heap, its heap position
+ */
+static inline void prefetch_vertex_state(const sssp_solver_t* solver, vertex_id_t v) {
+    SSSP_PREFETCH(&solver->distances[v]);
+    if (solver->heap) {
+        SSSP_PREFETCH(&solver->heap->position[v]);
+    }
+}
+
+/**
+ * Relax the degree out-edges of u given by sssp_graph_neighbors. Long runs go
+ * through the SIMD relaxation kernel, which filters out the edges that cannot
+ * improve.
+ */
+static sssp_error_t relax_out_edges(sssp_solver_t* solver, vertex_id_t u, distance_t dist_u,
+                                    const vertex_id_t* targets, const weight_t* weights,
+                                    edge_count_t degree) {
+    sssp_error_t result;
+    
+    if (degree < SSSP_RELAX_MIN_VECTOR_DEGREE) {
+        for (edge_count_t e = 0; e < degree; e++) {
+#if SSSP_PREFETCH_DISTANCE > 0
+            if (e + SSSP_PREFETCH_DISTANCE < degree) {
+                prefetch_vertex_state(solver, targets[e + SSSP_PREFETCH_DISTANCE]);
+            }
+#endif
+            result = relax_edge(solver, u, dist_u, targets[e], weights[e]);
+            if (result != SSSP_SUCCESS) {
+                return result;
+            }
+        }
+        return SSSP_SUCCESS;
+    }
+    
+    edge_count_t improved[SSSP_RELAX_CHUNK];
+    for (edge_count_t chunk = 0; chunk < degree; chunk += SSSP_RELAX_CHUNK) {
+        edge_count_t count = SSSP_MIN(degree - chunk, (edge_count_t)SSSP_RELAX_CHUNK);
+        edge_count_t found = sssp_relax_scan(dist_u, targets + chunk, weights + chunk, count,
+                                             solver->distances, improved);
+        solver->stats.total_edges_relaxed += count;
+        
+        // apply_relaxation rechecks, which covers targets repeated in a chunk
+        for (edge_count_t i = 0; i < found; i++) {
+            edge_count_t e = chunk + improved[i];
+#if SSSP_PREFETCH_DISTANCE > 0
+            if (i + SSSP_PREFETCH_DISTANCE < found && solver->heap) {
+                SSSP_PREFETCH(&solver->heap->position[targets[chunk + improved[i + SSSP_PREFETCH_DISTANCE]]]);
+            }
+#endif
+            result = apply_relaxation(solver, u, targets[e], dist_u + weights[e]);
+            if (result != SSSP_SUCCESS) {
+                return result;
+            }
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Standard Dijkstra's algorithm, stopping at max_distance or once goal (if
+ * not NULL) is met
+ *
+ * With a profiler attached the loop runs as a split phase; one settled
+ * vertex in every SSSP_PROFILE_SAMPLE_INTERVAL is timed to divide it
+ * between heap operations (the extraction plus the heap updates of its
+ * relaxations) and relaxation.
+ */
+static sssp_error_t run_dijkstra(sssp_solver_t* solver, const sssp_graph_t* graph,
+                                 distance_t max_distance, settle_goal_t* goal) {
     SSSP_LOG_TRACE("Running standard Dijkstra with max distance %.2f", max_distance);
     
-    while (!sssp_partitioning_heap_is_empty(solver->heap)) {
+    sssp_profiler_t* profiler = solver->profiler;
+    sssp_error_t expired = sssp_check_query_limits(solver->deadline_ns, solver->cancel_token);
+    if (expired != SSSP_SUCCESS) {
+        return expired;
+    }
+    if (SSSP_UNLIKELY(profiler != NULL)) {
+        sssp_profiler_begin_split(profiler, SSSP_PHASE_HEAP_OPERATIONS, SSSP_PHASE_RELAXATION);
+    }
+    
+    for (;;) {
         vertex_id_t u;
         distance_t dist_u;
+        sssp_error_t result;
         
-        sssp_error_t result = sssp_partitioning_heap_extract_min(solver->heap, &u, &dist_u);
-        if (result != SSSP_SUCCESS) {
-            SSSP_LOG_ERROR("Failed to extract minimum from heap");
-            return result;
+        bool sampled = SSSP_UNLIKELY(profiler != NULL) && sssp_profiler_sample_due(profiler);
+        uint64_t sample_start_ns = sampled ? sssp_get_timestamp_ns() : 0;
+        if (!solver_extract_min(solver, &u, &dist_u)) {
+            break;
         }
         
         solver->stats.heap_operations++;
+        solver->stats.heap_pulls++;
         
         // Stop if we exceed maximum distance
         if (dist_u > max_distance) {
@@ -217,47 +540,61 @@ static sssp_error_t run_standard_dijkstra(sssp_solver_t* solver, const sssp_grap
             break;
         }
         
-        solver->visited[u] = true;
+        visited_set(solver, u);
         solver->stats.total_vertices_processed++;
+        if (solver->settled_order) {
+            solver->settled_order[solver->settled_count++] = u;
+        }
+        
+        if (goal && (goal->tags[u / 64] >> (u % 64) & 1)) {
+            if (goal->found) {
+                sssp_target_result_t* found = goal->found;
+                found->vertices[found->count] = u;
+                found->distances[found->count] = dist_u;
+                found->predecessors[found->count] = solver->predecessors[u];
+                found->count++;
+            }
+            if (--goal->remaining == 0) {
+                SSSP_LOG_TRACE("All tagged vertices settled, stopping");
+                break;
+            }
+        }
         
         SSSP_LOG_TRACE("Processing vertex %u with distance %.2f", u, dist_u);
         
         // Process all neighbors
-        const sssp_adj_list_t* adj_list = sssp_graph_get_adj_list(graph, u);
-        if (adj_list) {
-            sssp_edge_node_t* edge = adj_list->head;
-            while (edge) {
-                vertex_id_t v = edge->to;
-                distance_t new_dist = dist_u + edge->weight;
-                
-                solver->stats.total_edges_relaxed++;
-                
-                if (new_dist < solver->distances[v]) {
-                    SSSP_LOG_TRACE("Relaxing edge %u -> %u: %.2f -> %.2f", 
-                                   u, v, solver->distances[v], new_dist);
-                    
-                    if (solver->distances[v] == SSSP_INFINITY) {
-                        // First time seeing this vertex
-                        solver->distances[v] = new_dist;
-                        solver->predecessors[v] = u;
-                        result = sssp_partitioning_heap_insert(solver->heap, v, new_dist);
-                    } else {
-                        // Update existing distance
-                        solver->distances[v] = new_dist;
-                        solver->predecessors[v] = u;
-                        result = sssp_partitioning_heap_decrease_key(solver->heap, v, new_dist);
-                    }
-                    
-                    if (result != SSSP_SUCCESS) {
-                        SSSP_LOG_ERROR("Failed heap operation for vertex %u", v);
-                        return result;
-                    }
-                    
-                    solver->stats.heap_operations++;
-                }
-                
-                edge = edge->next;
-            }
+        uint64_t relax_start_ns = 0;
+        if (SSSP_UNLIKELY(sampled)) {
+            relax_start_ns = sssp_get_timestamp_ns();
+            solver->sampling = true;
+            solver->sampled_heap_ns = 0;
+        }
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t degree;
+        result = sssp_graph_neighbors(graph, u, &targets, &weights, &degree);
+        if (result == SSSP_SUCCESS) {
+            result = relax_out_edges(solver, u, dist_u, targets, weights, degree);
+        }
+        if (SSSP_UNLIKELY(sampled)) {
+            uint64_t relax_ns = sssp_get_timestamp_ns() - relax_start_ns;
+            uint64_t heap_ns = SSSP_MIN(solver->sampled_heap_ns, relax_ns);
+            solver->sampling = false;
+            sssp_profiler_add_sample(profiler, relax_start_ns - sample_start_ns + heap_ns,
+                                     relax_ns - heap_ns);
+        }
+        if (result != SSSP_SUCCESS) {
+            return result;
+        }
+        
+        // Query limits, polled rather than per vertex to keep the clock off the hot path
+        result = sssp_poll_query_limits(&solver->until_check, solver->check_interval,
+                                        solver->deadline_ns, solver->cancel_token);
+        if (SSSP_UNLIKELY(result != SSSP_SUCCESS)) {
+            SSSP_LOG_DEBUG("Query stopped after %llu settled vertices: %s",
+                           (unsigned long long)solver->stats.total_vertices_processed,
+                           sssp_error_string(result));
+            return result;
         }
     }
     
@@ -265,6 +602,24 @@ static sssp_error_t run_standard_dijkstra(sssp_solver_t* solver, const sssp_grap
     return SSSP_SUCCESS;
 }
 
+static sssp_error_t run_standard_dijkstra(sssp_solver_t* solver, const sssp_graph_t* graph,
+                                           distance_t max_distance) {
+    return run_dijkstra(solver, graph, max_distance, NULL);
+}
+
+/**
+ * Dijkstra settles a vertex for good when it leaves the heap, which a
+ * negative edge can prove wrong later
+ */
+static bool reject_negative_weights(const sssp_graph_t* graph) {
+    if (sssp_graph_has_negative_weights(graph)) {
+        SSSP_LOG_ERROR("Graph has negative edge weights; use sssp_solve_bellman_ford() "
+                       "or sssp_johnson_create()");
+        return true;
+    }
+    return false;
+}
+
 /**
  * Implementation of Algorithm 3 (bounded multi-source shortest paths)
  */
@@ -276,6 +631,14 @@ sssp_error_t sssp_solve_bounded_multi_source(sssp_solver_t* solver, const sssp_g
         return SSSP_ERROR_INVALID_PARAMETER;
     }
     
+    if (solver->mode != SSSP_SOLVER_FULL) {
+        SSSP_LOG_ERROR("Bounded multi-source SSSP needs a solver with FINDPIVOTS state");
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (reject_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    
     if (num_sources == 0) {
         SSSP_LOG_DEBUG("No sources provided");
         return SSSP_SUCCESS;
@@ -286,8 +649,13 @@ sssp_error_t sssp_solve_bounded_multi_source(sssp_solver_t* solver, const sssp_g
     
     solver->stats.algorithm_calls++;
     
+    sssp_error_t result = sssp_check_query_limits(solver->deadline_ns, solver->cancel_token);
+    if (result != SSSP_SUCCESS) {
+        return result;
+    }
+    
     // Initialize solver state
-    sssp_error_t result = initialize_sources(solver, sources, num_sources);
+    result = initialize_sources(solver, sources, num_sources);
     if (result != SSSP_SUCCESS) {
         return result;
     }
@@ -326,7 +694,7 @@ sssp_error_t sssp_solve_bounded_multi_source(sssp_solver_t* solver, const sssp_g
         // Re-insert close vertices into heap
         for (vertex_count_t i = 0; i < close_count; i++) {
             vertex_id_t v = sssp_vertex_set_get_vertex(solver->close_vertices, i);
-            if (!solver->visited[v] && solver->distances[v] < SSSP_INFINITY) {
+            if (!visited_test(solver, v) && solver->distances[v] < SSSP_INFINITY) {
                 sssp_partitioning_heap_insert(solver->heap, v, solver->distances[v]);
                 solver->stats.heap_operations++;
             }
@@ -343,8 +711,8 @@ sssp_error_t sssp_solve_bounded_multi_source(sssp_solver_t* solver, const sssp_g
     // Step 4: Collect far vertices (those still in heap or not yet processed)
     sssp_vertex_set_clear(solver->far_vertices);
     for (vertex_count_t v = 0; v < solver->max_vertices; v++) {
-        if (!solver->visited[v] && solver->distances[v] < max_distance) {
-            sssp_vertex_set_add(solver->far_vertices, v);
+        if (!visited_test(solver, v) && solver->distances[v] < max_distance) {
+            sssp_vertex_set_add_array(solver->far_vertices, &v, 1);  // Distinct by construction
         }
     }
     
@@ -431,12 +799,132 @@ sssp_error_t sssp_solve_bounded_multi_source(sssp_solver_t* solver, const sssp_g
 }
 
 /**
- * Solve standard single-source shortest path problem
+ * Allocator for the temporaries of one recursion level
  */
-sssp_error_t sssp_solve_single_source(const sssp_graph_t* graph,
-                                       vertex_id_t source,
-                                       const sssp_algorithm_config_t* config,
-                                       sssp_algorithm_result_t* result) {
+static const sssp_allocator_t* scratch_allocator(const sssp_algorithm_config_t* config) {
+    return config->scratch_arena ? &config->scratch_arena->allocator : config->allocator;
+}
+
+static sssp_error_t allocation_error(const sssp_tracking_allocator_t* tracker) {
+    return tracker->limit_failures > 0 ? SSSP_ERROR_MEMORY_LIMIT : SSSP_ERROR_OUT_OF_MEMORY;
+}
+
+/**
+ * Create the solver for a Dijkstra-based solve within config->memory_limit_bytes
+ *
+ * Every allocation of the solve goes through tracker, on top of parent,
+ * which enforces the limit and records the peak. With a huge page threshold
+ * configured, pages sits between the two and maps the solver's large arrays
+ * onto huge pages. When the indexed heap does not fit, the solver falls back
+ * to the lean lazy heap; when neither fits, the solve fails before
+ * allocating anything.
+ */
+static sssp_error_t create_budgeted_solver(vertex_count_t num_vertices,
+                                           const sssp_algorithm_config_t* config,
+                                           const sssp_allocator_t* parent,
+                                           sssp_huge_page_allocator_t* pages,
+                                           sssp_tracking_allocator_t* tracker,
+                                           sssp_solver_t** solver_out) {
+    size_t limit = config->memory_limit_bytes;
+    sssp_huge_page_allocator_init(pages, parent, config->huge_page_threshold,
+                                  SSSP_HUGE_PAGES_TRANSPARENT);
+    if (config->huge_page_threshold != 0) {
+        parent = &pages->allocator;
+    }
+    sssp_tracking_allocator_init(tracker, parent, limit);
+    *solver_out = NULL;
+    
+    sssp_solver_mode_t mode = SSSP_SOLVER_DIJKSTRA;
+    if (limit != 0 && sssp_solver_memory_estimate(num_vertices, mode) > limit) {
+        mode = SSSP_SOLVER_LEAN;
+        size_t required = sssp_solver_memory_estimate(num_vertices, mode);
+        if (required > limit) {
+            SSSP_LOG_ERROR("Solving %u vertices needs at least %zu bytes, limit is %zu",
+                           num_vertices, required, limit);
+            return SSSP_ERROR_MEMORY_LIMIT;
+        }
+        SSSP_LOG_INFO("Memory limit of %zu bytes: using lean solver", limit);
+    }
+    
+    sssp_solver_t* solver = sssp_solver_create(num_vertices, &tracker->allocator, mode);
+    if (!solver) {
+        return allocation_error(tracker);
+    }
+    solver->deadline_ns = config->deadline_ns;
+    solver->cancel_token = config->cancel_token;
+    solver->check_interval = sssp_limit_check_interval(config->deadline_ns, config->cancel_token,
+                                                       config->limit_check_interval);
+    solver->until_check = solver->check_interval;
+    *solver_out = solver;
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Copy a finished single-source solve, or one stopped by the query limits,
+ * into result
+ *
+ * A stopped solve has exact distances for its settled vertices and upper
+ * bounds, reached along the predecessors, for the rest of its frontier.
+ */
+static void copy_solver_result(const sssp_solver_t* solver, vertex_count_t num_vertices,
+                               sssp_error_t error, sssp_algorithm_result_t* result) {
+    for (vertex_count_t i = 0; i < num_vertices; i++) {
+        result->distances[i] = solver->distances[i];
+        result->predecessors[i] = solver->predecessors[i];
+        if (visited_test(solver, i)) {
+            sssp_vertex_set_add(result->processed_vertices, i);
+        }
+    }
+    
+    result->vertices_processed = solver->stats.total_vertices_processed;
+    result->relaxations_performed = solver->stats.total_edges_relaxed;
+    result->recursive_calls = 1;
+    result->is_optimal = error == SSSP_SUCCESS;
+    result->approximation_bound = error == SSSP_SUCCESS ? 1.0 : SSSP_INFINITY;
+    result->validation_status = error;
+}
+
+/**
+ * Check a finished single-source result when config->enable_validation is set
+ */
+static sssp_error_t validate_if_enabled(const sssp_graph_t* graph, vertex_id_t source,
+                                        const sssp_algorithm_config_t* config,
+                                        sssp_algorithm_result_t* result) {
+    if (!config->enable_validation) {
+        return SSSP_SUCCESS;
+    }
+    sssp_error_t status = sssp_validate_result(graph, source, result, NULL);
+    result->validation_status = status;
+    result->is_optimal = status == SSSP_SUCCESS;
+    return status;
+}
+
+/**
+ * Copy the operation counts of a solve that did not use the solver into a
+ * profile
+ */
+static void profile_result_counts(const sssp_algorithm_result_t* result,
+                                  sssp_performance_profile_t* profile) {
+    profile->total_relaxations = result->relaxations_performed;
+    profile->heap_pulls = result->vertices_processed;
+    profile->recursive_calls = 1;
+    profile->max_recursion_depth = 1;
+    profile->peak_memory_bytes = result->peak_memory_bytes;
+    profile->avg_memory_bytes = profile->peak_memory_bytes;
+}
+
+/**
+ * Body of sssp_solve_single_source() and sssp_solve_with_profiling()
+ *
+ * With profile given, the solve charges its phases to the profiler attached
+ * to the calling thread, and profile receives its operation counts and
+ * memory footprint.
+ */
+static sssp_error_t solve_single_source_impl(const sssp_graph_t* graph,
+                                             vertex_id_t source,
+                                             const sssp_algorithm_config_t* config,
+                                             sssp_algorithm_result_t* result,
+                                             sssp_performance_profile_t* profile) {
     if (!graph || !result) {
         return SSSP_ERROR_INVALID_PARAMETER;
     }
@@ -445,6 +933,9 @@ sssp_error_t sssp_solve_single_source(const sssp_graph_t* graph,
     if (source >= num_vertices) {
         return SSSP_ERROR_INVALID_PARAMETER;
     }
+    if (reject_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
     
     // Use default config if none provided
     sssp_algorithm_config_t default_config;
@@ -452,49 +943,527 @@ sssp_error_t sssp_solve_single_source(const sssp_graph_t* graph,
         default_config = sssp_algorithm_config_default(num_vertices, NULL);
         config = &default_config;
     }
+    if (!(config->approximation_epsilon >= 0.0)) {
+        SSSP_LOG_ERROR("Invalid approximation epsilon %f", config->approximation_epsilon);
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (config->approximation_epsilon > 0.0) {
+        sssp_error_t error = sssp_solve_approximate(graph, source, config, result);
+        if (profile) {
+            profile_result_counts(result, profile);
+        }
+        return error;
+    }
+    if (sssp_graph_get_weight_scale(graph) != 0) {
+        sssp_error_t error = sssp_solve_integer(graph, source, config, result);
+        if (profile) {
+            profile_result_counts(result, profile);
+        }
+        if (error == SSSP_SUCCESS) {
+            error = validate_if_enabled(graph, source, config, result);
+        }
+        return error;
+    }
     
     SSSP_LOG_INFO("Solving single-source SSSP from vertex %u", source);
     
     clock_t start_time = clock();
     
     // Create internal solver
-    sssp_solver_t* solver = sssp_solver_create(num_vertices, config->allocator);
-    if (!solver) {
-        return SSSP_ERROR_OUT_OF_MEMORY;
+    sssp_huge_page_allocator_t pages;
+    sssp_tracking_allocator_t tracker;
+    sssp_solver_t* solver;
+    sssp_error_t error = create_budgeted_solver(num_vertices, config, config->allocator,
+                                                &pages, &tracker, &solver);
+    if (error != SSSP_SUCCESS) {
+        return error;
     }
     
     // Run algorithm
-    sssp_error_t error = initialize_sources(solver, &source, 1);
+    solver->profiler = profile ? sssp_profiler_current() : NULL;
+    error = initialize_sources(solver, &source, 1);
     if (error == SSSP_SUCCESS) {
         error = run_standard_dijkstra(solver, graph, SSSP_INFINITY);
     }
+    if (error == SSSP_ERROR_OUT_OF_MEMORY) {
+        error = allocation_error(&tracker);
+    }
     
-    if (error == SSSP_SUCCESS) {
-        // Copy results
-        for (vertex_count_t i = 0; i < num_vertices; i++) {
-            result->distances[i] = solver->distances[i];
-            result->predecessors[i] = solver->predecessors[i];
-            if (solver->visited[i]) {
-                sssp_vertex_set_add(result->processed_vertices, i);
-            }
-        }
-        
-        result->vertices_processed = solver->stats.total_vertices_processed;
-        result->relaxations_performed = solver->stats.total_edges_relaxed;
-        result->recursive_calls = 1;
-        result->is_optimal = true;
-        result->validation_status = SSSP_SUCCESS;
+    SSSP_PROFILE_SWITCH(solver->profiler, SSSP_PHASE_FINALIZATION);
+    if (error == SSSP_SUCCESS || sssp_error_is_interruption(error)) {
+        copy_solver_result(solver, num_vertices, error, result);
     }
     
     clock_t end_time = clock();
     result->total_time_ms = ((double)(end_time - start_time)) / CLOCKS_PER_SEC * 1000.0;
+    if (error == SSSP_SUCCESS) {
+        error = validate_if_enabled(graph, source, config, result);
+    }
+    
+    result->page_size = sssp_huge_page_allocator_stats(&pages).page_size;
+    
+    if (profile) {
+        profile->total_relaxations = solver->stats.total_edges_relaxed;
+        profile->useful_relaxations = solver->stats.useful_relaxations;
+        profile->heap_inserts = solver->stats.heap_inserts;
+        profile->heap_pulls = solver->stats.heap_pulls;
+        profile->recursive_calls = 1;
+        profile->max_recursion_depth = 1;
+        profile->max_heap_size = (vertex_count_t)solver->stats.max_heap_size;
+        
+        // Memory footprint of the solver, measured by the tracking allocator
+        profile->heap_memory_bytes = solver->mode == SSSP_SOLVER_LEAN
+                                         ? solver->frontier_capacity * sizeof(sssp_heap_element_t)
+                                         : sssp_heap_memory_stats(solver->heap).current_bytes;
+        profile->temporary_memory_bytes = (size_t)num_vertices *
+                                          (sizeof(distance_t) + sizeof(vertex_id_t) + sizeof(bool));
+        profile->peak_memory_bytes = sssp_tracking_allocator_stats(&tracker).peak_bytes;
+        profile->avg_memory_bytes = profile->peak_memory_bytes;
+    }
     
     sssp_solver_destroy(solver);
+    result->peak_memory_bytes = sssp_tracking_allocator_stats(&tracker).peak_bytes;
     
     SSSP_LOG_INFO("Single-source SSSP completed in %.2f ms", result->total_time_ms);
     return error;
 }
 
+/**
+ * Solve standard single-source shortest path problem
+ */
+sssp_error_t sssp_solve_single_source(const sssp_graph_t* graph,
+                                       vertex_id_t source,
+                                       const sssp_algorithm_config_t* config,
+                                       sssp_algorithm_result_t* result) {
+    return solve_single_source_impl(graph, source, config, result, NULL);
+}
+
+/**
+ * Run a single-source solve that stops once goal is met
+ *
+ * Shared by the targeted queries. With targets given, the result is filled
+ * in the caller's target order from the solver's arrays afterwards;
+ * otherwise the search records the settled tagged vertices itself.
+ */
+static sssp_error_t solve_until_goal(const sssp_graph_t* graph,
+                                     vertex_id_t source,
+                                     const sssp_algorithm_config_t* config,
+                                     settle_goal_t* goal,
+                                     const vertex_id_t* targets,
+                                     vertex_count_t num_targets,
+                                     sssp_target_result_t* result) {
+    vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
+    uint64_t start_ns = sssp_get_timestamp_ns();
+    result->count = 0;
+    
+    sssp_huge_page_allocator_t pages;
+    sssp_tracking_allocator_t tracker;
+    sssp_solver_t* solver;
+    sssp_error_t error = create_budgeted_solver(num_vertices, config, config->allocator,
+                                                &pages, &tracker, &solver);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+    
+    error = initialize_sources(solver, &source, 1);
+    if (error == SSSP_SUCCESS && goal->remaining > 0) {
+        error = run_dijkstra(solver, graph, SSSP_INFINITY, goal);
+    }
+    if (error == SSSP_ERROR_OUT_OF_MEMORY) {
+        error = allocation_error(&tracker);
+    }
+    
+    if ((error == SSSP_SUCCESS || sssp_error_is_interruption(error)) && targets) {
+        for (vertex_count_t i = 0; i < num_targets; i++) {
+            vertex_id_t target = targets[i];
+            result->vertices[i] = target;
+            result->distances[i] = solver->distances[target];
+            result->predecessors[i] = solver->predecessors[target];
+        }
+        result->count = num_targets;
+    }
+    
+    result->vertices_settled = solver->stats.total_vertices_processed;
+    result->relaxations_performed = solver->stats.total_edges_relaxed;
+    result->total_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    sssp_solver_destroy(solver);
+    result->peak_memory_bytes = sssp_tracking_allocator_stats(&tracker).peak_bytes;
+    return error;
+}
+
+/**
+ * Solve shortest paths from source until every target is settled
+ */
+sssp_error_t sssp_solve_to_targets(const sssp_graph_t* graph,
+                                   vertex_id_t source,
+                                   const vertex_id_t* targets,
+                                   vertex_count_t num_targets,
+                                   const sssp_algorithm_config_t* config,
+                                   sssp_target_result_t* result) {
+    if (!graph || !result || (!targets && num_targets > 0)) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    
+    vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
+    if (source >= num_vertices || num_targets > result->capacity) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (reject_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    
+    sssp_algorithm_config_t default_config;
+    if (!config) {
+        default_config = sssp_algorithm_config_default(num_vertices, NULL);
+        config = &default_config;
+    }
+    
+    // Tag the distinct targets
+    uint64_t* tags = sssp_alloc(config->allocator, SSSP_TAG_WORDS(num_vertices) * sizeof(uint64_t));
+    if (!tags) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(tags, 0, SSSP_TAG_WORDS(num_vertices) * sizeof(uint64_t));
+    
+    settle_goal_t goal = { tags, 0, NULL };
+    for (vertex_count_t i = 0; i < num_targets; i++) {
+        vertex_id_t target = targets[i];
+        if (target >= num_vertices) {
+            sssp_free(config->allocator, tags);
+            return SSSP_ERROR_INVALID_PARAMETER;
+        }
+        uint64_t bit = (uint64_t)1 << (target % 64);
+        if (!(tags[target / 64] & bit)) {
+            tags[target / 64] |= bit;
+            goal.remaining++;
+        }
+    }
+    
+    SSSP_LOG_INFO("Solving from vertex %u to %u targets", source, goal.remaining);
+    sssp_error_t error = solve_until_goal(graph, source, config, &goal, targets, num_targets, result);
+    sssp_free(config->allocator, tags);
+    
+    SSSP_LOG_INFO("Targeted solve settled %llu vertices in %.2f ms",
+                  (unsigned long long)result->vertices_settled, result->total_time_ms);
+    return error;
+}
+
+/**
+ * Find the k tagged vertices nearest to source
+ */
+sssp_error_t sssp_solve_k_nearest(const sssp_graph_t* graph,
+                                  vertex_id_t source,
+                                  const uint64_t* tags,
+                                  vertex_count_t k,
+                                  const sssp_algorithm_config_t* config,
+                                  sssp_target_result_t* result) {
+    if (!graph || !tags || !result) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    
+    vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
+    if (source >= num_vertices || k > result->capacity) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (reject_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    
+    sssp_algorithm_config_t default_config;
+    if (!config) {
+        default_config = sssp_algorithm_config_default(num_vertices, NULL);
+        config = &default_config;
+    }
+    
+    SSSP_LOG_INFO("Finding %u nearest tagged vertices from vertex %u", k, source);
+    settle_goal_t goal = { tags, k, result };
+    sssp_error_t error = solve_until_goal(graph, source, config, &goal, NULL, 0, result);
+    
+    SSSP_LOG_INFO("k-nearest solve found %u vertices, settled %llu in %.2f ms", result->count,
+                  (unsigned long long)result->vertices_settled, result->total_time_ms);
+    return error;
+}
+
+struct sssp_workspace {
+    const sssp_graph_t* graph;
+    sssp_solver_t* solver;
+    uint64_t* goal_tags;                // Targets of the running query
+    uint32_t check_interval;            // config->limit_check_interval (0 for the default)
+    sssp_huge_page_allocator_t pages;
+    sssp_tracking_allocator_t tracker;  // Everything but the struct itself
+    const sssp_allocator_t* allocator;  // Allocator of the struct
+};
+
+sssp_error_t sssp_workspace_create(const sssp_graph_t* graph,
+                                   const sssp_algorithm_config_t* config,
+                                   sssp_workspace_t** workspace_out) {
+    if (!graph || !workspace_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    *workspace_out = NULL;
+    if (reject_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    
+    vertex_count_t num_vertices = sssp_graph_get_vertex_count(graph);
+    sssp_algorithm_config_t default_config;
+    if (!config) {
+        default_config = sssp_algorithm_config_default(num_vertices, NULL);
+        config = &default_config;
+    }
+    sssp_error_t error = sssp_graph_build_csr((sssp_graph_t*)graph);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+    
+    sssp_workspace_t* workspace = sssp_alloc(config->allocator, sizeof(sssp_workspace_t));
+    if (!workspace) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(workspace, 0, sizeof(*workspace));
+    workspace->graph = graph;
+    workspace->allocator = config->allocator;
+    workspace->check_interval = config->limit_check_interval;
+    
+    // Limits are set per query
+    sssp_algorithm_config_t solver_config = *config;
+    solver_config.deadline_ns = 0;
+    solver_config.cancel_token = NULL;
+    error = create_budgeted_solver(num_vertices, &solver_config, config->allocator,
+                                   &workspace->pages, &workspace->tracker, &workspace->solver);
+    if (error != SSSP_SUCCESS) {
+        sssp_free(config->allocator, workspace);
+        return error;
+    }
+    
+    const sssp_allocator_t* tracked = &workspace->tracker.allocator;
+    sssp_solver_t* solver = workspace->solver;
+    solver->touched = sssp_alloc(tracked, num_vertices * sizeof(vertex_id_t));
+    solver->settled_order = sssp_alloc(tracked, num_vertices * sizeof(vertex_id_t));
+    workspace->goal_tags = sssp_alloc(tracked, SSSP_TAG_WORDS(num_vertices) * sizeof(uint64_t));
+    if (!solver->touched || !solver->settled_order || !workspace->goal_tags) {
+        error = allocation_error(&workspace->tracker);
+        sssp_workspace_destroy(workspace);
+        return error;
+    }
+    memset(workspace->goal_tags, 0, SSSP_TAG_WORDS(num_vertices) * sizeof(uint64_t));
+    
+    *workspace_out = workspace;
+    return SSSP_SUCCESS;
+}
+
+void sssp_workspace_destroy(sssp_workspace_t* workspace) {
+    if (!workspace) return;
+    
+    sssp_free(&workspace->tracker.allocator, workspace->goal_tags);
+    sssp_solver_destroy(workspace->solver);
+    sssp_free(workspace->allocator, workspace);
+}
+
+sssp_error_t sssp_workspace_solve(sssp_workspace_t* workspace, const sssp_workspace_query_t* query) {
+    if (!workspace || !query || (!query->sources && query->num_sources > 0) ||
+        (!query->targets && query->num_targets > 0)) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    
+    sssp_solver_t* solver = workspace->solver;
+    for (vertex_count_t i = 0; i < query->num_targets; i++) {
+        if (query->targets[i] >= solver->max_vertices) {
+            return SSSP_ERROR_INVALID_PARAMETER;
+        }
+    }
+    
+    memset(&solver->stats, 0, sizeof(solver->stats));
+    solver->deadline_ns = query->deadline_ns;
+    solver->cancel_token = query->cancel_token;
+    solver->check_interval = sssp_limit_check_interval(query->deadline_ns, query->cancel_token,
+                                                       workspace->check_interval);
+    solver->until_check = solver->check_interval;
+    
+    // Tag the distinct targets
+    settle_goal_t goal = { workspace->goal_tags, 0, NULL };
+    for (vertex_count_t i = 0; i < query->num_targets; i++) {
+        vertex_id_t target = query->targets[i];
+        uint64_t bit = (uint64_t)1 << (target % 64);
+        if (!(workspace->goal_tags[target / 64] & bit)) {
+            workspace->goal_tags[target / 64] |= bit;
+            goal.remaining++;
+        }
+    }
+    
+    sssp_error_t error = initialize_sources(solver, query->sources, query->num_sources);
+    if (error == SSSP_SUCCESS) {
+        error = run_dijkstra(solver, workspace->graph, query->bound,
+                             query->num_targets > 0 ? &goal : NULL);
+    }
+    if (error == SSSP_ERROR_OUT_OF_MEMORY) {
+        error = allocation_error(&workspace->tracker);
+    }
+    
+    for (vertex_count_t i = 0; i < query->num_targets; i++) {
+        workspace->goal_tags[query->targets[i] / 64] = 0;
+    }
+    return error;
+}
+
+const vertex_id_t* sssp_workspace_settled(const sssp_workspace_t* workspace, vertex_count_t* count_out) {
+    *count_out = workspace->solver->settled_count;
+    return workspace->solver->settled_order;
+}
+
+distance_t sssp_workspace_distance(const sssp_workspace_t* workspace, vertex_id_t vertex) {
+    return workspace->solver->distances[vertex];
+}
+
+vertex_id_t sssp_workspace_predecessor(const sssp_workspace_t* workspace, vertex_id_t vertex) {
+    return workspace->solver->predecessors[vertex];
+}
+
+bool sssp_workspace_is_settled(const sssp_workspace_t* workspace, vertex_id_t vertex) {
+    return sssp_solver_is_visited(workspace->solver, vertex);
+}
+
+/**
+ * Copy the phase times and counters of a stopped profiler into profile
+ */
+static void record_profile(const sssp_profiler_t* profiler, uint64_t start_ns,
+                           sssp_performance_profile_t* profile) {
+    // Phase breakdown
+    profile->total_time_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    profile->initialization_time_ms = profiler->phase_time_ms[SSSP_PHASE_INITIALIZATION];
+    profile->find_pivots_time_ms = profiler->phase_time_ms[SSSP_PHASE_FIND_PIVOTS];
+    profile->heap_operations_time_ms = profiler->phase_time_ms[SSSP_PHASE_HEAP_OPERATIONS];
+    profile->relaxation_time_ms = profiler->phase_time_ms[SSSP_PHASE_RELAXATION];
+    profile->finalization_time_ms = profiler->phase_time_ms[SSSP_PHASE_FINALIZATION];
+    
+    // Hardware counters
+    profile->hw_counters_available = sssp_profiler_has_hw_counters(profiler);
+    memcpy(profile->phase_counters, profiler->phase_counters, sizeof(profile->phase_counters));
+    sssp_profiler_total_counters(profiler, &profile->total_counters);
+    
+    uint32_t llc_mask = (1u << SSSP_HW_LLC_REFERENCES) | (1u << SSSP_HW_LLC_MISSES);
+    uint64_t llc_references = profile->total_counters.values[SSSP_HW_LLC_REFERENCES];
+    if ((profile->total_counters.available_mask & llc_mask) == llc_mask && llc_references > 0) {
+        uint64_t llc_misses = profile->total_counters.values[SSSP_HW_LLC_MISSES];
+        if (llc_misses > llc_references) llc_misses = llc_references;
+        profile->cache_hit_ratio = 1.0 - (double)llc_misses / (double)llc_references;
+    }
+}
+
+/**
+ * Solve single-source shortest paths while recording a phase profile
+ */
+sssp_error_t sssp_solve_with_profiling(const sssp_graph_t* graph,
+                                        vertex_id_t source,
+                                        const sssp_algorithm_config_t* config,
+                                        sssp_algorithm_result_t* result,
+                                        sssp_performance_profile_t* profile) {
+    if (!graph || !result || !profile) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    
+    memset(profile, 0, sizeof(*profile));
+    
+    sssp_profiler_t profiler;
+    sssp_profiler_init(&profiler, true);
+    sssp_profiler_t* previous_profiler = sssp_profiler_set_current(&profiler);
+    
+    uint64_t start_ns = sssp_get_timestamp_ns();
+    sssp_profiler_start(&profiler, SSSP_PHASE_INITIALIZATION);
+    sssp_error_t error = solve_single_source_impl(graph, source, config, result, profile);
+    sssp_profiler_stop(&profiler);
+    record_profile(&profiler, start_ns, profile);
+    
+    sssp_profiler_set_current(previous_profiler);
+    sssp_profiler_destroy(&profiler);
+    
+    SSSP_LOG_INFO("Profiled single-source SSSP completed in %.2f ms", profile->total_time_ms);
+    return error;
+}
+
+/**
+ * Run Algorithm 3 from the top level while recording a phase profile
+ */
+sssp_error_t sssp_bounded_multi_source_with_profiling(const sssp_graph_t* graph,
+                                                       weight_t threshold,
+                                                       const sssp_vertex_set_t* source_set,
+                                                       vertex_count_t k,
+                                                       vertex_count_t t,
+                                                       const sssp_algorithm_config_t* config,
+                                                       sssp_vertex_set_t* output_set,
+                                                       weight_t* B_prime_out,
+                                                       sssp_performance_profile_t* profile) {
+    if (!profile) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    
+    memset(profile, 0, sizeof(*profile));
+    
+    sssp_profiler_t profiler;
+    sssp_profiler_init(&profiler, true);
+    sssp_profiler_t* previous_profiler = sssp_profiler_set_current(&profiler);
+    
+    uint64_t start_ns = sssp_get_timestamp_ns();
+    sssp_profiler_start(&profiler, SSSP_PHASE_INITIALIZATION);
+    sssp_error_t error = sssp_bounded_multi_source(graph, 0, threshold, source_set, k, t, config,
+                                                   output_set, B_prime_out);
+    sssp_profiler_stop(&profiler);
+    record_profile(&profiler, start_ns, profile);
+    
+    sssp_profiler_set_current(previous_profiler);
+    sssp_profiler_destroy(&profiler);
+    
+    SSSP_LOG_INFO("Profiled bounded multi-source SSSP completed in %.2f ms", profile->total_time_ms);
+    return error;
+}
+
+/**
+ * Print a performance profile
+ */
+void sssp_performance_profile_print(const sssp_performance_profile_t* profile) {
+    if (!profile) return;
+    
+    printf("Performance Profile:\n");
+    printf("  Total time:          %.3f ms\n", profile->total_time_ms);
+    printf("    Initialization:    %.3f ms\n", profile->initialization_time_ms);
+    printf("    FINDPIVOTS:        %.3f ms\n", profile->find_pivots_time_ms);
+    printf("    Heap operations:   %.3f ms\n", profile->heap_operations_time_ms);
+    printf("    Relaxation:        %.3f ms\n", profile->relaxation_time_ms);
+    printf("    Finalization:      %.3f ms\n", profile->finalization_time_ms);
+    printf("  Relaxations:         %llu (%llu useful)\n",
+           (unsigned long long)profile->total_relaxations,
+           (unsigned long long)profile->useful_relaxations);
+    printf("  Heap inserts/pulls:  %llu / %llu (max size %u)\n",
+           (unsigned long long)profile->heap_inserts,
+           (unsigned long long)profile->heap_pulls,
+           profile->max_heap_size);
+    printf("  Peak memory:         %zu bytes\n", profile->peak_memory_bytes);
+    
+    if (!profile->hw_counters_available) {
+        printf("  Hardware counters:   unavailable\n");
+        return;
+    }
+    
+    printf("  LLC hit ratio:       %.2f%%\n", profile->cache_hit_ratio * 100.0);
+    printf("  %-16s", "phase");
+    for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+        printf(" %14s", sssp_hw_counter_name((sssp_hw_counter_t)i));
+    }
+    printf("\n");
+    
+    for (int p = 0; p < SSSP_PHASE_COUNT; p++) {
+        printf("  %-16s", sssp_profile_phase_name((sssp_profile_phase_t)p));
+        for (int i = 0; i < SSSP_HW_COUNTER_COUNT; i++) {
+            if (profile->phase_counters[p].available_mask & (1u << i)) {
+                printf(" %14llu", (unsigned long long)profile->phase_counters[p].values[i]);
+            } else {
+                printf(" %14s", "n/a");
+            }
+        }
+        printf("\n");
+    }
+}
+
 /**
  * Configuration management functions
  */
@@ -513,6 +1482,7 @@ sssp_algorithm_config_t sssp_algorithm_config_default(vertex_count_t num_vertice
     
     config.allocator = allocator ? allocator : &SSSP_DEFAULT_ALLOCATOR;
     config.memory_limit_bytes = 0; // No limit
+    config.huge_page_threshold = 0; // Off; SSSP_HUGE_PAGE_THRESHOLD enables huge pages
     
     config.enable_profiling = false;
     config.enable_validation = false;
@@ -536,10 +1506,11 @@ sssp_algorithm_result_t* sssp_algorithm_result_create(vertex_count_t num_vertice
     }
     
     memset(result, 0, sizeof(sssp_algorithm_result_t));
+    result->approximation_bound = 1.0;
     
     result->distances = sssp_alloc(allocator, num_vertices * sizeof(weight_t));
     result->predecessors = sssp_alloc(allocator, num_vertices * sizeof(vertex_id_t));
-    result->processed_vertices = sssp_vertex_set_create(num_vertices, allocator);
+    result->processed_vertices = sssp_vertex_set_create_indexed(num_vertices, allocator);
     
     if (!result->distances || !result->predecessors || !result->processed_vertices) {
         if (result->distances) sssp_free(allocator, result->distances);
@@ -569,18 +1540,59 @@ void sssp_algorithm_result_destroy(sssp_algorithm_result_t* result) {
     sssp_free(allocator, result);
 }
 
+sssp_target_result_t* sssp_target_result_create(vertex_count_t capacity,
+                                                 const sssp_allocator_t* allocator) {
+    if (allocator == NULL) {
+        allocator = &SSSP_DEFAULT_ALLOCATOR;
+    }
+    
+    sssp_target_result_t* result = sssp_alloc(allocator, sizeof(sssp_target_result_t));
+    if (!result) {
+        return NULL;
+    }
+    
+    memset(result, 0, sizeof(sssp_target_result_t));
+    result->capacity = capacity;
+    result->allocator = allocator;
+    
+    // One spare entry keeps capacity 0 from asking for zero bytes
+    result->vertices = sssp_alloc(allocator, ((size_t)capacity + 1) * sizeof(vertex_id_t));
+    result->distances = sssp_alloc(allocator, ((size_t)capacity + 1) * sizeof(distance_t));
+    result->predecessors = sssp_alloc(allocator, ((size_t)capacity + 1) * sizeof(vertex_id_t));
+    if (!result->vertices || !result->distances || !result->predecessors) {
+        sssp_target_result_destroy(result);
+        return NULL;
+    }
+    
+    return result;
+}
+
+void sssp_target_result_destroy(sssp_target_result_t* result) {
+    if (!result) return;
+    
+    const sssp_allocator_t* allocator = result->allocator;
+    if (result->vertices) sssp_free(allocator, result->vertices);
+    if (result->distances) sssp_free(allocator, result->distances);
+    if (result->predecessors) sssp_free(allocator, result->predecessors);
+    sssp_free(allocator, result);
+}
+
 /**
- * Main Algorithm 3 implementation
+ * One level of Algorithm 3; temporaries come from scratch_allocator(config)
+ *
+ * With budget given, every temporary of the recursion is charged to it,
+ * through the scratch arena drawing its blocks from it.
  */
-sssp_error_t sssp_bounded_multi_source(const sssp_graph_t* graph,
-                                        vertex_count_t recursion_level,
-                                        weight_t threshold,
-                                        const sssp_vertex_set_t* source_set,
-                                        vertex_count_t k,
-                                        vertex_count_t t,
-                                        const sssp_algorithm_config_t* config,
-                                        sssp_vertex_set_t* output_set,
-                                        weight_t* B_prime_out) {
+static sssp_error_t bounded_multi_source_level(const sssp_graph_t* graph,
+                                               vertex_count_t recursion_level,
+                                               weight_t threshold,
+                                               const sssp_vertex_set_t* source_set,
+                                               vertex_count_t k,
+                                               vertex_count_t t,
+                                               const sssp_algorithm_config_t* config,
+                                               sssp_tracking_allocator_t* budget,
+                                               sssp_vertex_set_t* output_set,
+                                               weight_t* B_prime_out) {
     if (!graph || !source_set || !output_set || !B_prime_out) {
         return SSSP_ERROR_INVALID_PARAMETER;
     }
@@ -590,20 +1602,28 @@ sssp_error_t sssp_bounded_multi_source(const sssp_graph_t* graph,
     SSSP_LOG_DEBUG("Algorithm 3: recursion_level=%u, threshold=%.2f, sources=%u, k=%u, t=%u",
                    recursion_level, threshold, source_count, k, t);
     
+    sssp_error_t expired = sssp_check_query_limits(config->deadline_ns, config->cancel_token);
+    if (expired != SSSP_SUCCESS) {
+        sssp_vertex_set_clear(output_set);
+        *B_prime_out = 0.0;
+        return expired;
+    }
+    
     // Check recursion depth limit
     if (recursion_level >= config->max_recursion_depth) {
         SSSP_LOG_DEBUG("Reached maximum recursion depth, using base case");
-        return sssp_base_case(graph, threshold, source_set, k, config, output_set, B_prime_out);
+        return base_case_impl(graph, threshold, source_set, k, config, budget, output_set, B_prime_out);
     }
     
     // Base case: small source set
     if (source_count <= t) {
-        return sssp_base_case(graph, threshold, source_set, k, config, output_set, B_prime_out);
+        return base_case_impl(graph, threshold, source_set, k, config, budget, output_set, B_prime_out);
     }
     
     // Main recursive case - use FINDPIVOTS
-    sssp_find_pivots_config_t pivot_config = sssp_find_pivots_config_default(config->allocator);
-    sssp_find_pivots_result_t* pivot_result = sssp_find_pivots_result_create(config->allocator);
+    const sssp_allocator_t* scratch = scratch_allocator(config);
+    sssp_find_pivots_config_t pivot_config = sssp_find_pivots_config_default(scratch);
+    sssp_find_pivots_result_t* pivot_result = sssp_find_pivots_result_create(scratch);
     
     if (!pivot_result) {
         return SSSP_ERROR_OUT_OF_MEMORY;
@@ -626,10 +1646,13 @@ sssp_error_t sssp_bounded_multi_source(const sssp_graph_t* graph,
     
     if (num_pivots > 0) {
         weight_t pivot_B_prime;
-        result = sssp_bounded_multi_source(graph, recursion_level + 1, threshold,
-                                           pivot_result->pivots, k, t, config,
-                                           output_set, &pivot_B_prime);
+        result = enter_bounded_multi_source(graph, recursion_level + 1, threshold,
+                                            pivot_result->pivots, k, t, config, budget,
+                                            output_set, &pivot_B_prime);
         if (result != SSSP_SUCCESS) {
+            if (sssp_error_is_interruption(result)) {
+                *B_prime_out = pivot_B_prime;   // output_set holds what was completed
+            }
             sssp_find_pivots_result_destroy(pivot_result);
             return result;
         }
@@ -637,15 +1660,40 @@ sssp_error_t sssp_bounded_multi_source(const sssp_graph_t* graph,
     }
     
     if (num_witnesses > 0) {
+        // The pivot subproblem already filled output_set; merge the witness
+        // vertices in (both come out of the base case in ascending order).
+        // The set is scratch, taken before the callee's mark; sized for every
+        // vertex up front, it never grows into memory the callee's rewind
+        // would reclaim. The merge runs in it too, so output_set is only
+        // copied into and keeps its buffer across queries.
         weight_t witness_B_prime;
-        result = sssp_bounded_multi_source(graph, recursion_level + 1, threshold,
-                                           pivot_result->witnesses, k, t, config,
-                                           output_set, &witness_B_prime);
+        sssp_vertex_set_t* witness_output =
+            sssp_vertex_set_create(SSSP_MAX(sssp_graph_num_vertices(graph), 1), scratch);
+        if (!witness_output) {
+            sssp_find_pivots_result_destroy(pivot_result);
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        result = enter_bounded_multi_source(graph, recursion_level + 1, threshold,
+                                            pivot_result->witnesses, k, t, config, budget,
+                                            witness_output, &witness_B_prime);
+        if (result == SSSP_SUCCESS || sssp_error_is_interruption(result)) {
+            // Vertices completed before an interruption are kept
+            sssp_error_t merged = num_pivots > 0 ? sssp_vertex_set_union(witness_output, output_set)
+                                                 : SSSP_SUCCESS;
+            if (merged == SSSP_SUCCESS) {
+                merged = sssp_vertex_set_copy(output_set, witness_output);
+            }
+            max_B_prime = fmax(max_B_prime, witness_B_prime);
+            if (merged != SSSP_SUCCESS) {
+                result = merged;
+            }
+        }
+        sssp_vertex_set_destroy(witness_output);
         if (result != SSSP_SUCCESS) {
+            *B_prime_out = max_B_prime;
             sssp_find_pivots_result_destroy(pivot_result);
             return result;
         }
-        max_B_prime = fmax(max_B_prime, witness_B_prime);
     }
     
     *B_prime_out = max_B_prime;
@@ -655,15 +1703,20 @@ sssp_error_t sssp_bounded_multi_source(const sssp_graph_t* graph,
 }
 
 /**
- * Algorithm 2 implementation (base case)
+ * Algorithm 2 (base case); temporaries come from scratch_allocator(config)
+ *
+ * Within a budgeted recursion the solver gets what is left of the budget:
+ * its limit, less what the recursion holds, not counting arena blocks that
+ * a rewind has freed for reuse.
  */
-sssp_error_t sssp_base_case(const sssp_graph_t* graph,
-                             weight_t threshold,
-                             const sssp_vertex_set_t* source_set,
-                             vertex_count_t k,
-                             const sssp_algorithm_config_t* config,
-                             sssp_vertex_set_t* output_set,
-                             weight_t* B_prime_out) {
+static sssp_error_t base_case_impl(const sssp_graph_t* graph,
+                                   weight_t threshold,
+                                   const sssp_vertex_set_t* source_set,
+                                   vertex_count_t k,
+                                   const sssp_algorithm_config_t* config,
+                                   sssp_tracking_allocator_t* budget,
+                                   sssp_vertex_set_t* output_set,
+                                   weight_t* B_prime_out) {
     if (!graph || !source_set || !output_set || !B_prime_out) {
         return SSSP_ERROR_INVALID_PARAMETER;
     }
@@ -676,17 +1729,39 @@ sssp_error_t sssp_base_case(const sssp_graph_t* graph,
     // Suppress unused parameter warning for k (used in paper but not in implementation)
     (void)k;
     
+    sssp_algorithm_config_t budgeted_config;
+    if (budget) {
+        size_t held = sssp_tracking_allocator_stats(budget).current_bytes;
+        size_t spare = sssp_arena_spare_bytes(config->scratch_arena);
+        held = held > spare ? held - spare : 0;
+        if (held >= budget->limit_bytes) {
+            SSSP_LOG_ERROR("Memory budget of %zu bytes used up before the base case", budget->limit_bytes);
+            return SSSP_ERROR_MEMORY_LIMIT;
+        }
+        budgeted_config = *config;
+        budgeted_config.memory_limit_bytes = budget->limit_bytes - held;
+        config = &budgeted_config;
+    }
+    
     // Create internal solver
-    sssp_solver_t* solver = sssp_solver_create(num_vertices, config->allocator);
-    if (!solver) {
-        return SSSP_ERROR_OUT_OF_MEMORY;
+    sssp_huge_page_allocator_t pages;
+    sssp_tracking_allocator_t tracker;
+    sssp_solver_t* solver;
+    sssp_error_t result = create_budgeted_solver(num_vertices, config, scratch_allocator(config),
+                                                 &pages, &tracker, &solver);
+    if (result == SSSP_ERROR_OUT_OF_MEMORY && budget && budget->limit_failures > 0) {
+        result = SSSP_ERROR_MEMORY_LIMIT;
+    }
+    if (result != SSSP_SUCCESS) {
+        return result;
     }
+    solver->profiler = sssp_profiler_current();
     
     // Convert vertex set to array
-    vertex_id_t* source_array = sssp_alloc(config->allocator, source_count * sizeof(vertex_id_t));
+    vertex_id_t* source_array = sssp_alloc(&tracker.allocator, source_count * sizeof(vertex_id_t));
     if (!source_array) {
         sssp_solver_destroy(solver);
-        return SSSP_ERROR_OUT_OF_MEMORY;
+        return allocation_error(budget && budget->limit_failures > 0 ? budget : &tracker);
     }
     
     for (vertex_count_t i = 0; i < source_count; i++) {
@@ -694,19 +1769,26 @@ sssp_error_t sssp_base_case(const sssp_graph_t* graph,
     }
     
     // Run bounded multi-source algorithm
-    sssp_error_t result = initialize_sources(solver, source_array, source_count);
+    result = initialize_sources(solver, source_array, source_count);
     if (result == SSSP_SUCCESS) {
         result = run_standard_dijkstra(solver, graph, threshold);
     }
+    if (result == SSSP_ERROR_OUT_OF_MEMORY) {
+        result = allocation_error(budget && budget->limit_failures > 0 ? budget : &tracker);
+    }
     
-    if (result == SSSP_SUCCESS) {
-        // Collect vertices within threshold
+    SSSP_PROFILE_SWITCH(solver->profiler, SSSP_PHASE_FINALIZATION);
+    
+    bool interrupted = sssp_error_is_interruption(result);
+    if (result == SSSP_SUCCESS || interrupted) {
+        // Collect vertices within threshold; after an interruption, only the
+        // settled ones have exact distances
         sssp_vertex_set_clear(output_set);
         weight_t max_distance = 0.0;
         
         for (vertex_count_t v = 0; v < num_vertices; v++) {
-            if (solver->distances[v] <= threshold) {
-                sssp_vertex_set_add(output_set, v);
+            if (solver->distances[v] <= threshold && (!interrupted || visited_test(solver, v))) {
+                sssp_vertex_set_add_array(output_set, &v, 1);  // Distinct by construction
                 if (solver->distances[v] > max_distance && solver->distances[v] < SSSP_INFINITY) {
                     max_distance = solver->distances[v];
                 }
@@ -718,11 +1800,123 @@ sssp_error_t sssp_base_case(const sssp_graph_t* graph,
                        sssp_vertex_set_size(output_set), max_distance);
     }
     
-    sssp_free(config->allocator, source_array);
+    sssp_free(&tracker.allocator, source_array);
     sssp_solver_destroy(solver);
     return result;
 }
 
+/**
+ * Run one recursion level, rewinding the scratch arena (if any) on return
+ */
+static sssp_error_t enter_bounded_multi_source(const sssp_graph_t* graph,
+                                               vertex_count_t recursion_level,
+                                               weight_t threshold,
+                                               const sssp_vertex_set_t* source_set,
+                                               vertex_count_t k,
+                                               vertex_count_t t,
+                                               const sssp_algorithm_config_t* config,
+                                               sssp_tracking_allocator_t* budget,
+                                               sssp_vertex_set_t* output_set,
+                                               weight_t* B_prime_out) {
+    if (!config->scratch_arena) {
+        return bounded_multi_source_level(graph, recursion_level, threshold, source_set, k, t,
+                                          config, budget, output_set, B_prime_out);
+    }
+    
+    sssp_arena_mark_t mark = sssp_arena_mark(config->scratch_arena);
+    sssp_error_t result = bounded_multi_source_level(graph, recursion_level, threshold, source_set,
+                                                     k, t, config, budget, output_set, B_prime_out);
+    sssp_arena_rewind(config->scratch_arena, mark);
+    return result;
+}
+
+/**
+ * Main Algorithm 3 entry point
+ *
+ * Each level rewinds the scratch arena on return, releasing its FINDPIVOTS
+ * state and base-case solvers in O(1). A top-level call without an arena
+ * gets one for the duration of the solve.
+ *
+ * A top-level call with memory_limit_bytes set holds the whole recursion to
+ * it: one tracker, on top of the caller's scratch allocator, takes every
+ * temporary through an arena of its own, and each base case may use only
+ * what the rest of the recursion leaves.
+ */
+sssp_error_t sssp_bounded_multi_source(const sssp_graph_t* graph,
+                                        vertex_count_t recursion_level,
+                                        weight_t threshold,
+                                        const sssp_vertex_set_t* source_set,
+                                        vertex_count_t k,
+                                        vertex_count_t t,
+                                        const sssp_algorithm_config_t* config,
+                                        sssp_vertex_set_t* output_set,
+                                        weight_t* B_prime_out) {
+    if (!config) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (reject_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    
+    if (recursion_level != 0 || (config->scratch_arena && config->memory_limit_bytes == 0)) {
+        return enter_bounded_multi_source(graph, recursion_level, threshold, source_set, k, t,
+                                          config, NULL, output_set, B_prime_out);
+    }
+    
+    sssp_tracking_allocator_t budget;
+    sssp_tracking_allocator_t* tracked = NULL;
+    const sssp_allocator_t* parent = config->allocator;
+    size_t block_size = 0;
+    if (config->memory_limit_bytes != 0) {
+        sssp_tracking_allocator_init(&budget, scratch_allocator(config), config->memory_limit_bytes);
+        tracked = &budget;
+        parent = &budget.allocator;
+        // Small budgets get small blocks, so the arena does not waste them
+        block_size = SSSP_MAX(config->memory_limit_bytes / 16, (size_t)4096);
+    }
+    
+    sssp_arena_t arena;
+    sssp_arena_init(&arena, parent, block_size);
+    sssp_algorithm_config_t solve_config = *config;
+    solve_config.scratch_arena = &arena;
+    sssp_error_t result = bounded_multi_source_level(graph, recursion_level, threshold, source_set,
+                                                     k, t, &solve_config, tracked, output_set,
+                                                     B_prime_out);
+    sssp_arena_destroy(&arena);
+    
+    if (result == SSSP_ERROR_OUT_OF_MEMORY && tracked && tracked->limit_failures > 0) {
+        result = SSSP_ERROR_MEMORY_LIMIT;
+    }
+    return result;
+}
+
+/**
+ * Algorithm 2 entry point
+ */
+sssp_error_t sssp_base_case(const sssp_graph_t* graph,
+                             weight_t threshold,
+                             const sssp_vertex_set_t* source_set,
+                             vertex_count_t k,
+                             const sssp_algorithm_config_t* config,
+                             sssp_vertex_set_t* output_set,
+                             weight_t* B_prime_out) {
+    if (!config) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (reject_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    if (!config->scratch_arena) {
+        return base_case_impl(graph, threshold, source_set, k, config, NULL, output_set, B_prime_out);
+    }
+    
+    sssp_arena_mark_t mark = sssp_arena_mark(config->scratch_arena);
+    sssp_error_t result = base_case_impl(graph, threshold, source_set, k, config, NULL,
+                                         output_set, B_prime_out);
+    sssp_arena_rewind(config->scratch_arena, mark);
+    return result;
+}
+
 /**
  * Parameter computation utilities
  */
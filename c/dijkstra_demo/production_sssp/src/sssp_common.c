@@ -7,19 +7,23 @@
  * @version 1.0
  */
 
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE     // MAP_ANONYMOUS, MAP_HUGETLB, MADV_HUGEPAGE
 
 #include "../include/sssp_common.h"
+#include "sssp_internal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdarg.h>
 #include <errno.h>
+#include <stdatomic.h>
 
 #if defined(__linux__) || defined(__APPLE__)
     #include <unistd.h>
     #include <sys/time.h>
+    #include <sys/mman.h>
 #elif defined(_WIN32)
     #include <windows.h>
 #endif
@@ -28,6 +32,7 @@
 #include <windows.h>
 #else
 #include <sys/time.h>
+#include <pthread.h>
 #endif
 
 // Global state
@@ -35,6 +40,7 @@ static sssp_error_handler_t g_error_handler = NULL;
 static void* g_error_context = NULL;
 static sssp_log_func_t g_log_func = NULL;
 static sssp_log_level_t g_log_level = SSSP_LOG_WARN;
+static unsigned int g_num_threads = 0;
 
 // Default allocator implementation
 static void* default_alloc(size_t size, void* context) {
@@ -91,8 +97,20 @@ const char* sssp_error_string(sssp_error_t error) {
             return "Numeric overflow";
         case SSSP_ERROR_GRAPH_INVALID:
             return "Invalid graph";
+        case SSSP_ERROR_IO:
+            return "I/O error";
         case SSSP_ERROR_NOT_IMPLEMENTED:
             return "Not implemented";
+        case SSSP_ERROR_ALGORITHM:
+            return "Algorithm error";
+        case SSSP_ERROR_MEMORY_LIMIT:
+            return "Memory limit exceeded";
+        case SSSP_ERROR_NEGATIVE_CYCLE:
+            return "Negative cycle";
+        case SSSP_ERROR_TIMEOUT:
+            return "Deadline expired";
+        case SSSP_ERROR_CANCELLED:
+            return "Cancelled";
         case SSSP_ERROR_INTERNAL:
             return "Internal error";
         default:
@@ -109,21 +127,26 @@ void sssp_set_log_level(sssp_log_level_t level) {
     g_log_level = level;
 }
 
+sssp_log_func_t sssp_log_get_function(void) {
+    return g_log_func;
+}
+
+const char* sssp_log_level_name(sssp_log_level_t level) {
+    switch (level) {
+        case SSSP_LOG_ERROR: return "ERROR";
+        case SSSP_LOG_WARN:  return "WARN";
+        case SSSP_LOG_INFO:  return "INFO";
+        case SSSP_LOG_DEBUG: return "DEBUG";
+        case SSSP_LOG_TRACE: return "TRACE";
+        default:             return "LOG";
+    }
+}
+
 static void default_log_func(sssp_log_level_t level, const char* file, int line,
                            const char* func, const char* format, ...) {
     if (level > g_log_level) return;
     
-    const char* level_str;
-    switch (level) {
-        case SSSP_LOG_ERROR: level_str = "ERROR"; break;
-        case SSSP_LOG_WARN:  level_str = "WARN";  break;
-        case SSSP_LOG_INFO:  level_str = "INFO";  break;
-        case SSSP_LOG_DEBUG: level_str = "DEBUG"; break;
-        case SSSP_LOG_TRACE: level_str = "TRACE"; break;
-        default:             level_str = "LOG";   break;
-    }
-    
-    fprintf(stderr, "[%s] %s:%d in %s(): ", level_str, file, line, func);
+    fprintf(stderr, "[%s] %s:%d in %s(): ", sssp_log_level_name(level), file, line, func);
     
     va_list args;
     va_start(args, format);
@@ -138,10 +161,14 @@ void sssp_log(sssp_log_level_t level, const char* file, int line,
               const char* func, const char* format, ...) {
     if (level > g_log_level) return;
     
-    sssp_log_func_t log_func = g_log_func ? g_log_func : default_log_func;
-    
     va_list args;
     va_start(args, format);
+    if (sssp_log_async_push(level, file, line, func, format, args)) {
+        va_end(args);
+        return;
+    }
+    
+    sssp_log_func_t log_func = g_log_func ? g_log_func : default_log_func;
     
     // Unfortunately, we need to format the string first since we can't pass va_list
     char buffer[1024];
@@ -186,6 +213,180 @@ uint64_t sssp_get_timestamp_ns(void) {
 #endif
 }
 
+// Query limits
+void sssp_cancel_token_init(sssp_cancel_token_t* token) {
+    if (!token) return;
+    token->cancelled = 0;
+}
+
+void sssp_cancel_token_cancel(sssp_cancel_token_t* token) {
+    if (!token) return;
+    __atomic_store_n(&token->cancelled, 1, __ATOMIC_RELEASE);
+}
+
+void sssp_cancel_token_reset(sssp_cancel_token_t* token) {
+    if (!token) return;
+    __atomic_store_n(&token->cancelled, 0, __ATOMIC_RELEASE);
+}
+
+bool sssp_cancel_token_is_cancelled(const sssp_cancel_token_t* token) {
+    return token && __atomic_load_n(&token->cancelled, __ATOMIC_ACQUIRE) != 0;
+}
+
+uint64_t sssp_deadline_after_ms(double ms) {
+    if (ms < 0.0) ms = 0.0;
+    return sssp_get_timestamp_ns() + (uint64_t)(ms * 1000000.0);
+}
+
+sssp_error_t sssp_check_query_limits(uint64_t deadline_ns, const sssp_cancel_token_t* token) {
+    if (sssp_cancel_token_is_cancelled(token)) {
+        return SSSP_ERROR_CANCELLED;
+    }
+    if (deadline_ns != 0 && sssp_get_timestamp_ns() >= deadline_ns) {
+        return SSSP_ERROR_TIMEOUT;
+    }
+    return SSSP_SUCCESS;
+}
+
+// Random numbers
+uint64_t sssp_hash64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void sssp_rng_seed(sssp_rng_t* rng, uint64_t seed, uint64_t stream) {
+    if (!rng) return;
+    uint64_t x = sssp_hash64(seed) ^ sssp_hash64(stream ^ 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++) {
+        x = sssp_hash64(x);
+        rng->state[i] = x;
+    }
+    // xoshiro must not start from the all-zero state
+    if ((rng->state[0] | rng->state[1] | rng->state[2] | rng->state[3]) == 0) {
+        rng->state[0] = 1;
+    }
+}
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+uint64_t sssp_rng_next(sssp_rng_t* rng) {
+    uint64_t* s = rng->state;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+double sssp_rng_uniform(sssp_rng_t* rng) {
+    return (double)(sssp_rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+uint64_t sssp_rng_bounded(sssp_rng_t* rng, uint64_t bound) {
+    if (bound == 0) return 0;
+    // Rejection keeps the result unbiased for bounds that are not powers of two
+    uint64_t threshold = (0 - bound) % bound;
+    for (;;) {
+        uint64_t r = sssp_rng_next(rng);
+        if (r >= threshold) {
+            return r % bound;
+        }
+    }
+}
+
+// Parallel loops
+void sssp_set_num_threads(unsigned int num_threads) {
+    g_num_threads = num_threads;
+}
+
+unsigned int sssp_get_num_threads(void) {
+    if (g_num_threads > 0) {
+        return g_num_threads;
+    }
+#if defined(_SC_NPROCESSORS_ONLN)
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0) {
+        return (unsigned int)cpus;
+    }
+#endif
+    return 1;
+}
+
+typedef struct parallel_for_state {
+    size_t count;
+    size_t grain;
+    sssp_parallel_fn_t fn;
+    void* context;
+    atomic_size_t next;
+} parallel_for_state_t;
+
+static void* parallel_for_worker(void* arg) {
+    parallel_for_state_t* state = arg;
+    for (;;) {
+        size_t begin = atomic_fetch_add_explicit(&state->next, state->grain, memory_order_relaxed);
+        if (begin >= state->count) {
+            break;
+        }
+        size_t end = state->count - begin < state->grain ? state->count : begin + state->grain;
+        state->fn(begin, end, state->context);
+    }
+    return NULL;
+}
+
+sssp_error_t sssp_parallel_for(size_t count, size_t grain, sssp_parallel_fn_t fn, void* context) {
+    if (!fn) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (count == 0) {
+        return SSSP_SUCCESS;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    size_t chunks = (count + grain - 1) / grain;
+    unsigned int num_threads = sssp_get_num_threads();
+    if (num_threads > chunks) {
+        num_threads = (unsigned int)chunks;
+    }
+
+    parallel_for_state_t state = {
+        .count = count, .grain = grain, .fn = fn, .context = context
+    };
+    atomic_init(&state.next, 0);
+
+#ifndef _WIN32
+    if (num_threads > 1) {
+        pthread_t* threads = malloc((num_threads - 1) * sizeof(pthread_t));
+        unsigned int started = 0;
+        if (threads) {
+            // A thread that fails to start just leaves its share to the others
+            while (started < num_threads - 1 &&
+                   pthread_create(&threads[started], NULL, parallel_for_worker, &state) == 0) {
+                started++;
+            }
+        }
+        parallel_for_worker(&state);
+        for (unsigned int i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        free(threads);
+        return SSSP_SUCCESS;
+    }
+#endif
+
+    parallel_for_worker(&state);
+    return SSSP_SUCCESS;
+}
+
 // Memory statistics
 void sssp_memory_stats_reset(sssp_memory_stats_t* stats) {
     if (!stats) return;
@@ -209,6 +410,500 @@ void sssp_memory_stats_add_deallocation(sssp_memory_stats_t* stats, size_t bytes
     stats->total_deallocations++;
 }
 
+// Tracking allocator
+//
+// Each block is preceded by a header recording its size, so that frees and
+// reallocations can be accounted without asking the parent allocator.
+typedef union tracking_header {
+    size_t size;
+    max_align_t align;
+} tracking_header_t;
+
+static bool tracking_reserve(sssp_tracking_allocator_t* tracker, size_t bytes) {
+    size_t current = __atomic_add_fetch(&tracker->stats.current_bytes, bytes, __ATOMIC_RELAXED);
+    if (tracker->limit_bytes != 0 && current > tracker->limit_bytes) {
+        __atomic_sub_fetch(&tracker->stats.current_bytes, bytes, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&tracker->limit_failures, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    
+    size_t peak = __atomic_load_n(&tracker->stats.peak_bytes, __ATOMIC_RELAXED);
+    while (current > peak &&
+           !__atomic_compare_exchange_n(&tracker->stats.peak_bytes, &peak, current, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    return true;
+}
+
+static void tracking_release(sssp_tracking_allocator_t* tracker, size_t bytes) {
+    __atomic_sub_fetch(&tracker->stats.current_bytes, bytes, __ATOMIC_RELAXED);
+}
+
+static void* tracking_alloc(size_t size, void* context) {
+    sssp_tracking_allocator_t* tracker = context;
+    if (size > SIZE_MAX - sizeof(tracking_header_t) || !tracking_reserve(tracker, size)) {
+        return NULL;
+    }
+    
+    tracking_header_t* header = sssp_alloc(tracker->parent, sizeof(tracking_header_t) + size);
+    if (!header) {
+        tracking_release(tracker, size);
+        return NULL;
+    }
+    
+    header->size = size;
+    __atomic_add_fetch(&tracker->stats.total_allocations, 1, __ATOMIC_RELAXED);
+    return header + 1;
+}
+
+static void tracking_free(void* ptr, void* context) {
+    if (!ptr) return;
+    
+    sssp_tracking_allocator_t* tracker = context;
+    tracking_header_t* header = (tracking_header_t*)ptr - 1;
+    tracking_release(tracker, header->size);
+    __atomic_add_fetch(&tracker->stats.total_deallocations, 1, __ATOMIC_RELAXED);
+    sssp_free(tracker->parent, header);
+}
+
+static void* tracking_realloc(void* ptr, size_t new_size, void* context) {
+    if (!ptr) {
+        return tracking_alloc(new_size, context);
+    }
+    if (new_size == 0) {
+        tracking_free(ptr, context);
+        return NULL;
+    }
+    
+    sssp_tracking_allocator_t* tracker = context;
+    tracking_header_t* header = (tracking_header_t*)ptr - 1;
+    size_t old_size = header->size;
+    if (new_size > SIZE_MAX - sizeof(tracking_header_t)) {
+        return NULL;
+    }
+    
+    // Reserve growth up front; the old block stays valid if this fails
+    if (new_size > old_size && !tracking_reserve(tracker, new_size - old_size)) {
+        return NULL;
+    }
+    
+    tracking_header_t* resized = sssp_realloc(tracker->parent, header,
+                                              sizeof(tracking_header_t) + new_size);
+    if (!resized) {
+        if (new_size > old_size) {
+            tracking_release(tracker, new_size - old_size);
+        }
+        return NULL;
+    }
+    
+    if (new_size < old_size) {
+        tracking_release(tracker, old_size - new_size);
+    }
+    resized->size = new_size;
+    return resized + 1;
+}
+
+void sssp_tracking_allocator_init(sssp_tracking_allocator_t* tracker,
+                                  const sssp_allocator_t* parent,
+                                  size_t limit_bytes) {
+    if (!tracker) return;
+    
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->allocator.alloc = tracking_alloc;
+    tracker->allocator.realloc = tracking_realloc;
+    tracker->allocator.free = tracking_free;
+    tracker->allocator.context = tracker;
+    tracker->parent = parent ? parent : sssp_default_allocator();
+    tracker->limit_bytes = limit_bytes;
+}
+
+sssp_memory_stats_t sssp_tracking_allocator_stats(const sssp_tracking_allocator_t* tracker) {
+    sssp_memory_stats_t stats;
+    sssp_memory_stats_reset(&stats);
+    if (!tracker) return stats;
+    
+    stats.current_bytes = __atomic_load_n(&tracker->stats.current_bytes, __ATOMIC_RELAXED);
+    stats.peak_bytes = __atomic_load_n(&tracker->stats.peak_bytes, __ATOMIC_RELAXED);
+    stats.total_allocations = __atomic_load_n(&tracker->stats.total_allocations, __ATOMIC_RELAXED);
+    stats.total_deallocations = __atomic_load_n(&tracker->stats.total_deallocations, __ATOMIC_RELAXED);
+    return stats;
+}
+
+// Huge page allocator
+//
+// Every block starts with a header. mapped_bytes is the length of the
+// block's own mapping, or 0 when the block came from the parent allocator.
+typedef union huge_page_header {
+    struct {
+        size_t size;
+        size_t mapped_bytes;
+    } info;
+    max_align_t align;
+} huge_page_header_t;
+
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+#define HUGE_PAGES_AVAILABLE 1
+
+/**
+ * Read "<key> <n> kB" from /proc/meminfo, or a plain number from a sysfs file
+ */
+static size_t read_size_file(const char* path, const char* key) {
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+    
+    size_t value = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long long n;
+        if (!key) {
+            if (sscanf(line, "%llu", &n) == 1) value = (size_t)n;
+            break;
+        }
+        if (strncmp(line, key, strlen(key)) == 0 && sscanf(line + strlen(key), " %llu", &n) == 1) {
+            value = (size_t)n * 1024;
+            break;
+        }
+    }
+    fclose(file);
+    return value;
+}
+
+static size_t base_page_size(void) {
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t)size : 4096;
+}
+
+// Size of MAP_HUGETLB pages and of transparent huge pages
+static size_t hugetlb_page_size(void) {
+    size_t size = read_size_file("/proc/meminfo", "Hugepagesize:");
+    return size ? size : ((size_t)2 << 20);
+}
+
+static size_t transparent_page_size(void) {
+    size_t size = read_size_file("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", NULL);
+    return size ? size : ((size_t)2 << 20);
+}
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+/**
+ * Map length bytes (a multiple of align) at an align boundary, trimming
+ * the over-allocation needed to find one
+ */
+static void* map_aligned(size_t length, size_t align) {
+    size_t padded = length + align;
+    char* raw = mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+    
+    char* start = (char*)round_up((size_t)(uintptr_t)raw, align);
+    if (start > raw) munmap(raw, (size_t)(start - raw));
+    size_t tail = (size_t)(raw + padded - (start + length));
+    if (tail > 0) munmap(start + length, tail);
+    return start;
+}
+
+/**
+ * Create a mapping for a block of total bytes; sets *mapped and *page_size
+ */
+static void* huge_page_map(sssp_huge_page_allocator_t* pages, size_t total,
+                           size_t* mapped, size_t* page_size) {
+#ifdef MAP_HUGETLB
+    if (pages->mode == SSSP_HUGE_PAGES_EXPLICIT) {
+        size_t size = hugetlb_page_size();
+        size_t length = round_up(total, size);
+        void* block = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (block != MAP_FAILED) {
+            __atomic_add_fetch(&pages->hugetlb_mappings, 1, __ATOMIC_RELAXED);
+            *mapped = length;
+            *page_size = size;
+            return block;
+        }
+        __atomic_add_fetch(&pages->fallback_mappings, 1, __ATOMIC_RELAXED);
+    }
+#endif
+    
+    size_t size = transparent_page_size();
+    size_t length = round_up(total, size);
+    void* block = map_aligned(length, size);
+    if (!block) return NULL;
+    
+    *mapped = length;
+    *page_size = base_page_size();
+#ifdef MADV_HUGEPAGE
+    if (madvise(block, length, MADV_HUGEPAGE) == 0) {
+        *page_size = size;
+    }
+#endif
+    return block;
+}
+#endif
+
+static void* huge_page_alloc(size_t size, void* context) {
+    sssp_huge_page_allocator_t* pages = context;
+    if (size > SIZE_MAX / 2) return NULL;
+    
+    size_t total = sizeof(huge_page_header_t) + size;
+    huge_page_header_t* header = NULL;
+    size_t mapped = 0;
+    
+#ifdef HUGE_PAGES_AVAILABLE
+    if (size >= pages->threshold) {
+        size_t page_size;
+        header = huge_page_map(pages, total, &mapped, &page_size);
+        if (header) {
+            __atomic_store_n(&pages->stats.page_size, page_size, __ATOMIC_RELAXED);
+            size_t current = __atomic_add_fetch(&pages->stats.current_bytes, mapped, __ATOMIC_RELAXED);
+            size_t peak = __atomic_load_n(&pages->stats.peak_bytes, __ATOMIC_RELAXED);
+            while (current > peak &&
+                   !__atomic_compare_exchange_n(&pages->stats.peak_bytes, &peak, current, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            }
+            __atomic_add_fetch(&pages->stats.total_allocations, 1, __ATOMIC_RELAXED);
+        }
+    }
+#endif
+    
+    if (!header) {
+        mapped = 0;
+        header = sssp_alloc(pages->parent, total);
+        if (!header) return NULL;
+    }
+    
+    header->info.size = size;
+    header->info.mapped_bytes = mapped;
+    return header + 1;
+}
+
+static void huge_page_free(void* ptr, void* context) {
+    if (!ptr) return;
+    
+    sssp_huge_page_allocator_t* pages = context;
+    huge_page_header_t* header = (huge_page_header_t*)ptr - 1;
+#ifdef HUGE_PAGES_AVAILABLE
+    size_t mapped = header->info.mapped_bytes;
+    if (mapped != 0) {
+        munmap(header, mapped);
+        __atomic_sub_fetch(&pages->stats.current_bytes, mapped, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&pages->stats.total_deallocations, 1, __ATOMIC_RELAXED);
+        return;
+    }
+#endif
+    sssp_free(pages->parent, header);
+}
+
+static void* huge_page_realloc(void* ptr, size_t new_size, void* context) {
+    if (!ptr) {
+        return huge_page_alloc(new_size, context);
+    }
+    if (new_size == 0) {
+        huge_page_free(ptr, context);
+        return NULL;
+    }
+    
+    sssp_huge_page_allocator_t* pages = context;
+    huge_page_header_t* header = (huge_page_header_t*)ptr - 1;
+    size_t old_size = header->info.size;
+    size_t mapped = header->info.mapped_bytes;
+    
+    // Shrinking or growing within the mapping keeps the block
+    if (mapped != 0 && new_size <= mapped - sizeof(huge_page_header_t)) {
+        header->info.size = new_size;
+        return ptr;
+    }
+    if (mapped == 0 && new_size < pages->threshold) {
+        huge_page_header_t* resized = sssp_realloc(pages->parent, header,
+                                                   sizeof(huge_page_header_t) + new_size);
+        if (!resized) return NULL;
+        resized->info.size = new_size;
+        return resized + 1;
+    }
+    
+    void* moved = huge_page_alloc(new_size, context);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, SSSP_MIN(old_size, new_size));
+    huge_page_free(ptr, context);
+    return moved;
+}
+
+void sssp_huge_page_allocator_init(sssp_huge_page_allocator_t* pages,
+                                   const sssp_allocator_t* parent,
+                                   size_t threshold,
+                                   sssp_huge_page_mode_t mode) {
+    if (!pages) return;
+    
+    memset(pages, 0, sizeof(*pages));
+    pages->allocator.alloc = huge_page_alloc;
+    pages->allocator.realloc = huge_page_realloc;
+    pages->allocator.free = huge_page_free;
+    pages->allocator.context = pages;
+    pages->parent = parent ? parent : sssp_default_allocator();
+    pages->threshold = threshold ? threshold : SSSP_HUGE_PAGE_THRESHOLD;
+    pages->mode = mode;
+}
+
+sssp_memory_stats_t sssp_huge_page_allocator_stats(const sssp_huge_page_allocator_t* pages) {
+    sssp_memory_stats_t stats;
+    sssp_memory_stats_reset(&stats);
+    if (!pages) return stats;
+    
+    stats.current_bytes = __atomic_load_n(&pages->stats.current_bytes, __ATOMIC_RELAXED);
+    stats.peak_bytes = __atomic_load_n(&pages->stats.peak_bytes, __ATOMIC_RELAXED);
+    stats.total_allocations = __atomic_load_n(&pages->stats.total_allocations, __ATOMIC_RELAXED);
+    stats.total_deallocations = __atomic_load_n(&pages->stats.total_deallocations, __ATOMIC_RELAXED);
+    stats.page_size = __atomic_load_n(&pages->stats.page_size, __ATOMIC_RELAXED);
+    return stats;
+}
+
+// Arena allocator
+//
+// Each allocation is preceded by a header holding its size, which realloc
+// needs to copy a block that cannot grow in place.
+#define SSSP_ARENA_DEFAULT_BLOCK_SIZE ((size_t)1 << 20)
+
+struct sssp_arena_block {
+    sssp_arena_block_t* next;
+    size_t size;                        // Usable bytes in data
+    max_align_t data[];
+};
+
+typedef union arena_header {
+    size_t size;
+    max_align_t align;
+} arena_header_t;
+
+static size_t arena_round_up(size_t bytes) {
+    const size_t align = _Alignof(max_align_t);
+    return (bytes + align - 1) & ~(align - 1);
+}
+
+static bool arena_fits(const sssp_arena_block_t* block, size_t offset, size_t bytes) {
+    return block && block->size - offset >= bytes;
+}
+
+static void* arena_alloc(size_t size, void* context) {
+    sssp_arena_t* arena = context;
+    if (size > SIZE_MAX / 2) return NULL;
+    size_t bytes = sizeof(arena_header_t) + arena_round_up(size);
+    
+    if (!arena_fits(arena->current, arena->offset, bytes)) {
+        // Reuse the following block when it is large enough; otherwise
+        // insert a new one in front of it
+        sssp_arena_block_t* next = arena->current ? arena->current->next : arena->first;
+        if (!arena_fits(next, 0, bytes)) {
+            size_t block_bytes = SSSP_MAX(arena->block_size, bytes);
+            sssp_arena_block_t* block = sssp_alloc(arena->parent, sizeof(sssp_arena_block_t) + block_bytes);
+            if (!block) return NULL;
+            
+            block->size = block_bytes;
+            block->next = next;
+            if (arena->current) {
+                arena->current->next = block;
+            } else {
+                arena->first = block;
+            }
+            arena->reserved_bytes += block_bytes;
+            arena->block_allocations++;
+            next = block;
+        }
+        arena->current = next;
+        arena->offset = 0;
+    }
+    
+    arena_header_t* header = (arena_header_t*)((char*)arena->current->data + arena->offset);
+    header->size = size;
+    arena->offset += bytes;
+    return header + 1;
+}
+
+static void arena_free(void* ptr, void* context) {
+    (void)ptr;
+    (void)context;
+}
+
+static void* arena_realloc(void* ptr, size_t new_size, void* context) {
+    sssp_arena_t* arena = context;
+    if (!ptr) return arena_alloc(new_size, context);
+    if (new_size > SIZE_MAX / 2) return NULL;
+    
+    arena_header_t* header = (arena_header_t*)ptr - 1;
+    size_t old_size = header->size;
+    
+    // The newest allocation can grow or shrink in place
+    if (arena->current &&
+        (char*)ptr + arena_round_up(old_size) == (char*)arena->current->data + arena->offset) {
+        size_t start = (size_t)((char*)ptr - (char*)arena->current->data);
+        if (arena->current->size - start >= arena_round_up(new_size)) {
+            header->size = new_size;
+            arena->offset = start + arena_round_up(new_size);
+            return ptr;
+        }
+    }
+    
+    void* resized = arena_alloc(new_size, context);
+    if (resized) {
+        memcpy(resized, ptr, SSSP_MIN(old_size, new_size));
+    }
+    return resized;
+}
+
+void sssp_arena_init(sssp_arena_t* arena, const sssp_allocator_t* parent, size_t block_size) {
+    if (!arena) return;
+    
+    memset(arena, 0, sizeof(*arena));
+    arena->allocator.alloc = arena_alloc;
+    arena->allocator.realloc = arena_realloc;
+    arena->allocator.free = arena_free;
+    arena->allocator.context = arena;
+    arena->parent = parent ? parent : sssp_default_allocator();
+    arena->block_size = block_size ? block_size : SSSP_ARENA_DEFAULT_BLOCK_SIZE;
+}
+
+void sssp_arena_destroy(sssp_arena_t* arena) {
+    if (!arena) return;
+    
+    sssp_arena_block_t* block = arena->first;
+    while (block) {
+        sssp_arena_block_t* next = block->next;
+        sssp_free(arena->parent, block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->offset = 0;
+    arena->reserved_bytes = 0;
+}
+
+sssp_arena_mark_t sssp_arena_mark(const sssp_arena_t* arena) {
+    sssp_arena_mark_t mark = { arena->current, arena->offset };
+    return mark;
+}
+
+void sssp_arena_rewind(sssp_arena_t* arena, sssp_arena_mark_t mark) {
+    arena->current = mark.block;
+    arena->offset = mark.offset;
+}
+
+void sssp_arena_reset(sssp_arena_t* arena) {
+    arena->current = NULL;
+    arena->offset = 0;
+}
+
+size_t sssp_arena_spare_bytes(const sssp_arena_t* arena) {
+    size_t spare = 0;
+    const sssp_arena_block_t* block = arena->first;
+    if (arena->current) {
+        spare = arena->current->size - arena->offset;
+        block = arena->current->next;
+    }
+    for (; block; block = block->next) {
+        spare += block->size;
+    }
+    return spare;
+}
+
 // Internal error reporting
 void sssp_report_error(sssp_error_t error, const char* message) {
     if (g_error_handler) {
@@ -0,0 +1,104 @@
+/**
+ * @file sssp_internal.h
+ * @brief Declarations shared between library source files
+ *
+ * Nothing in this header is part of the public API.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#ifndef SSSP_INTERNAL_H
+#define SSSP_INTERNAL_H
+
+#include "../include/graph.h"
+#include "../include/sssp_algorithm.h"
+#include <stdarg.h>
+
+/**
+ * @brief Create an empty CSR graph
+ *
+ * csr_offsets is allocated (num_vertices + 1 entries) and zeroed; the edge
+ * arrays are allocated later by sssp_graph_csr_reserve_edges once the
+ * caller has turned per-vertex counts into offsets.
+ */
+sssp_graph_t* sssp_graph_create_csr(vertex_count_t num_vertices,
+                                     const sssp_allocator_t* allocator);
+
+/**
+ * @brief Allocate csr_targets and csr_weights and set the edge count
+ */
+sssp_error_t sssp_graph_csr_reserve_edges(sssp_graph_t* graph, edge_count_t num_edges);
+
+/**
+ * @brief Single-source solve for config->approximation_epsilon > 0
+ *
+ * Called by sssp_solve_single_source() once the arguments are checked.
+ */
+sssp_error_t sssp_solve_approximate(const sssp_graph_t* graph, vertex_id_t source,
+                                    const sssp_algorithm_config_t* config,
+                                    sssp_algorithm_result_t* result);
+
+/**
+ * @brief Exact single-source solve over the graph's integer weights
+ *
+ * Called by sssp_solve_single_source() once the arguments are checked, for
+ * graphs with sssp_graph_get_weight_scale() != 0.
+ */
+sssp_error_t sssp_solve_integer(const sssp_graph_t* graph, vertex_id_t source,
+                                const sssp_algorithm_config_t* config,
+                                sssp_algorithm_result_t* result);
+
+/**
+ * @brief Settled vertices between query limit checks
+ *
+ * configured, or SSSP_DEFAULT_LIMIT_CHECK_INTERVAL if it is 0, for a query
+ * with a deadline or a cancellation token; UINT32_MAX, in effect never,
+ * for one without.
+ */
+static inline uint32_t sssp_limit_check_interval(uint64_t deadline_ns, const sssp_cancel_token_t* token,
+                                                 uint32_t configured) {
+    if (deadline_ns == 0 && !token) {
+        return UINT32_MAX;
+    }
+    return configured ? configured : SSSP_DEFAULT_LIMIT_CHECK_INTERVAL;
+}
+
+/**
+ * @brief Count a settled vertex and check the query limits when *until_check runs out
+ *
+ * Starts *until_check over at interval after each check, so the clock is
+ * read once every interval vertices rather than per vertex.
+ */
+static inline sssp_error_t sssp_poll_query_limits(uint32_t* until_check, uint32_t interval,
+                                                  uint64_t deadline_ns, const sssp_cancel_token_t* token) {
+    if (SSSP_LIKELY(--*until_check != 0)) {
+        return SSSP_SUCCESS;
+    }
+    *until_check = interval;
+    return sssp_check_query_limits(deadline_ns, token);
+}
+
+/**
+ * @brief Queue a message with the asynchronous log backend
+ *
+ * Reads the arguments from a copy of args.
+ *
+ * @return false if the backend is not running, so the caller logs it
+ *         synchronously
+ */
+bool sssp_log_async_push(sssp_log_level_t level, const char* file, int line,
+                         const char* func, const char* format, va_list args);
+
+/**
+ * @brief Function set with sssp_set_log_function(), or NULL for stderr
+ */
+sssp_log_func_t sssp_log_get_function(void);
+
+/**
+ * @brief Name of a log level as printed in messages ("ERROR", ...)
+ */
+const char* sssp_log_level_name(sssp_log_level_t level);
+
+#endif // SSSP_INTERNAL_H
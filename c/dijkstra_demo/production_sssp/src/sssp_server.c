@@ -0,0 +1,1213 @@
+/**
+ * @file sssp_server.c
+ * @brief Query server: socket loop, admission, worker pool
+ *
+ * The thread in sssp_server_run() owns the listeners and the read side of
+ * every connection. Each complete request is checked, given an estimate of
+ * its service time (a running average per query type) and either queued or
+ * rejected at once: a request is rejected when the queue is full, or when
+ * the estimated work queued ahead of it, spread over the workers, plus its
+ * own estimate exceeds its deadline. Workers take up to max_batch requests
+ * at a time, drop the ones whose deadline has passed, and answer the rest,
+ * writing replies to the connection under its write lock. A search that
+ * outlives its deadline is stopped, so an overloaded server sheds the work
+ * instead of finishing answers nobody waits for. Destroying the server
+ * cancels the searches still queued or running.
+ *
+ * A connection is freed when neither the socket loop nor any queued
+ * request refers to it any more.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "sssp_server.h"
+#include "sssp_algorithm.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+// Service time assumed for a query type before one has been measured
+#define INITIAL_ESTIMATE_MS 1.0
+
+// Weight of the newest measurement in the running service time average
+#define ESTIMATE_WEIGHT 0.125
+
+// Bytes read from a connection at a time
+#define READ_CHUNK 65536
+
+// Unsent reply bytes above which the socket loop stops reading a connection
+#define OUTPUT_LIMIT ((size_t)4 << 20)
+
+sssp_server_config_t sssp_server_config_default(const sssp_allocator_t* allocator) {
+    sssp_server_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.unix_path = NULL;
+    config.listen_tcp = false;
+    config.tcp_port = 0;
+    config.num_workers = 0;
+    config.max_batch = SSSP_SERVER_DEFAULT_BATCH;
+    config.max_queue = SSSP_SERVER_DEFAULT_QUEUE;
+    config.allocator = allocator;
+    return config;
+}
+
+#ifndef _WIN32
+
+typedef struct wire_request {
+    uint32_t magic;
+    uint32_t id;
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t deadline_ms;
+    vertex_id_t source;
+    vertex_id_t target;
+    uint32_t num_sources;
+    uint32_t reserved2;
+    double bound;
+} wire_request_t;
+
+typedef struct wire_response {
+    uint32_t magic;
+    uint32_t id;
+    int32_t status;
+    int32_t error;
+    uint32_t count;
+    uint32_t reserved;
+    double service_time_ms;
+} wire_response_t;
+
+static sssp_error_t write_all(int fd, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    while (size > 0) {
+        ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return SSSP_ERROR_IO;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t read_all(int fd, void* data, size_t size) {
+    unsigned char* bytes = data;
+    while (size > 0) {
+        ssize_t n = recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return SSSP_ERROR_IO;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return SSSP_SUCCESS;
+}
+
+// ============================================================================
+// Workers' state
+// ============================================================================
+
+typedef struct connection connection_t;
+typedef struct job job_t;
+
+/**
+ * Per-worker state: a library search workspace over the whole graph, plus
+ * reply and batch buffers
+ */
+typedef struct workspace {
+    sssp_server_t* server;
+    pthread_t thread;
+    sssp_workspace_t* search;
+    vertex_id_t* targets;               // Targets of a shared point-to-point search
+    vertex_id_t* path;                  // Reply buffers
+    distance_t* path_distances;
+    job_t** batch;
+} workspace_t;
+
+struct connection {
+    int fd;                             // Non-blocking
+    unsigned char* buffer;              // Bytes read but not yet parsed
+    size_t size;
+    size_t capacity;
+    uint32_t references;                // The socket loop plus queued requests
+    pthread_mutex_t write_lock;         // Guards the output fields
+    unsigned char* output;              // Replies the socket has not taken yet
+    size_t output_size;
+    size_t output_capacity;
+    bool broken;                        // A write failed; replies are dropped
+};
+
+struct job {
+    connection_t* connection;
+    uint32_t id;
+    sssp_query_type_t type;
+    vertex_id_t source;
+    vertex_id_t target;
+    vertex_id_t* sources;               // Multi-source only
+    vertex_count_t num_sources;
+    distance_t bound;
+    uint64_t arrival_ns;
+    uint64_t deadline_ns;               // 0: none
+    double estimate_ms;
+};
+
+struct sssp_server {
+    const sssp_graph_t* graph;
+    vertex_count_t num_vertices;
+    char* unix_path;
+    int unix_fd;
+    int tcp_fd;
+    uint16_t port;
+    int wake[2];                        // Self-pipe waking the socket loop
+    volatile sig_atomic_t stop_requested;
+
+    connection_t** connections;
+    size_t num_connections;
+    size_t connection_capacity;
+    struct pollfd* polls;
+
+    workspace_t* workspaces;
+    unsigned int num_workers;
+    vertex_count_t max_batch;
+
+    pthread_mutex_t lock;               // Guards everything below
+    pthread_cond_t ready;
+    job_t** queue;                      // Ring of waiting requests
+    size_t queue_head;
+    size_t queue_count;
+    size_t queue_capacity;
+    double estimate_ms[SSSP_QUERY_MULTI_SOURCE + 1];
+    double queued_ms;                   // Estimates of the waiting requests
+    bool stopping;
+    sssp_server_stats_t stats;
+
+    sssp_cancel_token_t cancel;         // Cancelled by sssp_server_destroy()
+
+    const sssp_allocator_t* allocator;
+};
+
+static void workspace_destroy(workspace_t* workspace, const sssp_allocator_t* allocator) {
+    sssp_workspace_destroy(workspace->search);
+    sssp_free(allocator, workspace->targets);
+    sssp_free(allocator, workspace->path);
+    sssp_free(allocator, workspace->path_distances);
+    sssp_free(allocator, workspace->batch);
+}
+
+static sssp_error_t workspace_init(workspace_t* workspace, sssp_server_t* server) {
+    const sssp_allocator_t* allocator = server->allocator;
+    size_t n = server->num_vertices;
+    memset(workspace, 0, sizeof(*workspace));
+    workspace->server = server;
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(server->num_vertices, allocator);
+    sssp_error_t error = sssp_workspace_create(server->graph, &config, &workspace->search);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+    workspace->targets = sssp_alloc(allocator, server->max_batch * sizeof(vertex_id_t));
+    workspace->path = sssp_alloc(allocator, n * sizeof(vertex_id_t));
+    workspace->path_distances = sssp_alloc(allocator, n * sizeof(distance_t));
+    workspace->batch = sssp_alloc(allocator, server->max_batch * sizeof(job_t*));
+    if (!workspace->targets || !workspace->path || !workspace->path_distances || !workspace->batch) {
+        workspace_destroy(workspace, allocator);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Search from sources up to bound, stopping early once every target is
+ * settled, with SSSP_ERROR_TIMEOUT once deadline_ns (0: none) has passed,
+ * or with SSSP_ERROR_CANCELLED once the server is destroyed; the vertices
+ * settled by then keep exact distances
+ */
+static sssp_error_t search(workspace_t* workspace, const vertex_id_t* sources, vertex_count_t num_sources,
+                           distance_t bound, const vertex_id_t* targets, vertex_count_t num_targets,
+                           uint64_t deadline_ns) {
+    sssp_workspace_query_t query;
+    memset(&query, 0, sizeof(query));
+    query.sources = sources;
+    query.num_sources = num_sources;
+    query.bound = bound;
+    query.targets = targets;
+    query.num_targets = num_targets;
+    query.deadline_ns = deadline_ns;
+    query.cancel_token = &workspace->server->cancel;
+    return sssp_workspace_solve(workspace->search, &query);
+}
+
+// ============================================================================
+// Connections and replies
+// ============================================================================
+
+static void connection_release(sssp_server_t* server, connection_t* connection) {
+    if (__atomic_sub_fetch(&connection->references, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+    close(connection->fd);
+    pthread_mutex_destroy(&connection->write_lock);
+    sssp_free(server->allocator, connection->buffer);
+    sssp_free(server->allocator, connection->output);
+    sssp_free(server->allocator, connection);
+}
+
+static void wake_loop(sssp_server_t* server) {
+    char byte = 1;
+    ssize_t ignored = write(server->wake[1], &byte, 1);
+    (void)ignored;
+}
+
+/**
+ * Send as much pending output as the socket takes; call with write_lock held
+ */
+static void flush_output(connection_t* connection) {
+    size_t sent = 0;
+    while (sent < connection->output_size) {
+        ssize_t n = send(connection->fd, connection->output + sent, connection->output_size - sent,
+                         MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            connection->broken = true;
+            sent = connection->output_size;
+        }
+    }
+    memmove(connection->output, connection->output + sent, connection->output_size - sent);
+    connection->output_size -= sent;
+}
+
+static bool append_output(sssp_server_t* server, connection_t* connection, const void* data, size_t size) {
+    if (size == 0) {
+        return true;
+    }
+    if (connection->output_capacity - connection->output_size < size) {
+        size_t capacity = SSSP_MAX(connection->output_capacity * 2, connection->output_size + size);
+        unsigned char* output = sssp_realloc(server->allocator, connection->output, capacity);
+        if (!output) {
+            return false;
+        }
+        connection->output = output;
+        connection->output_capacity = capacity;
+    }
+    memcpy(connection->output + connection->output_size, data, size);
+    connection->output_size += size;
+    return true;
+}
+
+/**
+ * Queue one response on the connection and send what the socket takes
+ * right away; the socket loop sends the rest. Never blocks on the client.
+ */
+static void send_reply(sssp_server_t* server, connection_t* connection, uint32_t id,
+                       sssp_server_status_t status, sssp_error_t error, uint64_t arrival_ns,
+                       size_t count, const vertex_id_t* vertices, const distance_t* distances) {
+    wire_response_t response;
+    memset(&response, 0, sizeof(response));
+    response.magic = SSSP_SERVER_RESPONSE_MAGIC;
+    response.id = id;
+    response.status = status;
+    response.error = error;
+    response.count = (uint32_t)count;
+    response.service_time_ms = (double)(sssp_get_timestamp_ns() - arrival_ns) / 1000000.0;
+
+    bool wake = false;
+    pthread_mutex_lock(&connection->write_lock);
+    bool was_idle = connection->output_size == 0;
+    if (!connection->broken) {
+        if (append_output(server, connection, &response, sizeof(response)) &&
+            append_output(server, connection, vertices, count * sizeof(vertex_id_t)) &&
+            append_output(server, connection, distances, count * sizeof(distance_t))) {
+            if (was_idle) {
+                flush_output(connection);
+                wake = connection->output_size > 0;
+            }
+        } else {
+            connection->broken = true;  // A partial response would corrupt the stream
+            connection->output_size = 0;
+        }
+    }
+    pthread_mutex_unlock(&connection->write_lock);
+    if (wake) {
+        wake_loop(server);              // So the socket loop polls for room to write
+    }
+}
+
+/**
+ * Reply to a point-to-point job from the workspace's last search
+ */
+static void reply_path(workspace_t* workspace, const job_t* job) {
+    const sssp_workspace_t* search = workspace->search;
+    size_t length = 0;
+    if (sssp_workspace_distance(search, job->target) != SSSP_INFINITY) {
+        for (vertex_id_t v = job->target; v != SSSP_INVALID_VERTEX; v = sssp_workspace_predecessor(search, v)) {
+            length++;
+        }
+        size_t i = length;
+        for (vertex_id_t v = job->target; v != SSSP_INVALID_VERTEX; v = sssp_workspace_predecessor(search, v)) {
+            i--;
+            workspace->path[i] = v;
+            workspace->path_distances[i] = sssp_workspace_distance(search, v);
+        }
+    }
+    send_reply(workspace->server, job->connection, job->id, SSSP_SERVER_OK, SSSP_SUCCESS, job->arrival_ns,
+               length, workspace->path, workspace->path_distances);
+}
+
+/**
+ * Reply with every vertex the workspace's last search settled
+ */
+static void reply_settled(workspace_t* workspace, const job_t* job,
+                          sssp_server_status_t status, sssp_error_t error) {
+    vertex_count_t count;
+    const vertex_id_t* settled = sssp_workspace_settled(workspace->search, &count);
+    for (vertex_count_t i = 0; i < count; i++) {
+        workspace->path_distances[i] = sssp_workspace_distance(workspace->search, settled[i]);
+    }
+    send_reply(workspace->server, job->connection, job->id, status, error, job->arrival_ns,
+               count, settled, workspace->path_distances);
+}
+
+/**
+ * Reply to a job whose search ran out of time; jobs that list settled
+ * vertices get the ones settled in time
+ */
+static void reply_expired(workspace_t* workspace, const job_t* job) {
+    sssp_server_t* server = workspace->server;
+    pthread_mutex_lock(&server->lock);
+    server->stats.expired++;
+    pthread_mutex_unlock(&server->lock);
+    if (job->type == SSSP_QUERY_POINT_TO_POINT) {
+        send_reply(server, job->connection, job->id, SSSP_SERVER_EXPIRED, SSSP_ERROR_TIMEOUT,
+                   job->arrival_ns, 0, NULL, NULL);
+    } else {
+        reply_settled(workspace, job, SSSP_SERVER_EXPIRED, SSSP_ERROR_TIMEOUT);
+    }
+}
+
+static void job_free(sssp_server_t* server, job_t* job) {
+    connection_release(server, job->connection);
+    sssp_free(server->allocator, job->sources);
+    sssp_free(server->allocator, job);
+}
+
+// ============================================================================
+// Workers
+// ============================================================================
+
+/**
+ * Record a finished search; counters change before the replies go out, so
+ * a client that has its answer also sees it counted. A search cut short by
+ * its deadline only says the full one takes at least as long, so it can
+ * raise the service time estimate but not lower it; a cancelled one says
+ * nothing.
+ */
+static void record_search(sssp_server_t* server, sssp_query_type_t type, uint64_t start_ns,
+                          sssp_error_t error, uint64_t answered) {
+    double measured_ms = (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0;
+    pthread_mutex_lock(&server->lock);
+    if (error == SSSP_SUCCESS || (error == SSSP_ERROR_TIMEOUT && measured_ms > server->estimate_ms[type])) {
+        server->estimate_ms[type] += ESTIMATE_WEIGHT * (measured_ms - server->estimate_ms[type]);
+    }
+    if (error == SSSP_SUCCESS) {
+        server->stats.answered += answered;
+        server->stats.shared_searches += answered - 1;
+    }
+    pthread_mutex_unlock(&server->lock);
+}
+
+/**
+ * Answer a batch; jobs answered together with an earlier one are set to NULL
+ */
+static void process_batch(workspace_t* workspace, job_t** batch, size_t count) {
+    sssp_server_t* server = workspace->server;
+
+    for (size_t i = 0; i < count; i++) {
+        job_t* job = batch[i];
+        if (!job) {
+            continue;
+        }
+        uint64_t start_ns = sssp_get_timestamp_ns();
+        if (sssp_check_query_limits(job->deadline_ns, NULL) == SSSP_ERROR_TIMEOUT) {
+            pthread_mutex_lock(&server->lock);
+            server->stats.expired++;
+            pthread_mutex_unlock(&server->lock);
+            send_reply(server, job->connection, job->id, SSSP_SERVER_EXPIRED, SSSP_SUCCESS,
+                       job->arrival_ns, 0, NULL, NULL);
+            job_free(server, job);
+            continue;
+        }
+
+        sssp_error_t error;
+        if (job->type == SSSP_QUERY_POINT_TO_POINT) {
+            // Later jobs of the batch from the same source share this search,
+            // which runs until the last of their deadlines
+            vertex_count_t num_targets = 0;
+            workspace->targets[num_targets++] = job->target;
+            uint64_t sharing = 1;
+            uint64_t deadline_ns = job->deadline_ns;
+            for (size_t j = i + 1; j < count; j++) {
+                if (batch[j] && batch[j]->type == SSSP_QUERY_POINT_TO_POINT &&
+                    batch[j]->source == job->source) {
+                    sharing++;
+                    workspace->targets[num_targets++] = batch[j]->target;
+                    deadline_ns = deadline_ns == 0 || batch[j]->deadline_ns == 0
+                                      ? 0 : SSSP_MAX(deadline_ns, batch[j]->deadline_ns);
+                }
+            }
+            error = search(workspace, &job->source, 1, SSSP_INFINITY, workspace->targets, num_targets,
+                           deadline_ns);
+            record_search(server, job->type, start_ns, error, sharing);
+            bool finished = error == SSSP_SUCCESS || error == SSSP_ERROR_TIMEOUT;
+            for (size_t j = i + 1; j < count && finished; j++) {
+                if (batch[j] && batch[j]->type == SSSP_QUERY_POINT_TO_POINT &&
+                    batch[j]->source == job->source) {
+                    if (error == SSSP_SUCCESS) {
+                        reply_path(workspace, batch[j]);
+                    } else {
+                        reply_expired(workspace, batch[j]);
+                    }
+                    job_free(server, batch[j]);
+                    batch[j] = NULL;
+                }
+            }
+            if (error == SSSP_SUCCESS) {
+                reply_path(workspace, job);
+            }
+        } else {
+            const vertex_id_t* sources = job->type == SSSP_QUERY_MULTI_SOURCE ? job->sources : &job->source;
+            vertex_count_t num_sources = job->type == SSSP_QUERY_MULTI_SOURCE ? job->num_sources : 1;
+            distance_t bound = job->type == SSSP_QUERY_SINGLE_SOURCE ? SSSP_INFINITY : job->bound;
+            error = search(workspace, sources, num_sources, bound, NULL, 0, job->deadline_ns);
+            record_search(server, job->type, start_ns, error, 1);
+            if (error == SSSP_SUCCESS) {
+                reply_settled(workspace, job, SSSP_SERVER_OK, SSSP_SUCCESS);
+            }
+        }
+        if (error == SSSP_ERROR_TIMEOUT) {
+            reply_expired(workspace, job);
+        } else if (error != SSSP_SUCCESS) {
+            send_reply(server, job->connection, job->id, SSSP_SERVER_FAILED, error,
+                       job->arrival_ns, 0, NULL, NULL);
+        }
+        job_free(server, job);
+    }
+}
+
+static void* worker_main(void* context) {
+    workspace_t* workspace = context;
+    sssp_server_t* server = workspace->server;
+
+    for (;;) {
+        pthread_mutex_lock(&server->lock);
+        while (server->queue_count == 0 && !server->stopping) {
+            pthread_cond_wait(&server->ready, &server->lock);
+        }
+        if (server->queue_count == 0) {
+            pthread_mutex_unlock(&server->lock);
+            break;
+        }
+        size_t count = SSSP_MIN(server->queue_count, (size_t)server->max_batch);
+        for (size_t i = 0; i < count; i++) {
+            job_t* job = server->queue[server->queue_head];
+            server->queue_head = (server->queue_head + 1) % server->queue_capacity;
+            server->queued_ms -= job->estimate_ms;
+            workspace->batch[i] = job;
+        }
+        server->queue_count -= count;
+        if (server->queue_count == 0) {
+            server->queued_ms = 0.0;    // Drop accumulated rounding
+        }
+        server->stats.batches++;
+        pthread_mutex_unlock(&server->lock);
+
+        process_batch(workspace, workspace->batch, count);
+    }
+    return NULL;
+}
+
+// ============================================================================
+// Socket loop
+// ============================================================================
+
+static bool valid_request(const sssp_server_t* server, const wire_request_t* request,
+                          const unsigned char* sources) {
+    vertex_count_t n = server->num_vertices;
+    switch (request->type) {
+        case SSSP_QUERY_POINT_TO_POINT:
+            return request->source < n && request->target < n;
+        case SSSP_QUERY_SINGLE_SOURCE:
+            return request->source < n;
+        case SSSP_QUERY_BOUNDED:
+            return request->source < n && request->bound >= 0.0;
+        case SSSP_QUERY_MULTI_SOURCE:
+            if (request->num_sources == 0 || !(request->bound >= 0.0)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < request->num_sources; i++) {
+                vertex_id_t source;
+                memcpy(&source, sources + i * sizeof(vertex_id_t), sizeof(source));
+                if (source >= n) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Queue a parsed request, or answer it at once if it is malformed or not
+ * admitted
+ */
+static void admit(sssp_server_t* server, connection_t* connection, const wire_request_t* request,
+                  const unsigned char* sources) {
+    uint64_t arrival_ns = sssp_get_timestamp_ns();
+    pthread_mutex_lock(&server->lock);
+    server->stats.requests++;
+    pthread_mutex_unlock(&server->lock);
+
+    if (!valid_request(server, request, sources)) {
+        send_reply(server, connection, request->id, SSSP_SERVER_BAD_REQUEST, SSSP_ERROR_INVALID_PARAMETER,
+                   arrival_ns, 0, NULL, NULL);
+        return;
+    }
+
+    job_t* job = sssp_alloc(server->allocator, sizeof(job_t));
+    if (job) {
+        memset(job, 0, sizeof(*job));
+        job->num_sources = request->type == SSSP_QUERY_MULTI_SOURCE ? request->num_sources : 0;
+        if (job->num_sources > 0) {
+            job->sources = sssp_alloc(server->allocator, job->num_sources * sizeof(vertex_id_t));
+            if (!job->sources) {
+                sssp_free(server->allocator, job);
+                job = NULL;
+            } else {
+                memcpy(job->sources, sources, job->num_sources * sizeof(vertex_id_t));
+            }
+        }
+    }
+    if (!job) {
+        send_reply(server, connection, request->id, SSSP_SERVER_FAILED, SSSP_ERROR_OUT_OF_MEMORY,
+                   arrival_ns, 0, NULL, NULL);
+        return;
+    }
+    job->connection = connection;
+    job->id = request->id;
+    job->type = (sssp_query_type_t)request->type;
+    job->source = request->source;
+    job->target = request->target;
+    job->bound = request->bound;
+    job->arrival_ns = arrival_ns;
+    job->deadline_ns = request->deadline_ms ? arrival_ns + (uint64_t)request->deadline_ms * 1000000 : 0;
+
+    pthread_mutex_lock(&server->lock);
+    job->estimate_ms = server->estimate_ms[job->type];
+    double wait_ms = server->queued_ms / server->num_workers + job->estimate_ms;
+    bool admitted = server->queue_count < server->queue_capacity &&
+                    (request->deadline_ms == 0 || wait_ms <= request->deadline_ms);
+    if (admitted) {
+        size_t tail = (server->queue_head + server->queue_count) % server->queue_capacity;
+        server->queue[tail] = job;
+        server->queue_count++;
+        server->queued_ms += job->estimate_ms;
+        __atomic_add_fetch(&connection->references, 1, __ATOMIC_ACQ_REL);
+        pthread_cond_signal(&server->ready);
+    } else {
+        server->stats.rejected++;
+    }
+    pthread_mutex_unlock(&server->lock);
+
+    if (!admitted) {
+        send_reply(server, connection, request->id, SSSP_SERVER_REJECTED, SSSP_SUCCESS,
+                   arrival_ns, 0, NULL, NULL);
+        sssp_free(server->allocator, job->sources);
+        sssp_free(server->allocator, job);
+    }
+}
+
+/**
+ * Read what a connection has sent and admit its complete requests
+ * @return false when the connection is closed or sent garbage
+ */
+static bool read_connection(sssp_server_t* server, connection_t* connection) {
+    if (connection->capacity - connection->size < READ_CHUNK) {
+        size_t capacity = connection->size + READ_CHUNK;
+        unsigned char* buffer = sssp_realloc(server->allocator, connection->buffer, capacity);
+        if (!buffer) {
+            return false;
+        }
+        connection->buffer = buffer;
+        connection->capacity = capacity;
+    }
+    ssize_t n = recv(connection->fd, connection->buffer + connection->size,
+                     connection->capacity - connection->size, 0);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;
+    }
+    if (n <= 0) {
+        return false;
+    }
+    connection->size += (size_t)n;
+
+    size_t offset = 0;
+    while (connection->size - offset >= sizeof(wire_request_t)) {
+        wire_request_t request;
+        memcpy(&request, connection->buffer + offset, sizeof(request));
+        if (request.magic != SSSP_SERVER_REQUEST_MAGIC || request.num_sources > server->num_vertices) {
+            SSSP_LOG_WARN("Closing connection after a malformed request");
+            return false;
+        }
+        size_t length = sizeof(request) + (size_t)request.num_sources * sizeof(vertex_id_t);
+        if (connection->size - offset < length) {
+            break;
+        }
+        admit(server, connection, &request, connection->buffer + offset + sizeof(request));
+        offset += length;
+    }
+    memmove(connection->buffer, connection->buffer + offset, connection->size - offset);
+    connection->size -= offset;
+    return true;
+}
+
+static void accept_connection(sssp_server_t* server, int listener) {
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    if (listener == server->tcp_fd) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    if (server->num_connections == server->connection_capacity) {
+        size_t capacity = server->connection_capacity ? server->connection_capacity * 2 : SSSP_INITIAL_CAPACITY;
+        connection_t** connections = sssp_realloc(server->allocator, server->connections,
+                                                  capacity * sizeof(connection_t*));
+        struct pollfd* polls = connections
+            ? sssp_realloc(server->allocator, server->polls, (capacity + 3) * sizeof(struct pollfd))
+            : NULL;
+        if (connections) {
+            server->connections = connections;
+        }
+        if (!polls) {
+            close(fd);
+            return;
+        }
+        server->polls = polls;
+        server->connection_capacity = capacity;
+    }
+    connection_t* connection = sssp_alloc(server->allocator, sizeof(connection_t));
+    if (!connection) {
+        close(fd);
+        return;
+    }
+    memset(connection, 0, sizeof(*connection));
+    connection->fd = fd;
+    connection->references = 1;
+    pthread_mutex_init(&connection->write_lock, NULL);
+    server->connections[server->num_connections++] = connection;
+    pthread_mutex_lock(&server->lock);
+    server->stats.connections++;
+    pthread_mutex_unlock(&server->lock);
+}
+
+sssp_error_t sssp_server_run(sssp_server_t* server) {
+    if (!server) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    SSSP_LOG_INFO("Serving %u vertices with %u workers", server->num_vertices, server->num_workers);
+
+    for (;;) {
+        // Fixed slots first: wake pipe, Unix listener, TCP listener
+        struct pollfd* polls = server->polls;
+        polls[0].fd = server->wake[0];
+        polls[1].fd = server->unix_fd;
+        polls[2].fd = server->tcp_fd;
+        size_t count = 3 + server->num_connections;
+        for (size_t i = 0; i < count; i++) {
+            polls[i].events = POLLIN;
+            polls[i].revents = 0;
+        }
+        for (size_t i = 0; i < server->num_connections; i++) {
+            // Wait for room to write pending replies; stop reading requests
+            // from a client that leaves too many of them unread
+            connection_t* connection = server->connections[i];
+            pthread_mutex_lock(&connection->write_lock);
+            size_t pending = connection->output_size;
+            pthread_mutex_unlock(&connection->write_lock);
+            polls[3 + i].fd = connection->fd;
+            polls[3 + i].events = (short)((pending > 0 ? POLLOUT : 0) | (pending > OUTPUT_LIMIT ? 0 : POLLIN));
+        }
+
+        if (poll(polls, (nfds_t)count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return SSSP_ERROR_IO;
+        }
+        if (polls[0].revents) {
+            char drain[64];
+            while (read(server->wake[0], drain, sizeof(drain)) > 0) {
+            }
+            if (server->stop_requested) {
+                server->stop_requested = 0;
+                break;
+            }
+        }
+
+        // Backwards, so that removing by swapping in the last one is safe
+        for (size_t i = server->num_connections; i-- > 0;) {
+            connection_t* connection = server->connections[i];
+            short events = polls[3 + i].revents;
+            if (events & POLLOUT) {
+                pthread_mutex_lock(&connection->write_lock);
+                flush_output(connection);
+                pthread_mutex_unlock(&connection->write_lock);
+            }
+            if ((events & (POLLIN | POLLHUP | POLLERR)) && !read_connection(server, connection)) {
+                connection_release(server, connection);
+                server->connections[i] = server->connections[--server->num_connections];
+            }
+        }
+        short unix_events = polls[1].revents;
+        short tcp_events = polls[2].revents;
+        if (unix_events) {
+            accept_connection(server, server->unix_fd);
+        }
+        if (tcp_events) {
+            accept_connection(server, server->tcp_fd);
+        }
+    }
+    return SSSP_SUCCESS;
+}
+
+void sssp_server_stop(sssp_server_t* server) {
+    if (server) {
+        server->stop_requested = 1;
+        wake_loop(server);
+    }
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+static sssp_error_t listen_unix(sssp_server_t* server, const char* path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    size_t length = strlen(path);
+    if (length >= sizeof(address.sun_path)) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path, length + 1);
+
+    server->unix_path = sssp_alloc(server->allocator, length + 1);
+    if (!server->unix_path) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(server->unix_path, path, length + 1);
+
+    unlink(path);
+    server->unix_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server->unix_fd < 0 ||
+        bind(server->unix_fd, (const struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(server->unix_fd, SOMAXCONN) != 0) {
+        SSSP_LOG_ERROR("Cannot listen on %s: %s", path, strerror(errno));
+        return SSSP_ERROR_IO;
+    }
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t listen_tcp(sssp_server_t* server, uint16_t port) {
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int one = 1;
+    socklen_t length = sizeof(address);
+    server->tcp_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (server->tcp_fd < 0 ||
+        setsockopt(server->tcp_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(server->tcp_fd, (const struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(server->tcp_fd, SOMAXCONN) != 0 ||
+        getsockname(server->tcp_fd, (struct sockaddr*)&address, &length) != 0) {
+        SSSP_LOG_ERROR("Cannot listen on 127.0.0.1:%u: %s", port, strerror(errno));
+        return SSSP_ERROR_IO;
+    }
+    server->port = ntohs(address.sin_port);
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_server_create(const sssp_graph_t* graph,
+                                const sssp_server_config_t* config,
+                                sssp_server_t** server_out) {
+    if (!graph || !config || !server_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    *server_out = NULL;
+    if ((!config->unix_path && !config->listen_tcp) || sssp_graph_get_vertex_count(graph) == 0) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    if (sssp_graph_has_negative_weights(graph)) {
+        SSSP_LOG_ERROR("The server answers with Dijkstra and needs non-negative weights");
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+
+    const sssp_allocator_t* allocator = config->allocator ? config->allocator : sssp_default_allocator();
+    sssp_server_t* server = sssp_alloc(allocator, sizeof(sssp_server_t));
+    if (!server) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(server, 0, sizeof(*server));
+    server->graph = graph;
+    server->num_vertices = sssp_graph_get_vertex_count(graph);
+    server->allocator = allocator;
+    server->unix_fd = -1;
+    server->tcp_fd = -1;
+    server->wake[0] = -1;
+    server->wake[1] = -1;
+    server->max_batch = config->max_batch ? config->max_batch : SSSP_SERVER_DEFAULT_BATCH;
+    server->queue_capacity = config->max_queue ? config->max_queue : SSSP_SERVER_DEFAULT_QUEUE;
+    server->num_workers = config->num_workers ? config->num_workers : sssp_get_num_threads();
+    for (int type = 0; type <= SSSP_QUERY_MULTI_SOURCE; type++) {
+        server->estimate_ms[type] = INITIAL_ESTIMATE_MS;
+    }
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_cond_init(&server->ready, NULL);
+    sssp_cancel_token_init(&server->cancel);
+
+    sssp_error_t error = SSSP_SUCCESS;
+    server->queue = sssp_alloc(allocator, server->queue_capacity * sizeof(job_t*));
+    server->polls = sssp_alloc(allocator, 3 * sizeof(struct pollfd));
+    server->workspaces = sssp_alloc(allocator, server->num_workers * sizeof(workspace_t));
+    if (!server->queue || !server->polls || !server->workspaces) {
+        error = SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    if (error == SSSP_SUCCESS) {
+        // Up front, so the first query does not pay for the arrays
+        error = sssp_graph_build_csr((sssp_graph_t*)graph);
+    }
+    if (error == SSSP_SUCCESS && pipe(server->wake) != 0) {
+        error = SSSP_ERROR_IO;
+    }
+    for (int i = 0; i < 2 && error == SSSP_SUCCESS; i++) {
+        // Never block sssp_server_stop(), even from a signal handler
+        fcntl(server->wake[i], F_SETFL, fcntl(server->wake[i], F_GETFL) | O_NONBLOCK);
+    }
+    if (error == SSSP_SUCCESS && config->unix_path) {
+        error = listen_unix(server, config->unix_path);
+    }
+    if (error == SSSP_SUCCESS && config->listen_tcp) {
+        error = listen_tcp(server, config->tcp_port);
+    }
+
+    // A worker that fails to start just leaves its share to the others
+    unsigned int started = 0;
+    for (unsigned int i = 0; i < server->num_workers && error == SSSP_SUCCESS; i++) {
+        error = workspace_init(&server->workspaces[started], server);
+        if (error != SSSP_SUCCESS) {
+            break;
+        }
+        if (pthread_create(&server->workspaces[started].thread, NULL, worker_main,
+                           &server->workspaces[started]) != 0) {
+            workspace_destroy(&server->workspaces[started], allocator);
+            break;
+        }
+        started++;
+    }
+    server->num_workers = started;
+    if (error == SSSP_SUCCESS && started == 0) {
+        error = SSSP_ERROR_INTERNAL;
+    }
+    if (error != SSSP_SUCCESS) {
+        sssp_server_destroy(server);
+        return error;
+    }
+
+    *server_out = server;
+    return SSSP_SUCCESS;
+}
+
+void sssp_server_destroy(sssp_server_t* server) {
+    if (!server) {
+        return;
+    }
+    sssp_cancel_token_cancel(&server->cancel);
+    pthread_mutex_lock(&server->lock);
+    server->stopping = true;
+    pthread_cond_broadcast(&server->ready);
+    pthread_mutex_unlock(&server->lock);
+    for (unsigned int i = 0; i < server->num_workers; i++) {
+        pthread_join(server->workspaces[i].thread, NULL);
+        workspace_destroy(&server->workspaces[i], server->allocator);
+    }
+
+    // Last chance for replies the socket loop did not get to send
+    for (size_t i = 0; i < server->num_connections; i++) {
+        pthread_mutex_lock(&server->connections[i]->write_lock);
+        flush_output(server->connections[i]);
+        pthread_mutex_unlock(&server->connections[i]->write_lock);
+        connection_release(server, server->connections[i]);
+    }
+    if (server->unix_fd >= 0) {
+        close(server->unix_fd);
+        unlink(server->unix_path);
+    }
+    if (server->tcp_fd >= 0) {
+        close(server->tcp_fd);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (server->wake[i] >= 0) {
+            close(server->wake[i]);
+        }
+    }
+    pthread_cond_destroy(&server->ready);
+    pthread_mutex_destroy(&server->lock);
+
+    const sssp_allocator_t* allocator = server->allocator;
+    sssp_free(allocator, server->unix_path);
+    sssp_free(allocator, server->connections);
+    sssp_free(allocator, server->polls);
+    sssp_free(allocator, server->workspaces);
+    sssp_free(allocator, server->queue);
+    sssp_free(allocator, server);
+}
+
+uint16_t sssp_server_get_port(const sssp_server_t* server) {
+    return server ? server->port : 0;
+}
+
+sssp_server_stats_t sssp_server_get_stats(sssp_server_t* server) {
+    sssp_server_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    if (server) {
+        pthread_mutex_lock(&server->lock);
+        stats = server->stats;
+        pthread_mutex_unlock(&server->lock);
+    }
+    return stats;
+}
+
+// ============================================================================
+// Client
+// ============================================================================
+
+sssp_error_t sssp_client_connect_unix(const char* path, int* fd_out) {
+    if (!path || !fd_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    size_t length = strlen(path);
+    if (length >= sizeof(address.sun_path)) {
+        return SSSP_ERROR_INVALID_ARGUMENT;
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path, length + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (const struct sockaddr*)&address, sizeof(address)) != 0) {
+        if (fd >= 0) close(fd);
+        return SSSP_ERROR_IO;
+    }
+    *fd_out = fd;
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_client_connect_tcp(uint16_t port, int* fd_out) {
+    if (!fd_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (const struct sockaddr*)&address, sizeof(address)) != 0) {
+        if (fd >= 0) close(fd);
+        return SSSP_ERROR_IO;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    *fd_out = fd;
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_client_send(int fd, uint32_t id, const sssp_query_t* query) {
+    if (!query || (query->type == SSSP_QUERY_MULTI_SOURCE && !query->sources)) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    wire_request_t request;
+    memset(&request, 0, sizeof(request));
+    request.magic = SSSP_SERVER_REQUEST_MAGIC;
+    request.id = id;
+    request.type = (uint16_t)query->type;
+    request.deadline_ms = query->deadline_ms;
+    request.source = query->source;
+    request.target = query->target;
+    request.num_sources = query->type == SSSP_QUERY_MULTI_SOURCE ? query->num_sources : 0;
+    request.bound = query->bound;
+
+    sssp_error_t error = write_all(fd, &request, sizeof(request));
+    if (error == SSSP_SUCCESS && request.num_sources > 0) {
+        error = write_all(fd, query->sources, request.num_sources * sizeof(vertex_id_t));
+    }
+    return error;
+}
+
+sssp_error_t sssp_client_receive(int fd, const sssp_allocator_t* allocator, sssp_query_reply_t* reply) {
+    if (!reply) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    memset(reply, 0, sizeof(*reply));
+    wire_response_t response;
+    sssp_error_t error = read_all(fd, &response, sizeof(response));
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+    if (response.magic != SSSP_SERVER_RESPONSE_MAGIC) {
+        return SSSP_ERROR_IO;
+    }
+    reply->id = response.id;
+    reply->status = (sssp_server_status_t)response.status;
+    reply->error = (sssp_error_t)response.error;
+    reply->service_time_ms = response.service_time_ms;
+    if (response.count == 0) {
+        return SSSP_SUCCESS;
+    }
+
+    reply->vertices = sssp_alloc(allocator, response.count * sizeof(vertex_id_t));
+    reply->distances = sssp_alloc(allocator, response.count * sizeof(distance_t));
+    if (!reply->vertices || !reply->distances) {
+        sssp_query_reply_free(reply, allocator);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    reply->count = response.count;
+    error = read_all(fd, reply->vertices, reply->count * sizeof(vertex_id_t));
+    if (error == SSSP_SUCCESS) {
+        error = read_all(fd, reply->distances, reply->count * sizeof(distance_t));
+    }
+    if (error != SSSP_SUCCESS) {
+        sssp_query_reply_free(reply, allocator);
+    }
+    return error;
+}
+
+sssp_error_t sssp_client_query(int fd, const sssp_query_t* query,
+                               const sssp_allocator_t* allocator, sssp_query_reply_t* reply) {
+    sssp_error_t error = sssp_client_send(fd, 0, query);
+    return error == SSSP_SUCCESS ? sssp_client_receive(fd, allocator, reply) : error;
+}
+
+void sssp_query_reply_free(sssp_query_reply_t* reply, const sssp_allocator_t* allocator) {
+    if (!reply) {
+        return;
+    }
+    sssp_free(allocator, reply->vertices);
+    sssp_free(allocator, reply->distances);
+    reply->vertices = NULL;
+    reply->distances = NULL;
+    reply->count = 0;
+}
+
+#else // _WIN32
+
+sssp_error_t sssp_server_create(const sssp_graph_t* graph, const sssp_server_config_t* config,
+                                sssp_server_t** server_out) {
+    (void)graph; (void)config;
+    if (server_out) {
+        *server_out = NULL;
+    }
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_server_run(sssp_server_t* server) {
+    (void)server;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+void sssp_server_stop(sssp_server_t* server) {
+    (void)server;
+}
+
+void sssp_server_destroy(sssp_server_t* server) {
+    (void)server;
+}
+
+uint16_t sssp_server_get_port(const sssp_server_t* server) {
+    (void)server;
+    return 0;
+}
+
+sssp_server_stats_t sssp_server_get_stats(sssp_server_t* server) {
+    sssp_server_stats_t stats;
+    (void)server;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+sssp_error_t sssp_client_connect_unix(const char* path, int* fd_out) {
+    (void)path; (void)fd_out;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_client_connect_tcp(uint16_t port, int* fd_out) {
+    (void)port; (void)fd_out;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_client_send(int fd, uint32_t id, const sssp_query_t* query) {
+    (void)fd; (void)id; (void)query;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_client_receive(int fd, const sssp_allocator_t* allocator, sssp_query_reply_t* reply) {
+    (void)fd; (void)allocator; (void)reply;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_client_query(int fd, const sssp_query_t* query,
+                               const sssp_allocator_t* allocator, sssp_query_reply_t* reply) {
+    (void)fd; (void)query; (void)allocator; (void)reply;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+void sssp_query_reply_free(sssp_query_reply_t* reply, const sssp_allocator_t* allocator) {
+    (void)reply; (void)allocator;
+}
+
+#endif // _WIN32
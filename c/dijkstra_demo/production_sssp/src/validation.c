@@ -0,0 +1,377 @@
+/**
+ * @file validation.c
+ * @brief Shortest-path certificate checking and reference solvers
+ *
+ * A distance array d with predecessors p is a correct single-source result
+ * exactly when
+ *   1. d[source] = 0 and source has no predecessor,
+ *   2. no edge (u, v, w) has d[v] > d[u] + w,
+ *   3. every other vertex with finite d has a predecessor edge (p[v], v, w)
+ *      with d[v] = d[p[v]] + w, and
+ *   4. the predecessor links have no cycle.
+ * Conditions 3 and 4 make every finite d[v] the length of a real path
+ * from source, and condition 2 makes it no longer than any other path.
+ * Checking them reads every edge once and needs no second solve.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#include "sssp_algorithm.h"
+#include <string.h>
+#include <math.h>
+
+// Vertices per chunk of the parallel passes
+#define CERTIFICATE_GRAIN 4096
+
+// Per-vertex flags of the check
+#define CERT_TIGHT 1                    // Predecessor edge found and tight
+#define CERT_FLAT 2                     // Predecessor link does not lower the distance
+
+typedef enum certificate_violation {
+    CERT_OK = 0,
+    CERT_BAD_SOURCE,
+    CERT_EDGE_VIOLATED,
+    CERT_NO_TIGHT_PREDECESSOR,
+    CERT_PREDECESSOR_CYCLE,
+    CERT_EXPECTED_MISMATCH
+} certificate_violation_t;
+
+typedef struct certificate_check {
+    const sssp_graph_t* graph;
+    vertex_id_t source;
+    const weight_t* distances;
+    const vertex_id_t* predecessors;
+    const weight_t* expected;           // NULL when not comparing
+    bool negative_weights;
+    uint8_t* flags;                     // CERT_* per vertex
+    vertex_count_t flat_count;          // Vertices with CERT_FLAT
+    vertex_id_t witness;                // First offending vertex reported
+    certificate_violation_t violation;  // What it violates
+} certificate_check_t;
+
+static inline bool within_tolerance(distance_t a, distance_t b) {
+    return a == b || fabs(a - b) <= SSSP_VALIDATION_TOLERANCE * SSSP_MAX(1.0, fabs(b));
+}
+
+static void report(certificate_check_t* check, vertex_id_t v, certificate_violation_t violation) {
+    vertex_id_t none = SSSP_INVALID_VERTEX;
+    if (__atomic_compare_exchange_n(&check->witness, &none, v, false,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        check->violation = violation;
+    }
+}
+
+/**
+ * Check one edge for condition 2 and mark a tight predecessor edge
+ *
+ * Only the thread scanning u writes flags[v] for v with p[v] = u.
+ */
+static inline bool check_edge(certificate_check_t* check, vertex_id_t u, distance_t dist_u,
+                              vertex_id_t v, weight_t w) {
+    distance_t through_u = dist_u + w;
+    distance_t dist_v = check->distances[v];
+    if (dist_v > through_u && !within_tolerance(dist_v, through_u)) {
+        report(check, v, CERT_EDGE_VIOLATED);
+        return false;
+    }
+    if (check->predecessors[v] == u && v != check->source && within_tolerance(dist_v, through_u)) {
+        bool flat = check->negative_weights || dist_u >= dist_v;
+        check->flags[v] = CERT_TIGHT | (flat ? CERT_FLAT : 0);
+    }
+    return true;
+}
+
+static void check_edges(size_t begin, size_t end, void* context) {
+    certificate_check_t* check = context;
+    const sssp_graph_t* graph = check->graph;
+
+    for (vertex_id_t u = (vertex_id_t)begin; u < end; u++) {
+        distance_t dist_u = check->distances[u];
+        if (dist_u == SSSP_INFINITY) {
+            continue;
+        }
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t degree;
+        if (sssp_graph_neighbors(graph, u, &targets, &weights, &degree) != SSSP_SUCCESS) {
+            return;
+        }
+        for (edge_count_t e = 0; e < degree; e++) {
+            if (!check_edge(check, u, dist_u, targets[e], weights[e])) {
+                return;
+            }
+        }
+    }
+}
+
+static void check_vertices(size_t begin, size_t end, void* context) {
+    certificate_check_t* check = context;
+    vertex_count_t flat = 0;
+
+    for (vertex_id_t v = (vertex_id_t)begin; v < end; v++) {
+        distance_t d = check->distances[v];
+        if (check->expected && !within_tolerance(d, check->expected[v])) {
+            report(check, v, CERT_EXPECTED_MISMATCH);
+            break;
+        }
+        if (v == check->source) {
+            if (d != 0.0 || check->predecessors[v] != SSSP_INVALID_VERTEX) {
+                report(check, v, CERT_BAD_SOURCE);
+                break;
+            }
+            continue;
+        }
+        if (d != SSSP_INFINITY && !(check->flags[v] & CERT_TIGHT)) {
+            report(check, v, CERT_NO_TIGHT_PREDECESSOR);
+            break;
+        }
+        flat += (check->flags[v] & CERT_FLAT) != 0;
+    }
+    __atomic_add_fetch(&check->flat_count, flat, __ATOMIC_RELAXED);
+}
+
+/**
+ * Condition 4. Distances cannot rise along every link of a cycle, so there
+ * is none without a flat link. Links accepted as tight within the tolerance
+ * may still rise a little, so a cycle can mix flat and rising links, and
+ * every tight link is walked.
+ */
+static sssp_error_t check_acyclic(certificate_check_t* check, const sssp_allocator_t* allocator) {
+    vertex_count_t n = check->graph->num_vertices;
+    vertex_id_t* mark = sssp_alloc(allocator, n * sizeof(vertex_id_t));
+    if (!mark) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(mark, 0, n * sizeof(vertex_id_t));
+
+    for (vertex_id_t v = 0; v < n; v++) {
+        vertex_id_t x = v;
+        while ((check->flags[x] & CERT_TIGHT) && mark[x] == 0) {
+            mark[x] = v + 1;
+            x = check->predecessors[x];
+        }
+        if ((check->flags[x] & CERT_TIGHT) && mark[x] == v + 1) {
+            report(check, x, CERT_PREDECESSOR_CYCLE);
+            break;
+        }
+    }
+    sssp_free(allocator, mark);
+    return SSSP_SUCCESS;
+}
+
+static sssp_error_t run_pass(size_t count, sssp_parallel_fn_t fn, certificate_check_t* check) {
+    if (count > CERTIFICATE_GRAIN) {
+        return sssp_parallel_for(count, CERTIFICATE_GRAIN, fn, check);
+    }
+    fn(0, count, check);
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_validate_result(const sssp_graph_t* graph,
+                                   vertex_id_t source,
+                                   const sssp_algorithm_result_t* result,
+                                   const weight_t* expected_distances) {
+    if (!graph || !result || !result->distances || !result->predecessors) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    if (source >= n) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    // Build the arrays of a list-backed graph first, so no edge walk fails
+    sssp_error_t built = sssp_graph_build_csr((sssp_graph_t*)graph);
+    if (built != SSSP_SUCCESS) {
+        return built;
+    }
+
+    uint64_t start_ns = sssp_get_timestamp_ns();
+    const sssp_allocator_t* allocator = graph->allocator;
+    certificate_check_t check = {
+        .graph = graph,
+        .source = source,
+        .distances = result->distances,
+        .predecessors = result->predecessors,
+        .expected = expected_distances,
+        .negative_weights = sssp_graph_has_negative_weights(graph),
+        .witness = SSSP_INVALID_VERTEX,
+        .violation = CERT_OK,
+    };
+    check.flags = sssp_alloc(allocator, n);
+    if (!check.flags) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(check.flags, 0, n);
+
+    sssp_error_t error = run_pass(n, check_edges, &check);
+    if (error == SSSP_SUCCESS && check.violation == CERT_OK) {
+        error = run_pass(n, check_vertices, &check);
+    }
+    if (error == SSSP_SUCCESS && check.violation == CERT_OK && check.flat_count > 0) {
+        error = check_acyclic(&check, allocator);
+    }
+    sssp_free(allocator, check.flags);
+    if (error != SSSP_SUCCESS) {
+        return error;
+    }
+
+    vertex_id_t v = check.witness;
+    switch (check.violation) {
+        case CERT_OK:
+            SSSP_LOG_DEBUG("Certificate for source %u checked in %.2f ms", source,
+                           (double)(sssp_get_timestamp_ns() - start_ns) / 1000000.0);
+            return SSSP_SUCCESS;
+        case CERT_BAD_SOURCE:
+            SSSP_LOG_ERROR("Source %u has distance %g or a predecessor", v, result->distances[v]);
+            break;
+        case CERT_EDGE_VIOLATED:
+            SSSP_LOG_ERROR("Distance %g of vertex %u exceeds a path through an in-edge",
+                           result->distances[v], v);
+            break;
+        case CERT_NO_TIGHT_PREDECESSOR:
+            SSSP_LOG_ERROR("Vertex %u at distance %g has no tight predecessor edge",
+                           v, result->distances[v]);
+            break;
+        case CERT_PREDECESSOR_CYCLE:
+            SSSP_LOG_ERROR("Predecessor links of vertex %u form a cycle", v);
+            break;
+        case CERT_EXPECTED_MISMATCH:
+            SSSP_LOG_ERROR("Distance %g of vertex %u differs from expected %g",
+                           result->distances[v], v, expected_distances[v]);
+            break;
+    }
+    return SSSP_ERROR_ALGORITHM;
+}
+
+/**
+ * Compare distances; predecessors may differ between equally short paths
+ */
+bool sssp_results_equal(const sssp_algorithm_result_t* result1,
+                        const sssp_algorithm_result_t* result2,
+                        vertex_count_t num_vertices,
+                        weight_t tolerance) {
+    if (!result1 || !result2) {
+        return false;
+    }
+    for (vertex_count_t v = 0; v < num_vertices; v++) {
+        weight_t a = result1->distances[v];
+        weight_t b = result2->distances[v];
+        if (a != b && !(fabs(a - b) <= tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Reference Dijkstra: binary heap with lazy deletion, no shared code with
+ * the solvers it is meant to check
+ */
+
+typedef struct reference_entry {
+    distance_t distance;
+    vertex_id_t vertex;
+} reference_entry_t;
+
+static void reference_push(reference_entry_t* heap, size_t* size, reference_entry_t entry) {
+    size_t i = (*size)++;
+    while (i > 0 && heap[(i - 1) / 2].distance > entry.distance) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = entry;
+}
+
+static reference_entry_t reference_pop(reference_entry_t* heap, size_t* size) {
+    reference_entry_t top = heap[0];
+    reference_entry_t last = heap[--(*size)];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && heap[child + 1].distance < heap[child].distance) child++;
+        if (heap[child].distance >= last.distance) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*size > 0) {
+        heap[i] = last;
+    }
+    return top;
+}
+
+sssp_error_t sssp_dijkstra_reference(const sssp_graph_t* graph,
+                                      vertex_id_t source,
+                                      const sssp_allocator_t* allocator,
+                                      weight_t** distances_out,
+                                      vertex_id_t** predecessors_out) {
+    if (!graph || !distances_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    if (source >= n) {
+        return SSSP_ERROR_INVALID_PARAMETER;
+    }
+    if (sssp_graph_has_negative_weights(graph)) {
+        return SSSP_ERROR_GRAPH_INVALID;
+    }
+    sssp_error_t built = sssp_graph_build_csr((sssp_graph_t*)graph);
+    if (built != SSSP_SUCCESS) {
+        return built;
+    }
+    if (!allocator) {
+        allocator = &SSSP_DEFAULT_ALLOCATOR;
+    }
+
+    // Every improvement pushes one entry, so m + 1 entries always suffice
+    size_t capacity = (size_t)sssp_graph_get_edge_count(graph) + 1;
+    weight_t* distances = sssp_alloc(allocator, n * sizeof(weight_t));
+    vertex_id_t* predecessors = sssp_alloc(allocator, n * sizeof(vertex_id_t));
+    reference_entry_t* heap = sssp_alloc(allocator, capacity * sizeof(reference_entry_t));
+    if (!distances || !predecessors || !heap) {
+        if (distances) sssp_free(allocator, distances);
+        if (predecessors) sssp_free(allocator, predecessors);
+        if (heap) sssp_free(allocator, heap);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    for (vertex_count_t v = 0; v < n; v++) {
+        distances[v] = SSSP_INFINITY;
+        predecessors[v] = SSSP_INVALID_VERTEX;
+    }
+
+    size_t size = 0;
+    distances[source] = 0.0;
+    reference_push(heap, &size, (reference_entry_t){ 0.0, source });
+    while (size > 0) {
+        reference_entry_t top = reference_pop(heap, &size);
+        vertex_id_t u = top.vertex;
+        if (top.distance > distances[u]) {
+            continue;
+        }
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t degree;
+        if (sssp_graph_neighbors(graph, u, &targets, &weights, &degree) != SSSP_SUCCESS) {
+            continue;
+        }
+        for (edge_count_t e = 0; e < degree; e++) {
+            vertex_id_t v = targets[e];
+            distance_t candidate = top.distance + weights[e];
+            if (candidate < distances[v]) {
+                distances[v] = candidate;
+                predecessors[v] = u;
+                reference_push(heap, &size, (reference_entry_t){ candidate, v });
+            }
+        }
+    }
+
+    sssp_free(allocator, heap);
+    *distances_out = distances;
+    if (predecessors_out) {
+        *predecessors_out = predecessors;
+    } else {
+        sssp_free(allocator, predecessors);
+    }
+    return SSSP_SUCCESS;
+}
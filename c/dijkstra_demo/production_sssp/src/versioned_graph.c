@@ -0,0 +1,567 @@
+/**
+ * @file versioned_graph.c
+ * @brief Versioned graphs: delta staging, publishing and epoch-based
+ *        reclamation
+ *
+ * Reclamation protocol. The global epoch starts at 1 and a reader slot holds
+ * 0 while unpinned. To pin, a reader reads the epoch E, stores it in its
+ * slot and then loads the current version. To publish, the writer stores the
+ * new version, advances the epoch from R to R + 1 and records R as the
+ * retire epoch of the replaced version. All of these are sequentially
+ * consistent, so a reader that loaded the replaced version stored its slot
+ * before the writer's scan and read an epoch no later than R; a slot holding
+ * an epoch above R was stored after the swap and can only have loaded a
+ * newer version. A replaced version is therefore freed once every slot is
+ * 0 or above its retire epoch.
+ *
+ * @author Sambit Chakraborty
+ * @date 21-08-2025
+ * @version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "versioned_graph.h"
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define PENDING_INITIAL_CAPACITY 64
+
+// Offsets and targets, shared by versions that differ only in weights
+typedef struct structure {
+    edge_count_t* offsets;
+    vertex_id_t* targets;
+    uint32_t refs;                      // Versions using it; changed under the writer lock
+} structure_t;
+
+typedef struct version {
+    sssp_graph_t graph;                 // CSR view handed to readers
+    uint64_t number;
+    uint64_t retire_epoch;              // Epoch in which it was replaced
+    structure_t* structure;
+    struct version* next_retired;
+} version_t;
+
+typedef struct pending_edge {
+    vertex_id_t from;
+    vertex_id_t to;
+    weight_t weight;
+} pending_edge_t;
+
+struct sssp_graph_reader {
+    _Atomic uint64_t epoch;             // Epoch of the pin, 0 while unpinned
+    sssp_versioned_graph_t* owner;
+    bool in_use;                        // Changed under the writer lock
+    char padding[SSSP_CACHE_LINE_SIZE - sizeof(uint64_t) - sizeof(void*) - sizeof(bool)];
+};
+
+struct sssp_versioned_graph {
+    _Atomic(version_t*) current;
+    _Atomic uint64_t epoch;
+    sssp_graph_reader_t* readers;
+    uint32_t max_readers;
+
+    // Writer state, under lock
+    pthread_mutex_t lock;
+    version_t* retired;                 // Replaced versions, newest first
+    pending_edge_t* edges;
+    edge_count_t num_edges;
+    edge_count_t edges_capacity;
+    pending_edge_t* overrides;
+    edge_count_t num_overrides;
+    edge_count_t overrides_capacity;
+    sssp_versioned_graph_stats_t stats;
+
+    bool allow_negative_weights;
+    const sssp_allocator_t* allocator;
+};
+
+static void structure_release(structure_t* structure, const sssp_allocator_t* allocator) {
+    if (structure && --structure->refs == 0) {
+        sssp_free(allocator, structure->offsets);
+        sssp_free(allocator, structure->targets);
+        sssp_free(allocator, structure);
+    }
+}
+
+static void version_free(version_t* version, const sssp_allocator_t* allocator) {
+    // Lists and in-edges built on demand over the arrays are the version's own
+    sssp_free(allocator, version->graph.adj_list);
+    sssp_free(allocator, version->graph.edge_pool);
+    sssp_free(allocator, version->graph.reverse_offsets);
+    sssp_free(allocator, version->graph.reverse_sources);
+    sssp_free(allocator, version->graph.reverse_weights);
+    sssp_free(allocator, version->graph.int_weights);
+    sssp_free(allocator, version->graph.csr_weights);
+    structure_release(version->structure, allocator);
+    sssp_free(allocator, version);
+}
+
+/**
+ * Allocate a version over structure (taking a reference) with room for
+ * num_edges weights
+ */
+static version_t* version_create(sssp_versioned_graph_t* versioned, structure_t* structure,
+                                 vertex_count_t num_vertices, edge_count_t num_edges) {
+    version_t* version = sssp_alloc(versioned->allocator, sizeof(version_t));
+    weight_t* weights = sssp_alloc(versioned->allocator,
+                                   (num_edges > 0 ? num_edges : 1) * sizeof(weight_t));
+    if (!version || !weights) {
+        sssp_free(versioned->allocator, version);
+        sssp_free(versioned->allocator, weights);
+        return NULL;
+    }
+    memset(version, 0, sizeof(*version));
+    version->graph.num_vertices = num_vertices;
+    version->graph.num_edges = num_edges;
+    version->graph.total_edges = num_edges;
+    version->graph.allow_negative_weights = versioned->allow_negative_weights;
+    version->graph.csr_offsets = structure->offsets;
+    version->graph.csr_targets = structure->targets;
+    version->graph.csr_weights = weights;
+    version->graph.allocator = versioned->allocator;
+    version->structure = structure;
+    structure->refs++;
+    return version;
+}
+
+static structure_t* structure_create(const sssp_allocator_t* allocator,
+                                     vertex_count_t num_vertices, edge_count_t num_edges) {
+    structure_t* structure = sssp_alloc(allocator, sizeof(structure_t));
+    edge_count_t* offsets = sssp_alloc(allocator, ((size_t)num_vertices + 1) * sizeof(edge_count_t));
+    vertex_id_t* targets = sssp_alloc(allocator, (num_edges > 0 ? num_edges : 1) * sizeof(vertex_id_t));
+    if (!structure || !offsets || !targets) {
+        sssp_free(allocator, structure);
+        sssp_free(allocator, offsets);
+        sssp_free(allocator, targets);
+        return NULL;
+    }
+    structure->offsets = offsets;
+    structure->targets = targets;
+    structure->refs = 0;
+    return structure;
+}
+
+static bool valid_weight(const sssp_versioned_graph_t* versioned, weight_t weight) {
+    return !isnan(weight) && (weight >= 0 || versioned->allow_negative_weights);
+}
+
+/**
+ * Free the replaced versions no reader can hold. Called under the lock.
+ */
+static void reclaim(sssp_versioned_graph_t* versioned) {
+    uint64_t oldest = UINT64_MAX;
+    for (uint32_t i = 0; i < versioned->max_readers; i++) {
+        uint64_t epoch = atomic_load(&versioned->readers[i].epoch);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    version_t** link = &versioned->retired;
+    while (*link) {
+        version_t* version = *link;
+        if (version->retire_epoch < oldest) {
+            *link = version->next_retired;
+            version_free(version, versioned->allocator);
+            versioned->stats.reclaimed++;
+            versioned->stats.retained--;
+        } else {
+            link = &version->next_retired;
+        }
+    }
+}
+
+sssp_error_t sssp_versioned_graph_create(const sssp_graph_t* graph,
+                                         uint32_t max_readers,
+                                         const sssp_allocator_t* allocator,
+                                         sssp_versioned_graph_t** versioned_out) {
+    if (!graph || !versioned_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    if (allocator == NULL) {
+        allocator = &SSSP_DEFAULT_ALLOCATOR;
+    }
+    if (max_readers == 0) {
+        max_readers = SSSP_VERSIONED_DEFAULT_READERS;
+    }
+
+    sssp_versioned_graph_t* versioned = sssp_alloc(allocator, sizeof(sssp_versioned_graph_t));
+    if (!versioned) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(versioned, 0, sizeof(*versioned));
+    versioned->allocator = allocator;
+    versioned->max_readers = max_readers;
+    versioned->allow_negative_weights = graph->allow_negative_weights;
+    atomic_init(&versioned->epoch, 1);
+
+    versioned->readers = sssp_alloc(allocator, max_readers * sizeof(sssp_graph_reader_t));
+    structure_t* structure = structure_create(allocator, graph->num_vertices, graph->num_edges);
+    version_t* first = structure ? version_create(versioned, structure, graph->num_vertices,
+                                                  graph->num_edges) : NULL;
+    if (!versioned->readers || !first) {
+        sssp_free(allocator, structure ? structure->offsets : NULL);
+        sssp_free(allocator, structure ? structure->targets : NULL);
+        sssp_free(allocator, structure);
+        sssp_free(allocator, first ? first->graph.csr_weights : NULL);
+        sssp_free(allocator, first);
+        sssp_free(allocator, versioned->readers);
+        sssp_free(allocator, versioned);
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < max_readers; i++) {
+        atomic_init(&versioned->readers[i].epoch, 0);
+        versioned->readers[i].owner = versioned;
+        versioned->readers[i].in_use = false;
+    }
+
+    edge_count_t e = 0;
+    for (vertex_id_t v = 0; v < graph->num_vertices; v++) {
+        const vertex_id_t* targets;
+        const weight_t* weights;
+        edge_count_t degree;
+        sssp_error_t result = sssp_graph_neighbors(graph, v, &targets, &weights, &degree);
+        if (result != SSSP_SUCCESS) {
+            version_free(first, allocator);
+            sssp_free(allocator, versioned->readers);
+            sssp_free(allocator, versioned);
+            return result;
+        }
+        structure->offsets[v] = e;
+        memcpy(structure->targets + e, targets, degree * sizeof(vertex_id_t));
+        memcpy(first->graph.csr_weights + e, weights, degree * sizeof(weight_t));
+        e += degree;
+    }
+    structure->offsets[graph->num_vertices] = e;
+    first->graph.has_negative_weights = graph->has_negative_weights;
+    first->number = 1;
+
+    pthread_mutex_init(&versioned->lock, NULL);
+    atomic_init(&versioned->current, first);
+    versioned->stats.version = 1;
+    *versioned_out = versioned;
+    return SSSP_SUCCESS;
+}
+
+void sssp_versioned_graph_destroy(sssp_versioned_graph_t* versioned) {
+    if (!versioned) {
+        return;
+    }
+    const sssp_allocator_t* allocator = versioned->allocator;
+    while (versioned->retired) {
+        version_t* next = versioned->retired->next_retired;
+        version_free(versioned->retired, allocator);
+        versioned->retired = next;
+    }
+    version_free(atomic_load(&versioned->current), allocator);
+    pthread_mutex_destroy(&versioned->lock);
+    sssp_free(allocator, versioned->edges);
+    sssp_free(allocator, versioned->overrides);
+    sssp_free(allocator, versioned->readers);
+    sssp_free(allocator, versioned);
+}
+
+sssp_error_t sssp_versioned_graph_add_reader(sssp_versioned_graph_t* versioned,
+                                             sssp_graph_reader_t** reader_out) {
+    if (!versioned || !reader_out) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+    sssp_error_t result = SSSP_ERROR_INVALID_ARGUMENT;
+    pthread_mutex_lock(&versioned->lock);
+    for (uint32_t i = 0; i < versioned->max_readers; i++) {
+        if (!versioned->readers[i].in_use) {
+            versioned->readers[i].in_use = true;
+            *reader_out = &versioned->readers[i];
+            result = SSSP_SUCCESS;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&versioned->lock);
+    if (result != SSSP_SUCCESS) {
+        SSSP_LOG_ERROR("All %u reader slots are taken", versioned->max_readers);
+    }
+    return result;
+}
+
+void sssp_versioned_graph_remove_reader(sssp_graph_reader_t* reader) {
+    if (!reader) {
+        return;
+    }
+    pthread_mutex_lock(&reader->owner->lock);
+    reader->in_use = false;
+    pthread_mutex_unlock(&reader->owner->lock);
+}
+
+const sssp_graph_t* sssp_graph_reader_pin(sssp_graph_reader_t* reader, uint64_t* version_out) {
+    if (!reader) {
+        return NULL;
+    }
+    sssp_versioned_graph_t* versioned = reader->owner;
+    atomic_store(&reader->epoch, atomic_load(&versioned->epoch));
+    version_t* version = atomic_load(&versioned->current);
+    if (version_out) {
+        *version_out = version->number;
+    }
+    return &version->graph;
+}
+
+void sssp_graph_reader_unpin(sssp_graph_reader_t* reader) {
+    if (reader) {
+        atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+    }
+}
+
+static sssp_error_t stage(sssp_versioned_graph_t* versioned, pending_edge_t** items,
+                          edge_count_t* count, edge_count_t* capacity,
+                          vertex_id_t from, vertex_id_t to, weight_t weight) {
+    if (*count == *capacity) {
+        edge_count_t grown = *capacity ? *capacity * 2 : PENDING_INITIAL_CAPACITY;
+        pending_edge_t* resized = sssp_realloc(versioned->allocator, *items, grown * sizeof(pending_edge_t));
+        if (!resized) {
+            return SSSP_ERROR_OUT_OF_MEMORY;
+        }
+        *items = resized;
+        *capacity = grown;
+    }
+    (*items)[(*count)++] = (pending_edge_t){ .from = from, .to = to, .weight = weight };
+    return SSSP_SUCCESS;
+}
+
+sssp_error_t sssp_versioned_graph_add_edge(sssp_versioned_graph_t* versioned,
+                                           vertex_id_t from, vertex_id_t to, weight_t weight) {
+    if (!versioned) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&versioned->lock);
+    const sssp_graph_t* graph = &atomic_load(&versioned->current)->graph;
+    sssp_error_t result;
+    if (from >= graph->num_vertices || to >= graph->num_vertices || !valid_weight(versioned, weight)) {
+        SSSP_LOG_ERROR("Invalid edge %u -> %u (weight=%f)", from, to, weight);
+        result = SSSP_ERROR_INVALID_PARAMETER;
+    } else if (graph->num_edges + (uint64_t)versioned->num_edges >= UINT32_MAX) {
+        result = SSSP_ERROR_OVERFLOW;
+    } else {
+        result = stage(versioned, &versioned->edges, &versioned->num_edges, &versioned->edges_capacity,
+                       from, to, weight);
+    }
+    pthread_mutex_unlock(&versioned->lock);
+    return result;
+}
+
+sssp_error_t sssp_versioned_graph_set_weight(sssp_versioned_graph_t* versioned,
+                                             vertex_id_t from, vertex_id_t to, weight_t weight) {
+    if (!versioned) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&versioned->lock);
+    // The current version only changes under the lock
+    const sssp_graph_t* graph = &atomic_load(&versioned->current)->graph;
+    bool found = false;
+    if (from < graph->num_vertices && to < graph->num_vertices) {
+        for (edge_count_t e = graph->csr_offsets[from]; e < graph->csr_offsets[from + 1] && !found; e++) {
+            found = graph->csr_targets[e] == to;
+        }
+        for (edge_count_t i = 0; i < versioned->num_edges && !found; i++) {
+            found = versioned->edges[i].from == from && versioned->edges[i].to == to;
+        }
+    }
+    sssp_error_t result = SSSP_ERROR_INVALID_PARAMETER;
+    if (found && valid_weight(versioned, weight)) {
+        result = stage(versioned, &versioned->overrides, &versioned->num_overrides,
+                       &versioned->overrides_capacity, from, to, weight);
+    } else {
+        SSSP_LOG_ERROR("Cannot set weight of edge %u -> %u to %f", from, to, weight);
+    }
+    pthread_mutex_unlock(&versioned->lock);
+    return result;
+}
+
+/**
+ * Build the next version from previous and the staged delta
+ */
+static version_t* build_version(sssp_versioned_graph_t* versioned, const version_t* previous) {
+    const sssp_graph_t* old = &previous->graph;
+    const vertex_count_t n = old->num_vertices;
+    const edge_count_t m = old->num_edges + versioned->num_edges;
+    const sssp_allocator_t* allocator = versioned->allocator;
+    version_t* version;
+
+    if (versioned->num_edges == 0) {
+        version = version_create(versioned, previous->structure, n, m);
+        if (!version) {
+            return NULL;
+        }
+        memcpy(version->graph.csr_weights, old->csr_weights, m * sizeof(weight_t));
+    } else {
+        structure_t* structure = structure_create(allocator, n, m);
+        edge_count_t* fill = sssp_alloc(allocator, ((size_t)n + 1) * sizeof(edge_count_t));
+        version = structure && fill ? version_create(versioned, structure, n, m) : NULL;
+        if (!version) {
+            sssp_free(allocator, fill);
+            if (structure) {
+                structure->refs = 1;
+                structure_release(structure, allocator);
+            }
+            return NULL;
+        }
+
+        // Each row keeps its old edges and gets its appended edges after them
+        memset(fill, 0, ((size_t)n + 1) * sizeof(edge_count_t));
+        for (edge_count_t i = 0; i < versioned->num_edges; i++) {
+            fill[versioned->edges[i].from + 1]++;
+        }
+        edge_count_t* offsets = structure->offsets;
+        edge_count_t appended = 0;
+        for (vertex_id_t v = 0; v <= n; v++) {
+            appended += fill[v];
+            offsets[v] = old->csr_offsets[v] + appended;
+        }
+        for (vertex_id_t v = 0; v < n; v++) {
+            edge_count_t begin = old->csr_offsets[v];
+            edge_count_t degree = old->csr_offsets[v + 1] - begin;
+            memcpy(structure->targets + offsets[v], old->csr_targets + begin, degree * sizeof(vertex_id_t));
+            memcpy(version->graph.csr_weights + offsets[v], old->csr_weights + begin, degree * sizeof(weight_t));
+            fill[v] = offsets[v] + degree;
+        }
+        for (edge_count_t i = 0; i < versioned->num_edges; i++) {
+            const pending_edge_t* edge = &versioned->edges[i];
+            edge_count_t slot = fill[edge->from]++;
+            structure->targets[slot] = edge->to;
+            version->graph.csr_weights[slot] = edge->weight;
+        }
+        sssp_free(allocator, fill);
+    }
+
+    bool negative = old->has_negative_weights;
+    for (edge_count_t i = 0; i < versioned->num_edges; i++) {
+        negative |= versioned->edges[i].weight < 0;
+    }
+    for (edge_count_t i = 0; i < versioned->num_overrides; i++) {
+        const pending_edge_t* change = &versioned->overrides[i];
+        edge_count_t end = version->graph.csr_offsets[change->from + 1];
+        for (edge_count_t e = version->graph.csr_offsets[change->from]; e < end; e++) {
+            if (version->graph.csr_targets[e] == change->to) {
+                version->graph.csr_weights[e] = change->weight;
+            }
+        }
+        negative |= change->weight < 0;
+    }
+    version->graph.has_negative_weights = negative;
+    version->number = previous->number + 1;
+    return version;
+}
+
+sssp_error_t sssp_versioned_graph_publish(sssp_versioned_graph_t* versioned, uint64_t* version_out) {
+    if (!versioned) {
+        return SSSP_ERROR_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&versioned->lock);
+    version_t* previous = atomic_load(&versioned->current);
+    sssp_error_t result = SSSP_SUCCESS;
+    if (versioned->num_edges > 0 || versioned->num_overrides > 0) {
+        version_t* version = build_version(versioned, previous);
+        if (!version) {
+            result = SSSP_ERROR_OUT_OF_MEMORY;
+        } else {
+            atomic_store(&versioned->current, version);
+            previous->retire_epoch = atomic_fetch_add(&versioned->epoch, 1);
+            previous->next_retired = versioned->retired;
+            versioned->retired = previous;
+
+            versioned->stats.version = version->number;
+            versioned->stats.retained++;
+            versioned->stats.edges_added += versioned->num_edges;
+            versioned->stats.weights_overridden += versioned->num_overrides;
+            versioned->num_edges = 0;
+            versioned->num_overrides = 0;
+            SSSP_LOG_DEBUG("Published graph version %llu (%u edges)",
+                           (unsigned long long)version->number, version->graph.num_edges);
+        }
+    }
+    reclaim(versioned);
+    if (version_out) {
+        *version_out = versioned->stats.version;
+    }
+    pthread_mutex_unlock(&versioned->lock);
+    return result;
+}
+
+sssp_versioned_graph_stats_t sssp_versioned_graph_get_stats(sssp_versioned_graph_t* versioned) {
+    sssp_versioned_graph_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!versioned) {
+        return stats;
+    }
+    pthread_mutex_lock(&versioned->lock);
+    stats = versioned->stats;
+    stats.pending_edges = versioned->num_edges;
+    stats.pending_overrides = versioned->num_overrides;
+    pthread_mutex_unlock(&versioned->lock);
+    return stats;
+}
+
+#else // _WIN32
+
+sssp_error_t sssp_versioned_graph_create(const sssp_graph_t* graph, uint32_t max_readers,
+                                         const sssp_allocator_t* allocator,
+                                         sssp_versioned_graph_t** versioned_out) {
+    (void)graph; (void)max_readers; (void)allocator; (void)versioned_out;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+void sssp_versioned_graph_destroy(sssp_versioned_graph_t* versioned) {
+    (void)versioned;
+}
+
+sssp_error_t sssp_versioned_graph_add_reader(sssp_versioned_graph_t* versioned,
+                                             sssp_graph_reader_t** reader_out) {
+    (void)versioned; (void)reader_out;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+void sssp_versioned_graph_remove_reader(sssp_graph_reader_t* reader) {
+    (void)reader;
+}
+
+const sssp_graph_t* sssp_graph_reader_pin(sssp_graph_reader_t* reader, uint64_t* version_out) {
+    (void)reader; (void)version_out;
+    return NULL;
+}
+
+void sssp_graph_reader_unpin(sssp_graph_reader_t* reader) {
+    (void)reader;
+}
+
+sssp_error_t sssp_versioned_graph_add_edge(sssp_versioned_graph_t* versioned,
+                                           vertex_id_t from, vertex_id_t to, weight_t weight) {
+    (void)versioned; (void)from; (void)to; (void)weight;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_versioned_graph_set_weight(sssp_versioned_graph_t* versioned,
+                                             vertex_id_t from, vertex_id_t to, weight_t weight) {
+    (void)versioned; (void)from; (void)to; (void)weight;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_error_t sssp_versioned_graph_publish(sssp_versioned_graph_t* versioned, uint64_t* version_out) {
+    (void)versioned; (void)version_out;
+    return SSSP_ERROR_NOT_IMPLEMENTED;
+}
+
+sssp_versioned_graph_stats_t sssp_versioned_graph_get_stats(sssp_versioned_graph_t* versioned) {
+    (void)versioned;
+    sssp_versioned_graph_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+#endif // _WIN32
@@ -12,9 +12,24 @@
 #include <string.h>
 #include <stdio.h>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#    define VERTEX_SET_X86_SIMD 1
+#    include <immintrin.h>
+#endif
+
+// Sets with at most this many vertices are probed by linear scan
+#define VERTEX_SET_SCAN_LIMIT 16
+// Arrays with at most this many vertices are sorted by insertion
+#define VERTEX_SET_INSERTION_SORT_LIMIT 32
+// Sorted set algebra gallops through the larger operand beyond this size ratio
+#define VERTEX_SET_GALLOP_RATIO 32
+
 // Internal functions
 static sssp_error_t ensure_capacity(sssp_vertex_set_t* set, vertex_count_t required_capacity);
-static int vertex_compare(const void* a, const void* b);
+static sssp_error_t radix_sort(vertex_id_t* values, vertex_count_t count,
+                               const sssp_allocator_t* allocator);
+static void rebuild_index(sssp_vertex_set_t* set, vertex_count_t begin);
+static void update_sorted(sssp_vertex_set_t* set, vertex_count_t begin);
 
 // Creation and destruction
 sssp_vertex_set_t* sssp_vertex_set_create(vertex_count_t initial_capacity,
@@ -41,17 +56,49 @@ sssp_vertex_set_t* sssp_vertex_set_create(vertex_count_t initial_capacity,
     set->size = 0;
     set->capacity = initial_capacity;
     set->allocator = allocator;
+    set->index = NULL;
+    set->universe = 0;
+    set->sorted = true;
     
     SSSP_LOG_TRACE("Created vertex set with capacity %u", initial_capacity);
     return set;
 }
 
+sssp_vertex_set_t* sssp_vertex_set_create_indexed(vertex_count_t universe,
+                                                   const sssp_allocator_t* allocator) {
+    if (universe == 0) {
+        SSSP_LOG_ERROR("Indexed vertex set needs a non-empty universe");
+        return NULL;
+    }
+    
+    sssp_vertex_set_t* set = sssp_vertex_set_create(universe, allocator);
+    if (!set) return NULL;
+    
+    // Entries are validated against the member array, so stale values are
+    // harmless; zeroing once keeps reads well-defined
+    set->index = (vertex_count_t*)set->allocator->alloc(universe * sizeof(vertex_count_t),
+                                                       set->allocator->context);
+    if (!set->index) {
+        SSSP_LOG_ERROR("Failed to allocate vertex set index");
+        sssp_vertex_set_destroy(set);
+        return NULL;
+    }
+    memset(set->index, 0, universe * sizeof(vertex_count_t));
+    set->universe = universe;
+    
+    SSSP_LOG_TRACE("Created indexed vertex set over %u vertices", universe);
+    return set;
+}
+
 void sssp_vertex_set_destroy(sssp_vertex_set_t* set) {
     if (!set) return;
     
     if (set->vertices) {
         set->allocator->free(set->vertices, set->allocator->context);
     }
+    if (set->index) {
+        set->allocator->free(set->index, set->allocator->context);
+    }
     set->allocator->free(set, set->allocator->context);
     
     SSSP_LOG_TRACE("Destroyed vertex set");
@@ -61,12 +108,14 @@ sssp_error_t sssp_vertex_set_clear(sssp_vertex_set_t* set) {
     if (!set) return SSSP_ERROR_NULL_POINTER;
     
     set->size = 0;
+    set->sorted = true;
     return SSSP_SUCCESS;
 }
 
 // Basic operations
 sssp_error_t sssp_vertex_set_add(sssp_vertex_set_t* set, vertex_id_t vertex) {
     if (!set) return SSSP_ERROR_NULL_POINTER;
+    if (set->index && vertex >= set->universe) return SSSP_ERROR_INVALID_ARGUMENT;
     
     // Check if vertex already exists
     if (sssp_vertex_set_contains(set, vertex)) {
@@ -76,7 +125,11 @@ sssp_error_t sssp_vertex_set_add(sssp_vertex_set_t* set, vertex_id_t vertex) {
     sssp_error_t err = ensure_capacity(set, set->size + 1);
     if (err != SSSP_SUCCESS) return err;
     
+    if (set->index) {
+        set->index[vertex] = set->size;
+    }
     set->vertices[set->size++] = vertex;
+    update_sorted(set, set->size - 1);
     return SSSP_SUCCESS;
 }
 
@@ -94,8 +147,23 @@ sssp_error_t sssp_vertex_set_add_array(sssp_vertex_set_t* set,
     sssp_error_t err = ensure_capacity(set, new_size);
     if (err != SSSP_SUCCESS) return err;
     
+    vertex_count_t old_size = set->size;
+    if (set->index) {
+        // Indexed sets stay duplicate-free: skip members and bad ids
+        for (vertex_count_t i = 0; i < count; i++) {
+            vertex_id_t v = vertices[i];
+            if (v < set->universe && !sssp_vertex_set_contains(set, v)) {
+                set->index[v] = set->size;
+                set->vertices[set->size++] = v;
+            }
+        }
+        update_sorted(set, old_size);
+        return SSSP_SUCCESS;
+    }
+    
     memcpy(set->vertices + set->size, vertices, count * sizeof(vertex_id_t));
     set->size = new_size;
+    update_sorted(set, old_size);
     
     return SSSP_SUCCESS;
 }
@@ -108,6 +176,11 @@ sssp_error_t sssp_vertex_set_remove(sssp_vertex_set_t* set, vertex_id_t vertex)
         return SSSP_ERROR_INVALID_ARGUMENT; // Vertex not found
     }
     
+    // Indexed sets remove in O(1) by moving the last vertex into the hole
+    if (set->index) {
+        return sssp_vertex_set_remove_at(set, index);
+    }
+    
     // Shift remaining elements
     if (index < set->size - 1) {
         memmove(set->vertices + index, 
@@ -125,7 +198,12 @@ sssp_error_t sssp_vertex_set_remove_at(sssp_vertex_set_t* set, vertex_count_t in
     
     // Fast removal: swap with last element
     if (index < set->size - 1) {
-        set->vertices[index] = set->vertices[set->size - 1];
+        vertex_id_t last = set->vertices[set->size - 1];
+        set->vertices[index] = last;
+        if (set->index) {
+            set->index[last] = index;
+        }
+        set->sorted = set->size <= 2;
     }
     set->size--;
     
@@ -141,6 +219,34 @@ bool sssp_vertex_set_find(const sssp_vertex_set_t* set,
                           vertex_count_t* index_out) {
     if (!set) return false;
     
+    if (set->index) {
+        if (vertex >= set->universe) return false;
+        vertex_count_t i = set->index[vertex];
+        if (i < set->size && set->vertices[i] == vertex) {
+            if (index_out) *index_out = i;
+            return true;
+        }
+        return false;
+    }
+    
+    if (set->sorted && set->size > VERTEX_SET_SCAN_LIMIT) {
+        vertex_count_t lo = 0;
+        vertex_count_t hi = set->size;
+        while (lo < hi) {
+            vertex_count_t mid = lo + (hi - lo) / 2;
+            if (set->vertices[mid] < vertex) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < set->size && set->vertices[lo] == vertex) {
+            if (index_out) *index_out = lo;
+            return true;
+        }
+        return false;
+    }
+    
     for (vertex_count_t i = 0; i < set->size; i++) {
         if (set->vertices[i] == vertex) {
             if (index_out) *index_out = i;
@@ -168,60 +274,407 @@ vertex_id_t sssp_vertex_set_get_vertex(const sssp_vertex_set_t* set,
     return set->vertices[index];
 }
 
+// Sorted set kernels
+//
+// Both inputs are strictly ascending. filter_sorted() keeps the vertices of
+// a that are (keep_matched) or are not (!keep_matched) in b, writing them to
+// out, which may alias a: every write lands at or before the element read.
+
+/**
+ * First position p >= lo with values[p] >= key, by exponential then binary search
+ */
+static vertex_count_t gallop(const vertex_id_t* values, vertex_count_t lo,
+                             vertex_count_t count, vertex_id_t key) {
+    vertex_count_t step = 1;
+    vertex_count_t hi = lo;
+    while (hi < count && values[hi] < key) {
+        lo = hi + 1;
+        hi = (count - hi > step) ? hi + step : count;
+        step *= 2;
+    }
+    while (lo < hi) {
+        vertex_count_t mid = lo + (hi - lo) / 2;
+        if (values[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static vertex_count_t filter_gallop(const vertex_id_t* a, vertex_count_t na,
+                                    const vertex_id_t* b, vertex_count_t nb,
+                                    bool keep_matched, vertex_id_t* out) {
+    vertex_count_t k = 0;
+    
+    if (na <= nb) {
+        // Few probes into a large b
+        vertex_count_t pos = 0;
+        for (vertex_count_t i = 0; i < na; i++) {
+            pos = gallop(b, pos, nb, a[i]);
+            bool matched = pos < nb && b[pos] == a[i];
+            if (matched == keep_matched) {
+                out[k++] = a[i];
+            }
+        }
+        return k;
+    }
+    
+    // Few vertices of b to find in a large a; copy the runs between them
+    vertex_count_t ia = 0;
+    for (vertex_count_t j = 0; j < nb && ia < na; j++) {
+        vertex_count_t pos = gallop(a, ia, na, b[j]);
+        bool matched = pos < na && a[pos] == b[j];
+        if (!keep_matched) {
+            memmove(out + k, a + ia, (pos - ia) * sizeof(vertex_id_t));
+            k += pos - ia;
+        } else if (matched) {
+            out[k++] = a[pos];
+        }
+        ia = matched ? pos + 1 : pos;
+    }
+    if (!keep_matched) {
+        memmove(out + k, a + ia, (na - ia) * sizeof(vertex_id_t));
+        k += na - ia;
+    }
+    return k;
+}
+
+/**
+ * Scalar merge from positions (i, j). Bits of pending mark vertices of the
+ * block starting at a[i] already known to be in b.
+ */
+static vertex_count_t filter_scalar(const vertex_id_t* a, vertex_count_t na,
+                                    const vertex_id_t* b, vertex_count_t nb,
+                                    vertex_count_t i, vertex_count_t j, uint32_t pending,
+                                    bool keep_matched, vertex_id_t* out, vertex_count_t k) {
+    const vertex_count_t block = i;
+    while (i < na) {
+        bool matched;
+        if (i - block < 32 && (pending >> (i - block)) & 1u) {
+            matched = true;
+        } else {
+            while (j < nb && b[j] < a[i]) {
+                j++;
+            }
+            matched = j < nb && b[j] == a[i];
+        }
+        if (matched == keep_matched) {
+            out[k++] = a[i];
+        }
+        i++;
+    }
+    return k;
+}
+
+#ifdef VERTEX_SET_X86_SIMD
+/**
+ * Emit the vertices of one block of a whose match bit equals keep_matched
+ */
+static SSSP_INLINE vertex_count_t emit_block(const vertex_id_t* a, uint32_t matched, uint32_t full,
+                                             bool keep_matched, vertex_id_t* out, vertex_count_t k) {
+    uint32_t bits = keep_matched ? matched : (~matched & full);
+    while (bits) {
+        out[k++] = a[__builtin_ctz(bits)];
+        bits &= bits - 1;
+    }
+    return k;
+}
+
+/**
+ * SSE2 (x86-64 baseline) kernel: all-pairs compare of 4x4 blocks
+ */
+static vertex_count_t filter_sse2(const vertex_id_t* a, vertex_count_t na,
+                                  const vertex_id_t* b, vertex_count_t nb,
+                                  bool keep_matched, vertex_id_t* out) {
+    vertex_count_t i = 0, j = 0, k = 0;
+    uint32_t matched = 0;
+    
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i eq = _mm_cmpeq_epi32(va, vb);
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        matched |= (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(eq));
+        
+        vertex_id_t a_max = a[i + 3];
+        vertex_id_t b_max = b[j + 3];
+        if (a_max <= b_max) {
+            k = emit_block(a + i, matched, 0xFu, keep_matched, out, k);
+            matched = 0;
+            i += 4;
+        }
+        if (b_max <= a_max) {
+            j += 4;
+        }
+    }
+    return filter_scalar(a, na, b, nb, i, j, matched, keep_matched, out, k);
+}
+
+/**
+ * AVX2 kernel: all-pairs compare of 8x8 blocks through lane rotations
+ */
+__attribute__((target("avx2")))
+static vertex_count_t filter_avx2(const vertex_id_t* a, vertex_count_t na,
+                                  const vertex_id_t* b, vertex_count_t nb,
+                                  bool keep_matched, vertex_id_t* out) {
+    vertex_count_t i = 0, j = 0, k = 0;
+    uint32_t matched = 0;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i eq = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+        }
+        matched |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        
+        vertex_id_t a_max = a[i + 7];
+        vertex_id_t b_max = b[j + 7];
+        if (a_max <= b_max) {
+            k = emit_block(a + i, matched, 0xFFu, keep_matched, out, k);
+            matched = 0;
+            i += 8;
+        }
+        if (b_max <= a_max) {
+            j += 8;
+        }
+    }
+    return filter_scalar(a, na, b, nb, i, j, matched, keep_matched, out, k);
+}
+#endif
+
+static vertex_count_t filter_sorted(const vertex_id_t* a, vertex_count_t na,
+                                    const vertex_id_t* b, vertex_count_t nb,
+                                    bool keep_matched, vertex_id_t* out) {
+    if (na == 0) return 0;
+    if (nb == 0) {
+        if (!keep_matched && out != a) memmove(out, a, na * sizeof(vertex_id_t));
+        return keep_matched ? 0 : na;
+    }
+    
+    if ((uint64_t)na * VERTEX_SET_GALLOP_RATIO < nb ||
+        (uint64_t)nb * VERTEX_SET_GALLOP_RATIO < na) {
+        return filter_gallop(a, na, b, nb, keep_matched, out);
+    }
+    
+#ifdef VERTEX_SET_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        return filter_avx2(a, na, b, nb, keep_matched, out);
+    }
+    return filter_sse2(a, na, b, nb, keep_matched, out);
+#else
+    return filter_scalar(a, na, b, nb, 0, 0, 0, keep_matched, out, 0);
+#endif
+}
+
+/**
+ * Sorted union into out, which has room for na + nb vertices and must not
+ * alias a or b. The vertices of b missing from a are found by the filter
+ * kernels and parked at the back of out, then merged forward with a; the
+ * merge never overtakes the parked vertices it has yet to read.
+ */
+static vertex_count_t union_sorted(const vertex_id_t* a, vertex_count_t na,
+                                   const vertex_id_t* b, vertex_count_t nb,
+                                   vertex_id_t* out) {
+    vertex_id_t* extra = out + na;
+    vertex_count_t ne = filter_sorted(b, nb, a, na, false, extra);
+    
+    vertex_count_t ia = 0, ie = 0, k = 0;
+    while (ia < na && ie < ne) {
+        bool take_a = a[ia] < extra[ie];
+        out[k++] = take_a ? a[ia] : extra[ie];
+        ia += take_a;
+        ie += !take_a;
+    }
+    memcpy(out + k, a + ia, (na - ia) * sizeof(vertex_id_t));
+    k += na - ia;
+    if (ie < ne) {
+        memmove(out + k, extra + ie, (ne - ie) * sizeof(vertex_id_t));
+        k += ne - ie;
+    }
+    return k;
+}
+
 // Set operations
+
+/**
+ * Membership test against a set for the set operations. Indexed and small
+ * sets are probed directly; other sets through a radix-sorted copy.
+ */
+typedef struct membership {
+    const sssp_vertex_set_t* set;
+    vertex_id_t* sorted;                // NULL when probing the set directly
+} membership_t;
+
+static sssp_error_t membership_init(membership_t* m, const sssp_vertex_set_t* set,
+                                    const sssp_allocator_t* allocator) {
+    m->set = set;
+    m->sorted = NULL;
+    if (set->index || set->size <= VERTEX_SET_SCAN_LIMIT) {
+        return SSSP_SUCCESS;
+    }
+    
+    m->sorted = (vertex_id_t*)allocator->alloc(set->size * sizeof(vertex_id_t), allocator->context);
+    if (!m->sorted) return SSSP_ERROR_OUT_OF_MEMORY;
+    memcpy(m->sorted, set->vertices, set->size * sizeof(vertex_id_t));
+    sssp_error_t err = radix_sort(m->sorted, set->size, allocator);
+    if (err != SSSP_SUCCESS) {
+        allocator->free(m->sorted, allocator->context);
+        m->sorted = NULL;
+    }
+    return err;
+}
+
+static bool membership_test(const membership_t* m, vertex_id_t vertex) {
+    if (!m->sorted) {
+        return sssp_vertex_set_contains(m->set, vertex);
+    }
+    
+    vertex_count_t lo = 0;
+    vertex_count_t hi = m->set->size;
+    while (lo < hi) {
+        vertex_count_t mid = lo + (hi - lo) / 2;
+        if (m->sorted[mid] < vertex) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < m->set->size && m->sorted[lo] == vertex;
+}
+
+static void membership_release(membership_t* m, const sssp_allocator_t* allocator) {
+    if (m->sorted) {
+        allocator->free(m->sorted, allocator->context);
+    }
+}
+
+/**
+ * Keep the vertices of dest whose membership in src equals keep_members
+ */
+static sssp_error_t filter_by_membership(sssp_vertex_set_t* dest, const sssp_vertex_set_t* src,
+                                         bool keep_members) {
+    membership_t m;
+    sssp_error_t err = membership_init(&m, src, dest->allocator);
+    if (err != SSSP_SUCCESS) return err;
+    
+    vertex_count_t write_pos = 0;
+    for (vertex_count_t i = 0; i < dest->size; i++) {
+        if (membership_test(&m, dest->vertices[i]) == keep_members) {
+            dest->vertices[write_pos++] = dest->vertices[i];
+        }
+    }
+    dest->size = write_pos;
+    
+    membership_release(&m, dest->allocator);
+    rebuild_index(dest, 0);
+    return SSSP_SUCCESS;
+}
+
 sssp_error_t sssp_vertex_set_union(sssp_vertex_set_t* dest, 
                                     const sssp_vertex_set_t* src) {
     if (!dest || !src) return SSSP_ERROR_NULL_POINTER;
+    if (src->size == 0) return SSSP_SUCCESS;
     
+    vertex_count_t new_size;
+    if (!sssp_safe_add_vertex_count(dest->size, src->size, &new_size)) {
+        return SSSP_ERROR_OVERFLOW;
+    }
+    
+    if (dest->sorted && src->sorted) {
+        if (dest->index && src->vertices[src->size - 1] >= dest->universe) {
+            return SSSP_ERROR_INVALID_ARGUMENT;
+        }
+        vertex_id_t* merged = (vertex_id_t*)dest->allocator->alloc(new_size * sizeof(vertex_id_t),
+                                                                   dest->allocator->context);
+        if (!merged) return SSSP_ERROR_OUT_OF_MEMORY;
+        
+        dest->size = union_sorted(dest->vertices, dest->size, src->vertices, src->size, merged);
+        if (dest->vertices) {
+            dest->allocator->free(dest->vertices, dest->allocator->context);
+        }
+        dest->vertices = merged;
+        dest->capacity = new_size;
+        rebuild_index(dest, 0);
+        return SSSP_SUCCESS;
+    }
+    
+    sssp_error_t err = ensure_capacity(dest, new_size);
+    if (err != SSSP_SUCCESS) return err;
+    
+    // Probe the original members only; src has no duplicates of its own
+    membership_t m;
+    err = membership_init(&m, dest, dest->allocator);
+    if (err != SSSP_SUCCESS) return err;
+    
+    vertex_count_t original_size = dest->size;
     for (vertex_count_t i = 0; i < src->size; i++) {
-        if (!sssp_vertex_set_contains(dest, src->vertices[i])) {
-            sssp_error_t err = sssp_vertex_set_add(dest, src->vertices[i]);
-            if (err != SSSP_SUCCESS) return err;
+        vertex_id_t v = src->vertices[i];
+        if (dest->index && v >= dest->universe) {
+            err = SSSP_ERROR_INVALID_ARGUMENT;
+            break;
+        }
+        if (dest->index ? !sssp_vertex_set_contains(dest, v) : !membership_test(&m, v)) {
+            if (dest->index) {
+                dest->index[v] = dest->size;
+            }
+            dest->vertices[dest->size++] = v;
         }
     }
     
-    return SSSP_SUCCESS;
+    membership_release(&m, dest->allocator);
+    update_sorted(dest, original_size);
+    return err;
 }
 
 sssp_error_t sssp_vertex_set_intersection(sssp_vertex_set_t* dest, 
                                            const sssp_vertex_set_t* src) {
     if (!dest || !src) return SSSP_ERROR_NULL_POINTER;
     
-    vertex_count_t write_pos = 0;
-    for (vertex_count_t i = 0; i < dest->size; i++) {
-        if (sssp_vertex_set_contains(src, dest->vertices[i])) {
-            dest->vertices[write_pos++] = dest->vertices[i];
-        }
+    if (dest->sorted && src->sorted) {
+        dest->size = filter_sorted(dest->vertices, dest->size, src->vertices, src->size,
+                                   true, dest->vertices);
+        rebuild_index(dest, 0);
+        return SSSP_SUCCESS;
     }
-    dest->size = write_pos;
-    
-    return SSSP_SUCCESS;
+    return filter_by_membership(dest, src, true);
 }
 
 sssp_error_t sssp_vertex_set_difference(sssp_vertex_set_t* dest, 
                                          const sssp_vertex_set_t* src) {
     if (!dest || !src) return SSSP_ERROR_NULL_POINTER;
     
-    vertex_count_t write_pos = 0;
-    for (vertex_count_t i = 0; i < dest->size; i++) {
-        if (!sssp_vertex_set_contains(src, dest->vertices[i])) {
-            dest->vertices[write_pos++] = dest->vertices[i];
-        }
+    if (dest->sorted && src->sorted) {
+        dest->size = filter_sorted(dest->vertices, dest->size, src->vertices, src->size,
+                                   false, dest->vertices);
+        rebuild_index(dest, 0);
+        return SSSP_SUCCESS;
     }
-    dest->size = write_pos;
-    
-    return SSSP_SUCCESS;
+    return filter_by_membership(dest, src, false);
 }
 
 sssp_error_t sssp_vertex_set_copy(sssp_vertex_set_t* dest, 
                                    const sssp_vertex_set_t* src) {
     if (!dest || !src) return SSSP_ERROR_NULL_POINTER;
     
+    if (dest->index) {
+        dest->size = 0;
+        return sssp_vertex_set_add_array(dest, src->vertices, src->size);
+    }
+    
     sssp_error_t err = ensure_capacity(dest, src->size);
     if (err != SSSP_SUCCESS) return err;
     
     memcpy(dest->vertices, src->vertices, src->size * sizeof(vertex_id_t));
     dest->size = src->size;
+    dest->sorted = src->sorted;
     
     return SSSP_SUCCESS;
 }
@@ -259,7 +712,13 @@ sssp_error_t sssp_vertex_set_sort(sssp_vertex_set_t* set) {
     if (!set) return SSSP_ERROR_NULL_POINTER;
     if (set->size <= 1) return SSSP_SUCCESS;
     
-    qsort(set->vertices, set->size, sizeof(vertex_id_t), vertex_compare);
+    sssp_error_t err = radix_sort(set->vertices, set->size, set->allocator);
+    if (err != SSSP_SUCCESS) return err;
+    
+    // Sorted only counts once duplicates are gone too
+    set->sorted = true;
+    update_sorted(set, 0);
+    rebuild_index(set, 0);
     return SSSP_SUCCESS;
 }
 
@@ -282,6 +741,9 @@ sssp_error_t sssp_vertex_set_unique(sssp_vertex_set_t* set) {
     sssp_error_t err = sssp_vertex_set_sort(set);
     if (err != SSSP_SUCCESS) return err;
     
+    // Indexed sets never hold duplicates
+    if (set->index) return SSSP_SUCCESS;
+    
     // Remove duplicates
     vertex_count_t write_pos = 0;
     for (vertex_count_t i = 0; i < set->size; i++) {
@@ -290,6 +752,7 @@ sssp_error_t sssp_vertex_set_unique(sssp_vertex_set_t* set) {
         }
     }
     set->size = write_pos;
+    set->sorted = true;
     
     return SSSP_SUCCESS;
 }
@@ -350,7 +813,12 @@ void sssp_vertex_set_print_stats(const sssp_vertex_set_t* set) {
     printf("Vertex Set Statistics:\n");
     printf("  Size: %u vertices\n", set->size);
     printf("  Capacity: %u vertices\n", set->capacity);
-    printf("  Memory usage: %zu bytes\n", set->capacity * sizeof(vertex_id_t) + sizeof(sssp_vertex_set_t));
+    printf("  Memory usage: %zu bytes\n", set->capacity * sizeof(vertex_id_t) +
+           set->universe * sizeof(vertex_count_t) + sizeof(sssp_vertex_set_t));
+    if (set->index) {
+        printf("  Index universe: %u vertices\n", set->universe);
+    }
+    printf("  Sorted: %s\n", set->sorted ? "yes" : "no");
     printf("  Load factor: %.2f%%\n", set->capacity > 0 ? (100.0 * set->size / set->capacity) : 0.0);
 }
 
@@ -360,6 +828,18 @@ bool sssp_vertex_set_validate(const sssp_vertex_set_t* set) {
     if (set->size > set->capacity) return false;
     if (!set->allocator) return false;
     
+    if (set->index) {
+        for (vertex_count_t i = 0; i < set->size; i++) {
+            vertex_id_t v = set->vertices[i];
+            if (v >= set->universe || set->index[v] != i) return false;
+        }
+    }
+    if (set->sorted) {
+        for (vertex_count_t i = 1; i < set->size; i++) {
+            if (set->vertices[i - 1] >= set->vertices[i]) return false;
+        }
+    }
+    
     return true;
 }
 
@@ -403,11 +883,94 @@ static sssp_error_t ensure_capacity(sssp_vertex_set_t* set, vertex_count_t requi
     return SSSP_SUCCESS;
 }
 
-static int vertex_compare(const void* a, const void* b) {
-    vertex_id_t va = *(const vertex_id_t*)a;
-    vertex_id_t vb = *(const vertex_id_t*)b;
+static void rebuild_index(sssp_vertex_set_t* set, vertex_count_t begin) {
+    if (!set->index) return;
+    
+    for (vertex_count_t i = begin; i < set->size; i++) {
+        set->index[set->vertices[i]] = i;
+    }
+}
+
+/**
+ * Clear the sorted flag unless vertices[begin..size) continue the ascending run
+ */
+static void update_sorted(sssp_vertex_set_t* set, vertex_count_t begin) {
+    if (!set->sorted) return;
+    
+    for (vertex_count_t i = SSSP_MAX(begin, 1); i < set->size; i++) {
+        if (set->vertices[i - 1] >= set->vertices[i]) {
+            set->sorted = false;
+            return;
+        }
+    }
+}
+
+static void insertion_sort(vertex_id_t* values, vertex_count_t count) {
+    for (vertex_count_t i = 1; i < count; i++) {
+        vertex_id_t v = values[i];
+        vertex_count_t j = i;
+        while (j > 0 && values[j - 1] > v) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = v;
+    }
+}
+
+/**
+ * LSD radix sort on 8-bit digits. Passes whose digit is the same for every
+ * key are skipped, so small vertex ids cost one or two passes.
+ */
+static sssp_error_t radix_sort(vertex_id_t* values, vertex_count_t count,
+                               const sssp_allocator_t* allocator) {
+    if (count <= VERTEX_SET_INSERTION_SORT_LIMIT) {
+        insertion_sort(values, count);
+        return SSSP_SUCCESS;
+    }
     
-    if (va < vb) return -1;
-    if (va > vb) return 1;
-    return 0;
+    vertex_id_t* buffer = (vertex_id_t*)allocator->alloc(count * sizeof(vertex_id_t),
+                                                         allocator->context);
+    if (!buffer) return SSSP_ERROR_OUT_OF_MEMORY;
+    
+    // Histograms for all four digits in one pass over the input
+    vertex_count_t counts[4][256];
+    memset(counts, 0, sizeof(counts));
+    for (vertex_count_t i = 0; i < count; i++) {
+        vertex_id_t v = values[i];
+        counts[0][v & 0xFF]++;
+        counts[1][(v >> 8) & 0xFF]++;
+        counts[2][(v >> 16) & 0xFF]++;
+        counts[3][v >> 24]++;
+    }
+    
+    vertex_id_t* src = values;
+    vertex_id_t* dst = buffer;
+    for (int pass = 0; pass < 4; pass++) {
+        const unsigned shift = 8u * (unsigned)pass;
+        vertex_count_t* hist = counts[pass];
+        if (hist[(src[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+        
+        vertex_count_t offset = 0;
+        for (int d = 0; d < 256; d++) {
+            vertex_count_t c = hist[d];
+            hist[d] = offset;
+            offset += c;
+        }
+        for (vertex_count_t i = 0; i < count; i++) {
+            vertex_id_t v = src[i];
+            dst[hist[(v >> shift) & 0xFF]++] = v;
+        }
+        
+        vertex_id_t* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    
+    if (src != values) {
+        memcpy(values, src, count * sizeof(vertex_id_t));
+    }
+    allocator->free(buffer, allocator->context);
+    return SSSP_SUCCESS;
 }
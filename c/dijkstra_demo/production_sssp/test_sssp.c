@@ -13,11 +13,24 @@
 #include "find_pivots.h"
 #include "vertex_set.h"
 #include "sssp_common.h"
+#include "profiler.h"
+#include "implicit_graph.h"
+#include "relax_kernels.h"
+#include "all_pairs.h"
+#include "negative_weights.h"
+#include "distributed.h"
+#include "sssp_server.h"
+#include "snapshot.h"
+#include "versioned_graph.h"
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
 
 #define TEST_ASSERT(condition, message) \
     do { \
@@ -84,6 +97,170 @@ static bool test_vertex_set() {
     return true;
 }
 
+/**
+ * Test indexed vertex sets, linear-time set operations and radix sort
+ */
+static bool test_indexed_vertex_set() {
+    const vertex_count_t n = 5000;
+    sssp_vertex_set_t* set = sssp_vertex_set_create_indexed(n, NULL);
+    sssp_vertex_set_t* plain = sssp_vertex_set_create(0, NULL);
+    TEST_ASSERT(set != NULL && plain != NULL, "Failed to create vertex sets");
+    TEST_ASSERT(sssp_vertex_set_is_indexed(set), "Set should be indexed");
+    TEST_ASSERT(!sssp_vertex_set_is_indexed(plain), "Set should not be indexed");
+    TEST_ASSERT(sssp_vertex_set_create_indexed(0, NULL) == NULL, "Empty universe should fail");
+    
+    // Add every vertex in a scrambled order; both sets must agree
+    for (vertex_count_t i = 0; i < n; i++) {
+        vertex_id_t v = (i * 7919u) % n;
+        TEST_ASSERT(sssp_vertex_set_add(set, v) == SSSP_SUCCESS, "Failed to add vertex");
+        TEST_ASSERT(sssp_vertex_set_add(plain, v) == SSSP_SUCCESS, "Failed to add vertex");
+    }
+    TEST_ASSERT(sssp_vertex_set_add(set, 17) == SSSP_ERROR_INVALID_PARAMETER,
+                "Adding duplicate vertex should fail");
+    TEST_ASSERT(sssp_vertex_set_add(set, n) == SSSP_ERROR_INVALID_ARGUMENT,
+                "Adding vertex outside the universe should fail");
+    TEST_ASSERT(!sssp_vertex_set_contains(set, n), "Set should not contain vertex outside universe");
+    
+    // Remove the odd vertices
+    for (vertex_id_t v = 1; v < n; v += 2) {
+        TEST_ASSERT(sssp_vertex_set_remove(set, v) == SSSP_SUCCESS, "Failed to remove vertex");
+    }
+    TEST_ASSERT(sssp_vertex_set_size(set) == n / 2, "Half of the vertices should remain");
+    TEST_ASSERT(sssp_vertex_set_validate(set), "Index should be consistent after removals");
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(sssp_vertex_set_contains(set, v) == (v % 2 == 0), "Wrong membership after removal");
+    }
+    
+    // add_array skips members instead of duplicating them
+    vertex_id_t again[3] = { 0, 1, 1 };
+    TEST_ASSERT(sssp_vertex_set_add_array(set, again, 3) == SSSP_SUCCESS, "add_array failed");
+    TEST_ASSERT(sssp_vertex_set_size(set) == n / 2 + 1, "add_array should skip members");
+    
+    // plain \ set leaves odd vertices except 1, in plain's order
+    TEST_ASSERT(sssp_vertex_set_difference(plain, set) == SSSP_SUCCESS, "Difference failed");
+    TEST_ASSERT(sssp_vertex_set_size(plain) == n / 2 - 1, "Wrong difference size");
+    for (vertex_count_t i = 0; i < sssp_vertex_set_size(plain); i++) {
+        vertex_id_t v = sssp_vertex_set_get_vertex(plain, i);
+        TEST_ASSERT(v % 2 == 1 && v != 1, "Wrong vertex in difference");
+    }
+    
+    // set ∪ plain is everything; set ∩ {evens} via a large plain probe set
+    TEST_ASSERT(sssp_vertex_set_union(set, plain) == SSSP_SUCCESS, "Union failed");
+    TEST_ASSERT(sssp_vertex_set_size(set) == n, "Union should cover the universe");
+    sssp_vertex_set_clear(plain);
+    for (vertex_id_t v = n; v-- > 0;) {
+        if (v % 2 == 0) sssp_vertex_set_add_array(plain, &v, 1);
+    }
+    TEST_ASSERT(sssp_vertex_set_intersection(set, plain) == SSSP_SUCCESS, "Intersection failed");
+    TEST_ASSERT(sssp_vertex_set_size(set) == n / 2, "Wrong intersection size");
+    TEST_ASSERT(sssp_vertex_set_validate(set), "Index should be consistent after intersection");
+    
+    // Radix sort, including ids that need all four digit passes
+    TEST_ASSERT(sssp_vertex_set_sort(set) == SSSP_SUCCESS, "Sort failed");
+    for (vertex_count_t i = 0; i < sssp_vertex_set_size(set); i++) {
+        TEST_ASSERT(sssp_vertex_set_get_vertex(set, i) == 2 * i, "Indexed set not sorted");
+    }
+    TEST_ASSERT(sssp_vertex_set_validate(set), "Index should be consistent after sort");
+    
+    sssp_vertex_set_clear(plain);
+    for (vertex_count_t i = 0; i < 1000; i++) {
+        vertex_id_t v = (vertex_id_t)(((uint64_t)i * 2654435761u) & SSSP_MAX_VERTICES);
+        sssp_vertex_set_add_array(plain, &v, 1);
+        sssp_vertex_set_add_array(plain, &v, 1);
+    }
+    TEST_ASSERT(sssp_vertex_set_unique(plain) == SSSP_SUCCESS, "Unique failed");
+    TEST_ASSERT(sssp_vertex_set_size(plain) == 1000, "Unique should drop duplicates");
+    for (vertex_count_t i = 1; i < sssp_vertex_set_size(plain); i++) {
+        TEST_ASSERT(sssp_vertex_set_get_vertex(plain, i - 1) < sssp_vertex_set_get_vertex(plain, i),
+                    "Plain set not sorted");
+    }
+    
+    sssp_vertex_set_destroy(plain);
+    sssp_vertex_set_destroy(set);
+    TEST_PASS("test_indexed_vertex_set");
+    return true;
+}
+
+/**
+ * Fill set with a random strictly ascending subset of [0, universe)
+ */
+static void fill_sorted_subset(sssp_vertex_set_t* set, vertex_count_t universe,
+                               vertex_count_t count, uint32_t* seed) {
+    sssp_vertex_set_clear(set);
+    for (vertex_count_t i = 0; i < count; i++) {
+        *seed = *seed * 1664525u + 1013904223u;
+        vertex_id_t v = (*seed >> 8) % universe;
+        sssp_vertex_set_add_array(set, &v, 1);
+    }
+    sssp_vertex_set_unique(set);
+}
+
+/**
+ * Test the sorted set algebra kernels against a membership table
+ */
+static bool test_sorted_vertex_set() {
+    const vertex_count_t universe = 4096;
+    const vertex_count_t sizes[][2] = {
+        { 0, 100 }, { 100, 0 }, { 5, 3000 }, { 3000, 5 },
+        { 1000, 1000 }, { 997, 1003 }, { 3500, 3500 }, { 13, 11 }
+    };
+    sssp_vertex_set_t* a = sssp_vertex_set_create(0, NULL);
+    sssp_vertex_set_t* b = sssp_vertex_set_create(0, NULL);
+    sssp_vertex_set_t* r = sssp_vertex_set_create(0, NULL);
+    bool* in_a = calloc(universe, sizeof(bool));
+    bool* in_b = calloc(universe, sizeof(bool));
+    TEST_ASSERT(a && b && r && in_a && in_b, "Failed to allocate test sets");
+    
+    TEST_ASSERT(sssp_vertex_set_is_sorted(a), "Empty set should be sorted");
+    vertex_id_t descending[2] = { 9, 3 };
+    sssp_vertex_set_add_array(r, descending, 2);
+    TEST_ASSERT(!sssp_vertex_set_is_sorted(r), "Descending set should not be sorted");
+    sssp_vertex_set_sort(r);
+    TEST_ASSERT(sssp_vertex_set_is_sorted(r), "Set should be sorted after sort");
+    
+    uint32_t seed = 12345;
+    for (size_t c = 0; c < sizeof(sizes) / sizeof(sizes[0]); c++) {
+        fill_sorted_subset(a, universe, sizes[c][0], &seed);
+        fill_sorted_subset(b, universe, sizes[c][1], &seed);
+        TEST_ASSERT(sssp_vertex_set_is_sorted(a) && sssp_vertex_set_is_sorted(b),
+                    "Sets should be sorted after unique");
+        memset(in_a, 0, universe * sizeof(bool));
+        memset(in_b, 0, universe * sizeof(bool));
+        for (vertex_count_t i = 0; i < a->size; i++) in_a[a->vertices[i]] = true;
+        for (vertex_count_t i = 0; i < b->size; i++) in_b[b->vertices[i]] = true;
+        
+        for (int op = 0; op < 3; op++) {
+            sssp_vertex_set_copy(r, a);
+            sssp_error_t err = op == 0 ? sssp_vertex_set_intersection(r, b) :
+                               op == 1 ? sssp_vertex_set_difference(r, b) :
+                                         sssp_vertex_set_union(r, b);
+            TEST_ASSERT(err == SSSP_SUCCESS, "Sorted set operation failed");
+            TEST_ASSERT(sssp_vertex_set_is_sorted(r) && sssp_vertex_set_validate(r),
+                        "Sorted set operation should keep the result sorted");
+            
+            vertex_count_t expected = 0;
+            for (vertex_id_t v = 0; v < universe; v++) {
+                bool want = op == 0 ? (in_a[v] && in_b[v]) :
+                            op == 1 ? (in_a[v] && !in_b[v]) : (in_a[v] || in_b[v]);
+                if (want) {
+                    TEST_ASSERT(expected < r->size && r->vertices[expected] == v,
+                                "Sorted set operation gave the wrong vertices");
+                    expected++;
+                }
+            }
+            TEST_ASSERT(r->size == expected, "Sorted set operation gave the wrong size");
+        }
+    }
+    
+    free(in_b);
+    free(in_a);
+    sssp_vertex_set_destroy(r);
+    sssp_vertex_set_destroy(b);
+    sssp_vertex_set_destroy(a);
+    TEST_PASS("test_sorted_vertex_set");
+    return true;
+}
+
 /**
  * Test graph operations
  */
@@ -129,6 +306,361 @@ static bool test_graph() {
     return true;
 }
 
+/**
+ * Check that two CSR graphs are identical
+ */
+static bool same_csr_graph(const sssp_graph_t* a, const sssp_graph_t* b) {
+    if (a->num_vertices != b->num_vertices || a->num_edges != b->num_edges) return false;
+    if (memcmp(a->csr_offsets, b->csr_offsets, (a->num_vertices + 1) * sizeof(edge_count_t)) != 0) {
+        return false;
+    }
+    return memcmp(a->csr_targets, b->csr_targets, a->num_edges * sizeof(vertex_id_t)) == 0 &&
+           memcmp(a->csr_weights, b->csr_weights, a->num_edges * sizeof(weight_t)) == 0;
+}
+
+/**
+ * Test the synthetic graph generators
+ */
+static bool test_graph_generators() {
+    // G(n,m): exact edge count, no self-loops or duplicates, weights in range
+    sssp_graph_t* gnm = sssp_graph_generate_gnm(2000, 20000, 1.0, 2.0, 7, NULL);
+    TEST_ASSERT(gnm != NULL, "Failed to generate G(n,m) graph");
+    TEST_ASSERT(sssp_graph_is_csr(gnm), "Generated graph should use CSR storage");
+    TEST_ASSERT(sssp_graph_get_edge_count(gnm) == 20000, "G(n,m) should have exactly m edges");
+    for (vertex_id_t u = 0; u < 2000; u++) {
+        for (edge_count_t e = gnm->csr_offsets[u]; e < gnm->csr_offsets[u + 1]; e++) {
+            TEST_ASSERT(gnm->csr_targets[e] != u, "G(n,m) should have no self-loops");
+            TEST_ASSERT(e == gnm->csr_offsets[u] || gnm->csr_targets[e] > gnm->csr_targets[e - 1],
+                        "G(n,m) rows should be sorted without duplicates");
+            TEST_ASSERT(gnm->csr_weights[e] >= 1.0 && gnm->csr_weights[e] < 2.0,
+                        "G(n,m) weights should be in range");
+        }
+    }
+    
+    // Same seed, different thread counts: identical graphs
+    unsigned int threads = sssp_get_num_threads();
+    sssp_set_num_threads(1);
+    sssp_graph_t* serial = sssp_graph_generate_rmat(12, 40000, 0.57, 0.19, 0.19, 1.0, 10.0, 3, NULL);
+    sssp_graph_t* serial_gnm = sssp_graph_generate_gnm(2000, 20000, 1.0, 2.0, 7, NULL);
+    sssp_set_num_threads(4);
+    sssp_graph_t* parallel = sssp_graph_generate_rmat(12, 40000, 0.57, 0.19, 0.19, 1.0, 10.0, 3, NULL);
+    sssp_set_num_threads(threads);
+    TEST_ASSERT(serial && parallel && serial_gnm, "Failed to generate graphs");
+    TEST_ASSERT(sssp_graph_get_edge_count(serial) == 40000, "R-MAT should have exactly m edges");
+    TEST_ASSERT(same_csr_graph(serial, parallel), "R-MAT output should not depend on thread count");
+    TEST_ASSERT(same_csr_graph(serial_gnm, gnm), "G(n,m) output should not depend on thread count");
+    
+    // G(n,p) extremes
+    sssp_graph_t* empty = sssp_graph_generate_random(50, 0.0, 1.0, 1.0, 1, NULL);
+    sssp_graph_t* complete = sssp_graph_generate_random(50, 1.0, 1.0, 1.0, 1, NULL);
+    TEST_ASSERT(empty && complete, "Failed to generate G(n,p) graphs");
+    TEST_ASSERT(sssp_graph_get_edge_count(empty) == 0, "G(n,0) should have no edges");
+    TEST_ASSERT(sssp_graph_get_edge_count(complete) == 50 * 49, "G(n,1) should be complete");
+    
+    // Grids: 4-neighbor 2D degree sum and 26-neighbor 3D corner degree
+    sssp_graph_t* grid = sssp_graph_generate_grid(10, 20, false, NULL);
+    sssp_graph_t* cube = sssp_graph_generate_grid_3d(4, 4, 4, true, 1.0, 1.0, 0, NULL);
+    TEST_ASSERT(grid && cube, "Failed to generate grids");
+    TEST_ASSERT(sssp_graph_get_edge_count(grid) == 2 * (10 * 19 + 9 * 20), "Wrong grid edge count");
+    TEST_ASSERT(sssp_graph_out_degree(cube, 0) == 7, "3D corner should have 7 neighbors");
+    TEST_ASSERT(sssp_graph_out_degree(cube, 1 + 4 + 16) == 26, "3D interior should have 26 neighbors");
+    
+    // Geometric graphs are symmetric with distance weights
+    sssp_graph_t* geo = sssp_graph_generate_geometric(3000, 0.03, 5, NULL);
+    TEST_ASSERT(geo != NULL && sssp_graph_get_edge_count(geo) > 0, "Failed to generate geometric graph");
+    TEST_ASSERT(sssp_graph_get_edge_count(geo) % 2 == 0, "Geometric graph should be symmetric");
+    for (edge_count_t e = 0; e < geo->num_edges; e++) {
+        TEST_ASSERT(geo->csr_weights[e] <= 0.03, "Geometric edge longer than radius");
+    }
+    
+    // Solving on CSR storage matches solving after conversion to lists
+    sssp_algorithm_result_t* csr_result = sssp_algorithm_result_create(2000, NULL);
+    sssp_algorithm_result_t* list_result = sssp_algorithm_result_create(2000, NULL);
+    TEST_ASSERT(csr_result && list_result, "Failed to create results");
+    TEST_ASSERT(sssp_solve_single_source(gnm, 0, NULL, csr_result) == SSSP_SUCCESS,
+                "Failed to solve on CSR graph");
+    TEST_ASSERT(sssp_graph_add_edge(gnm, 0, 0, 1.0) == SSSP_SUCCESS,
+                "Adding an edge to a CSR graph should convert it");
+    TEST_ASSERT(!sssp_graph_is_csr(gnm), "Mutated graph should use list storage");
+    TEST_ASSERT(sssp_graph_out_degree(gnm, 0) == serial_gnm->csr_offsets[1] + 1,
+                "Conversion should keep existing edges");
+    TEST_ASSERT(sssp_solve_single_source(gnm, 0, NULL, list_result) == SSSP_SUCCESS,
+                "Failed to solve on converted graph");
+    for (vertex_id_t v = 0; v < 2000; v++) {
+        TEST_ASSERT(csr_result->distances[v] == list_result->distances[v],
+                    "CSR and list storage should give the same distances");
+    }
+    
+    sssp_algorithm_result_destroy(csr_result);
+    sssp_algorithm_result_destroy(list_result);
+    sssp_graph_destroy(geo);
+    sssp_graph_destroy(cube);
+    sssp_graph_destroy(grid);
+    sssp_graph_destroy(complete);
+    sssp_graph_destroy(empty);
+    sssp_graph_destroy(parallel);
+    sssp_graph_destroy(serial);
+    sssp_graph_destroy(serial_gnm);
+    sssp_graph_destroy(gnm);
+    TEST_PASS("test_graph_generators");
+    return true;
+}
+
+/**
+ * Test in-edges against the out-edges they transpose
+ */
+static bool test_reverse_graph() {
+    const vertex_count_t n = 10000;     // Several target blocks
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 60000, 1.0, 10.0, 47, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to generate graph");
+    TEST_ASSERT(graph->reverse_offsets == NULL, "In-edges should not be built up front");
+    
+    edge_count_t total = 0;
+    for (vertex_id_t v = 0; v < n; v++) {
+        const vertex_id_t* sources = NULL;
+        const weight_t* weights = NULL;
+        vertex_count_t degree = sssp_graph_in_edges(graph, v, &sources, &weights);
+        TEST_ASSERT(degree == sssp_graph_in_degree(graph, v), "In-edge count should match in-degree");
+        total += degree;
+        for (vertex_count_t i = 0; i < degree; i++) {
+            vertex_id_t u = sources[i];
+            TEST_ASSERT(i == 0 || sources[i - 1] <= u, "In-edges should be sorted by source");
+            bool found = false;
+            for (edge_count_t e = graph->csr_offsets[u]; e < graph->csr_offsets[u + 1] && !found; e++) {
+                found = graph->csr_targets[e] == v && graph->csr_weights[e] == weights[i];
+            }
+            TEST_ASSERT(found, "Every in-edge should be an out-edge of its source");
+        }
+    }
+    TEST_ASSERT(total == graph->num_edges, "In-degrees should add up to the edge count");
+    TEST_ASSERT(sssp_graph_in_degree(graph, n) == 0, "Invalid vertex should have in-degree 0");
+    sssp_graph_destroy(graph);
+    
+    // List-backed graph; adding an edge drops the in-edges until next use
+    sssp_graph_t* list = sssp_graph_create(4, NULL);
+    TEST_ASSERT(list != NULL, "Failed to create graph");
+    sssp_graph_add_edge(list, 2, 1, 3.0);
+    sssp_graph_add_edge(list, 0, 1, 1.0);
+    sssp_graph_add_edge(list, 3, 1, 2.0);
+    const vertex_id_t* sources = NULL;
+    const weight_t* weights = NULL;
+    TEST_ASSERT(sssp_graph_in_edges(list, 1, &sources, &weights) == 3 && sources[0] == 0 && weights[0] == 1.0 &&
+                sources[1] == 2 && sources[2] == 3 && weights[2] == 2.0, "Wrong in-edges of list graph");
+    TEST_ASSERT(sssp_graph_in_edges(list, 0, &sources, NULL) == 0 && sources == NULL, "Vertex 0 has no in-edges");
+    sssp_graph_add_edge(list, 1, 0, 5.0);
+    TEST_ASSERT(list->reverse_offsets == NULL, "Adding an edge should drop the in-edges");
+    TEST_ASSERT(sssp_graph_in_degree(list, 0) == 1 && sssp_graph_in_degree(list, 1) == 3,
+                "In-degrees should follow the change");
+    sssp_graph_destroy(list);
+    
+    TEST_PASS("test_reverse_graph");
+    return true;
+}
+
+/**
+ * Test contiguous neighbor access and the edge iterator over it
+ */
+typedef struct first_use_solve {
+    const sssp_graph_t* graph;
+    sssp_algorithm_result_t* result;
+    sssp_error_t error;
+} first_use_solve_t;
+
+static void* solve_on_first_use(void* arg) {
+    first_use_solve_t* solve = arg;
+    solve->error = sssp_solve_single_source(solve->graph, 0, NULL, solve->result);
+    return NULL;
+}
+
+static bool test_graph_neighbors() {
+    // List-backed graph: arrays follow list order and survive until the next edge
+    sssp_graph_t* graph = sssp_graph_create(4, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to create graph");
+    sssp_graph_add_edge(graph, 0, 1, 1.0);
+    sssp_graph_add_edge(graph, 0, 2, 4.0);
+    sssp_graph_add_edge(graph, 2, 3, 2.0);
+    TEST_ASSERT(!sssp_graph_is_csr(graph), "Graph should start list-backed");
+    
+    const vertex_id_t* targets = NULL;
+    const weight_t* weights = NULL;
+    edge_count_t degree = 0;
+    TEST_ASSERT(sssp_graph_neighbors(graph, 0, &targets, &weights, &degree) == SSSP_SUCCESS,
+                "Neighbors of a list graph should be available");
+    const sssp_edge_node_t* node = graph->adj_list[0].head;
+    for (edge_count_t i = 0; i < degree; i++, node = node->next) {
+        TEST_ASSERT(node && targets[i] == node->to && weights[i] == node->weight,
+                    "Neighbor arrays should follow list order");
+    }
+    TEST_ASSERT(degree == 2 && node == NULL, "Vertex 0 should have 2 neighbors");
+    TEST_ASSERT(sssp_graph_neighbors(graph, 3, &targets, NULL, &degree) == SSSP_SUCCESS && degree == 0,
+                "Vertex 3 has no neighbors");
+    TEST_ASSERT(sssp_graph_neighbors(graph, 4, &targets, &weights, &degree) == SSSP_ERROR_INVALID_PARAMETER,
+                "Invalid vertex should be rejected");
+    
+    sssp_edge_iterator_t iter;
+    const sssp_edge_node_t* edge = NULL;
+    TEST_ASSERT(sssp_edge_iterator_init(graph, 2, &iter) == SSSP_SUCCESS, "Failed to start iterator");
+    TEST_ASSERT(sssp_edge_iterator_next(&iter, &edge) && edge->to == 3 && edge->weight == 2.0,
+                "Iterator should hand out the edge 2 -> 3");
+    TEST_ASSERT(!sssp_edge_iterator_next(&iter, &edge), "Iterator should stop after the last edge");
+    
+    sssp_graph_add_edge(graph, 3, 0, 1.5);
+    TEST_ASSERT(!sssp_graph_is_csr(graph), "Adding an edge should drop the arrays");
+    TEST_ASSERT(sssp_graph_neighbors(graph, 3, &targets, &weights, &degree) == SSSP_SUCCESS &&
+                degree == 1 && targets[0] == 0 && weights[0] == 1.5, "Arrays should follow the change");
+    
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(4, NULL);
+    TEST_ASSERT(result != NULL, "Failed to create result");
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, NULL, result) == SSSP_SUCCESS, "Solve failed");
+    TEST_ASSERT(result->distances[3] == 6.0, "Distance to vertex 3 should be 6");
+    sssp_algorithm_result_destroy(result);
+    sssp_graph_destroy(graph);
+    
+    // CSR graph: arrays point straight into the CSR storage
+    sssp_graph_t* gnm = sssp_graph_generate_gnm(1000, 8000, 1.0, 10.0, 45, NULL);
+    TEST_ASSERT(gnm != NULL, "Failed to generate graph");
+    edge_count_t total = 0;
+    for (vertex_id_t v = 0; v < gnm->num_vertices; v++) {
+        TEST_ASSERT(sssp_graph_neighbors(gnm, v, &targets, &weights, &degree) == SSSP_SUCCESS &&
+                    targets == gnm->csr_targets + gnm->csr_offsets[v] &&
+                    degree == sssp_graph_out_degree(gnm, v), "Wrong neighbors of CSR graph");
+        TEST_ASSERT(sssp_edge_iterator_init(gnm, v, &iter) == SSSP_SUCCESS, "Failed to start iterator");
+        edge_count_t i = 0;
+        while (sssp_edge_iterator_next(&iter, &edge)) {
+            TEST_ASSERT(i < degree && edge->to == targets[i] && edge->weight == weights[i],
+                        "Iterator should follow the neighbor arrays");
+            i++;
+        }
+        TEST_ASSERT(i == degree, "Iterator should visit every edge");
+        total += degree;
+    }
+    TEST_ASSERT(total == gnm->num_edges, "Degrees should add up to the edge count");
+    sssp_graph_destroy(gnm);
+    
+    // Concurrent first solves on a list-backed graph build its arrays once
+    const vertex_count_t n = 3000;
+    sssp_graph_t* list = sssp_graph_create(n, NULL);
+    TEST_ASSERT(list != NULL, "Failed to create graph");
+    for (vertex_id_t v = 0; v < n; v++) {
+        sssp_graph_add_edge(list, v, (v + 1) % n, 1.0);
+        sssp_graph_add_edge(list, v, (v * 7 + 3) % n, 5.0);
+    }
+    first_use_solve_t solves[4];
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        solves[i].graph = list;
+        solves[i].result = sssp_algorithm_result_create(n, NULL);
+        TEST_ASSERT(solves[i].result != NULL, "Failed to create result");
+    }
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(pthread_create(&threads[i], NULL, solve_on_first_use, &solves[i]) == 0,
+                    "Failed to start solve thread");
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    TEST_ASSERT(sssp_graph_is_csr(list), "The first solves should leave the arrays built");
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(solves[i].error == SSSP_SUCCESS, "Concurrent first solve failed");
+        TEST_ASSERT(memcmp(solves[i].result->distances, solves[0].result->distances,
+                           n * sizeof(distance_t)) == 0, "Concurrent first solves should agree");
+    }
+    for (int i = 0; i < 4; i++) {
+        sssp_algorithm_result_destroy(solves[i].result);
+    }
+    sssp_graph_destroy(list);
+    
+    TEST_PASS("test_graph_neighbors");
+    return true;
+}
+
+/**
+ * Neighbors of a directed cycle 0 -> 1 -> ... -> n-1 -> 0 with weight 2
+ */
+static vertex_count_t cycle_neighbors(const sssp_implicit_graph_t* graph, vertex_id_t vertex,
+                                      vertex_id_t* targets, weight_t* weights) {
+    targets[0] = (vertex + 1) % graph->num_vertices;
+    weights[0] = 2.0;
+    return 1;
+}
+
+/**
+ * Test searches over implicit graphs
+ */
+static bool test_implicit_graph() {
+    // Implicit grid agrees with the materialized grid
+    const vertex_count_t rows = 30, cols = 40, n = rows * cols;
+    sssp_graph_t* explicit_grid = sssp_graph_generate_grid(rows, cols, true, NULL);
+    sssp_implicit_graph_t* grid = sssp_implicit_grid_create(rows, cols, true, NULL, NULL);
+    sssp_algorithm_result_t* expected = sssp_algorithm_result_create(n, NULL);
+    distance_t* distances = malloc(n * sizeof(distance_t));
+    vertex_id_t* predecessors = malloc(n * sizeof(vertex_id_t));
+    TEST_ASSERT(explicit_grid && grid && expected && distances && predecessors,
+                "Failed to set up implicit grid test");
+    TEST_ASSERT(grid->max_degree == 8, "Diagonal grid should have degree 8");
+    TEST_ASSERT(sssp_solve_single_source(explicit_grid, 5, NULL, expected) == SSSP_SUCCESS,
+                "Failed to solve explicit grid");
+    
+    sssp_implicit_stats_t stats;
+    TEST_ASSERT(sssp_implicit_solve(grid, 5, SSSP_INVALID_VERTEX, SSSP_INFINITY,
+                                    distances, predecessors, &stats) == SSSP_SUCCESS,
+                "Failed to solve implicit grid");
+    TEST_ASSERT(stats.vertices_settled == n, "Every grid cell should be settled");
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(fabs(distances[v] - expected->distances[v]) < 1e-9,
+                    "Implicit and explicit grid distances should match");
+    }
+    TEST_ASSERT(predecessors[5] == SSSP_INVALID_VERTEX, "Source should have no predecessor");
+    
+    // Early exit at a target settles fewer vertices with the same distance
+    const vertex_id_t target = 7 * cols + 9;
+    TEST_ASSERT(sssp_implicit_solve(grid, 5, target, SSSP_INFINITY,
+                                    distances, NULL, &stats) == SSSP_SUCCESS,
+                "Failed targeted implicit search");
+    TEST_ASSERT(stats.vertices_settled < n, "Targeted search should stop early");
+    TEST_ASSERT(fabs(distances[target] - expected->distances[target]) < 1e-9,
+                "Targeted search should find the shortest distance");
+    
+    // A wall of blocked cells with one gap forces a detour
+    weight_t* costs = malloc(25 * sizeof(weight_t));
+    TEST_ASSERT(costs != NULL, "Failed to allocate cell costs");
+    for (int i = 0; i < 25; i++) costs[i] = 1.0;
+    for (int r = 0; r < 4; r++) costs[r * 5 + 2] = SSSP_INFINITY;   // Column 2 open only at row 4
+    sssp_implicit_graph_t* maze = sssp_implicit_grid_create(5, 5, false, costs, NULL);
+    TEST_ASSERT(maze != NULL, "Failed to create grid with cell costs");
+    TEST_ASSERT(sssp_implicit_solve(maze, 0, SSSP_INVALID_VERTEX, SSSP_INFINITY,
+                                    distances, NULL, NULL) == SSSP_SUCCESS,
+                "Failed to solve grid with blocked cells");
+    TEST_ASSERT(distances[4] == 12.0, "Path should detour through the gap");
+    TEST_ASSERT(distances[2] == SSSP_INFINITY, "Blocked cell should be unreachable");
+    
+    // User-defined graph through the vtable, with a distance bound
+    static const sssp_implicit_graph_ops_t cycle_ops = { cycle_neighbors, NULL };
+    sssp_implicit_graph_t cycle = { &cycle_ops, 100, 1, NULL };
+    TEST_ASSERT(sssp_implicit_solve(&cycle, 10, SSSP_INVALID_VERTEX, 50.0,
+                                    distances, predecessors, &stats) == SSSP_SUCCESS,
+                "Failed to solve user-defined implicit graph");
+    TEST_ASSERT(distances[9] == SSSP_INFINITY && distances[35] == 50.0 && distances[36] == SSSP_INFINITY,
+                "Distance bound should limit the search");
+    TEST_ASSERT(predecessors[35] == 34, "Wrong predecessor on cycle");
+    TEST_ASSERT(sssp_implicit_solve(&cycle, 100, SSSP_INVALID_VERTEX, SSSP_INFINITY,
+                                    distances, NULL, NULL) == SSSP_ERROR_INVALID_ARGUMENT,
+                "Out-of-range source should be rejected");
+    TEST_ASSERT(sssp_implicit_grid_create(65536, 65536, false, NULL, NULL) == NULL,
+                "Grid beyond the vertex id range should be rejected");
+    
+    sssp_implicit_graph_destroy(&cycle);   // No destroy operation: no-op
+    sssp_implicit_graph_destroy(maze);
+    sssp_implicit_graph_destroy(grid);
+    sssp_algorithm_result_destroy(expected);
+    sssp_graph_destroy(explicit_grid);
+    free(costs);
+    free(predecessors);
+    free(distances);
+    TEST_PASS("test_implicit_graph");
+    return true;
+}
+
 /**
  * Test partitioning heap operations
  */
@@ -405,6 +937,1240 @@ static bool test_disconnected_graph() {
     return true;
 }
 
+/**
+ * Test target-set and k-nearest queries against a full solve
+ */
+static bool test_targeted_queries() {
+    const vertex_count_t side = 100;
+    const vertex_count_t n = side * side;
+    const vertex_id_t source = 50 * side + 50;
+    sssp_graph_t* graph = sssp_graph_generate_grid(side, side, false, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to generate grid");
+    sssp_algorithm_result_t* full = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(full != NULL, "Failed to create result");
+    TEST_ASSERT(sssp_solve_single_source(graph, source, NULL, full) == SSSP_SUCCESS, "Full solve failed");
+    
+    // Targets answered in the caller's order, duplicates and source included
+    vertex_id_t targets[] = { source + 3, source + 2 * side, source, source + 3, source - side - 1 };
+    const vertex_count_t num_targets = sizeof(targets) / sizeof(targets[0]);
+    sssp_target_result_t* answer = sssp_target_result_create(num_targets, NULL);
+    TEST_ASSERT(answer != NULL, "Failed to create target result");
+    TEST_ASSERT(sssp_solve_to_targets(graph, source, targets, num_targets, NULL, answer) == SSSP_SUCCESS,
+                "Targeted solve failed");
+    TEST_ASSERT(answer->count == num_targets, "Every target should be answered");
+    for (vertex_count_t i = 0; i < num_targets; i++) {
+        TEST_ASSERT(answer->vertices[i] == targets[i], "Targets should keep their order");
+        TEST_ASSERT(answer->distances[i] == full->distances[targets[i]], "Wrong target distance");
+        TEST_ASSERT(answer->predecessors[i] == SSSP_INVALID_VERTEX ||
+                    full->distances[answer->predecessors[i]] + 1.0 == answer->distances[i],
+                    "Predecessor should be on a shortest path");
+    }
+    
+    // Only vertices no farther than the farthest target were settled
+    vertex_count_t within = 0;
+    for (vertex_id_t v = 0; v < n; v++) {
+        if (full->distances[v] <= 3.0) within++;
+    }
+    TEST_ASSERT(answer->vertices_settled <= within, "Targeted solve explored too far");
+    
+    // Too small a result and out-of-range targets are rejected
+    TEST_ASSERT(sssp_solve_to_targets(graph, source, targets, num_targets + 1, NULL, answer) ==
+                SSSP_ERROR_INVALID_PARAMETER, "Result capacity should be checked");
+    vertex_id_t bad_target = n;
+    TEST_ASSERT(sssp_solve_to_targets(graph, source, &bad_target, 1, NULL, answer) ==
+                SSSP_ERROR_INVALID_PARAMETER, "Out-of-range target should be rejected");
+    sssp_target_result_destroy(answer);
+    
+    // k nearest of the vertices on every 7th column
+    uint64_t* tags = calloc(SSSP_TAG_WORDS(n), sizeof(uint64_t));
+    TEST_ASSERT(tags != NULL, "Failed to allocate tags");
+    vertex_count_t num_tagged = 0;
+    for (vertex_id_t v = 0; v < n; v++) {
+        if ((v % side) % 7 == 0) {
+            tags[v / 64] |= (uint64_t)1 << (v % 64);
+            num_tagged++;
+        }
+    }
+    const vertex_count_t k = 12;
+    sssp_target_result_t* nearest = sssp_target_result_create(num_tagged + 1, NULL);
+    TEST_ASSERT(nearest != NULL, "Failed to create k-nearest result");
+    TEST_ASSERT(sssp_solve_k_nearest(graph, source, tags, k, NULL, nearest) == SSSP_SUCCESS,
+                "k-nearest solve failed");
+    TEST_ASSERT(nearest->count == k, "Should find k tagged vertices");
+    vertex_count_t closer = 0;
+    distance_t kth = nearest->distances[k - 1];
+    for (vertex_count_t i = 0; i < k; i++) {
+        vertex_id_t v = nearest->vertices[i];
+        TEST_ASSERT((v % side) % 7 == 0, "Untagged vertex reported");
+        TEST_ASSERT(nearest->distances[i] == full->distances[v], "Wrong k-nearest distance");
+        TEST_ASSERT(i == 0 || nearest->distances[i - 1] <= nearest->distances[i],
+                    "k-nearest entries should be in distance order");
+    }
+    for (vertex_id_t v = 0; v < n; v++) {
+        if ((v % side) % 7 == 0 && full->distances[v] < kth) closer++;
+    }
+    TEST_ASSERT(closer < k, "A closer tagged vertex was missed");
+    TEST_ASSERT(nearest->vertices_settled < n, "k-nearest solve should stop early");
+    
+    // Asking for more than are reachable returns all of them
+    TEST_ASSERT(sssp_solve_k_nearest(graph, source, tags, num_tagged + 1, NULL, nearest) == SSSP_SUCCESS,
+                "Exhaustive k-nearest solve failed");
+    TEST_ASSERT(nearest->count == num_tagged, "Should return every tagged vertex");
+    
+    sssp_target_result_destroy(nearest);
+    free(tags);
+    
+    // A workspace answers a run of queries, each from a clean state
+    sssp_workspace_t* workspace = NULL;
+    TEST_ASSERT(sssp_workspace_create(graph, NULL, &workspace) == SSSP_SUCCESS, "Workspace creation failed");
+    sssp_workspace_query_t query = { &source, 1, 4.0, NULL, 0, 0, NULL };
+    vertex_count_t settled_count;
+    for (int round = 0; round < 2; round++) {
+        TEST_ASSERT(sssp_workspace_solve(workspace, &query) == SSSP_SUCCESS, "Bounded workspace query failed");
+        const vertex_id_t* settled = sssp_workspace_settled(workspace, &settled_count);
+        TEST_ASSERT(settled_count == 41, "Bounded query should settle the diamond of radius 4");
+        for (vertex_count_t i = 0; i < settled_count; i++) {
+            TEST_ASSERT(sssp_workspace_distance(workspace, settled[i]) == full->distances[settled[i]],
+                        "Wrong workspace distance");
+            TEST_ASSERT(i == 0 || sssp_workspace_distance(workspace, settled[i - 1]) <=
+                                  sssp_workspace_distance(workspace, settled[i]),
+                        "Settled vertices should come in distance order");
+        }
+        
+        // A second source far away: nothing left over from the first query
+        vertex_id_t corners[] = { 0, 0, n - 1 };
+        sssp_workspace_query_t multi = { corners, 3, 2.0, NULL, 0, 0, NULL };
+        TEST_ASSERT(sssp_workspace_solve(workspace, &multi) == SSSP_SUCCESS, "Multi-source workspace query failed");
+        sssp_workspace_settled(workspace, &settled_count);
+        TEST_ASSERT(settled_count == 12, "Two corners should settle 6 vertices each");
+        TEST_ASSERT(sssp_workspace_distance(workspace, source) == SSSP_INFINITY,
+                    "Previous query should have been reset");
+    }
+    query.bound = SSSP_INFINITY;
+    query.targets = targets;
+    query.num_targets = num_targets;
+    TEST_ASSERT(sssp_workspace_solve(workspace, &query) == SSSP_SUCCESS, "Targeted workspace query failed");
+    sssp_workspace_settled(workspace, &settled_count);
+    TEST_ASSERT(settled_count <= within, "Targeted workspace query explored too far");
+    for (vertex_count_t i = 0; i < num_targets; i++) {
+        TEST_ASSERT(sssp_workspace_distance(workspace, targets[i]) == full->distances[targets[i]],
+                    "Wrong workspace target distance");
+    }
+    query.targets = &bad_target;
+    query.num_targets = 1;
+    TEST_ASSERT(sssp_workspace_solve(workspace, &query) == SSSP_ERROR_INVALID_PARAMETER,
+                "Out-of-range workspace target should be rejected");
+    sssp_workspace_destroy(workspace);
+    
+    // Settled flags and distances match the reference in every visited
+    // layout and prefetch distance; vertex counts off the 64-bit word size
+    // and degrees past the prefetch distance exercise both
+    const vertex_count_t random_n = 1000;
+    sssp_graph_t* random = sssp_graph_generate_gnm(random_n, 20 * random_n, 1.0, 10.0, 23, NULL);
+    weight_t* reference = NULL;
+    TEST_ASSERT(random && sssp_dijkstra_reference(random, 0, NULL, &reference, NULL) == SSSP_SUCCESS,
+                "Reference solve failed");
+    TEST_ASSERT(sssp_workspace_create(random, NULL, &workspace) == SSSP_SUCCESS, "Workspace creation failed");
+    vertex_id_t first = 0;
+    distance_t bounds[] = { 6.0, SSSP_INFINITY, 3.0 };
+    for (size_t b = 0; b < sizeof(bounds) / sizeof(bounds[0]); b++) {
+        sssp_workspace_query_t bounded = { &first, 1, bounds[b], NULL, 0, 0, NULL };
+        TEST_ASSERT(sssp_workspace_solve(workspace, &bounded) == SSSP_SUCCESS, "Reference workspace query failed");
+        vertex_count_t in_bound = 0;
+        for (vertex_id_t v = 0; v < random_n; v++) {
+            bool expected_settled = reference[v] < SSSP_INFINITY && reference[v] <= bounds[b];
+            in_bound += expected_settled;
+            TEST_ASSERT(sssp_workspace_is_settled(workspace, v) == expected_settled,
+                        "Settled flag should match the reference");
+            TEST_ASSERT(!expected_settled || sssp_workspace_distance(workspace, v) == reference[v],
+                        "Settled distance should match the reference");
+        }
+        sssp_workspace_settled(workspace, &settled_count);
+        TEST_ASSERT(settled_count == in_bound, "Settled list should match the settled flags");
+    }
+    sssp_workspace_destroy(workspace);
+    free(reference);
+    sssp_graph_destroy(random);
+    
+    sssp_algorithm_result_destroy(full);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_targeted_queries");
+    return true;
+}
+
+/**
+ * Test query deadlines and cancellation
+ */
+static bool test_query_limits() {
+    const vertex_count_t side = 500;
+    const vertex_count_t n = side * side;
+    const vertex_id_t source = 0;
+    sssp_graph_t* graph = sssp_graph_generate_grid(side, side, false, NULL);
+    sssp_algorithm_result_t* full = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* partial = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(graph && full && partial, "Failed to set up query limit test");
+    TEST_ASSERT(sssp_solve_single_source(graph, source, NULL, full) == SSSP_SUCCESS, "Full solve failed");
+    TEST_ASSERT(strcmp(sssp_error_string(SSSP_ERROR_TIMEOUT), "Deadline expired") == 0,
+                "Timeout should have a message");
+    
+    // A deadline that passes mid-solve leaves exact settled distances and
+    // upper bounds elsewhere
+    // upper bounds elsewhere. Setup counts against the deadline, so it
+    // grows until the search itself gets some of the time.
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    config.limit_check_interval = 64;
+    vertex_count_t settled = 0;
+    for (double ms = full->total_time_ms / 8.0; settled == 0; ms *= 2.0) {
+        sssp_vertex_set_clear(partial->processed_vertices);
+        config.deadline_ns = sssp_deadline_after_ms(ms);
+        TEST_ASSERT(sssp_solve_single_source(graph, source, &config, partial) == SSSP_ERROR_TIMEOUT,
+                    "Solve should stop at its deadline");
+        settled = sssp_vertex_set_size(partial->processed_vertices);
+    }
+    TEST_ASSERT(!partial->is_optimal && partial->validation_status == SSSP_ERROR_TIMEOUT,
+                "Interrupted result should not claim optimality");
+    TEST_ASSERT(settled < n && settled == partial->vertices_processed,
+                "Interrupted solve should report its settled vertices");
+    vertex_count_t bounded = 0;
+    for (vertex_id_t v = 0; v < n; v++) {
+        if (sssp_vertex_set_contains(partial->processed_vertices, v)) {
+            TEST_ASSERT(partial->distances[v] == full->distances[v], "Settled distance should be exact");
+        } else if (partial->distances[v] < SSSP_INFINITY) {
+            TEST_ASSERT(partial->distances[v] >= full->distances[v], "Distance should be an upper bound");
+            vertex_id_t p = partial->predecessors[v];
+            TEST_ASSERT(p != SSSP_INVALID_VERTEX && partial->distances[p] + 1.0 <= partial->distances[v],
+                        "Upper bound should be reached along the predecessor");
+            bounded++;
+        }
+    }
+    TEST_ASSERT(bounded > 0, "Interrupted solve should leave a frontier");
+    
+    // A cancelled token stops every query before it settles anything
+    sssp_cancel_token_t token;
+    sssp_cancel_token_init(&token);
+    sssp_cancel_token_cancel(&token);
+    TEST_ASSERT(sssp_cancel_token_is_cancelled(&token), "Token should be cancelled");
+    config.deadline_ns = 0;
+    config.cancel_token = &token;
+    sssp_algorithm_result_t* cancelled = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(cancelled != NULL, "Failed to create result");
+    TEST_ASSERT(sssp_solve_single_source(graph, source, &config, cancelled) == SSSP_ERROR_CANCELLED,
+                "Cancelled solve should fail with SSSP_ERROR_CANCELLED");
+    TEST_ASSERT(cancelled->vertices_processed == 0 && cancelled->distances[source] == 0.0 &&
+                cancelled->distances[1] == SSSP_INFINITY, "Cancelled solve should hold only the source");
+    sssp_algorithm_result_destroy(cancelled);
+    
+    uint64_t* tags = calloc(SSSP_TAG_WORDS(n), sizeof(uint64_t));
+    sssp_target_result_t* nearest = sssp_target_result_create(4, NULL);
+    sssp_vertex_set_t* sources = sssp_vertex_set_create(1, NULL);
+    sssp_vertex_set_t* output = sssp_vertex_set_create(0, NULL);
+    TEST_ASSERT(tags && nearest && sources && output, "Failed to set up limited queries");
+    tags[0] = 0xF0;
+    TEST_ASSERT(sssp_solve_k_nearest(graph, source, tags, 4, &config, nearest) == SSSP_ERROR_CANCELLED &&
+                nearest->count == 0, "Cancelled k-nearest solve should find nothing");
+    sssp_vertex_set_add(sources, source);
+    weight_t b_prime = -1.0;
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 10.0, sources, config.k, config.t, &config,
+                                          output, &b_prime) == SSSP_ERROR_CANCELLED,
+                "Cancelled bounded multi-source solve should fail with SSSP_ERROR_CANCELLED");
+    TEST_ASSERT(sssp_vertex_set_size(output) == 0, "Cancelled bounded solve should complete nothing");
+    
+    // Reset tokens stop nothing
+    sssp_cancel_token_reset(&token);
+    TEST_ASSERT(sssp_solve_k_nearest(graph, source, tags, 4, &config, nearest) == SSSP_SUCCESS &&
+                nearest->count == 4, "Reset token should let the solve finish");
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 10.0, sources, config.k, config.t, &config,
+                                          output, &b_prime) == SSSP_SUCCESS && sssp_vertex_set_size(output) > 0,
+                "Reset token should let the bounded solve finish");
+    
+    sssp_vertex_set_destroy(output);
+    sssp_vertex_set_destroy(sources);
+    sssp_target_result_destroy(nearest);
+    free(tags);
+    sssp_algorithm_result_destroy(partial);
+    sssp_algorithm_result_destroy(full);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_query_limits");
+    return true;
+}
+
+/**
+ * Test (1+ε)-approximate single-source solves
+ */
+static bool test_approximate_sssp() {
+    const vertex_count_t side = 200;
+    const vertex_count_t n = side * side;
+    const vertex_id_t source = side / 2 * side + side / 2;
+    sssp_graph_t* graph = sssp_graph_generate_grid_3d(side, side, 1, true, 1.0, 100.0, 11, NULL);
+    sssp_algorithm_result_t* exact = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* approx = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(graph && exact && approx, "Failed to set up approximate solve test");
+    TEST_ASSERT(sssp_solve_single_source(graph, source, NULL, exact) == SSSP_SUCCESS, "Exact solve failed");
+    TEST_ASSERT(exact->is_optimal && exact->approximation_bound == 1.0, "Exact solve should have bound 1");
+    
+    const double epsilons[] = { 0.001, 0.05, 0.5 };
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    for (size_t i = 0; i < sizeof(epsilons) / sizeof(epsilons[0]); i++) {
+        double epsilon = epsilons[i];
+        config.approximation_epsilon = epsilon;
+        sssp_vertex_set_clear(approx->processed_vertices);
+        TEST_ASSERT(sssp_solve_single_source(graph, source, &config, approx) == SSSP_SUCCESS,
+                    "Approximate solve failed");
+        TEST_ASSERT(!approx->is_optimal, "Approximate result should not claim optimality");
+        TEST_ASSERT(approx->approximation_bound >= 1.0 && approx->approximation_bound <= 1.0 + epsilon,
+                    "Reported bound should be within 1 + epsilon");
+        TEST_ASSERT(sssp_vertex_set_size(approx->processed_vertices) == n, "Every vertex should be settled");
+        for (vertex_id_t v = 0; v < n; v++) {
+            distance_t d = exact->distances[v];
+            TEST_ASSERT(approx->distances[v] >= d && approx->distances[v] <= approx->approximation_bound * d,
+                        "Approximate distance outside its bound");
+            vertex_id_t p = approx->predecessors[v];
+            TEST_ASSERT(v == source ? p == SSSP_INVALID_VERTEX
+                                    : p != SSSP_INVALID_VERTEX && approx->distances[p] < approx->distances[v],
+                        "Approximate distance should be reached along the predecessor");
+        }
+    }
+    
+    // Zero weights, a tiny and a huge weight, and an unreachable vertex
+    sssp_graph_t* small = sssp_graph_create(6, NULL);
+    sssp_algorithm_result_t* small_result = sssp_algorithm_result_create(6, NULL);
+    TEST_ASSERT(small && small_result, "Failed to create small graph");
+    sssp_graph_add_edge(small, 0, 1, 0.0);
+    sssp_graph_add_edge(small, 1, 2, 5.0);
+    sssp_graph_add_edge(small, 0, 2, 10.0);
+    sssp_graph_add_edge(small, 2, 3, 0.001);
+    sssp_graph_add_edge(small, 3, 4, 1e6);
+    sssp_graph_add_edge(small, 1, 4, 2e6);
+    config = sssp_algorithm_config_default(6, NULL);
+    config.approximation_epsilon = 0.1;
+    TEST_ASSERT(sssp_solve_single_source(small, 0, &config, small_result) == SSSP_SUCCESS,
+                "Approximate solve of small graph failed");
+    const distance_t expected[] = { 0.0, 0.0, 5.0, 5.001, 1e6 + 5.001, SSSP_INFINITY };
+    for (vertex_id_t v = 0; v < 6; v++) {
+        TEST_ASSERT(small_result->distances[v] >= expected[v] &&
+                    small_result->distances[v] <= 1.1 * expected[v], "Wrong small graph distance");
+    }
+    
+    // Epsilon must be a number >= 0
+    config.approximation_epsilon = -0.5;
+    TEST_ASSERT(sssp_solve_single_source(small, 0, &config, small_result) == SSSP_ERROR_INVALID_PARAMETER,
+                "Negative epsilon should be rejected");
+    config.approximation_epsilon = NAN;
+    TEST_ASSERT(sssp_solve_single_source(small, 0, &config, small_result) == SSSP_ERROR_INVALID_PARAMETER,
+                "NaN epsilon should be rejected");
+    
+    sssp_algorithm_result_destroy(small_result);
+    sssp_graph_destroy(small);
+    sssp_algorithm_result_destroy(approx);
+    sssp_algorithm_result_destroy(exact);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_approximate_sssp");
+    return true;
+}
+
+/**
+ * Test integer weight detection and the integer solver path
+ */
+static bool test_integer_weights() {
+    const vertex_count_t n = 2000;
+    sssp_graph_t* graph = sssp_graph_create(n, NULL);
+    sssp_algorithm_result_t* reference = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(graph && reference && result, "Failed to set up integer weight test");
+    
+    // Weights with one decimal place, including zero
+    uint32_t state = 12345;
+    for (edge_count_t e = 0; e < 12000; e++) {
+        state = state * 1103515245u + 12345u;
+        vertex_id_t from = (state >> 8) % n;
+        state = state * 1103515245u + 12345u;
+        vertex_id_t to = (state >> 8) % n;
+        state = state * 1103515245u + 12345u;
+        sssp_graph_add_edge(graph, from, to, (double)((state >> 8) % 1000) / 10.0);
+    }
+    TEST_ASSERT(sssp_graph_get_weight_scale(graph) == 0, "Weights should not be scaled before building");
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, NULL, reference) == SSSP_SUCCESS, "Reference solve failed");
+    
+    TEST_ASSERT(sssp_graph_build_integer_weights(graph) == SSSP_SUCCESS, "Integer weights should build");
+    TEST_ASSERT(sssp_graph_get_weight_scale(graph) == 10, "One decimal place should give scale 10");
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    config.enable_validation = true;
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, result) == SSSP_SUCCESS, "Integer solve failed");
+    TEST_ASSERT(result->is_optimal && result->approximation_bound == 1.0, "Integer solve should be exact");
+    TEST_ASSERT(result->vertices_processed == reference->vertices_processed &&
+                sssp_vertex_set_size(result->processed_vertices) ==
+                sssp_vertex_set_size(reference->processed_vertices), "Both paths should settle the same vertices");
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(result->distances[v] == reference->distances[v] ||
+                    fabs(result->distances[v] - reference->distances[v]) <= 1e-9 * reference->distances[v],
+                    "Integer distance differs from the double solve");
+    }
+    
+    // A cancelled solve stops with what it has
+    sssp_cancel_token_t token;
+    sssp_cancel_token_init(&token);
+    sssp_cancel_token_cancel(&token);
+    config.cancel_token = &token;
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, result) == SSSP_ERROR_CANCELLED,
+                "Cancelled integer solve should report it");
+    config.cancel_token = NULL;
+    
+    // Saved with six decimals and loaded back, the weights are detected again
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/sssp_test_%d.graph", (int)getpid());
+    TEST_ASSERT(sssp_graph_save_to_file(graph, path) == SSSP_SUCCESS, "Failed to save graph");
+    sssp_graph_t* loaded = sssp_graph_load_from_file(path, NULL);
+    remove(path);
+    TEST_ASSERT(loaded && sssp_graph_get_weight_scale(loaded) == 10, "Loading should detect integer weights");
+    sssp_graph_destroy(loaded);
+    
+    // Adding an edge drops the integers; a finer weight needs a finer scale
+    TEST_ASSERT(sssp_graph_add_edge(graph, 1, 2, 0.25) == SSSP_SUCCESS, "Failed to add edge");
+    TEST_ASSERT(sssp_graph_get_weight_scale(graph) == 0, "Adding an edge should drop integer weights");
+    TEST_ASSERT(sssp_graph_build_integer_weights(graph) == SSSP_SUCCESS &&
+                sssp_graph_get_weight_scale(graph) == 100, "Two decimal places should give scale 100");
+    
+    // Weights without a short decimal form, or too large, stay doubles
+    TEST_ASSERT(sssp_graph_add_edge(graph, 2, 3, 1.0 / 3.0) == SSSP_SUCCESS, "Failed to add edge");
+    TEST_ASSERT(sssp_graph_build_integer_weights(graph) == SSSP_ERROR_INVALID_ARGUMENT &&
+                sssp_graph_get_weight_scale(graph) == 0, "A third should not be scaled");
+    sssp_graph_t* large = sssp_graph_create(2, NULL);
+    TEST_ASSERT(large != NULL, "Failed to create graph");
+    sssp_graph_add_edge(large, 0, 1, 5e9);
+    TEST_ASSERT(sssp_graph_build_integer_weights(large) == SSSP_ERROR_INVALID_ARGUMENT,
+                "Weights above 32 bits should not be scaled");
+    sssp_graph_destroy(large);
+    
+    sssp_algorithm_result_destroy(result);
+    sssp_algorithm_result_destroy(reference);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_integer_weights");
+    return true;
+}
+
+/**
+ * Test blocked Floyd-Warshall against single-source solves
+ */
+static bool test_all_pairs() {
+    const vertex_count_t n = 150;   // Not a multiple of any tile size
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 900, 1.0, 10.0, 23, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to generate graph");
+    sssp_algorithm_result_t* reference = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(reference != NULL, "Failed to create result");
+    sssp_vertex_set_t* path = sssp_vertex_set_create(n, NULL);
+    TEST_ASSERT(path != NULL, "Failed to create path set");
+    
+    sssp_apsp_config_t config = sssp_apsp_config_default(NULL);
+    config.compute_next_hops = true;
+    sssp_apsp_matrix_t* exact = NULL;
+    TEST_ASSERT(sssp_all_pairs(graph, &config, &exact) == SSSP_SUCCESS, "All-pairs solve failed");
+    
+    for (vertex_id_t u = 0; u < n; u++) {
+        sssp_vertex_set_clear(reference->processed_vertices);
+        TEST_ASSERT(sssp_solve_single_source(graph, u, NULL, reference) == SSSP_SUCCESS,
+                    "Reference solve failed");
+        for (vertex_id_t v = 0; v < n; v++) {
+            TEST_ASSERT(fabs(sssp_apsp_distance(exact, u, v) - reference->distances[v]) < 1e-9 ||
+                        sssp_apsp_distance(exact, u, v) == reference->distances[v],
+                        "All-pairs distance differs from Dijkstra");
+        }
+    }
+    
+    // Paths follow next hops with strictly decreasing remaining distance
+    for (vertex_id_t u = 0; u < n; u += 7) {
+        for (vertex_id_t v = 0; v < n; v += 5) {
+            if (sssp_apsp_distance(exact, u, v) == SSSP_INFINITY) {
+                TEST_ASSERT(sssp_apsp_path(exact, u, v, path) == SSSP_ERROR_INVALID_ARGUMENT,
+                            "Unreachable pair should have no path");
+                continue;
+            }
+            TEST_ASSERT(sssp_apsp_path(exact, u, v, path) == SSSP_SUCCESS, "Path query failed");
+            vertex_count_t length = sssp_vertex_set_size(path);
+            TEST_ASSERT(sssp_vertex_set_get_vertex(path, 0) == u &&
+                        sssp_vertex_set_get_vertex(path, length - 1) == v, "Path has wrong endpoints");
+            for (vertex_count_t i = 1; i < length; i++) {
+                TEST_ASSERT(sssp_apsp_distance(exact, sssp_vertex_set_get_vertex(path, i), v) <
+                            sssp_apsp_distance(exact, sssp_vertex_set_get_vertex(path, i - 1), v),
+                            "Path should get closer at every hop");
+            }
+        }
+    }
+    
+    // Every kernel, serially, in both precisions and with small tiles agrees
+    sssp_relax_kernel_t kernel = sssp_relax_get_kernel();
+    config.use_parallel_processing = false;
+    config.tile_size = 16;
+    for (int k = SSSP_RELAX_KERNEL_SCALAR; k <= SSSP_RELAX_KERNEL_AVX512; k++) {
+        if (sssp_relax_set_kernel((sssp_relax_kernel_t)k) != SSSP_SUCCESS) continue;
+        for (int precision = SSSP_APSP_DOUBLE; precision <= SSSP_APSP_FLOAT; precision++) {
+            config.precision = (sssp_apsp_precision_t)precision;
+            const double tolerance = precision == SSSP_APSP_FLOAT ? 1e-3 : 1e-9;
+            sssp_apsp_matrix_t* other = NULL;
+            TEST_ASSERT(sssp_all_pairs(graph, &config, &other) == SSSP_SUCCESS, "All-pairs variant failed");
+            for (vertex_id_t u = 0; u < n; u++) {
+                for (vertex_id_t v = 0; v < n; v++) {
+                    distance_t d = sssp_apsp_distance(exact, u, v);
+                    distance_t got = sssp_apsp_distance(other, u, v);
+                    TEST_ASSERT(got == d || fabs(got - d) < tolerance * (1.0 + d),
+                                "All-pairs variant distance differs");
+                    vertex_id_t hop = sssp_apsp_next_hop(other, u, v);
+                    TEST_ASSERT(d == SSSP_INFINITY ? hop == SSSP_INVALID_VERTEX
+                                                   : u == v || sssp_apsp_distance(exact, hop, v) < d,
+                                "All-pairs variant next hop should lead toward the target");
+                }
+            }
+            sssp_apsp_matrix_destroy(other);
+        }
+    }
+    sssp_relax_set_kernel(kernel);
+    
+    config.tile_size = 24;
+    sssp_apsp_matrix_t* bad = NULL;
+    TEST_ASSERT(sssp_all_pairs(graph, &config, &bad) == SSSP_ERROR_INVALID_ARGUMENT && bad == NULL,
+                "Tile size must be a multiple of 16");
+    
+    sssp_apsp_matrix_destroy(exact);
+    sssp_vertex_set_destroy(path);
+    sssp_algorithm_result_destroy(reference);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_all_pairs");
+    return true;
+}
+
+/**
+ * Test Bellman-Ford and Johnson reweighting on graphs with negative weights
+ */
+static bool test_negative_weights() {
+    const vertex_count_t n = 2000;
+    sssp_graph_t* base = sssp_graph_generate_gnm(n, 40000, 1.0, 10.0, 31, NULL);
+    TEST_ASSERT(base != NULL, "Failed to generate graph");
+    sssp_algorithm_result_t* expected = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* parallel = sssp_algorithm_result_create(n, NULL);
+    sssp_vertex_set_t* cycle = sssp_vertex_set_create(16, NULL);
+    TEST_ASSERT(expected && result && parallel && cycle, "Failed to create results");
+    
+    // Shifting by potentials p gives negative edges but keeps shortest paths:
+    // d'(s, v) = d(s, v) + p[s] - p[v]
+    distance_t* p = malloc(n * sizeof(distance_t));
+    TEST_ASSERT(p != NULL, "Failed to allocate potentials");
+    sssp_rng_t rng;
+    sssp_rng_seed(&rng, 7, 0);
+    for (vertex_id_t v = 0; v < n; v++) p[v] = 30.0 * sssp_rng_uniform(&rng);
+    
+    sssp_graph_t* graph = sssp_graph_create(n, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to create graph");
+    TEST_ASSERT(sssp_graph_add_edge(graph, 0, 1, -1.0) == SSSP_ERROR_INVALID_PARAMETER,
+                "Negative weights should need opting in");
+    TEST_ASSERT(sssp_graph_allow_negative_weights(graph, true) == SSSP_SUCCESS, "Opt-in failed");
+    for (vertex_id_t u = 0; u < n; u++) {
+        for (edge_count_t e = base->csr_offsets[u]; e < base->csr_offsets[u + 1]; e++) {
+            vertex_id_t v = base->csr_targets[e];
+            TEST_ASSERT(sssp_graph_add_edge(graph, u, v, base->csr_weights[e] + p[u] - p[v]) == SSSP_SUCCESS,
+                        "Failed to add shifted edge");
+        }
+    }
+    TEST_ASSERT(sssp_graph_has_negative_weights(graph), "Graph should have negative weights");
+    TEST_ASSERT(sssp_graph_allow_negative_weights(graph, false) == SSSP_ERROR_INVALID_ARGUMENT,
+                "Cannot opt out with negative edges present");
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, NULL, result) == SSSP_ERROR_GRAPH_INVALID,
+                "Dijkstra should reject negative weights");
+    sssp_algorithm_config_t bmssp_config = sssp_algorithm_config_default(n, NULL);
+    sssp_vertex_set_t* bmssp_sources = sssp_vertex_set_create(0, NULL);
+    sssp_vertex_set_t* bmssp_output = sssp_vertex_set_create(n, NULL);
+    TEST_ASSERT(bmssp_sources && bmssp_output, "Failed to create BMSSP sets");
+    sssp_vertex_set_add(bmssp_sources, 0);
+    weight_t bmssp_bound;
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 10.0, bmssp_sources, bmssp_config.k, bmssp_config.t,
+                                          &bmssp_config, bmssp_output, &bmssp_bound) == SSSP_ERROR_GRAPH_INVALID,
+                "BMSSP should reject negative weights");
+    TEST_ASSERT(sssp_base_case(graph, 10.0, bmssp_sources, bmssp_config.k, &bmssp_config,
+                               bmssp_output, &bmssp_bound) == SSSP_ERROR_GRAPH_INVALID,
+                "Base case should reject negative weights");
+    sssp_vertex_set_destroy(bmssp_output);
+    sssp_vertex_set_destroy(bmssp_sources);
+    
+    sssp_johnson_t* johnson = NULL;
+    TEST_ASSERT(sssp_johnson_create(graph, NULL, &johnson, cycle) == SSSP_SUCCESS, "Johnson failed");
+    TEST_ASSERT(!sssp_graph_has_negative_weights(johnson->reduced), "Reduced costs should be non-negative");
+    
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    unsigned int threads = sssp_get_num_threads();
+    for (vertex_id_t s = 0; s < n; s += 397) {
+        sssp_vertex_set_clear(expected->processed_vertices);
+        sssp_vertex_set_clear(result->processed_vertices);
+        sssp_vertex_set_clear(parallel->processed_vertices);
+        TEST_ASSERT(sssp_solve_single_source(base, s, NULL, expected) == SSSP_SUCCESS, "Reference solve failed");
+        
+        config.use_parallel_processing = false;
+        TEST_ASSERT(sssp_solve_bellman_ford(graph, s, &config, result, NULL) == SSSP_SUCCESS,
+                    "Bellman-Ford failed");
+        sssp_set_num_threads(4);
+        config.use_parallel_processing = true;
+        TEST_ASSERT(sssp_solve_bellman_ford(graph, s, &config, parallel, NULL) == SSSP_SUCCESS,
+                    "Parallel Bellman-Ford failed");
+        sssp_set_num_threads(threads);
+        for (vertex_id_t v = 0; v < n; v++) {
+            distance_t d = expected->distances[v];
+            TEST_ASSERT(d == SSSP_INFINITY ? result->distances[v] == SSSP_INFINITY
+                                           : fabs(result->distances[v] - (d + p[s] - p[v])) < 1e-9,
+                        "Bellman-Ford distance differs from shifted Dijkstra");
+            TEST_ASSERT(parallel->distances[v] == result->distances[v],
+                        "Parallel rounds should match serial rounds exactly");
+        }
+        
+        TEST_ASSERT(sssp_johnson_solve(johnson, s, NULL, parallel) == SSSP_SUCCESS, "Johnson solve failed");
+        for (vertex_id_t v = 0; v < n; v++) {
+            distance_t d = result->distances[v];
+            TEST_ASSERT(d == SSSP_INFINITY ? parallel->distances[v] == SSSP_INFINITY
+                                           : fabs(parallel->distances[v] - d) < 1e-9,
+                        "Johnson distance differs from Bellman-Ford");
+        }
+    }
+    sssp_johnson_destroy(johnson);
+    
+    // A reachable negative cycle 0 -> 1 -> 2 -> 0 of weight -1
+    sssp_graph_t* cyclic = sssp_graph_create(5, NULL);
+    TEST_ASSERT(cyclic != NULL, "Failed to create graph");
+    sssp_graph_allow_negative_weights(cyclic, true);
+    sssp_graph_add_edge(cyclic, 3, 0, 2.0);
+    sssp_graph_add_edge(cyclic, 0, 1, 1.0);
+    sssp_graph_add_edge(cyclic, 1, 2, -3.0);
+    sssp_graph_add_edge(cyclic, 2, 0, 1.0);
+    sssp_graph_add_edge(cyclic, 2, 4, 1.0);
+    
+    TEST_ASSERT(sssp_solve_bellman_ford(cyclic, 3, NULL, result, cycle) == SSSP_ERROR_NEGATIVE_CYCLE,
+                "Negative cycle should be reported");
+    TEST_ASSERT(sssp_vertex_set_size(cycle) == 3, "Cycle should have 3 vertices");
+    for (vertex_count_t i = 0; i < 3; i++) {
+        vertex_id_t from = sssp_vertex_set_get_vertex(cycle, i);
+        vertex_id_t to = sssp_vertex_set_get_vertex(cycle, (i + 1) % 3);
+        TEST_ASSERT(from <= 2 && to == (from + 1) % 3, "Cycle should follow the edges");
+    }
+    TEST_ASSERT(sssp_solve_bellman_ford(cyclic, 4, NULL, result, NULL) == SSSP_SUCCESS,
+                "Unreachable cycle should not matter");
+    TEST_ASSERT(sssp_johnson_create(cyclic, NULL, &johnson, NULL) == SSSP_ERROR_NEGATIVE_CYCLE &&
+                johnson == NULL, "Johnson should reject a negative cycle");
+    
+    weight_t* distances = NULL;
+    bool has_cycle = false;
+    TEST_ASSERT(sssp_bellman_ford_reference(cyclic, 3, NULL, &distances, NULL, &has_cycle) == SSSP_SUCCESS &&
+                has_cycle, "Reference should detect the cycle");
+    free(distances);
+    TEST_ASSERT(sssp_bellman_ford_reference(graph, 0, NULL, &distances, NULL, &has_cycle) == SSSP_SUCCESS &&
+                !has_cycle, "Reference should find no cycle");
+    TEST_ASSERT(sssp_solve_bellman_ford(graph, 0, NULL, result, NULL) == SSSP_SUCCESS, "Bellman-Ford failed");
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(distances[v] == result->distances[v] || fabs(distances[v] - result->distances[v]) < 1e-9,
+                    "Reference Bellman-Ford differs");
+    }
+    free(distances);
+    
+    sssp_graph_destroy(cyclic);
+    sssp_graph_destroy(graph);
+    sssp_graph_destroy(base);
+    free(p);
+    sssp_vertex_set_destroy(cycle);
+    sssp_algorithm_result_destroy(parallel);
+    sssp_algorithm_result_destroy(result);
+    sssp_algorithm_result_destroy(expected);
+    TEST_PASS("test_negative_weights");
+    return true;
+}
+
+/**
+ * Test certificate validation and the reference solvers
+ */
+static bool test_result_validation() {
+    const vertex_count_t n = 20000;
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 100000, 1.0, 10.0, 41, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to generate graph");
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* other = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(result && other, "Failed to create results");
+    
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    config.enable_validation = true;
+    TEST_ASSERT(sssp_solve_single_source(graph, 3, &config, result) == SSSP_SUCCESS &&
+                result->validation_status == SSSP_SUCCESS && result->is_optimal,
+                "Validated solve should pass");
+    
+    weight_t* expected = NULL;
+    vertex_id_t* predecessors = NULL;
+    TEST_ASSERT(sssp_dijkstra_reference(graph, 3, NULL, &expected, &predecessors) == SSSP_SUCCESS,
+                "Reference Dijkstra failed");
+    TEST_ASSERT(sssp_validate_result(graph, 3, result, expected) == SSSP_SUCCESS,
+                "Result should match the reference");
+    memcpy(other->distances, expected, n * sizeof(weight_t));
+    memcpy(other->predecessors, predecessors, n * sizeof(vertex_id_t));
+    TEST_ASSERT(sssp_results_equal(result, other, n, 0.0), "Results should be equal");
+    TEST_ASSERT(sssp_validate_result(graph, 3, other, NULL) == SSSP_SUCCESS,
+                "Reference result should be a valid certificate");
+    
+    // Same verdicts on several threads
+    unsigned int threads = sssp_get_num_threads();
+    sssp_set_num_threads(4);
+    TEST_ASSERT(sssp_validate_result(graph, 3, other, NULL) == SSSP_SUCCESS,
+                "Parallel check should pass");
+    
+    vertex_id_t v = 0;
+    while (v == 3 || other->distances[v] == SSSP_INFINITY) v++;
+    other->distances[v] += 1.0;
+    TEST_ASSERT(!sssp_results_equal(result, other, n, 1e-6), "Results should differ");
+    TEST_ASSERT(sssp_validate_result(graph, 3, other, NULL) == SSSP_ERROR_ALGORITHM,
+                "Raised distance should be caught");
+    other->distances[v] -= 2.0;
+    TEST_ASSERT(sssp_validate_result(graph, 3, other, NULL) == SSSP_ERROR_ALGORITHM,
+                "Lowered distance should be caught");
+    other->distances[v] += 1.0;
+    other->predecessors[v] = v;
+    TEST_ASSERT(sssp_validate_result(graph, 3, other, NULL) == SSSP_ERROR_ALGORITHM,
+                "Wrong predecessor should be caught");
+    other->predecessors[v] = predecessors[v];
+    other->distances[3] = 0.5;
+    TEST_ASSERT(sssp_validate_result(graph, 3, other, NULL) == SSSP_ERROR_ALGORITHM,
+                "Source distance should be caught");
+    other->distances[3] = 0.0;
+    TEST_ASSERT(sssp_validate_result(graph, 3, other, NULL) == SSSP_SUCCESS, "Restored result should pass");
+    sssp_set_num_threads(threads);
+    
+    // Tight zero-weight links can still form a predecessor cycle
+    sssp_graph_t* small = sssp_graph_create(3, NULL);
+    TEST_ASSERT(small != NULL, "Failed to create graph");
+    sssp_graph_add_edge(small, 0, 1, 1.0);
+    sssp_graph_add_edge(small, 1, 2, 0.0);
+    sssp_graph_add_edge(small, 2, 1, 0.0);
+    sssp_algorithm_result_t* looped = sssp_algorithm_result_create(3, NULL);
+    TEST_ASSERT(looped != NULL, "Failed to create result");
+    looped->distances[0] = 0.0;
+    looped->distances[1] = 1.0;
+    looped->distances[2] = 1.0;
+    looped->predecessors[0] = SSSP_INVALID_VERTEX;
+    looped->predecessors[1] = 2;
+    looped->predecessors[2] = 1;
+    TEST_ASSERT(sssp_validate_result(small, 0, looped, NULL) == SSSP_ERROR_ALGORITHM,
+                "Predecessor cycle should be caught");
+    looped->predecessors[1] = 0;
+    TEST_ASSERT(sssp_validate_result(small, 0, looped, NULL) == SSSP_SUCCESS,
+                "Zero-weight tree should pass");
+    
+    // A cycle whose distances rise within the tolerance on one link
+    looped->predecessors[1] = 2;
+    looped->distances[2] = 1.0 + 1e-12;
+    TEST_ASSERT(sssp_validate_result(small, 0, looped, NULL) == SSSP_ERROR_ALGORITHM,
+                "Cycle through a nearly tight link should be caught");
+    
+    sssp_algorithm_result_destroy(looped);
+    sssp_graph_destroy(small);
+    free(expected);
+    free(predecessors);
+    sssp_algorithm_result_destroy(other);
+    sssp_algorithm_result_destroy(result);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_result_validation");
+    return true;
+}
+
+/**
+ * Test partitioned solves on shard processes
+ */
+static bool test_distributed_sssp() {
+    const vertex_count_t n = 20000;
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 100000, 1.0, 10.0, 43, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to generate graph");
+    sssp_algorithm_result_t* expected = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(expected && result, "Failed to create results");
+    TEST_ASSERT(sssp_solve_single_source(graph, 7, NULL, expected) == SSSP_SUCCESS, "Reference solve failed");
+    
+    const sssp_transport_ops_t* transports[] = { sssp_transport_unix_socket(), sssp_transport_shared_memory() };
+    for (int t = 0; t < 2; t++) {
+        sssp_cluster_config_t config = sssp_cluster_config_default(4, NULL);
+        config.transport = transports[t];
+        config.channel_capacity = 16384;    // Smaller than a frame, so frames wrap
+        sssp_cluster_t* cluster = NULL;
+        TEST_ASSERT(sssp_cluster_create(graph, &config, &cluster) == SSSP_SUCCESS, "Failed to start cluster");
+        TEST_ASSERT(sssp_cluster_num_shards(cluster) == 4, "Wrong shard count");
+        vertex_id_t begin = 0, end = 0, covered = 0;
+        for (uint32_t shard = 0; shard < 4; shard++) {
+            TEST_ASSERT(sssp_cluster_shard_range(cluster, shard, &begin, &end) == SSSP_SUCCESS &&
+                        begin == covered && end > begin, "Shard ranges should tile the vertices");
+            covered = end;
+        }
+        TEST_ASSERT(covered == n, "Shard ranges should cover every vertex");
+        
+        distance_t distance = 0.0;
+        TEST_ASSERT(sssp_cluster_gather(cluster, result) == SSSP_ERROR_INVALID_ARGUMENT,
+                    "Gather before a solve should fail");
+        TEST_ASSERT(sssp_cluster_solve(cluster, n, NULL, result) == SSSP_ERROR_INVALID_PARAMETER,
+                    "Bad source should be rejected");
+        TEST_ASSERT(sssp_cluster_solve(cluster, 7, NULL, result) == SSSP_SUCCESS, "Cluster solve failed");
+        TEST_ASSERT(sssp_results_equal(expected, result, n, 1e-9), "Cluster distances should match");
+        TEST_ASSERT(sssp_validate_result(graph, 7, result, NULL) == SSSP_SUCCESS,
+                    "Cluster predecessors should form a shortest-path tree");
+        sssp_cluster_stats_t stats = sssp_cluster_get_stats(cluster);
+        TEST_ASSERT(stats.supersteps > 0 && stats.messages > 0 && stats.cut_edges > 0,
+                    "Stats should count supersteps and messages");
+        
+        // Solve without gathering, then fetch on demand
+        TEST_ASSERT(sssp_cluster_solve(cluster, 11, NULL, NULL) == SSSP_SUCCESS, "Cluster solve failed");
+        vertex_id_t predecessor = 0;
+        TEST_ASSERT(sssp_cluster_distance(cluster, 11, &distance, &predecessor) == SSSP_SUCCESS &&
+                    distance == 0.0 && predecessor == SSSP_INVALID_VERTEX, "Source distance should be 0");
+        TEST_ASSERT(sssp_cluster_gather(cluster, result) == SSSP_SUCCESS, "Gather failed");
+        TEST_ASSERT(sssp_validate_result(graph, 11, result, NULL) == SSSP_SUCCESS,
+                    "Gathered result should be valid");
+        TEST_ASSERT(sssp_cluster_distance(cluster, n - 1, &distance, NULL) == SSSP_SUCCESS &&
+                    distance == result->distances[n - 1], "Query should match the gathered distance");
+        
+        // Query limits stop every shard, and the cluster stays usable
+        sssp_algorithm_config_t limits = sssp_algorithm_config_default(n, NULL);
+        limits.deadline_ns = sssp_deadline_after_ms(0.001);
+        TEST_ASSERT(sssp_cluster_solve(cluster, 7, &limits, result) == SSSP_ERROR_TIMEOUT,
+                    "A solve past its deadline should time out");
+        TEST_ASSERT(sssp_cluster_gather(cluster, result) == SSSP_ERROR_INVALID_ARGUMENT,
+                    "A stopped solve should leave nothing to gather");
+        sssp_cancel_token_t token;
+        sssp_cancel_token_init(&token);
+        sssp_cancel_token_cancel(&token);
+        limits.deadline_ns = 0;
+        limits.cancel_token = &token;
+        TEST_ASSERT(sssp_cluster_solve(cluster, 7, &limits, result) == SSSP_ERROR_CANCELLED,
+                    "A cancelled solve should stop");
+        limits.cancel_token = NULL;
+        limits.memory_limit_bytes = 1 << 20;
+        TEST_ASSERT(sssp_cluster_solve(cluster, 7, &limits, result) == SSSP_ERROR_INVALID_ARGUMENT,
+                    "A memory limit should be rejected");
+        limits.memory_limit_bytes = 0;
+        TEST_ASSERT(sssp_cluster_solve(cluster, 7, &limits, result) == SSSP_SUCCESS &&
+                    sssp_results_equal(expected, result, n, 1e-9), "The cluster should solve after a stop");
+        limits.deadline_ns = 1;             // Long past, so rejected before the shards start
+        TEST_ASSERT(sssp_cluster_solve(cluster, 7, &limits, NULL) == SSSP_ERROR_TIMEOUT,
+                    "A solve past its deadline should be rejected");
+        TEST_ASSERT(sssp_cluster_gather(cluster, result) == SSSP_ERROR_INVALID_ARGUMENT &&
+                    sssp_cluster_distance(cluster, 7, &distance, NULL) == SSSP_ERROR_INVALID_ARGUMENT &&
+                    sssp_cluster_get_stats(cluster).supersteps == 0,
+                    "A rejected solve should not expose the previous one");
+        sssp_cluster_destroy(cluster);
+    }
+    
+    // More shards than vertices, and unreachable vertices
+    sssp_graph_t* small = sssp_graph_create(3, NULL);
+    TEST_ASSERT(small != NULL, "Failed to create graph");
+    sssp_graph_add_edge(small, 0, 1, 2.0);
+    sssp_graph_add_edge(small, 1, 0, 1.0);
+    sssp_cluster_config_t config = sssp_cluster_config_default(5, NULL);
+    sssp_cluster_t* cluster = NULL;
+    TEST_ASSERT(sssp_cluster_create(small, &config, &cluster) == SSSP_SUCCESS, "Failed to start cluster");
+    sssp_algorithm_result_t* small_result = sssp_algorithm_result_create(3, NULL);
+    TEST_ASSERT(small_result != NULL, "Failed to create result");
+    TEST_ASSERT(sssp_cluster_solve(cluster, 1, NULL, small_result) == SSSP_SUCCESS, "Cluster solve failed");
+    TEST_ASSERT(small_result->distances[0] == 1.0 && small_result->distances[1] == 0.0 &&
+                small_result->distances[2] == SSSP_INFINITY, "Wrong distances on small graph");
+    sssp_cluster_destroy(cluster);
+    
+    config.num_shards = 0;
+    TEST_ASSERT(sssp_cluster_create(small, &config, &cluster) == SSSP_ERROR_INVALID_ARGUMENT,
+                "Zero shards should be rejected");
+    sssp_graph_allow_negative_weights(small, true);
+    sssp_graph_add_edge(small, 2, 0, -1.0);
+    TEST_ASSERT(sssp_cluster_create(small, NULL, &cluster) == SSSP_ERROR_GRAPH_INVALID,
+                "Negative weights should be rejected");
+    
+    sssp_algorithm_result_destroy(small_result);
+    sssp_graph_destroy(small);
+    sssp_algorithm_result_destroy(result);
+    sssp_algorithm_result_destroy(expected);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_distributed_sssp");
+    return true;
+}
+
+static void* run_server(void* server) {
+    sssp_server_run(server);
+    return NULL;
+}
+
+/**
+ * Test the query server over both socket kinds
+ */
+static bool test_query_server() {
+    const vertex_count_t n = 5000;
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 25000, 1.0, 10.0, 44, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to generate graph");
+    sssp_algorithm_result_t* from3 = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* from100 = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(from3 && from100, "Failed to create results");
+    TEST_ASSERT(sssp_solve_single_source(graph, 3, NULL, from3) == SSSP_SUCCESS &&
+                sssp_solve_single_source(graph, 100, NULL, from100) == SSSP_SUCCESS, "Reference solve failed");
+    
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/sssp_test_%d.sock", (int)getpid());
+    sssp_server_config_t config = sssp_server_config_default(NULL);
+    sssp_server_t* server = NULL;
+    TEST_ASSERT(sssp_server_create(graph, &config, &server) == SSSP_ERROR_INVALID_ARGUMENT,
+                "A server without listeners should be rejected");
+    config.unix_path = path;
+    config.listen_tcp = true;
+    config.num_workers = 2;
+    config.max_batch = 8;
+    TEST_ASSERT(sssp_server_create(graph, &config, &server) == SSSP_SUCCESS, "Failed to start server");
+    TEST_ASSERT(sssp_server_get_port(server) != 0, "An ephemeral port should be bound");
+    pthread_t thread;
+    TEST_ASSERT(pthread_create(&thread, NULL, run_server, server) == 0, "Failed to start server thread");
+    
+    int fd = -1;
+    TEST_ASSERT(sssp_client_connect_unix(path, &fd) == SSSP_SUCCESS, "Failed to connect over Unix socket");
+    sssp_query_reply_t reply;
+    sssp_query_t query = { SSSP_QUERY_POINT_TO_POINT, 3, n - 1, NULL, 0, SSSP_INFINITY, 0 };
+    TEST_ASSERT(sssp_client_query(fd, &query, NULL, &reply) == SSSP_SUCCESS && reply.status == SSSP_SERVER_OK,
+                "Point-to-point query failed");
+    TEST_ASSERT(reply.count > 1 && reply.vertices[0] == 3 && reply.vertices[reply.count - 1] == n - 1 &&
+                fabs(reply.distances[reply.count - 1] - from3->distances[n - 1]) < 1e-9,
+                "Path should run from source to target with the shortest distance");
+    for (vertex_count_t i = 1; i < reply.count; i++) {
+        TEST_ASSERT(reply.distances[i] >= reply.distances[i - 1], "Path distances should not decrease");
+    }
+    sssp_query_reply_free(&reply, NULL);
+    
+    // Single-source, bounded and multi-source answers against the reference
+    vertex_id_t sources[] = { 3, 100 };
+    sssp_query_t queries[] = {
+        { SSSP_QUERY_SINGLE_SOURCE, 3, 0, NULL, 0, SSSP_INFINITY, 0 },
+        { SSSP_QUERY_BOUNDED, 3, 0, NULL, 0, 12.0, 0 },
+        { SSSP_QUERY_MULTI_SOURCE, 0, 0, sources, 2, 20.0, 0 },
+    };
+    for (int q = 0; q < 3; q++) {
+        TEST_ASSERT(sssp_client_query(fd, &queries[q], NULL, &reply) == SSSP_SUCCESS &&
+                    reply.status == SSSP_SERVER_OK, "Query failed");
+        vertex_count_t expected_count = 0;
+        for (vertex_id_t v = 0; v < n; v++) {
+            distance_t d = q == 2 ? SSSP_MIN(from3->distances[v], from100->distances[v]) : from3->distances[v];
+            if (d != SSSP_INFINITY && d <= queries[q].bound) {
+                expected_count++;
+            }
+        }
+        TEST_ASSERT(reply.count == expected_count, "Query should return every vertex within its bound");
+        for (vertex_count_t i = 0; i < reply.count; i++) {
+            vertex_id_t v = reply.vertices[i];
+            distance_t d = q == 2 ? SSSP_MIN(from3->distances[v], from100->distances[v]) : from3->distances[v];
+            TEST_ASSERT(fabs(reply.distances[i] - d) < 1e-9, "Query distance should match the reference");
+        }
+        sssp_query_reply_free(&reply, NULL);
+    }
+    close(fd);
+    
+    // Pipelined point-to-point queries from one source, plus a bad one
+    TEST_ASSERT(sssp_client_connect_tcp(sssp_server_get_port(server), &fd) == SSSP_SUCCESS,
+                "Failed to connect over TCP");
+    const uint32_t pipelined = 40;
+    for (uint32_t i = 0; i < pipelined; i++) {
+        sssp_query_t p2p = { SSSP_QUERY_POINT_TO_POINT, 3, (i * 131) % n, NULL, 0, SSSP_INFINITY, 0 };
+        TEST_ASSERT(sssp_client_send(fd, i, &p2p) == SSSP_SUCCESS, "Send failed");
+    }
+    sssp_query_t bad = { SSSP_QUERY_POINT_TO_POINT, 3, n, NULL, 0, SSSP_INFINITY, 0 };
+    TEST_ASSERT(sssp_client_send(fd, pipelined, &bad) == SSSP_SUCCESS, "Send failed");
+    for (uint32_t i = 0; i <= pipelined; i++) {
+        TEST_ASSERT(sssp_client_receive(fd, NULL, &reply) == SSSP_SUCCESS, "Receive failed");
+        if (reply.id == pipelined) {
+            TEST_ASSERT(reply.status == SSSP_SERVER_BAD_REQUEST, "Bad target should be reported");
+        } else {
+            vertex_id_t target = (reply.id * 131) % n;
+            TEST_ASSERT(reply.status == SSSP_SERVER_OK, "Pipelined query failed");
+            TEST_ASSERT(reply.count == 0 ? from3->distances[target] == SSSP_INFINITY
+                        : fabs(reply.distances[reply.count - 1] - from3->distances[target]) < 1e-9,
+                        "Pipelined distance should match the reference");
+        }
+        sssp_query_reply_free(&reply, NULL);
+    }
+    close(fd);
+    
+    sssp_server_stop(server);
+    pthread_join(thread, NULL);
+    sssp_server_stats_t stats = sssp_server_get_stats(server);
+    TEST_ASSERT(stats.connections == 2 && stats.requests == pipelined + 5 && stats.answered == pipelined + 4 &&
+                stats.batches > 0,
+                "Stats should count connections and requests");
+    sssp_server_destroy(server);
+    TEST_ASSERT(access(path, F_OK) != 0, "Socket file should be removed");
+    
+    sssp_algorithm_result_destroy(from100);
+    sssp_algorithm_result_destroy(from3);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_query_server");
+    return true;
+}
+
+static int in_degree_builds = 0;
+
+static sssp_error_t build_in_degrees(const sssp_graph_t* graph, void* context,
+                                     const sssp_allocator_t* allocator, void** data_out, uint64_t* size_out) {
+    (void)context;
+    in_degree_builds++;
+    vertex_count_t n = sssp_graph_get_vertex_count(graph);
+    uint32_t* degrees = sssp_alloc(allocator, n * sizeof(uint32_t));
+    if (!degrees) {
+        return SSSP_ERROR_OUT_OF_MEMORY;
+    }
+    memset(degrees, 0, n * sizeof(uint32_t));
+    for (edge_count_t e = 0; e < graph->num_edges; e++) {
+        degrees[graph->csr_targets[e]]++;
+    }
+    *data_out = degrees;
+    *size_out = n * sizeof(uint32_t);
+    return SSSP_SUCCESS;
+}
+
+/**
+ * Test snapshot files: round trip, reuse, staleness and damage
+ */
+static bool test_snapshot() {
+    const vertex_count_t n = 3000;
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 15000, 1.0, 10.0, 45, NULL);
+    sssp_graph_t* other = sssp_graph_generate_gnm(n, 15000, 1.0, 10.0, 46, NULL);
+    TEST_ASSERT(graph && other, "Failed to generate graphs");
+    TEST_ASSERT(sssp_graph_content_hash(graph) == sssp_graph_content_hash(graph) &&
+                sssp_graph_content_hash(graph) != sssp_graph_content_hash(other),
+                "Content hash should tell graphs apart");
+    
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/sssp_test_%d.snapshot", (int)getpid());
+    unlink(path);
+    sssp_snapshot_index_t index = { 0x494e4447, build_in_degrees, NULL };
+    sssp_snapshot_t* snapshot = NULL;
+    bool rebuilt = false;
+    TEST_ASSERT(sssp_snapshot_load_or_build(path, graph, &index, 1, 0, NULL, &snapshot, &rebuilt) == SSSP_SUCCESS &&
+                rebuilt && in_degree_builds == 1, "Missing snapshot should be built");
+    const sssp_graph_t* mapped = sssp_snapshot_graph(snapshot);
+    TEST_ASSERT(sssp_graph_is_csr(mapped) && mapped->num_vertices == n && mapped->num_edges == graph->num_edges,
+                "Mapped graph should have the original shape");
+    TEST_ASSERT(sssp_snapshot_graph_hash(snapshot) == sssp_graph_content_hash(graph) &&
+                sssp_graph_content_hash(mapped) == sssp_graph_content_hash(graph),
+                "Mapped graph should hash like its source");
+    sssp_algorithm_result_t* expected = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(expected && result, "Failed to create results");
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, NULL, expected) == SSSP_SUCCESS &&
+                sssp_solve_single_source(mapped, 0, NULL, result) == SSSP_SUCCESS &&
+                sssp_results_equal(expected, result, n, 0.0), "Mapped graph should solve like its source");
+    const uint32_t* degrees = NULL;
+    uint64_t size = 0;
+    TEST_ASSERT(sssp_snapshot_find(snapshot, index.tag, (const void**)&degrees, &size) == SSSP_SUCCESS &&
+                size == n * sizeof(uint32_t), "Index section should be stored");
+    uint64_t total = 0;
+    for (vertex_id_t v = 0; v < n; v++) {
+        total += degrees[v];
+    }
+    TEST_ASSERT(total == graph->num_edges, "Index section should keep its contents");
+    TEST_ASSERT(sssp_snapshot_find(snapshot, 0x12345678, (const void**)&degrees, NULL) == SSSP_ERROR_INVALID_ARGUMENT,
+                "Unknown sections should not be found");
+    sssp_snapshot_close(snapshot);
+    
+    // A matching file is reused, a stale one rebuilt
+    TEST_ASSERT(sssp_snapshot_load_or_build(path, graph, &index, 1, SSSP_SNAPSHOT_VERIFY, NULL,
+                                            &snapshot, &rebuilt) == SSSP_SUCCESS && !rebuilt &&
+                in_degree_builds == 1, "Matching snapshot should be reused");
+    sssp_snapshot_close(snapshot);
+    TEST_ASSERT(sssp_snapshot_load_or_build(path, other, &index, 1, 0, NULL, &snapshot, &rebuilt) == SSSP_SUCCESS &&
+                rebuilt && in_degree_builds == 2, "Snapshot of another graph should be rebuilt");
+    TEST_ASSERT(sssp_snapshot_graph_hash(snapshot) == sssp_graph_content_hash(other), "Rebuilt for the wrong graph");
+    sssp_snapshot_close(snapshot);
+    
+    // Flip a byte in the edge weights: caught only by verification
+    FILE* file = fopen(path, "r+b");
+    TEST_ASSERT(file != NULL, "Failed to open snapshot");
+    fseek(file, -(long)(n * sizeof(uint32_t)) - 100, SEEK_END);
+    int byte = fgetc(file);
+    fseek(file, -1, SEEK_CUR);
+    fputc(byte ^ 0x40, file);
+    fclose(file);
+    TEST_ASSERT(sssp_snapshot_open(path, 0, NULL, &snapshot) == SSSP_SUCCESS, "Unverified open should succeed");
+    sssp_snapshot_close(snapshot);
+    TEST_ASSERT(sssp_snapshot_open(path, SSSP_SNAPSHOT_VERIFY, NULL, &snapshot) == SSSP_ERROR_IO,
+                "Verified open should catch the damage");
+    TEST_ASSERT(sssp_snapshot_load_or_build(path, other, &index, 1, SSSP_SNAPSHOT_VERIFY, NULL,
+                                            &snapshot, &rebuilt) == SSSP_SUCCESS && rebuilt,
+                "Damaged snapshot should be rebuilt");
+    sssp_snapshot_close(snapshot);
+    
+    // List-backed graphs are stored in CSR form and hash the same
+    sssp_graph_t* list = sssp_graph_create(4, NULL);
+    TEST_ASSERT(list != NULL, "Failed to create graph");
+    sssp_graph_add_edge(list, 0, 1, 1.5);
+    sssp_graph_add_edge(list, 0, 2, 4.0);
+    sssp_graph_add_edge(list, 2, 3, 0.5);
+    TEST_ASSERT(sssp_snapshot_save(path, list, NULL, 0) == SSSP_SUCCESS, "Failed to save list graph");
+    TEST_ASSERT(sssp_snapshot_open(path, SSSP_SNAPSHOT_VERIFY, NULL, &snapshot) == SSSP_SUCCESS,
+                "Failed to open list graph snapshot");
+    mapped = sssp_snapshot_graph(snapshot);
+    TEST_ASSERT(mapped->num_edges == 3 && mapped->csr_offsets[1] == 2 &&
+                sssp_graph_content_hash(mapped) == sssp_graph_content_hash(list),
+                "List graph should round-trip through CSR");
+    const sssp_adj_list_t* adjacency = sssp_graph_get_adj_list(mapped, 2);
+    TEST_ASSERT(adjacency && adjacency->count == 1 && adjacency->head->to == 3,
+                "Lists should be available over a mapped graph");
+    TEST_ASSERT(sssp_graph_in_degree(mapped, 3) == 1 && sssp_graph_in_degree(mapped, 0) == 0,
+                "In-edges should be available over a mapped graph");
+    TEST_ASSERT(sssp_graph_build_integer_weights((sssp_graph_t*)mapped) == SSSP_SUCCESS &&
+                sssp_graph_get_weight_scale(mapped) == 10,
+                "Integer weights should be available over a mapped graph");
+    sssp_snapshot_close(snapshot);
+    sssp_snapshot_section_t duplicate[2] = { { 1, "a", 1 }, { 1, "b", 1 } };
+    TEST_ASSERT(sssp_snapshot_save(path, list, duplicate, 2) == SSSP_ERROR_INVALID_ARGUMENT,
+                "Duplicate tags should be rejected");
+    
+    unlink(path);
+    sssp_graph_destroy(list);
+    sssp_algorithm_result_destroy(result);
+    sssp_algorithm_result_destroy(expected);
+    sssp_graph_destroy(other);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_snapshot");
+    return true;
+}
+
+typedef struct version_reader {
+    sssp_versioned_graph_t* versioned;
+    atomic_bool stop;
+    uint64_t queries;
+    uint64_t mismatches;
+} version_reader_t;
+
+/**
+ * Query pinned versions until told to stop; the writer sets the weight of
+ * 0 -> 1 to version - 1 in every version after the first
+ */
+static void* run_version_reader(void* arg) {
+    version_reader_t* state = arg;
+    sssp_graph_reader_t* reader = NULL;
+    if (sssp_versioned_graph_add_reader(state->versioned, &reader) != SSSP_SUCCESS) {
+        state->mismatches++;
+        return NULL;
+    }
+    while (!atomic_load(&state->stop)) {
+        uint64_t version = 0;
+        const sssp_graph_t* graph = sssp_graph_reader_pin(reader, &version);
+        weight_t* distances = NULL;
+        if (sssp_dijkstra_reference(graph, 0, NULL, &distances, NULL) != SSSP_SUCCESS ||
+            distances[1] != (version == 1 ? 1.0 : (double)(version - 1)) ||
+            distances[graph->num_vertices - 1] != distances[1] + graph->num_vertices - 2) {
+            state->mismatches++;
+        }
+        free(distances);
+        sssp_graph_reader_unpin(reader);
+        state->queries++;
+    }
+    sssp_versioned_graph_remove_reader(reader);
+    return NULL;
+}
+
+/**
+ * Test versioned graphs: deltas, pinning, reclamation and concurrent readers
+ */
+static bool test_versioned_graph() {
+    const vertex_count_t n = 64;
+    sssp_graph_t* chain = sssp_graph_create(n, NULL);
+    TEST_ASSERT(chain != NULL, "Failed to create graph");
+    for (vertex_id_t v = 0; v + 1 < n; v++) {
+        sssp_graph_add_edge(chain, v, v + 1, 1.0);
+    }
+    sssp_versioned_graph_t* versioned = NULL;
+    TEST_ASSERT(sssp_versioned_graph_create(chain, 2, NULL, &versioned) == SSSP_SUCCESS,
+                "Failed to create versioned graph");
+    sssp_graph_destroy(chain);
+    
+    TEST_ASSERT(sssp_versioned_graph_set_weight(versioned, 0, 2, 1.0) == SSSP_ERROR_INVALID_PARAMETER,
+                "Overriding a missing edge should fail");
+    TEST_ASSERT(sssp_versioned_graph_add_edge(versioned, 0, n, 1.0) == SSSP_ERROR_INVALID_PARAMETER,
+                "Edge to an invalid vertex should fail");
+    TEST_ASSERT(sssp_versioned_graph_add_edge(versioned, 0, 1, -1.0) == SSSP_ERROR_INVALID_PARAMETER,
+                "Negative weight should fail");
+    
+    // A pinned version survives later publishes
+    sssp_graph_reader_t* reader = NULL;
+    TEST_ASSERT(sssp_versioned_graph_add_reader(versioned, &reader) == SSSP_SUCCESS, "Failed to add reader");
+    uint64_t version = 0;
+    const sssp_graph_t* pinned = sssp_graph_reader_pin(reader, &version);
+    TEST_ASSERT(pinned && version == 1 && pinned->num_edges == n - 1, "First version should be the copy");
+    TEST_ASSERT(sssp_graph_build_integer_weights((sssp_graph_t*)pinned) == SSSP_SUCCESS,
+                "Integer weights should be available over a version");
+    
+    TEST_ASSERT(sssp_versioned_graph_add_edge(versioned, 0, 5, 3.0) == SSSP_SUCCESS &&
+                sssp_versioned_graph_set_weight(versioned, 0, 5, 2.0) == SSSP_SUCCESS,
+                "Failed to stage delta");
+    TEST_ASSERT(sssp_versioned_graph_publish(versioned, &version) == SSSP_SUCCESS && version == 2,
+                "Failed to publish");
+    TEST_ASSERT(sssp_versioned_graph_set_weight(versioned, 1, 2, SSSP_INFINITY) == SSSP_SUCCESS &&
+                sssp_versioned_graph_publish(versioned, &version) == SSSP_SUCCESS && version == 3,
+                "Failed to publish weight override");
+    TEST_ASSERT(pinned->num_edges == n - 1 && pinned->csr_weights[pinned->csr_offsets[1]] == 1.0,
+                "Pinned version should not change");
+    sssp_versioned_graph_stats_t stats = sssp_versioned_graph_get_stats(versioned);
+    TEST_ASSERT(stats.retained == 2 && stats.reclaimed == 0, "Pinned version should be retained");
+    sssp_graph_reader_unpin(reader);
+    
+    const sssp_graph_t* current = sssp_graph_reader_pin(reader, &version);
+    weight_t* distances = NULL;
+    TEST_ASSERT(version == 3 && current->num_edges == n &&
+                sssp_dijkstra_reference(current, 0, NULL, &distances, NULL) == SSSP_SUCCESS,
+                "Failed to query current version");
+    TEST_ASSERT(distances[5] == 2.0 && distances[2] == SSSP_INFINITY && distances[6] == 3.0,
+                "Current version should have the delta applied");
+    free(distances);
+    sssp_graph_reader_unpin(reader);
+    TEST_ASSERT(sssp_versioned_graph_publish(versioned, NULL) == SSSP_SUCCESS, "Empty publish failed");
+    stats = sssp_versioned_graph_get_stats(versioned);
+    TEST_ASSERT(stats.retained == 0 && stats.reclaimed == 2 && stats.edges_added == 1 &&
+                stats.weights_overridden == 2, "Unpinned versions should be reclaimed");
+    sssp_graph_reader_t* extra = NULL;
+    TEST_ASSERT(sssp_versioned_graph_add_reader(versioned, &extra) == SSSP_SUCCESS &&
+                sssp_versioned_graph_add_reader(versioned, &(sssp_graph_reader_t*){ NULL }) ==
+                SSSP_ERROR_INVALID_ARGUMENT, "Reader slots should run out");
+    sssp_versioned_graph_remove_reader(extra);
+    sssp_versioned_graph_remove_reader(reader);
+    sssp_versioned_graph_destroy(versioned);
+    
+    // Readers query while a writer publishes
+    chain = sssp_graph_create(n, NULL);
+    TEST_ASSERT(chain != NULL, "Failed to create graph");
+    for (vertex_id_t v = 0; v + 1 < n; v++) {
+        sssp_graph_add_edge(chain, v, v + 1, 1.0);
+    }
+    TEST_ASSERT(sssp_versioned_graph_create(chain, 0, NULL, &versioned) == SSSP_SUCCESS,
+                "Failed to create versioned graph");
+    sssp_graph_destroy(chain);
+    version_reader_t states[2] = { { .versioned = versioned }, { .versioned = versioned } };
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT(pthread_create(&threads[i], NULL, run_version_reader, &states[i]) == 0,
+                    "Failed to start reader");
+    }
+    const uint64_t publishes = 300;
+    bool published = true;
+    for (uint64_t k = 1; k <= publishes && published; k++) {
+        published = sssp_versioned_graph_set_weight(versioned, 0, 1, (double)k) == SSSP_SUCCESS;
+        if (k % 4 == 0) {
+            published &= sssp_versioned_graph_add_edge(versioned, (vertex_id_t)(k % n), 0, 1000.0) == SSSP_SUCCESS;
+        }
+        published &= sssp_versioned_graph_publish(versioned, NULL) == SSSP_SUCCESS;
+    }
+    for (int i = 0; i < 2; i++) {
+        atomic_store(&states[i].stop, true);
+        pthread_join(threads[i], NULL);
+    }
+    TEST_ASSERT(published, "Publishing under readers failed");
+    TEST_ASSERT(states[0].mismatches == 0 && states[1].mismatches == 0,
+                "Readers should always see a consistent version");
+    TEST_ASSERT(sssp_versioned_graph_publish(versioned, NULL) == SSSP_SUCCESS, "Empty publish failed");
+    stats = sssp_versioned_graph_get_stats(versioned);
+    TEST_ASSERT(stats.version == publishes + 1 && stats.retained == 0 && stats.reclaimed == publishes,
+                "Every replaced version should be reclaimed");
+    sssp_versioned_graph_destroy(versioned);
+    
+    TEST_PASS("test_versioned_graph");
+    return true;
+}
+
 /**
  * Test parameter computation utilities
  */
@@ -436,6 +2202,545 @@ static bool test_parameter_computation() {
     return true;
 }
 
+/**
+ * Check that two vertex sets hold the same vertices in the same order
+ */
+static bool same_vertex_set(const sssp_vertex_set_t* a, const sssp_vertex_set_t* b) {
+    return a->size == b->size && memcmp(a->vertices, b->vertices, a->size * sizeof(vertex_id_t)) == 0;
+}
+
+/**
+ * Test profiled solve fills the profile whether or not counters are available
+ */
+static bool test_profiling() {
+    const vertex_count_t n = 64;
+    sssp_graph_t* graph = sssp_graph_create(n, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to create graph");
+    
+    for (vertex_id_t i = 0; i + 1 < n; i++) {
+        TEST_ASSERT(sssp_graph_add_edge(graph, i, i + 1, 1.0) == SSSP_SUCCESS, "Failed to add chain edge");
+        if (i + 7 < n) {
+            TEST_ASSERT(sssp_graph_add_edge(graph, i, i + 7, 5.0) == SSSP_SUCCESS, "Failed to add skip edge");
+        }
+    }
+    
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* reference = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(result != NULL && reference != NULL, "Failed to create results");
+    
+    sssp_performance_profile_t profile;
+    TEST_ASSERT(sssp_solve_with_profiling(graph, 0, NULL, result, &profile) == SSSP_SUCCESS,
+                "Profiled solve failed");
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, NULL, reference) == SSSP_SUCCESS,
+                "Reference solve failed");
+    
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(result->distances[v] == reference->distances[v],
+                    "Profiled distances should match the unprofiled solve");
+    }
+    
+    TEST_ASSERT(profile.heap_pulls == n, "Every vertex should be pulled once");
+    TEST_ASSERT(profile.total_relaxations == result->relaxations_performed,
+                "Relaxation count should match the result");
+    TEST_ASSERT(profile.useful_relaxations <= profile.total_relaxations,
+                "Useful relaxations cannot exceed total relaxations");
+    TEST_ASSERT(profile.max_heap_size >= 1, "Heap should have held at least one vertex");
+    TEST_ASSERT(profile.initialization_time_ms >= 0.0 && profile.relaxation_time_ms >= 0.0,
+                "Phase times should be non-negative");
+    TEST_ASSERT(profile.initialization_time_ms + profile.heap_operations_time_ms +
+                profile.relaxation_time_ms + profile.finalization_time_ms <= profile.total_time_ms + 1e-6,
+                "Phase times should not exceed the total");
+    if (!profile.hw_counters_available) {
+        TEST_ASSERT(profile.cache_hit_ratio == 0.0, "Cache hit ratio should be 0 without counters");
+        TEST_ASSERT(profile.total_counters.available_mask == 0, "No counters should be marked available");
+    } else {
+        TEST_ASSERT(profile.cache_hit_ratio >= 0.0 && profile.cache_hit_ratio <= 1.0,
+                    "Cache hit ratio should be a ratio");
+    }
+    
+    // A profiler attached to the thread charges FINDPIVOTS time to its own phase
+    sssp_profiler_t profiler;
+    TEST_ASSERT(sssp_profiler_init(&profiler, false) == SSSP_SUCCESS, "Failed to init profiler");
+    TEST_ASSERT(!sssp_profiler_has_hw_counters(&profiler), "Counters were not requested");
+    sssp_profiler_set_current(&profiler);
+    sssp_profiler_start(&profiler, SSSP_PHASE_INITIALIZATION);
+    
+    sssp_vertex_set_t* sources = sssp_vertex_set_create(n, NULL);
+    sssp_find_pivots_result_t* pivots = sssp_find_pivots_result_create(NULL);
+    TEST_ASSERT(sources != NULL && pivots != NULL, "Failed to create pivot inputs");
+    for (vertex_id_t v = 0; v < 8; v++) {
+        sssp_vertex_set_add(sources, v);
+    }
+    TEST_ASSERT(sssp_find_pivots(graph, 2.0, sources, 2, NULL, pivots) == SSSP_SUCCESS,
+                "FINDPIVOTS failed under profiling");
+    TEST_ASSERT(profiler.current_phase == SSSP_PHASE_INITIALIZATION,
+                "FINDPIVOTS should restore the caller's phase");
+    TEST_ASSERT(profiler.phase_switches >= 2, "FINDPIVOTS should switch phases");
+    
+    sssp_profiler_stop(&profiler);
+    sssp_profiler_set_current(NULL);
+    sssp_profiler_destroy(&profiler);
+    
+    // A profiled BMSSP query charges FINDPIVOTS and its base cases
+    sssp_vertex_set_t* found = sssp_vertex_set_create(n, NULL);
+    sssp_vertex_set_t* unprofiled = sssp_vertex_set_create(n, NULL);
+    TEST_ASSERT(found != NULL && unprofiled != NULL, "Failed to create BMSSP outputs");
+    sssp_algorithm_config_t bmssp = sssp_algorithm_config_default(n, NULL);
+    bmssp.t = 2;
+    weight_t b_profiled, b_unprofiled;
+    TEST_ASSERT(sssp_bounded_multi_source_with_profiling(graph, 20.0, sources, bmssp.k, bmssp.t, &bmssp,
+                                                         found, &b_profiled, &profile) == SSSP_SUCCESS,
+                "Profiled BMSSP query failed");
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 20.0, sources, bmssp.k, bmssp.t, &bmssp,
+                                          unprofiled, &b_unprofiled) == SSSP_SUCCESS,
+                "Unprofiled BMSSP query failed");
+    TEST_ASSERT(b_profiled == b_unprofiled && same_vertex_set(found, unprofiled),
+                "Profiling should not change the BMSSP result");
+    TEST_ASSERT(profile.find_pivots_time_ms > 0.0, "FINDPIVOTS time should be recorded");
+    TEST_ASSERT(profile.heap_operations_time_ms > 0.0, "Base case heap time should be recorded");
+    sssp_vertex_set_destroy(unprofiled);
+    sssp_vertex_set_destroy(found);
+    
+    sssp_find_pivots_result_destroy(pivots);
+    sssp_vertex_set_destroy(sources);
+    sssp_algorithm_result_destroy(reference);
+    sssp_algorithm_result_destroy(result);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_profiling");
+    return true;
+}
+
+/**
+ * Test memory tracking and memory limits
+ */
+static bool test_memory_limits() {
+    // Tracking allocator accounting
+    sssp_tracking_allocator_t tracker;
+    sssp_tracking_allocator_init(&tracker, NULL, 1000);
+    void* block = sssp_alloc(&tracker.allocator, 100);
+    TEST_ASSERT(block != NULL, "Tracked allocation failed");
+    block = sssp_realloc(&tracker.allocator, block, 300);
+    TEST_ASSERT(block != NULL, "Tracked reallocation failed");
+    TEST_ASSERT(sssp_alloc(&tracker.allocator, 800) == NULL, "Allocation over the limit should fail");
+    TEST_ASSERT(tracker.limit_failures == 1, "Refused allocation should be counted");
+    sssp_free(&tracker.allocator, block);
+    sssp_memory_stats_t stats = sssp_tracking_allocator_stats(&tracker);
+    TEST_ASSERT(stats.current_bytes == 0 && stats.peak_bytes == 300, "Wrong tracked byte counts");
+    TEST_ASSERT(stats.total_allocations == 1 && stats.total_deallocations == 1,
+                "Wrong tracked allocation counts");
+    
+    // Graph built through a tracker: tracked and computed footprints agree
+    sssp_tracking_allocator_t graph_tracker;
+    sssp_tracking_allocator_init(&graph_tracker, NULL, 0);
+    const vertex_count_t n = 20000;
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 80000, 1.0, 2.0, 11, &graph_tracker.allocator);
+    TEST_ASSERT(graph != NULL, "Failed to generate tracked graph");
+    TEST_ASSERT(sssp_graph_memory_stats(graph).current_bytes == graph_tracker.stats.current_bytes,
+                "Graph memory stats should match the tracked allocation");
+    
+    // Unlimited solve reports its peak working memory
+    sssp_algorithm_result_t* full = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* lean = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(full && lean, "Failed to create results");
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, full) == SSSP_SUCCESS,
+                "Unlimited solve failed");
+    TEST_ASSERT(full->peak_memory_bytes >= sssp_solver_memory_estimate(n, SSSP_SOLVER_DIJKSTRA),
+                "Peak memory should cover the solver arrays");
+    
+    // A budget below the indexed heap switches to the lean solver
+    config.memory_limit_bytes = sssp_solver_memory_estimate(n, SSSP_SOLVER_DIJKSTRA) - 1;
+    TEST_ASSERT(config.memory_limit_bytes > 2 * sssp_solver_memory_estimate(n, SSSP_SOLVER_LEAN),
+                "Lean solver should need much less memory");
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, lean) == SSSP_SUCCESS,
+                "Lean solve failed");
+    TEST_ASSERT(lean->peak_memory_bytes <= config.memory_limit_bytes, "Lean solve exceeded its budget");
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(full->distances[v] == lean->distances[v], "Lean solve should give the same distances");
+    }
+    
+    // A budget below the lean solver fails fast
+    config.memory_limit_bytes = sssp_solver_memory_estimate(n, SSSP_SOLVER_LEAN) - 1;
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, lean) == SSSP_ERROR_MEMORY_LIMIT,
+                "Solve over budget should fail with a memory limit error");
+    
+    // Per-query tracking stacks on a process-wide tracker
+    sssp_tracking_allocator_t process_tracker;
+    sssp_tracking_allocator_init(&process_tracker, NULL, 0);
+    config = sssp_algorithm_config_default(n, &process_tracker.allocator);
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, lean) == SSSP_SUCCESS,
+                "Solve on a tracked allocator failed");
+    stats = sssp_tracking_allocator_stats(&process_tracker);
+    TEST_ASSERT(stats.current_bytes == 0, "Solve should release all of its memory");
+    TEST_ASSERT(stats.peak_bytes >= lean->peak_memory_bytes, "Process tracker should see the query peak");
+    
+    sssp_algorithm_result_destroy(lean);
+    sssp_algorithm_result_destroy(full);
+    sssp_graph_destroy(graph);
+    TEST_ASSERT(graph_tracker.stats.current_bytes == 0, "Graph should release all of its memory");
+    TEST_PASS("test_memory_limits");
+    return true;
+}
+
+/**
+ * Test the huge page allocator and huge-page-backed solves
+ */
+static bool test_huge_pages() {
+    sssp_tracking_allocator_t counter;
+    sssp_tracking_allocator_init(&counter, NULL, 0);
+    
+    // Small blocks go to the parent; large blocks get a mapping of their own
+    const size_t threshold = (size_t)1 << 20;
+    for (int mode = SSSP_HUGE_PAGES_TRANSPARENT; mode <= SSSP_HUGE_PAGES_EXPLICIT; mode++) {
+        sssp_huge_page_allocator_t pages;
+        sssp_huge_page_allocator_init(&pages, &counter.allocator, threshold, (sssp_huge_page_mode_t)mode);
+        
+        char* small = sssp_alloc(&pages.allocator, 100);
+        TEST_ASSERT(small != NULL && counter.stats.current_bytes > 0, "Small block should come from the parent");
+        char* large = sssp_alloc(&pages.allocator, threshold + 1);
+        TEST_ASSERT(large != NULL, "Large allocation failed");
+        TEST_ASSERT(((uintptr_t)large % _Alignof(max_align_t)) == 0, "Large block is misaligned");
+        memset(large, 0x5a, threshold + 1);
+        
+        sssp_memory_stats_t stats = sssp_huge_page_allocator_stats(&pages);
+#if defined(__linux__)
+        TEST_ASSERT(stats.current_bytes > threshold && stats.total_allocations == 1,
+                    "Large block should be mapped");
+        TEST_ASSERT(stats.page_size >= 4096, "Mapping should report its page size");
+        TEST_ASSERT(counter.stats.current_bytes < threshold, "Large block should bypass the parent");
+#endif
+        
+        // Growing past the mapping moves the block and keeps its contents
+        large = sssp_realloc(&pages.allocator, large, 4 * threshold);
+        TEST_ASSERT(large != NULL && large[0] == 0x5a && large[threshold] == 0x5a,
+                    "Reallocation lost the block contents");
+        small = sssp_realloc(&pages.allocator, small, 2 * threshold);
+        TEST_ASSERT(small != NULL, "Growing a small block failed");
+        
+        sssp_free(&pages.allocator, large);
+        sssp_free(&pages.allocator, small);
+        stats = sssp_huge_page_allocator_stats(&pages);
+        TEST_ASSERT(stats.current_bytes == 0 && stats.total_allocations == stats.total_deallocations,
+                    "Mappings should all be released");
+        TEST_ASSERT(counter.stats.current_bytes == 0, "Parent blocks should all be released");
+    }
+    
+    // Solves with and without huge pages agree
+    const vertex_count_t n = 200000;
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 4 * n, 1.0, 10.0, 17, NULL);
+    TEST_ASSERT(graph != NULL, "Failed to generate graph");
+    sssp_algorithm_result_t* huge = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* plain = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(huge && plain, "Failed to create results");
+    
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    config.huge_page_threshold = threshold;
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, huge) == SSSP_SUCCESS, "Huge page solve failed");
+#if defined(__linux__)
+    TEST_ASSERT(huge->page_size >= 4096, "Solve should report the page size of its arrays");
+#endif
+    config.huge_page_threshold = 0;
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, plain) == SSSP_SUCCESS, "Plain solve failed");
+    TEST_ASSERT(plain->page_size == 0, "Solve without huge pages should not report a page size");
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(huge->distances[v] == plain->distances[v], "Huge page solve should give the same distances");
+    }
+    
+    // The graph's own arrays go on huge pages through its allocator
+    sssp_huge_page_allocator_t pages;
+    sssp_huge_page_allocator_init(&pages, NULL, threshold, SSSP_HUGE_PAGES_TRANSPARENT);
+    sssp_graph_t* mapped = sssp_graph_generate_gnm(n, 4 * n, 1.0, 10.0, 17, &pages.allocator);
+    TEST_ASSERT(mapped != NULL && sssp_graph_build_csr(mapped) == SSSP_SUCCESS,
+                "Failed to generate graph on huge pages");
+#if defined(__linux__)
+    TEST_ASSERT(sssp_huge_page_allocator_stats(&pages).current_bytes >=
+                (size_t)mapped->num_edges * (sizeof(vertex_id_t) + sizeof(weight_t)),
+                "CSR arrays should be mapped");
+#endif
+    TEST_ASSERT(sssp_solve_single_source(mapped, 0, &config, huge) == SSSP_SUCCESS,
+                "Solve over a mapped graph failed");
+    for (vertex_id_t v = 0; v < n; v++) {
+        TEST_ASSERT(huge->distances[v] == plain->distances[v], "Mapped graph should give the same distances");
+    }
+    sssp_graph_destroy(mapped);
+    TEST_ASSERT(sssp_huge_page_allocator_stats(&pages).current_bytes == 0,
+                "Graph mappings should all be released");
+    
+    sssp_algorithm_result_destroy(plain);
+    sssp_algorithm_result_destroy(huge);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_huge_pages");
+    return true;
+}
+
+/**
+ * Test the arena allocator and allocation-free repeated BMSSP solves
+ */
+static bool test_scratch_arena() {
+    // Rewinding releases in O(1) and reuses the same memory
+    sssp_tracking_allocator_t counter;
+    sssp_tracking_allocator_init(&counter, NULL, 0);
+    sssp_arena_t arena;
+    sssp_arena_init(&arena, &counter.allocator, 4096);
+    
+    sssp_arena_mark_t mark = sssp_arena_mark(&arena);
+    char* a = sssp_alloc(&arena.allocator, 100);
+    TEST_ASSERT(a != NULL, "Arena allocation failed");
+    memset(a, 7, 100);
+    TEST_ASSERT(sssp_realloc(&arena.allocator, a, 1000) == a, "Newest allocation should grow in place");
+    char* big = sssp_alloc(&arena.allocator, 10000);
+    TEST_ASSERT(big != NULL && ((uintptr_t)big % _Alignof(max_align_t)) == 0, "Arena allocation misaligned");
+    char* moved = sssp_realloc(&arena.allocator, a, 5000);
+    TEST_ASSERT(moved != NULL && moved != a && moved[99] == 7, "Reallocation should copy old contents");
+    sssp_arena_rewind(&arena, mark);
+    size_t blocks = counter.stats.total_allocations;
+    TEST_ASSERT(sssp_alloc(&arena.allocator, 100) == a, "Rewind should reuse the first block");
+    TEST_ASSERT(sssp_alloc(&arena.allocator, 10000) == big, "Rewind should reuse later blocks");
+    TEST_ASSERT(counter.stats.total_allocations == blocks, "Reuse should not allocate blocks");
+    sssp_arena_reset(&arena);
+    
+    // Repeated BMSSP queries through one arena stop allocating after the first
+    const vertex_count_t n = 300;
+    sssp_graph_t* graph = sssp_graph_generate_gnm(n, 1500, 1.0, 10.0, 5, NULL);
+    sssp_vertex_set_t* sources = sssp_vertex_set_create(0, &counter.allocator);
+    sssp_vertex_set_t* first = sssp_vertex_set_create(n, &counter.allocator);
+    sssp_vertex_set_t* second = sssp_vertex_set_create(n, &counter.allocator);
+    TEST_ASSERT(graph && sources && first && second, "Failed to set up BMSSP inputs");
+    for (vertex_id_t v = 0; v < 40; v++) {
+        sssp_vertex_set_add(sources, v * 7);
+    }
+    
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, &counter.allocator);
+    config.scratch_arena = &arena;
+    TEST_ASSERT(sssp_vertex_set_size(sources) > config.t, "Query should recurse");
+    weight_t b_first, b_second;
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 5.0, sources, config.k, config.t, &config,
+                                          first, &b_first) == SSSP_SUCCESS,
+                "First arena-backed query failed");
+    sssp_memory_stats_t warm = sssp_tracking_allocator_stats(&counter);
+    for (int query = 0; query < 3; query++) {
+        TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 5.0, sources, config.k, config.t, &config,
+                                              second, &b_second) == SSSP_SUCCESS,
+                    "Repeated arena-backed query failed");
+    }
+    sssp_memory_stats_t after = sssp_tracking_allocator_stats(&counter);
+    TEST_ASSERT(after.total_allocations == warm.total_allocations &&
+                after.total_deallocations == warm.total_deallocations,
+                "Repeated queries should not allocate");
+    TEST_ASSERT(b_first == b_second && same_vertex_set(first, second),
+                "Repeated queries should give the same result");
+    
+    // Without a caller arena the solve uses its own and frees everything
+    config.scratch_arena = NULL;
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 5.0, sources, config.k, config.t, &config,
+                                          second, &b_second) == SSSP_SUCCESS,
+                "Query with a per-solve arena failed");
+    TEST_ASSERT(b_first == b_second && same_vertex_set(first, second),
+                "Per-solve arena should give the same result");
+    
+    // A memory limit holds the whole recursion, FINDPIVOTS included
+    sssp_tracking_allocator_t process;
+    sssp_tracking_allocator_init(&process, NULL, 0);
+    sssp_algorithm_config_t budgeted = sssp_algorithm_config_default(n, &process.allocator);
+    budgeted.memory_limit_bytes = 64 * 1024;
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 5.0, sources, budgeted.k, budgeted.t, &budgeted,
+                                          second, &b_second) == SSSP_SUCCESS,
+                "Budgeted query failed");
+    TEST_ASSERT(b_first == b_second && same_vertex_set(first, second),
+                "Budgeted query should give the same result");
+    sssp_memory_stats_t budget_stats = sssp_tracking_allocator_stats(&process);
+    TEST_ASSERT(budget_stats.peak_bytes <= budgeted.memory_limit_bytes,
+                "Budgeted query exceeded its limit");
+    TEST_ASSERT(budget_stats.current_bytes == 0, "Budgeted query should release all of its memory");
+    budgeted.memory_limit_bytes = sssp_solver_memory_estimate(n, SSSP_SOLVER_DIJKSTRA);
+    TEST_ASSERT(sssp_bounded_multi_source(graph, 0, 5.0, sources, budgeted.k, budgeted.t, &budgeted,
+                                          second, &b_second) == SSSP_ERROR_MEMORY_LIMIT,
+                "Query over its budget should fail with a memory limit error");
+    TEST_ASSERT(sssp_tracking_allocator_stats(&process).peak_bytes <= 64 * 1024,
+                "Refused query exceeded its limit");
+    
+    sssp_vertex_set_destroy(second);
+    sssp_vertex_set_destroy(first);
+    sssp_vertex_set_destroy(sources);
+    sssp_arena_destroy(&arena);
+    TEST_ASSERT(sssp_tracking_allocator_stats(&counter).current_bytes == 0,
+                "Arena should return all blocks");
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_scratch_arena");
+    return true;
+}
+
+/**
+ * Test the SIMD relaxation kernels against the scalar kernel
+ */
+static bool test_relax_kernels() {
+    const sssp_relax_kernel_t kernels[] = {
+        SSSP_RELAX_KERNEL_SCALAR, SSSP_RELAX_KERNEL_AVX2, SSSP_RELAX_KERNEL_AVX512
+    };
+    const sssp_relax_kernel_t original = sssp_relax_get_kernel();
+    TEST_ASSERT(original != SSSP_RELAX_KERNEL_AUTO, "Active kernel should be resolved");
+    
+    // Direct scan: 37 edges (SIMD body plus tail) with repeated targets
+    distance_t distances[16];
+    vertex_id_t targets[37];
+    weight_t weights[37];
+    for (int i = 0; i < 16; i++) {
+        distances[i] = i % 3 == 0 ? SSSP_INFINITY : 1.0 + i;
+    }
+    for (int i = 0; i < 37; i++) {
+        targets[i] = (vertex_id_t)((i * 5) % 16);
+        weights[i] = 0.5 * (i % 11);
+    }
+    edge_count_t expected[37];
+    edge_count_t found[37];
+    sssp_relax_set_kernel(SSSP_RELAX_KERNEL_SCALAR);
+    edge_count_t expected_count = sssp_relax_scan(2.0, targets, weights, 37, distances, expected);
+    TEST_ASSERT(expected_count > 0 && expected_count < 37, "Scan should find some improving edges");
+    
+    // Whole solves on a power-law graph with high-degree hubs
+    const unsigned int scale = 12;
+    const vertex_count_t n = 1u << scale;
+    sssp_graph_t* graph = sssp_graph_generate_rmat(scale, 16 * n, 0.57, 0.19, 0.19, 1.0, 10.0, 3, NULL);
+    sssp_algorithm_result_t* reference = sssp_algorithm_result_create(n, NULL);
+    sssp_algorithm_result_t* result = sssp_algorithm_result_create(n, NULL);
+    TEST_ASSERT(graph && reference && result, "Failed to set up relaxation kernel test");
+    sssp_algorithm_config_t config = sssp_algorithm_config_default(n, NULL);
+    TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, reference) == SSSP_SUCCESS,
+                "Scalar solve failed");
+    
+    for (size_t k = 1; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!sssp_relax_kernel_supported(kernels[k])) {
+            TEST_ASSERT(sssp_relax_set_kernel(kernels[k]) == SSSP_ERROR_INVALID_ARGUMENT,
+                        "Selecting an unsupported kernel should fail");
+            continue;
+        }
+        TEST_ASSERT(sssp_relax_set_kernel(kernels[k]) == SSSP_SUCCESS, "Failed to select kernel");
+        
+        edge_count_t count = sssp_relax_scan(2.0, targets, weights, 37, distances, found);
+        TEST_ASSERT(count == expected_count && memcmp(found, expected, count * sizeof(edge_count_t)) == 0,
+                    "SIMD scan should report the same edges as the scalar scan");
+        
+        TEST_ASSERT(sssp_solve_single_source(graph, 0, &config, result) == SSSP_SUCCESS,
+                    "SIMD solve failed");
+        TEST_ASSERT(memcmp(result->distances, reference->distances, n * sizeof(distance_t)) == 0,
+                    "SIMD kernel should give the same distances as the scalar kernel");
+        TEST_ASSERT(result->relaxations_performed == reference->relaxations_performed,
+                    "SIMD kernel should count every scanned edge");
+    }
+    
+    sssp_relax_set_kernel(original);
+    sssp_algorithm_result_destroy(result);
+    sssp_algorithm_result_destroy(reference);
+    sssp_graph_destroy(graph);
+    TEST_PASS("test_relax_kernels");
+    return true;
+}
+
+#define CAPTURED_LOG_LINES 8
+
+static pthread_mutex_t captured_log_lock = PTHREAD_MUTEX_INITIALIZER;
+static char captured_log[CAPTURED_LOG_LINES][256];
+static int captured_log_count;
+static int captured_log_warnings;
+
+static void capture_log(sssp_log_level_t level, const char* file, int line,
+                        const char* func, const char* format, ...) {
+    (void)file; (void)line; (void)func;
+    pthread_mutex_lock(&captured_log_lock);
+    if (level == SSSP_LOG_WARN) {
+        captured_log_warnings++;
+    } else if (captured_log_count < CAPTURED_LOG_LINES) {
+        va_list args;
+        va_start(args, format);
+        vsnprintf(captured_log[captured_log_count++], sizeof(captured_log[0]), format, args);
+        va_end(args);
+    }
+    pthread_mutex_unlock(&captured_log_lock);
+}
+
+static void* log_from_thread(void* arg) {
+    for (int i = 0; i < 200; i++) {
+        SSSP_LOG_DEBUG("thread %d message %d", *(int*)arg, i);
+    }
+    return NULL;
+}
+
+/**
+ * Test the asynchronous log backend: formatting, drops and several threads
+ */
+static bool test_async_log() {
+    sssp_set_log_function(capture_log);
+    sssp_set_log_level(SSSP_LOG_DEBUG);
+    
+    // Messages come out formatted as synchronous logging would
+    sssp_log_async_config_t config = { .ring_records = 16, .flush_interval_ms = 200 };
+    sssp_error_t started = sssp_log_async_start(&config);
+    char transient[] = "copied";
+    size_t size = 12345;
+    SSSP_LOG_INFO("%u vertices, %s, %.2f ms, %llu edges", 42u, transient, 1.5, 1ULL << 40);
+    transient[0] = 'X';
+    SSSP_LOG_INFO("%zu bytes, %*d|%-5s|%c|%x|%%|%.3s", size, 6, -17, "ab", 'q', 255u, "truncate");
+    sssp_log_flush();
+    pthread_mutex_lock(&captured_log_lock);
+    bool formatted = captured_log_count == 2 &&
+                     strcmp(captured_log[0], "42 vertices, copied, 1.50 ms, 1099511627776 edges") == 0 &&
+                     strcmp(captured_log[1], "12345 bytes,    -17|ab   |q|ff|%|tru") == 0;
+    pthread_mutex_unlock(&captured_log_lock);
+    
+    // A string too long for a record is logged whole, synchronously
+    char long_string[201];
+    memset(long_string, 'y', 200);
+    long_string[200] = '\0';
+    SSSP_LOG_INFO("long: %s", long_string);
+    sssp_log_flush();
+    pthread_mutex_lock(&captured_log_lock);
+    formatted = formatted && captured_log_count == 3 && strncmp(captured_log[2], "long: ", 6) == 0 &&
+                strcmp(captured_log[2] + 6, long_string) == 0;
+    pthread_mutex_unlock(&captured_log_lock);
+    
+    // A full ring drops messages and counts them
+    sssp_log_async_stats_t before = sssp_log_async_get_stats();
+    for (int i = 0; i < 1000; i++) {
+        SSSP_LOG_DEBUG("burst %d", i);
+    }
+    sssp_log_flush();
+    sssp_log_async_stats_t after = sssp_log_async_get_stats();
+    bool dropped = after.dropped > before.dropped &&
+                   (after.written - before.written) + (after.dropped - before.dropped) == 1000;
+    
+    // Each thread gets its own ring
+    sssp_log_async_stop();
+    config.ring_records = 1024;
+    config.flush_interval_ms = 1;
+    started = started == SSSP_SUCCESS ? sssp_log_async_start(&config) : started;
+    before = sssp_log_async_get_stats();
+    pthread_t threads[2];
+    int ids[2] = { 0, 1 };
+    int running = 0;
+    for (int i = 0; i < 2; i++) {
+        running += pthread_create(&threads[i], NULL, log_from_thread, &ids[i]) == 0;
+    }
+    for (int i = 0; i < running; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    sssp_log_async_stop();
+    after = sssp_log_async_get_stats();
+    
+    sssp_set_log_function(NULL);
+    sssp_set_log_level(SSSP_LOG_WARN);
+    TEST_ASSERT(started == SSSP_SUCCESS, "Failed to start async logging");
+    TEST_ASSERT(formatted, "Async messages should be formatted like synchronous ones");
+    TEST_ASSERT(dropped, "Full rings should drop and count messages");
+    TEST_ASSERT(captured_log_warnings > 0, "Drops should be reported");
+    TEST_ASSERT(running == 2 && after.written - before.written == 400 && after.dropped == before.dropped,
+                "Stopping should write every message from every thread");
+    TEST_ASSERT(sssp_log_async_start(&(sssp_log_async_config_t){ .ring_records = 100 }) ==
+                SSSP_ERROR_INVALID_ARGUMENT, "Ring size should be a power of two");
+    
+    TEST_PASS("test_async_log");
+    return true;
+}
+
 /**
  * Run all tests
  */
@@ -450,9 +2755,27 @@ int main() {
     total_tests++;
     if (test_vertex_set()) tests_passed++;
     
+    total_tests++;
+    if (test_indexed_vertex_set()) tests_passed++;
+    
+    total_tests++;
+    if (test_sorted_vertex_set()) tests_passed++;
+    
     total_tests++;
     if (test_graph()) tests_passed++;
     
+    total_tests++;
+    if (test_graph_generators()) tests_passed++;
+    
+    total_tests++;
+    if (test_reverse_graph()) tests_passed++;
+    
+    total_tests++;
+    if (test_graph_neighbors()) tests_passed++;
+    
+    total_tests++;
+    if (test_implicit_graph()) tests_passed++;
+    
     total_tests++;
     if (test_partitioning_heap()) tests_passed++;
     
@@ -473,9 +2796,60 @@ int main() {
     total_tests++;
     if (test_disconnected_graph()) tests_passed++;
     
+    total_tests++;
+    if (test_targeted_queries()) tests_passed++;
+    
+    total_tests++;
+    if (test_query_limits()) tests_passed++;
+    
+    total_tests++;
+    if (test_approximate_sssp()) tests_passed++;
+    
+    total_tests++;
+    if (test_integer_weights()) tests_passed++;
+    
+    total_tests++;
+    if (test_all_pairs()) tests_passed++;
+    
+    total_tests++;
+    if (test_negative_weights()) tests_passed++;
+    
+    total_tests++;
+    if (test_result_validation()) tests_passed++;
+    
+    total_tests++;
+    if (test_distributed_sssp()) tests_passed++;
+    
+    total_tests++;
+    if (test_query_server()) tests_passed++;
+    
+    total_tests++;
+    if (test_snapshot()) tests_passed++;
+    
+    total_tests++;
+    if (test_versioned_graph()) tests_passed++;
+    
     total_tests++;
     if (test_parameter_computation()) tests_passed++;
     
+    total_tests++;
+    if (test_profiling()) tests_passed++;
+    
+    total_tests++;
+    if (test_memory_limits()) tests_passed++;
+    
+    total_tests++;
+    if (test_huge_pages()) tests_passed++;
+    
+    total_tests++;
+    if (test_scratch_arena()) tests_passed++;
+    
+    total_tests++;
+    if (test_relax_kernels()) tests_passed++;
+    
+    total_tests++;
+    if (test_async_log()) tests_passed++;
+    
     printf("\n=== TEST RESULTS ===\n");
     printf("Tests passed: %d/%d\n", tests_passed, total_tests);
     